@@ -0,0 +1,130 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Command line runner for native benchmark suites:
+//
+//   benchmarks [--suite light|full] [--format text|csv|json] [--output file]
+//              [--warmup N] [--iterations N] [--filter substring] [--quiet]
+//
+
+#include <system/Environment.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "FullBenchmarkSuit.h"
+#include "LightBenchmarkSuit.h"
+
+using namespace sd;
+
+static void usage() {
+  std::cerr << "usage: benchmarks [--suite light|full] [--format text|csv|json] [--output file]\n"
+               "                  [--warmup N] [--iterations N] [--filter substring] [--quiet]\n";
+}
+
+int main(int argc, char **argv) {
+  std::string suiteName("light");
+  std::string output;
+  std::string filter;
+  BenchmarkFormat format = BenchmarkFormat::TEXT;
+  unsigned int warmup = 10;
+  unsigned int iterations = 100;
+  bool quiet = false;
+
+  for (int e = 1; e < argc; e++) {
+    std::string arg(argv[e]);
+    bool hasValue = e + 1 < argc;
+
+    if (arg == "--quiet") {
+      quiet = true;
+    } else if (arg == "--help" || arg == "-h") {
+      usage();
+      return 0;
+    } else if (!hasValue) {
+      usage();
+      return 1;
+    } else if (arg == "--suite") {
+      suiteName = argv[++e];
+    } else if (arg == "--output") {
+      output = argv[++e];
+    } else if (arg == "--filter") {
+      filter = argv[++e];
+    } else if (arg == "--warmup") {
+      warmup = static_cast<unsigned int>(std::strtoul(argv[++e], nullptr, 10));
+    } else if (arg == "--iterations") {
+      iterations = static_cast<unsigned int>(std::strtoul(argv[++e], nullptr, 10));
+    } else if (arg == "--format") {
+      std::string f(argv[++e]);
+      if (f == "text")
+        format = BenchmarkFormat::TEXT;
+      else if (f == "csv")
+        format = BenchmarkFormat::CSV;
+      else if (f == "json")
+        format = BenchmarkFormat::JSON;
+      else {
+        usage();
+        return 1;
+      }
+    } else {
+      usage();
+      return 1;
+    }
+  }
+
+  std::unique_ptr<BenchmarkSuit> suit;
+  if (suiteName == "light")
+    suit.reset(new LightBenchmarkSuit());
+  else if (suiteName == "full")
+    suit.reset(new FullBenchmarkSuit());
+  else {
+    usage();
+    return 1;
+  }
+
+  if (iterations == 0) iterations = 1;
+
+  BenchmarkHelper helper(warmup, iterations);
+  helper.setFilter(filter);
+  helper.setPrintOut(!quiet);
+
+  try {
+    suit->runSuit(helper);
+  } catch (std::exception &e) {
+    std::cerr << "Benchmark suite [" << suit->name() << "] failed: " << e.what() << std::endl;
+    return 2;
+  }
+
+  auto report = helper.report(format);
+  if (output.empty()) {
+    std::cout << report;
+  } else {
+    std::ofstream file(output);
+    if (!file) {
+      std::cerr << "Can't open [" << output << "] for writing" << std::endl;
+      return 1;
+    }
+    file << report;
+  }
+
+  return 0;
+}
@@ -22,22 +22,30 @@
 
 #ifndef LIBND4J_BENCHMARKSUIT_H
 #define LIBND4J_BENCHMARKSUIT_H
+#include <array/NDArrayFactory.h>
+#include <helpers/BenchmarkHelper.h>
 
 #include <string>
-#include <system/pointercast.h>
-#include <system/dll.h>
-#include <helpers/BenchmarkHelper.h>
-#include <array/NDArrayFactory.h>
 
 namespace sd {
-    class SD_LIB_EXPORT BenchmarkSuit {
-    public:
-        BenchmarkSuit() = default;
-        ~BenchmarkSuit() = default;
 
-        virtual std::string runSuit() = 0;
-    };
+/**
+ * Set of benchmarks, results are collected by BenchmarkHelper
+ */
+class BenchmarkSuit {
+ public:
+  BenchmarkSuit() = default;
+  virtual ~BenchmarkSuit() = default;
+
+  virtual std::string name() const = 0;
+  virtual void runSuit(BenchmarkHelper &helper) = 0;
+};
+
+template <typename T>
+static NDArray *benchmarkArray(char order, std::vector<LongType> shape) {
+  return NDArrayFactory::create_<T>(order, shape);
 }
 
+}  // namespace sd
 
-#endif //DEV_TESTS_BENCHMARKSUIT_H
+#endif  // LIBND4J_BENCHMARKSUIT_H
@@ -0,0 +1,488 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+#include <helpers/benchmark/SortBenchmark.h>
+#include <ops/declarable/CustomOperations.h>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+#include "FullBenchmarkSuit.h"
+
+#ifdef _RELEASE
+static const int gemmRegularUpperPow = 11;
+static const int gemmIrregularSize = 1024;
+static const int gemmFallbackUpperPow = 9;
+static const int batchGemmSize = 1024;
+static const int transformPowLimit = 26;
+static const int heavyPowLimit = 22;
+static const int gatherOpPowLimit = 18;
+static const int sortPowLimit = 24;
+static const int stridedRows = 131072;
+#else
+static const int gemmRegularUpperPow = 7;
+static const int gemmIrregularSize = 32;
+static const int gemmFallbackUpperPow = 6;
+static const int batchGemmSize = 64;
+static const int transformPowLimit = 10;
+static const int heavyPowLimit = 10;
+static const int gatherOpPowLimit = 10;
+static const int sortPowLimit = 12;
+static const int stridedRows = 1024;
+#endif
+
+namespace sd {
+
+static void layerNormBenchmark(BenchmarkHelper &helper) {
+  BoolParameters nhwc("nhwc");  // 0 = nchw
+
+#ifdef _RELEASE
+  const int c = 32;
+  const int hw = 64;
+#else
+  const int c = 3;
+  const int hw = 8;
+#endif
+
+  ParametersBatch batch({&nhwc});
+
+  auto generator = PARAMETRIC_D() {
+    auto ctx = new graph::Context(1);
+    int n = p.getIntParam("nhwc");
+
+    std::vector<LongType> shape = n == 0 ? std::vector<LongType>{16, c, hw, hw} : std::vector<LongType>{16, hw, hw, c};
+    ctx->setInputArray(0, benchmarkArray<float>('c', shape), true);
+    ctx->setOutputArray(0, benchmarkArray<float>('c', shape), true);
+    ctx->setInputArray(1, benchmarkArray<float>('c', {c}), true);  // gain
+    ctx->setIArguments(std::vector<LongType>{n == 0 ? 1 : 3});     // axis
+    return ctx;
+  };
+
+  ops::layer_norm layerNorm;
+  DeclarableBenchmark benchmark(layerNorm, "layer norm");
+  helper.runOperationSuit(&benchmark, generator, batch, "Layer Norm");
+}
+
+static void batchnormBenchmark(BenchmarkHelper &helper) {
+  BoolParameters nhwc("nhwc");
+#ifdef _RELEASE
+  PredefinedParameters c("c", {3, 32, 128});
+  PredefinedParameters hw("hw", {32, 128});
+#else
+  PredefinedParameters c("c", {3});
+  PredefinedParameters hw("hw", {16});
+#endif
+
+  ParametersBatch batch({&nhwc, &c, &hw});
+
+  auto generator = PARAMETRIC_D() {
+    auto ctx = new graph::Context(1);
+    int n = p.getIntParam("nhwc");
+    int hw = p.getIntParam("hw");
+    int ch = p.getIntParam("c");
+
+    std::vector<LongType> shape = n == 0 ? std::vector<LongType>{32, ch, hw, hw} : std::vector<LongType>{32, hw, hw, ch};
+    ctx->setInputArray(0, benchmarkArray<float>('c', shape), true);
+    ctx->setOutputArray(0, benchmarkArray<float>('c', shape), true);
+
+    float one = 1.0f;
+    ctx->setInputArray(1, benchmarkArray<float>('c', {ch}), true);  // mean
+    for (int e = 2; e <= 4; e++) {                                   // variance, gamma, beta
+      auto arr = benchmarkArray<float>('c', {ch});
+      arr->assign(one);
+      ctx->setInputArray(e, arr, true);
+    }
+
+    ctx->setIArguments(std::vector<LongType>{1, 1, n == 0 ? 1 : 3});  // apply scale, apply offset, axis
+    ctx->setTArguments(std::vector<double>{1e-5});
+    return ctx;
+  };
+
+  ops::batchnorm batchnorm;
+  DeclarableBenchmark benchmark(batchnorm, "batchnorm");
+  helper.runOperationSuit(&benchmark, generator, batch, "Batch Normalization");
+}
+
+static void gemmRegularBenchmark(BenchmarkHelper &helper) {
+  for (int o = 0; o <= 1; o++) {
+    char resultOrder = (o == 0 ? 'f' : 'c');
+    for (int tA = 0; tA <= 1; tA++) {
+      for (int tB = 0; tB <= 1; tB++) {
+        IntPowerParameters pa("sz", 2, 7, gemmRegularUpperPow, 2);  // 2^7=128, 2^9=512, 2^11=2048
+
+        ParametersBatch b({&pa});
+
+        auto generator = PARAMETRIC_XYZ() {
+          auto s = p.getIntParam("sz");
+          x.push_back(benchmarkArray<float>('c', {s, s}));
+          y.push_back(benchmarkArray<float>('c', {s, s}));
+          z.push_back(benchmarkArray<float>(resultOrder, {s, s}));
+        };
+
+        std::string n("Gemm - tA=");
+        n += std::to_string(tA);
+        n += ", tB=";
+        n += std::to_string(tB);
+        n += ", cOrder=";
+        n += resultOrder;
+
+        MatrixBenchmark mb(1.0, 0.0, tA != 0, tB != 0, n);
+        helper.runOperationSuit(&mb, generator, b, n.c_str());
+      }
+    }
+  }
+}
+
+static void gemmIrregularBenchmark(BenchmarkHelper &helper) {
+  // same as above, but with shapes that aren't multiples of 8: one of m, k, n varies around the base size
+  const int base = gemmIrregularSize;
+  const char *varying[] = {"a.rows", "a.columns", "b.columns"};
+
+  for (int tA = 0; tA <= 1; tA++) {
+    for (int tB = 0; tB <= 1; tB++) {
+      for (int v = 0; v < 3; v++) {
+        IntParameters d("d", base - 4, base + 4, 1);
+        ParametersBatch dim({&d});
+
+        auto generator = PARAMETRIC_XYZ() {
+          LongType m = v == 0 ? p.getIntParam("d") : base;
+          LongType k = v == 1 ? p.getIntParam("d") : base;
+          LongType n = v == 2 ? p.getIntParam("d") : base;
+
+          x.push_back(benchmarkArray<float>('c', tA ? std::vector<LongType>{k, m} : std::vector<LongType>{m, k}));
+          y.push_back(benchmarkArray<float>('c', tB ? std::vector<LongType>{n, k} : std::vector<LongType>{k, n}));
+          z.push_back(benchmarkArray<float>('f', {m, n}));
+        };
+
+        std::string n("Gemm (");
+        n += varying[v];
+        n += ") - tA=";
+        n += std::to_string(tA);
+        n += ", tB=";
+        n += std::to_string(tB);
+
+        MatrixBenchmark mb(1.0, 0.0, tA != 0, tB != 0, n);
+        helper.runOperationSuit(&mb, generator, dim, n.c_str());
+      }
+    }
+  }
+}
+
+static void gemmFallbackBenchmark(BenchmarkHelper &helper) {
+  // types BLAS doesn't cover go through packed fallback gemm in MmulHelper
+  for (auto dtype : {DataType::HALF, DataType::BFLOAT16, DataType::INT16}) {
+    IntPowerParameters pa("sz", 2, 6, gemmFallbackUpperPow, 1);  // 2^6=64, ..., 2^9=512
+
+    ParametersBatch b({&pa});
+
+    auto generator = PARAMETRIC_XYZ() {
+      std::vector<LongType> shape = {p.getIntParam("sz"), p.getIntParam("sz")};
+      x.push_back(NDArrayFactory::create_('c', shape, dtype));
+      y.push_back(NDArrayFactory::create_('c', shape, dtype));
+      z.push_back(NDArrayFactory::create_('c', shape, dtype));
+    };
+
+    std::string n("Gemm (fallback) - ");
+    n += DataTypeUtils::asString(dtype);
+
+    MatrixBenchmark mb(1.0, 0.0, false, false, n);
+    helper.runOperationSuit(&mb, generator, b, n.c_str());
+  }
+}
+
+static void batchGemmBenchmark(BenchmarkHelper &helper) {
+  // rank 3 - [32,s,s]x[32,s,s], rank 4 - [4,8,s,s]x[4,8,s,s]
+  IntParameters rank("rank", 3, 4, 1);
+
+  ParametersBatch b({&rank});
+
+  auto generator = PARAMETRIC_D() {
+    const LongType s = batchGemmSize;
+    auto shape = p.getIntParam("rank") == 3 ? std::vector<LongType>{32, s, s} : std::vector<LongType>{4, 8, s, s};
+
+    auto ctx = new graph::Context(1);
+    ctx->setInputArray(0, benchmarkArray<float>('c', shape), true);
+    ctx->setInputArray(1, benchmarkArray<float>('c', shape), true);
+    ctx->setOutputArray(0, benchmarkArray<float>('c', shape), true);
+    return ctx;
+  };
+
+  ops::matmul mmul;
+  DeclarableBenchmark benchmark(mmul, "mmul (batch)");
+  helper.runOperationSuit(&benchmark, generator, b, "MMul (batch)");
+}
+
+static void gatherOpBenchmark(BenchmarkHelper &helper) {
+  IntPowerParameters length("length", 2, 10, gatherOpPowLimit, 4);  // 2^10 to 2^18 in steps of 4
+  ParametersBatch batch({&length});
+
+  // 1d input, 1d shuffled indices -> 1d output
+  auto generator = PARAMETRIC_D() {
+    auto ctx = new graph::Context(1);
+    int length = p.getIntParam("length");
+
+    std::vector<int> order(length);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), std::mt19937(12345));
+
+    auto indices = benchmarkArray<int>('c', {length});
+    for (int i = 0; i < length; i++) indices->p(i, order[i]);
+
+    ctx->setInputArray(0, benchmarkArray<float>('c', {length}), true);
+    ctx->setInputArray(1, indices, true);
+    ctx->setOutputArray(0, benchmarkArray<float>('c', {length}), true);
+    return ctx;
+  };
+
+  ops::gather gather;
+  DeclarableBenchmark gather1d(gather, "gather1d");
+  helper.runOperationSuit(&gather1d, generator, batch, "Gather - 1d");
+}
+
+template <typename T>
+static NDArray *randomArray(LongType length, unsigned int seed) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<double> dist(-1e6, 1e6);
+
+  auto result = benchmarkArray<T>('c', {length});
+  auto buffer = result->template bufferAsT<T>();
+  for (LongType e = 0; e < length; e++) buffer[e] = static_cast<T>(dist(rng));
+
+  return result;
+}
+
+static void sortBenchmark(BenchmarkHelper &helper) {
+  IntPowerParameters length("length", 2, 12, sortPowLimit, 4);  // 2^12, 2^16, ..., 2^24
+  ParametersBatch batch({&length});
+
+  auto generator = PARAMETRIC_XYZ() {
+    LongType length = p.getIntParam("length");
+    x.push_back(randomArray<float>(length, 124));
+    y.push_back(nullptr);
+    z.push_back(benchmarkArray<float>('c', {length}));
+  };
+
+  SortBenchmark sort(false, "sort");
+  helper.runOperationSuit(&sort, generator, batch, "Sort - float");
+
+  // keys are restored before every iteration, values are just carried along
+  auto generator2 = PARAMETRIC_XYZ() {
+    LongType length = p.getIntParam("length");
+    auto values = benchmarkArray<LongType>('c', {length});
+    values->linspace(0);
+
+    x.push_back(randomArray<double>(length, 125));
+    y.push_back(values);
+    z.push_back(benchmarkArray<double>('c', {length}));
+  };
+
+  SortBenchmark sortByKey(false, "sortByKey");
+  helper.runOperationSuit(&sortByKey, generator2, batch, "Sort By Key - double/long");
+}
+
+static void stridedReductionNonEws(BenchmarkHelper &helper) {
+  IntPowerParameters stride("stride", 2, 0, 10, 2);  // 2^0=1, ..., 2^10=1024
+
+  ParametersBatch batch({&stride});
+
+  // first column of a [rows, stride] matrix: technically an ews exists here
+  auto generator1 = PARAMETRIC_XYZ() {
+    LongType stride = p.getIntParam("stride");
+    auto arr = benchmarkArray<float>('c', {stridedRows, stride});
+
+    NDArray *strided = arr;
+    if (stride != 1) {
+      strided = &(*arr)({0, 0, 0, 1});
+      delete arr;
+    }
+
+    float one = 1.0f;
+    strided->assign(one);
+    x.push_back(strided);
+    y.push_back(nullptr);
+    z.push_back(NDArrayFactory::create_<float>(0.0f));
+  };
+
+  ReductionBenchmark rbSum(reduce::SameOps::Sum, "stridedSum");
+  helper.runOperationSuit(&rbSum, generator1, batch, "Strided Sum - No EWS Test 1");
+
+  // every other row and first column of a rank 3 array: no ews at all
+  auto generator2 = PARAMETRIC_XYZ() {
+    LongType stride = p.getIntParam("stride");
+    auto arr = benchmarkArray<float>('c', {(stride == 1 ? 1 : 2) * 128, 1024, stride});
+
+    NDArray *strided = arr;
+    if (stride != 1) {
+      strided = &(*arr)({0, 2 * 128, 2, 0, 0, 1, 0, 1, 1}, false, true);
+      delete arr;
+    }
+
+    float one = 1.0f;
+    strided->assign(one);
+    x.push_back(strided);
+    y.push_back(nullptr);
+    z.push_back(NDArrayFactory::create_<float>(0.0f));
+  };
+
+  ReductionBenchmark rbSum2(reduce::SameOps::Sum, "stridedSumNoEWS");
+  helper.runOperationSuit(&rbSum2, generator2, batch, "Strided Sum - No EWS Test 2");
+}
+
+static void intermediateTransformsBenchmark(BenchmarkHelper &helper) {
+  IntPowerParameters length("length", 2, 10, transformPowLimit, 4);  // 2^10 to 2^26, steps of 4
+  BoolParameters inplace("inplace");
+
+  ParametersBatch batch({&length, &inplace});
+
+  auto generator = PARAMETRIC_XZ() {
+    auto arr = benchmarkArray<float>('c', {p.getIntParam("length")});
+    float half = 0.5f;
+    arr->assign(half);
+    x.push_back(arr);
+    if (p.getIntParam("inplace") == 1)
+      z.push_back(arr);
+    else
+      z.push_back(benchmarkArray<float>('c', {p.getIntParam("length")}));
+  };
+
+  TransformBenchmark tbTanh(transform::StrictOps::Tanh, "tanh");
+  TransformBenchmark tbGelu(transform::StrictOps::GELU, "gelu");
+  TransformBenchmark tbExp(transform::StrictOps::Exp, "exp");
+
+  helper.runOperationSuit(&tbTanh, generator, batch, "Tanh");
+  helper.runOperationSuit(&tbGelu, generator, batch, "GELU");
+  helper.runOperationSuit(&tbExp, generator, batch, "Exp");
+}
+
+static void heavyTransformsBenchmark(BenchmarkHelper &helper) {
+  IntPowerParameters length("length", 2, 10, heavyPowLimit, 4);  // 2^10 to 2^22, steps of 4
+  BoolParameters inplace("inplace");
+
+  ParametersBatch batch({&length, &inplace});
+
+  auto generator = PARAMETRIC_XZ() {
+    auto arr = benchmarkArray<float>('c', {p.getIntParam("length")});
+    float one = 1.0f;
+    arr->assign(one);
+    x.push_back(arr);
+    if (p.getIntParam("inplace") == 1)
+      z.push_back(arr);
+    else
+      z.push_back(benchmarkArray<float>('c', {p.getIntParam("length")}));
+  };
+
+  TransformBenchmark erf(transform::StrictOps::Erf, "Erf");
+  helper.runOperationSuit(&erf, generator, batch, "Error Function (Erf)");
+
+  ParametersBatch batch2({&length});
+
+  auto generator2 = PARAMETRIC_D() {
+    auto ctx = new graph::Context(1);
+    const int numInputs = p.getIntParam("inputs");
+    const float values[] = {0.25f, 0.5f, 0.75f};
+    for (int e = 0; e < numInputs; e++) {
+      auto in = benchmarkArray<float>('c', {p.getIntParam("length")});
+      float v = values[e];
+      in->assign(v);
+      ctx->setInputArray(e, in, true);
+    }
+    ctx->setOutputArray(0, benchmarkArray<float>('c', {p.getIntParam("length")}), true);
+    return ctx;
+  };
+
+  PredefinedParameters twoInputs("inputs", {2});
+  PredefinedParameters threeInputs("inputs", {3});
+  ParametersBatch batchPolygamma({&length, &twoInputs});
+  ParametersBatch batchBetainc({&length, &threeInputs});
+
+  ops::polygamma op1;
+  DeclarableBenchmark pg(op1, "polygamma");
+  helper.runOperationSuit(&pg, generator2, batchPolygamma, "PolyGamma Function");
+
+  ops::betainc op2;
+  DeclarableBenchmark binc(op2, "betainc");
+  helper.runOperationSuit(&binc, generator2, batchBetainc, "Incomplete Beta Function (BetaInc)");
+}
+
+static void conv2dBenchmark(BenchmarkHelper &helper) {
+  BoolParameters nhwc("nhwc");
+  PredefinedParameters k("k", {2, 3});
+#ifdef _RELEASE
+  PredefinedParameters c("c", {3, 32, 128});
+  PredefinedParameters hw("hw", {32, 128});
+#else
+  PredefinedParameters c("c", {3});
+  PredefinedParameters hw("hw", {16});
+#endif
+
+  ParametersBatch batch({&nhwc, &k, &c, &hw});
+
+  auto generator = PARAMETRIC_D() {
+    auto ctx = new graph::Context(1);
+    int n = p.getIntParam("nhwc");
+    int khw = p.getIntParam("k");
+    int ch = p.getIntParam("c");
+    int hw = p.getIntParam("hw");
+
+    std::vector<LongType> shape = n == 0 ? std::vector<LongType>{8, ch, hw, hw} : std::vector<LongType>{8, hw, hw, ch};
+    ctx->setInputArray(0, benchmarkArray<float>('c', shape), true);
+    ctx->setOutputArray(0, benchmarkArray<float>('c', shape), true);
+    ctx->setInputArray(1, benchmarkArray<float>('c', {khw, khw, ch, ch}), true);  // [kH, kW, iC, oC] always
+    ctx->setInputArray(2, benchmarkArray<float>('c', {ch}), true);
+
+    // kernel, stride, padding, dilation, SAME mode, data format
+    ctx->setIArguments(std::vector<LongType>{khw, khw, 1, 1, 0, 0, 1, 1, 1, n});
+    return ctx;
+  };
+
+  ops::conv2d conv2d;
+  DeclarableBenchmark benchmark(conv2d, "conv2d");
+  helper.runOperationSuit(&benchmark, generator, batch, "Conv2d Operation");
+}
+
+void FullBenchmarkSuit::runSuit(BenchmarkHelper &helper) {
+  sd_printf("Running FullBenchmarkSuite.intermediateTransformsBenchmark\n", "");
+  intermediateTransformsBenchmark(helper);
+  sd_printf("Running FullBenchmarkSuite.heavyTransformsBenchmark\n", "");
+  heavyTransformsBenchmark(helper);
+  sd_printf("Running FullBenchmarkSuite.stridedReductionNonEws\n", "");
+  stridedReductionNonEws(helper);
+  sd_printf("Running FullBenchmarkSuite.gatherOpBenchmark\n", "");
+  gatherOpBenchmark(helper);
+  sd_printf("Running FullBenchmarkSuite.sortBenchmark\n", "");
+  sortBenchmark(helper);
+  sd_printf("Running FullBenchmarkSuite.gemmRegularBenchmark\n", "");
+  gemmRegularBenchmark(helper);
+  sd_printf("Running FullBenchmarkSuite.gemmIrregularBenchmark\n", "");
+  gemmIrregularBenchmark(helper);
+  sd_printf("Running FullBenchmarkSuite.gemmFallbackBenchmark\n", "");
+  gemmFallbackBenchmark(helper);
+  sd_printf("Running FullBenchmarkSuite.batchGemmBenchmark\n", "");
+  batchGemmBenchmark(helper);
+  sd_printf("Running FullBenchmarkSuite.conv2dBenchmark\n", "");
+  conv2dBenchmark(helper);
+  sd_printf("Running FullBenchmarkSuite.batchnormBenchmark\n", "");
+  batchnormBenchmark(helper);
+  sd_printf("Running FullBenchmarkSuite.layerNormBenchmark\n", "");
+  layerNormBenchmark(helper);
+}
+}  // namespace sd
@@ -22,15 +22,14 @@
 
 #ifndef LIBND4J_FULLBENCHMARKSUIT_H
 #define LIBND4J_FULLBENCHMARKSUIT_H
-
-#include <performance/benchmarking/BenchmarkSuit.h>
+#include "BenchmarkSuit.h"
 
 namespace sd {
-    class FullBenchmarkSuit : public BenchmarkSuit {
-    public:
-        std::string runSuit() override;
-    };
-}
-
+class FullBenchmarkSuit : public BenchmarkSuit {
+ public:
+  std::string name() const override { return "full"; }
+  void runSuit(BenchmarkHelper &helper) override;
+};
+}  // namespace sd
 
-#endif //DEV_TESTS_FULLBENCHMARKSUIT_H
+#endif  // LIBND4J_FULLBENCHMARKSUIT_H
@@ -0,0 +1,442 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+#include <ops/declarable/CustomOperations.h>
+
+#include "LightBenchmarkSuit.h"
+
+namespace sd {
+
+template <typename T>
+static void transformBenchmark(BenchmarkHelper &helper) {
+  IntPowerParameters length("length", 2, 8, 20, 4);  // 2^8, 2^12, 2^16, 2^20
+  BoolParameters inplace("inplace");
+
+  ParametersBatch batch({&length, &inplace});
+
+  auto generator = PARAMETRIC_XZ() {
+    auto arr = benchmarkArray<T>('c', {p.getIntParam("length")});
+    T one = static_cast<T>(1.0f);
+    arr->assign(one);
+    x.push_back(arr);
+    if (p.getIntParam("inplace") == 1)
+      z.push_back(arr);
+    else
+      z.push_back(benchmarkArray<T>('c', {p.getIntParam("length")}));
+  };
+
+  TransformBenchmark tbSigmoid(transform::StrictOps::Sigmoid, "sigmoid");
+  TransformBenchmark tbTanh(transform::StrictOps::Tanh, "tanh");
+
+  helper.runOperationSuit(&tbSigmoid, generator, batch, "Sigmoid");
+  helper.runOperationSuit(&tbTanh, generator, batch, "Tanh");
+}
+
+template <typename T>
+static void scalarBenchmark(BenchmarkHelper &helper) {
+  IntPowerParameters length("length", 2, 8, 20, 4);  // 2^8, 2^12, 2^16, 2^20
+  BoolParameters inplace("inplace");
+
+  ParametersBatch batch({&length, &inplace});
+
+  auto generator = PARAMETRIC_XYZ() {
+    auto arr = benchmarkArray<T>('c', {p.getIntParam("length")});
+    T one = static_cast<T>(1.0f);
+    arr->assign(one);
+    x.push_back(arr);
+    y.push_back(NDArrayFactory::create_<T>(3.14159265359));
+    if (p.getIntParam("inplace") == 1)
+      z.push_back(arr);
+    else
+      z.push_back(benchmarkArray<T>('c', {p.getIntParam("length")}));
+  };
+
+  ScalarBenchmark sbAdd(scalar::Ops::Add, "sAdd");
+  ScalarBenchmark sbDiv(scalar::Ops::Divide, "sDiv");
+  ScalarBenchmark sbPow(scalar::Ops::Pow, "sPow");
+  ScalarBenchmark sbRelu(scalar::Ops::RELU, "RELU");
+
+  helper.runOperationSuit(&sbAdd, generator, batch, "Scalar Addition - x.add(3.14159265359)");
+  helper.runOperationSuit(&sbDiv, generator, batch, "Scalar Division - x.div(3.14159265359)");
+  helper.runOperationSuit(&sbPow, generator, batch, "Scalar Power - x.pow(3.14159265359)");
+  helper.runOperationSuit(&sbRelu, generator, batch, "RELU");
+}
+
+template <typename T>
+static void pairwiseBenchmark(BenchmarkHelper &helper) {
+  IntPowerParameters length("length", 2, 8, 20, 4);  // 2^8, 2^12, 2^16, 2^20
+  BoolParameters inplace("inplace");
+
+  ParametersBatch batch({&length, &inplace});
+
+  auto generator = PARAMETRIC_XYZ() {
+    auto arr1 = benchmarkArray<T>('c', {p.getIntParam("length")});
+    auto arr2 = benchmarkArray<T>('c', {p.getIntParam("length")});
+    T one = static_cast<T>(1.0f), two = static_cast<T>(2.0f);
+    arr1->assign(one);
+    arr2->assign(two);
+    x.push_back(arr1);
+    y.push_back(arr2);
+    if (p.getIntParam("inplace") == 1)
+      z.push_back(arr1);
+    else
+      z.push_back(benchmarkArray<T>('c', {p.getIntParam("length")}));
+  };
+
+  PairwiseBenchmark pb1(pairwise::Ops::Add, "Add");
+  helper.runOperationSuit(&pb1, generator, batch, "Pairwise Add");
+
+  PairwiseBenchmark pb2(pairwise::Ops::Divide, "Divide");
+  helper.runOperationSuit(&pb2, generator, batch, "Pairwise Divide");
+}
+
+template <typename T>
+static void reduceFullBenchmark(BenchmarkHelper &helper) {
+  IntPowerParameters length("length", 2, 8, 20, 4);  // 2^8, 2^12, 2^16, 2^20
+
+  ParametersBatch batch({&length});
+
+  auto generator = PARAMETRIC_XYZ() {
+    auto arr = benchmarkArray<T>('c', {p.getIntParam("length")});
+    T one = static_cast<T>(1.0f);
+    arr->assign(one);
+    x.push_back(arr);
+    y.push_back(nullptr);
+    z.push_back(NDArrayFactory::create_<T>(0.0f));
+  };
+
+  ReductionBenchmark rbSum(reduce::SameOps::Sum, "sum");
+  ReductionBenchmark rbProd(reduce::SameOps::Prod, "prod");
+  ReductionBenchmark rbMax(reduce::SameOps::Max, "max");
+
+  helper.runOperationSuit(&rbSum, generator, batch, "Sum - Full Array Reduction");
+  helper.runOperationSuit(&rbProd, generator, batch, "Product - Full Array Reduction");
+  helper.runOperationSuit(&rbMax, generator, batch, "Maximum - Full Array Reduction");
+
+  // index reduction
+  ops::argmax opArgmax;
+  DeclarableBenchmark dbArgmax(opArgmax, "Argmax");
+  auto generator2 = PARAMETRIC_D() {
+    auto ctx = new graph::Context(1);
+    ctx->setInputArray(0, benchmarkArray<T>('c', {p.getIntParam("length")}), true);
+    ctx->setOutputArray(0, NDArrayFactory::create_<LongType>(0), true);
+    return ctx;
+  };
+
+  helper.runOperationSuit(&dbArgmax, generator2, batch, "Argmax Full Array Reduction");
+}
+
+template <typename T>
+static void reduceDimBenchmark(BenchmarkHelper &helper) {
+  const int length = 1024 * 1024;
+
+  IntPowerParameters rows("rows", 2, 0, 10, 2);  // 2^0, 2^2, ..., 2^10
+  BoolParameters dim("dim");
+
+  ParametersBatch batch({&rows, &dim});
+
+  auto generator = PARAMETRIC_XYZ() {
+    int rows = p.getIntParam("rows");
+    int cols = length / rows;
+    int dim = p.getIntParam("dim");
+
+    auto arr = benchmarkArray<T>('c', {rows, cols});
+    T one = static_cast<T>(1.0f);
+    arr->assign(one);
+    x.push_back(arr);
+    y.push_back(NDArrayFactory::create_<LongType>(dim));
+    z.push_back(benchmarkArray<T>('c', {dim == 0 ? cols : rows}));
+  };
+
+  ReductionBenchmark rbSum(reduce::SameOps::Sum, "sum");
+  ReductionBenchmark rbMax(reduce::SameOps::Max, "max");
+
+  helper.runOperationSuit(&rbSum, generator, batch, "Sum Along Dimension - 1048576");
+  helper.runOperationSuit(&rbMax, generator, batch, "Maximum Along Dimension - 1048576");
+
+  auto generator2 = PARAMETRIC_D() {
+    auto ctx = new graph::Context(1);
+    int rows = p.getIntParam("rows");
+    int cols = length / rows;
+    int dim = p.getIntParam("dim");
+
+    ctx->setIArguments(std::vector<LongType>{dim});
+    ctx->setInputArray(0, benchmarkArray<T>('c', {rows, cols}), true);
+    ctx->setOutputArray(0, benchmarkArray<LongType>('c', {dim == 0 ? cols : rows}), true);
+    return ctx;
+  };
+
+  ops::argmax opArgmax;
+  DeclarableBenchmark dbArgmax(opArgmax, "Argmax");
+  helper.runOperationSuit(&dbArgmax, generator2, batch, "Argmax Along Dimension - 1048576");
+}
+
+template <typename T>
+static void gemmBenchmark(BenchmarkHelper &helper) {
+  for (int o = 0; o <= 1; o++) {
+    char resultOrder = (o == 0 ? 'f' : 'c');
+    IntPowerParameters sz("sz", 2, 4, 10, 2);  // 2^4=16, ..., 2^10=1024
+
+    ParametersBatch batch({&sz});
+
+    auto generator = PARAMETRIC_XYZ() {
+      auto s = p.getIntParam("sz");
+      x.push_back(benchmarkArray<T>('c', {s, s}));
+      y.push_back(benchmarkArray<T>('c', {s, s}));
+      z.push_back(benchmarkArray<T>(resultOrder, {s, s}));
+    };
+
+    std::string n("Gemm - cOrder=");
+    n += resultOrder;
+
+    MatrixBenchmark mb(1.0, 0.0, false, false, n);
+    helper.runOperationSuit(&mb, generator, batch, n.c_str());
+  }
+}
+
+template <typename T>
+static void conv2d(BenchmarkHelper &helper) {
+  BoolParameters nhwc("nhwc");
+  PredefinedParameters k("k", {2, 3});
+
+  ParametersBatch batch({&nhwc, &k});
+  ops::conv2d conv2d;
+  DeclarableBenchmark benchmark(conv2d, "conv2d");
+
+  const int hw = 64;
+
+  auto generator = PARAMETRIC_D() {
+    auto ctx = new graph::Context(1);
+    int n = p.getIntParam("nhwc");
+    int khw = p.getIntParam("k");
+
+    if (n == 0) {
+      ctx->setInputArray(0, benchmarkArray<T>('c', {8, 3, hw, hw}), true);
+      ctx->setOutputArray(0, benchmarkArray<T>('c', {8, 3, hw, hw}), true);
+    } else {
+      ctx->setInputArray(0, benchmarkArray<T>('c', {8, hw, hw, 3}), true);
+      ctx->setOutputArray(0, benchmarkArray<T>('c', {8, hw, hw, 3}), true);
+    }
+
+    ctx->setInputArray(1, benchmarkArray<T>('c', {khw, khw, 3, 3}), true);  // [kH, kW, iC, oC] always
+    ctx->setInputArray(2, benchmarkArray<T>('c', {3}), true);
+
+    // kernel, stride, padding, dilation, SAME mode, data format
+    ctx->setIArguments(std::vector<LongType>{khw, khw, 1, 1, 0, 0, 1, 1, 1, n});
+    return ctx;
+  };
+
+  helper.runOperationSuit(&benchmark, generator, batch, "Conv2d");
+}
+
+template <typename T>
+static void pool2d(BenchmarkHelper &helper) {
+  BoolParameters nhwc("nhwc");
+  PredefinedParameters k("k", {2, 3});
+
+  ParametersBatch batch({&nhwc, &k});
+
+  const int c = 3;
+  const int hw = 64;
+
+  auto generator = PARAMETRIC_D() {
+    auto ctx = new graph::Context(1);
+    int n = p.getIntParam("nhwc");
+    int khw = p.getIntParam("k");
+
+    if (n == 0) {
+      ctx->setInputArray(0, benchmarkArray<T>('c', {8, c, hw, hw}), true);
+      ctx->setOutputArray(0, benchmarkArray<T>('c', {8, c, hw, hw}), true);
+    } else {
+      ctx->setInputArray(0, benchmarkArray<T>('c', {8, hw, hw, c}), true);
+      ctx->setOutputArray(0, benchmarkArray<T>('c', {8, hw, hw, c}), true);
+    }
+
+    // kernel, stride, padding, dilation, SAME mode, divisor mode (exclude padding), data format
+    ctx->setIArguments(std::vector<LongType>{khw, khw, 1, 1, 0, 0, 1, 1, 1, 0, n});
+    return ctx;
+  };
+
+  ops::avgpool2d avgpool2d;
+  DeclarableBenchmark benchmark1(avgpool2d, "avgpool");
+  helper.runOperationSuit(&benchmark1, generator, batch, "Average Pool 2d");
+
+  ops::maxpool2d maxpool2d;
+  DeclarableBenchmark benchmark2(maxpool2d, "maxpool");
+  helper.runOperationSuit(&benchmark2, generator, batch, "Max Pool 2d");
+}
+
+template <typename T>
+static void lstmBenchmark(BenchmarkHelper &helper) {
+  BoolParameters format("format");  // 0=TNS=[seqLen,mb,size]; 1=NST=[mb,size,seqLen]
+  PredefinedParameters mb("mb", {1, 8});
+  const int n = 128;
+  const int seqLength = 8;
+
+  ParametersBatch batch({&format, &mb});
+  ops::lstmBlock lstmBlock;
+  DeclarableBenchmark benchmark(lstmBlock, "lstm");
+
+  auto generator = PARAMETRIC_D() {
+    auto ctx = new graph::Context(1);
+    int f = p.getIntParam("format");
+    int m = p.getIntParam("mb");
+
+    ctx->setInputArray(0, NDArrayFactory::create_<LongType>(0), true);  // max TS length (unused)
+
+    const char order = f == 0 ? 'c' : 'f';
+    std::vector<LongType> shape = f == 0 ? std::vector<LongType>{seqLength, m, n} : std::vector<LongType>{m, n, seqLength};
+
+    ctx->setInputArray(1, benchmarkArray<T>(order, shape), true);  // x
+
+    // i, c, f, o, z, h, y
+    for (int e = 0; e < 7; e++) ctx->setOutputArray(e, benchmarkArray<T>(order, shape), true);
+
+    ctx->setInputArray(2, benchmarkArray<T>('c', {m, n}), true);          // cLast
+    ctx->setInputArray(3, benchmarkArray<T>('c', {m, n}), true);          // yLast
+    ctx->setInputArray(4, benchmarkArray<T>('c', {2 * n, 4 * n}), true);  // W
+    ctx->setInputArray(5, benchmarkArray<T>('c', {n}), true);             // Wci
+    ctx->setInputArray(6, benchmarkArray<T>('c', {n}), true);             // Wcf
+    ctx->setInputArray(7, benchmarkArray<T>('c', {n}), true);             // Wco
+    ctx->setInputArray(8, benchmarkArray<T>('c', {4 * n}), true);         // b
+
+    ctx->setIArguments(std::vector<LongType>{0, f});   // no peephole, data format
+    ctx->setTArguments(std::vector<double>{1.0, 0.0});  // forget bias, cell clipping
+    return ctx;
+  };
+
+  helper.runOperationSuit(&benchmark, generator, batch, "LSTMBlock");
+}
+
+static void broadcast2d(BenchmarkHelper &helper) {
+  const int rows = 65536;
+  IntPowerParameters cols("cols", 2, 2, 12, 4);  // 2^2, 2^6, 2^10
+  BoolParameters axis("axis");
+  BoolParameters inplace("inplace");
+
+  ParametersBatch batch({&cols, &axis, &inplace});
+
+  auto generator = PARAMETRIC_D() {
+    auto a = p.getIntParam("axis");
+    auto c = p.getIntParam("cols");
+    auto arr = benchmarkArray<float>('c', {rows, c});
+
+    auto ctx = new graph::Context(1);
+    ctx->setInputArray(0, arr, true);
+    ctx->setInputArray(1, a == 0 ? benchmarkArray<float>('c', {rows, 1}) : benchmarkArray<float>('c', {1, c}), true);
+
+    if (p.getIntParam("inplace") == 1) {
+      ctx->setOutputArray(0, arr);
+      ctx->markInplace(true);
+    } else {
+      ctx->setOutputArray(0, benchmarkArray<float>('c', {rows, c}), true);
+    }
+
+    return ctx;
+  };
+
+  ops::add op;
+  DeclarableBenchmark benchmark(op, "add");
+  helper.runOperationSuit(&benchmark, generator, batch, "Broadcast (Custom) Add - 2d");
+}
+
+static void mismatchedOrderAssign(BenchmarkHelper &helper) {
+  IntPowerParameters rows("rows", 2, 8, 20, 4);  // 2^8, 2^12, 2^16, 2^20
+  BoolParameters cf("cf");
+
+  ParametersBatch batch({&rows, &cf});
+
+  auto generator = PARAMETRIC_XZ() {
+    const int numElements = 4194304;  // 2^22
+    int rows = p.getIntParam("rows");
+    int cols = numElements / rows;
+    bool c = p.getIntParam("cf");
+
+    x.push_back(benchmarkArray<float>(c ? 'c' : 'f', {rows, cols}));
+    z.push_back(benchmarkArray<float>(c ? 'f' : 'c', {rows, cols}));
+  };
+
+  TransformBenchmark tb(transform::AnyOps::Assign, "assign");
+  helper.runOperationSuit(&tb, generator, batch, "C->F and F->C Assign F32");
+
+  // NCHW to NHWC and back
+  BoolParameters nchw("nchw");
+  const int mb = 8;
+  const int hw = 64;
+  const int c = 3;
+  ParametersBatch batch2({&nchw});
+
+  auto generator2 = PARAMETRIC_XZ() {
+    if (p.getIntParam("nchw")) {
+      auto orig = benchmarkArray<float>('c', {mb, c, hw, hw});
+      orig->permutei({0, 2, 3, 1}, false, false);
+      x.push_back(orig);
+      z.push_back(benchmarkArray<float>('c', {mb, hw, hw, c}));
+    } else {
+      auto orig = benchmarkArray<float>('c', {mb, hw, hw, c});
+      orig->permutei({0, 3, 1, 2}, false, false);
+      x.push_back(orig);
+      z.push_back(benchmarkArray<float>('c', {mb, c, hw, hw}));
+    }
+  };
+
+  TransformBenchmark tb2(transform::AnyOps::Assign, "assign_nchw");
+  helper.runOperationSuit(&tb2, generator2, batch2, "nchw->nhwc and nhwc->nchw Assign FP32");
+}
+
+void LightBenchmarkSuit::runSuit(BenchmarkHelper &helper) {
+  std::vector<DataType> dtypes({DataType::FLOAT32, DataType::HALF});
+
+  for (auto t : dtypes) {
+    sd_printf("Running LightBenchmarkSuite.transformBenchmark [%s]\n", DataTypeUtils::asString(t).c_str());
+    BUILD_SINGLE_SELECTOR(t, transformBenchmark, (helper), SD_FLOAT_TYPES);
+
+    sd_printf("Running LightBenchmarkSuite.scalarBenchmark [%s]\n", DataTypeUtils::asString(t).c_str());
+    BUILD_SINGLE_SELECTOR(t, scalarBenchmark, (helper), SD_FLOAT_TYPES);
+
+    sd_printf("Running LightBenchmarkSuite.pairwiseBenchmark [%s]\n", DataTypeUtils::asString(t).c_str());
+    BUILD_SINGLE_SELECTOR(t, pairwiseBenchmark, (helper), SD_FLOAT_TYPES);
+
+    sd_printf("Running LightBenchmarkSuite.reduceFullBenchmark [%s]\n", DataTypeUtils::asString(t).c_str());
+    BUILD_SINGLE_SELECTOR(t, reduceFullBenchmark, (helper), SD_FLOAT_TYPES);
+
+    sd_printf("Running LightBenchmarkSuite.reduceDimBenchmark [%s]\n", DataTypeUtils::asString(t).c_str());
+    BUILD_SINGLE_SELECTOR(t, reduceDimBenchmark, (helper), SD_FLOAT_TYPES);
+
+    sd_printf("Running LightBenchmarkSuite.gemmBenchmark [%s]\n", DataTypeUtils::asString(t).c_str());
+    BUILD_SINGLE_SELECTOR(t, gemmBenchmark, (helper), SD_FLOAT_TYPES);
+
+    sd_printf("Running LightBenchmarkSuite.conv2d [%s]\n", DataTypeUtils::asString(t).c_str());
+    BUILD_SINGLE_SELECTOR(t, conv2d, (helper), SD_FLOAT_TYPES);
+
+    sd_printf("Running LightBenchmarkSuite.pool2d [%s]\n", DataTypeUtils::asString(t).c_str());
+    BUILD_SINGLE_SELECTOR(t, pool2d, (helper), SD_FLOAT_TYPES);
+
+    sd_printf("Running LightBenchmarkSuite.lstmBenchmark [%s]\n", DataTypeUtils::asString(t).c_str());
+    BUILD_SINGLE_SELECTOR(t, lstmBenchmark, (helper), SD_FLOAT_TYPES);
+  }
+
+  sd_printf("Running LightBenchmarkSuite.broadcast2d\n", "");
+  broadcast2d(helper);
+  sd_printf("Running LightBenchmarkSuite.mismatchedOrderAssign\n", "");
+  mismatchedOrderAssign(helper);
+}
+}  // namespace sd
@@ -22,15 +22,14 @@
 
 #ifndef LIBND4J_LIGHTBENCHMARKSUIT_H
 #define LIBND4J_LIGHTBENCHMARKSUIT_H
-
-#include <performance/benchmarking/BenchmarkSuit.h>
+#include "BenchmarkSuit.h"
 
 namespace sd {
-    class LightBenchmarkSuit : public BenchmarkSuit {
-    public:
-        std::string runSuit() override;
-    };
-}
-
+class LightBenchmarkSuit : public BenchmarkSuit {
+ public:
+  std::string name() const override { return "light"; }
+  void runSuit(BenchmarkHelper &helper) override;
+};
+}  // namespace sd
 
-#endif //DEV_TESTS_LIGHTBENCHMARKSUIT_H
+#endif  // LIBND4J_LIGHTBENCHMARKSUIT_H
@@ -25,6 +25,7 @@
 #define DEV_TESTS_DATABUFFER_H
 
 #include <array/DataType.h>
+#include <array/PointerWrapper.h>
 #include <execution/LaunchContext.h>
 #include <memory/Workspace.h>
 #include <system/common.h>
@@ -41,6 +42,9 @@ class SD_LIB_EXPORT DataBuffer {
   LongType _lenInBytes = 0;
   memory::Workspace *_workspace = nullptr;
 
+  // keeps external memory (i.e. file mapping) primary buffer points into alive
+  std::shared_ptr<PointerWrapper> _primaryHolder;
+
   std::atomic<int> _deviceId;
   std::mutex _deleteMutex;
 #ifndef __JAVACPP_HACK__
@@ -103,6 +107,13 @@ class SD_LIB_EXPORT DataBuffer {
   DataBuffer(const sd::LongType lenInBytes, const DataType dataType, memory::Workspace *workspace = nullptr,
              const bool allocBoth = false);
 
+  /**
+   * Primary buffer points into memory owned by holder (i.e. file mapping), at given offset. Nothing is copied,
+   * holder is released together with this buffer
+   */
+  DataBuffer(const std::shared_ptr<PointerWrapper> &holder, const LongType offsetInBytes, const size_t lenInBytes,
+             const DataType dataType);
+
   DataBuffer(const DataBuffer &other);
   DataBuffer(DataBuffer &&other);
   explicit DataBuffer();
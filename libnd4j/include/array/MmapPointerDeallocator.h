@@ -0,0 +1,59 @@
+/*
+ *  ******************************************************************************
+ *  *
+ *  *
+ *  * This program and the accompanying materials are made available under the
+ *  * terms of the Apache License, Version 2.0 which is available at
+ *  * https://www.apache.org/licenses/LICENSE-2.0.
+ *  *
+ *  * See the NOTICE file distributed with this work for additional
+ *  * information regarding copyright ownership.
+ *  * Unless required by applicable law or agreed to in writing, software
+ *  * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ *  * License for the specific language governing permissions and limitations
+ *  * under the License.
+ *  *
+ *  * SPDX-License-Identifier: Apache-2.0
+ *  *****************************************************************************
+ */
+
+//
+//  Read-only file mappings backing DataBuffers
+//
+
+#ifndef SD_MMAPPOINTERDEALLOCATOR_H_
+#define SD_MMAPPOINTERDEALLOCATOR_H_
+
+#include <array/PointerDeallocator.h>
+#include <array/PointerWrapper.h>
+
+#include <memory>
+
+namespace sd {
+
+/**
+ * Unmaps file mapping once PointerWrapper holding it is released
+ */
+class SD_LIB_EXPORT MmapPointerDeallocator : public PointerDeallocator {
+ private:
+  LongType _length;
+
+ public:
+  explicit MmapPointerDeallocator(LongType length);
+  ~MmapPointerDeallocator() override = default;
+
+  void release(void *ptr) override;
+
+  /**
+   * Maps whole file into memory, read-only: pages come straight from page cache, and any write into them faults.
+   * @param fileName file to map
+   * @param length receives file length in bytes
+   * @return wrapper for the start of the mapping, it unmaps the file once destroyed
+   */
+  static std::shared_ptr<PointerWrapper> mapFile(const char *fileName, LongType &length);
+};
+
+}  // namespace sd
+
+#endif  // SD_MMAPPOINTERDEALLOCATOR_H_
@@ -28,6 +28,7 @@
 #include <array/NDArray.h>
 
 #include <initializer_list>
+#include <map>
 #include <vector>
 #include <execution/LaunchContext.h>
 
@@ -121,6 +122,24 @@ class SD_LIB_EXPORT NDArrayFactory {
    */
   static NDArray fromNpyFile(const char *fileName);
 
+  /**
+   * This method maps .npy file into memory instead of reading it: returned array points straight into the mapping,
+   * which is released together with array's DataBuffer. Mapping is read-only, so array must not be written to
+   * @param fileName
+   * @return
+   */
+  static NDArray *mmapNpyFile(const char *fileName, LaunchContext *context = LaunchContext ::defaultContext());
+
+  /**
+   * This method maps .npz archive into memory, and returns arrays pointing into it, keyed by member name.
+   * Members must be stored without compression; members which data isn't aligned to element size are copied.
+   * Arrays pointing into the mapping are read-only, as for mmapNpyFile
+   * @param fileName
+   * @return
+   */
+  static std::map<std::string, NDArray *> mmapNpzFile(const char *fileName,
+                                                      LaunchContext *context = LaunchContext ::defaultContext());
+
   /**
    * This factory create array from utf8 string
    * @return NDArray default dataType UTF8
@@ -41,6 +41,7 @@ void DataBuffer::expand(const uint64_t size) {
     }
 
     _primaryBuffer = newBuffer;
+    _primaryHolder.reset();
     _lenInBytes = size;
     _isOwnerPrimary = true;
   }
@@ -51,6 +51,7 @@ void DataBuffer::expand(const uint64_t size) {
       }
 
       _primaryBuffer = newBuffer;
+      _primaryHolder.reset();
       _isOwnerPrimary = true;
     }
 
@@ -152,6 +152,13 @@ DataBuffer::DataBuffer(void* primary, const size_t lenInBytes, const DataType da
 #endif
 }
 
+////////////////////////////////////////////////////////////////////////
+DataBuffer::DataBuffer(const std::shared_ptr<PointerWrapper>& holder, const LongType offsetInBytes,
+                       const size_t lenInBytes, const DataType dataType)
+    : DataBuffer(holder->pointerAsT<int8_t>() + offsetInBytes, nullptr, lenInBytes, dataType, false, false, nullptr) {
+  _primaryHolder = holder;
+}
+
 ////////////////////////////////////////////////////////////////////////
 // copies data from hostBuffer to own memory buffer
 DataBuffer::DataBuffer(const void* hostBuffer, const DataType dataType, const size_t lenInBytes,
@@ -249,6 +256,7 @@ DataBuffer::DataBuffer(DataBuffer&& other) {
   _workspace = other._workspace;
   _isOwnerPrimary = other._isOwnerPrimary;
   _isOwnerSpecial = other._isOwnerSpecial;
+  _primaryHolder = std::move(other._primaryHolder);
   _deviceId.store(other._deviceId);
 
   copyCounters(other);
@@ -321,6 +329,7 @@ DataBuffer& DataBuffer::operator=(DataBuffer&& other) noexcept {
   _workspace = other._workspace;
   _isOwnerPrimary = false;
   _isOwnerSpecial = false;
+  _primaryHolder = std::move(other._primaryHolder);
 
   copyCounters(other);
 
@@ -458,6 +467,7 @@ void DataBuffer::deleteBuffers() {
   std::lock_guard<std::mutex> lock(_deleteMutex);
   deletePrimary();
   deleteSpecial();
+  _primaryHolder.reset();
   closed = true;
   _lenInBytes = 0;
 }
@@ -478,6 +488,7 @@ void DataBuffer::setPrimaryBuffer(void* buffer, size_t length) {
   }
 #endif
   _primaryBuffer = buffer;
+  _primaryHolder.reset();
   _isOwnerPrimary = false;
   _lenInBytes = length * DataTypeUtils::sizeOf(_dataType);
 }
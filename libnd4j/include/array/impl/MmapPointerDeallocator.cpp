@@ -0,0 +1,97 @@
+/*
+ *  ******************************************************************************
+ *  *
+ *  *
+ *  * This program and the accompanying materials are made available under the
+ *  * terms of the Apache License, Version 2.0 which is available at
+ *  * https://www.apache.org/licenses/LICENSE-2.0.
+ *  *
+ *  * See the NOTICE file distributed with this work for additional
+ *  * information regarding copyright ownership.
+ *  * Unless required by applicable law or agreed to in writing, software
+ *  * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ *  * License for the specific language governing permissions and limitations
+ *  * under the License.
+ *  *
+ *  * SPDX-License-Identifier: Apache-2.0
+ *  *****************************************************************************
+ */
+
+//
+//  Read-only file mappings backing DataBuffers
+//
+#include <array/MmapPointerDeallocator.h>
+#include <system/op_boilerplate.h>
+
+#include <string>
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace sd {
+
+MmapPointerDeallocator::MmapPointerDeallocator(LongType length) : _length(length) {
+  //
+}
+
+void MmapPointerDeallocator::release(void *ptr) {
+  if (ptr == nullptr) return;
+
+#if defined(_WIN32) || defined(_WIN64)
+  UnmapViewOfFile(ptr);
+#else
+  munmap(ptr, static_cast<size_t>(_length));
+#endif
+}
+
+std::shared_ptr<PointerWrapper> MmapPointerDeallocator::mapFile(const char *fileName, LongType &length) {
+  void *ptr = nullptr;
+
+#if defined(_WIN32) || defined(_WIN64)
+  HANDLE file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                            nullptr);
+  if (file == INVALID_HANDLE_VALUE) THROW_EXCEPTION((std::string("Failed to open file for mmap: ") + fileName).c_str());
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+    CloseHandle(file);
+    THROW_EXCEPTION((std::string("Can't mmap empty file: ") + fileName).c_str());
+  }
+  length = static_cast<LongType>(size.QuadPart);
+
+  // the view keeps mapping object alive, so both handles can be closed right away
+  HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(file);
+  if (mapping == nullptr) THROW_EXCEPTION((std::string("Failed to mmap file: ") + fileName).c_str());
+
+  ptr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  CloseHandle(mapping);
+  if (ptr == nullptr) THROW_EXCEPTION((std::string("Failed to mmap file: ") + fileName).c_str());
+#else
+  int fd = open(fileName, O_RDONLY);
+  if (fd < 0) THROW_EXCEPTION((std::string("Failed to open file for mmap: ") + fileName).c_str());
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+    close(fd);
+    THROW_EXCEPTION((std::string("Can't mmap empty file: ") + fileName).c_str());
+  }
+  length = static_cast<LongType>(st.st_size);
+
+  // mapping stays valid after descriptor is closed
+  ptr = mmap(nullptr, static_cast<size_t>(length), PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (ptr == MAP_FAILED) THROW_EXCEPTION((std::string("Failed to mmap file: ") + fileName).c_str());
+#endif
+
+  return std::make_shared<PointerWrapper>(ptr, std::make_shared<MmapPointerDeallocator>(length));
+}
+
+}  // namespace sd
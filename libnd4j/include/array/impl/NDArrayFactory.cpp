@@ -22,6 +22,7 @@
 // Created by GS <sgazeos@gmail.com> on 2018-12-20.
 // @author Oleg Semeniv <oleg.semeniv@gmail.com>
 //
+#include <array/MmapPointerDeallocator.h>
 #include <array/NDArrayFactory.h>
 #include <exceptions/cuda_exception.h>
 #include <graph/GraphExecutioner.h>
@@ -30,6 +31,7 @@
 #include <helpers/LoopsCoordsHelper.h>
 #include <helpers/ShapeUtils.h>
 #include <helpers/StringUtils.h>
+#include <helpers/ShapeBuilders.h>
 #include <legacy/NativeOps.h>
 
 #include <type_traits>
@@ -682,4 +684,218 @@ NDArray NDArrayFactory::fromNpyFile(const char* fileName) {
 
   return NDArray(buffer, shape, LaunchContext::defaultContext(), true, 0);
 }
+
+////////////////////////////////////////////////////////////////////////
+// zero-copy .npy/.npz loading
+
+template <typename T>
+static T readLittleEndian(const int8_t* ptr) {
+  T result;
+  memcpy(&result, ptr, sizeof(T));
+  return result;
+}
+
+static DataType npyDataType(char kind, int size) {
+  switch (kind) {
+    case 'b':
+      return size == 1 ? BOOL : UNKNOWN;
+    case 'i':
+      return size == 1 ? INT8 : size == 2 ? INT16 : size == 4 ? INT32 : size == 8 ? INT64 : UNKNOWN;
+    case 'u':
+      return size == 1 ? UINT8 : size == 2 ? UINT16 : size == 4 ? UINT32 : size == 8 ? UINT64 : UNKNOWN;
+    case 'f':
+      return size == 2 ? HALF : size == 4 ? FLOAT32 : size == 8 ? DOUBLE : UNKNOWN;
+    default:
+      return UNKNOWN;
+  }
+}
+
+// returns position right after ':' that follows given key of header dictionary
+static size_t npyHeaderValue(const std::string& header, const char* key) {
+  auto pos = header.find(key);
+  if (pos == std::string::npos) THROW_EXCEPTION((std::string("NPY header doesn't have ") + key + " field").c_str());
+
+  pos = header.find(':', pos);
+  if (pos == std::string::npos) THROW_EXCEPTION("Malformed NPY header");
+
+  return pos + 1;
+}
+
+/**
+ * Builds array for .npy stream stored at data[0, length) of the mapping, which starts at given offset
+ */
+static NDArray* npyFromMapping(const std::shared_ptr<PointerWrapper>& mapping, LongType offset, LongType length,
+                               LaunchContext* context) {
+  auto data = mapping->pointerAsT<int8_t>() + offset;
+
+  const char magic[] = {(char)0x93, 'N', 'U', 'M', 'P', 'Y'};
+  if (length < 10 || memcmp(data, magic, sizeof(magic)) != 0) THROW_EXCEPTION("Data doesn't look like NPY file");
+
+  // version 1.0 uses 2 bytes for header length, later versions use 4
+  const auto major = data[6];
+  LongType headerStart = major == 1 ? 10 : 12;
+  if (length < headerStart) THROW_EXCEPTION("NPY file is truncated");
+  LongType headerLength = major == 1 ? readLittleEndian<uint16_t>(data + 8) : readLittleEndian<uint32_t>(data + 8);
+  if (headerStart + headerLength > length) THROW_EXCEPTION("NPY file is truncated");
+
+  std::string header(reinterpret_cast<const char*>(data) + headerStart, headerLength);
+
+  // 'descr': '<f4'
+  auto pos = header.find('\'', npyHeaderValue(header, "'descr'"));
+  if (pos == std::string::npos || pos + 3 >= header.size()) THROW_EXCEPTION("Malformed NPY header");
+  const char byteOrder = header[pos + 1];
+  const char kind = header[pos + 2];
+  const int size = atoi(header.c_str() + pos + 3);
+  auto dtype = npyDataType(kind, size);
+  if (dtype == UNKNOWN) THROW_EXCEPTION(("Unsupported NPY data type: " + header.substr(pos, 5)).c_str());
+  if (byteOrder == '>' && size > 1) THROW_EXCEPTION("Big endian NPY files aren't supported");
+
+  // 'fortran_order': False
+  pos = header.find_first_not_of(' ', npyHeaderValue(header, "'fortran_order'"));
+  const char order = header.compare(pos, 4, "True") == 0 ? 'f' : 'c';
+
+  // 'shape': (3, 4), empty tuple means scalar
+  pos = header.find('(', npyHeaderValue(header, "'shape'"));
+  auto end = header.find(')', pos);
+  if (pos == std::string::npos || end == std::string::npos) THROW_EXCEPTION("Malformed NPY header");
+
+  std::vector<LongType> shape;
+  bool empty = false;
+  for (auto cursor = header.c_str() + pos + 1; cursor < header.c_str() + end;) {
+    char* next = nullptr;
+    auto dim = strtoll(cursor, &next, 10);
+    if (next == cursor) {
+      cursor++;
+      continue;
+    }
+    shape.push_back(dim);
+    empty |= dim == 0;
+    cursor = next;
+  }
+
+  LongType numElements = 1;
+  for (auto dim : shape) numElements *= dim;
+  const LongType dataOffset = headerStart + headerLength;
+  const LongType lenInBytes = numElements * size;
+  if (dataOffset + lenInBytes > length) THROW_EXCEPTION("NPY file is truncated");
+
+  LongType* shapeInfo = nullptr;
+  if (empty)
+    shapeInfo = ShapeBuilders::emptyShapeInfo(dtype, order, shape);
+  else if (shape.empty())
+    shapeInfo = ShapeBuilders::createScalarShapeInfo(dtype);
+  else
+    shapeInfo = ShapeBuilders::createShapeInfo(dtype, order, shape);
+
+  DataBuffer* buffer = nullptr;
+  if (reinterpret_cast<uintptr_t>(data + dataOffset) % size == 0 || lenInBytes == 0)
+    buffer = new DataBuffer(mapping, offset + dataOffset, lenInBytes, dtype);
+  else  // misaligned data (only possible within .npz) can't be used in place
+    buffer = new DataBuffer(data + dataOffset, dtype, lenInBytes);
+
+  auto result = new NDArray(buffer, shapeInfo, context, 0);
+  delete[] shapeInfo;
+
+  return result;
+}
+
+NDArray* NDArrayFactory::mmapNpyFile(const char* fileName, LaunchContext* context) {
+  LongType length = 0;
+  auto mapping = MmapPointerDeallocator::mapFile(fileName, length);
+
+  return npyFromMapping(mapping, 0, length, context);
+}
+
+std::map<std::string, NDArray*> NDArrayFactory::mmapNpzFile(const char* fileName, LaunchContext* context) {
+  LongType length = 0;
+  auto mapping = MmapPointerDeallocator::mapFile(fileName, length);
+  auto data = mapping->pointerAsT<int8_t>();
+
+  // end of central directory record is at the very end, followed by comment of up to 64K
+  const LongType eocdSize = 22;
+  LongType eocd = -1;
+  for (LongType e = length - eocdSize; e >= 0 && e >= length - eocdSize - 65535; e--)
+    if (readLittleEndian<uint32_t>(data + e) == 0x06054b50) {
+      eocd = e;
+      break;
+    }
+
+  if (eocd < 0) THROW_EXCEPTION((std::string("File doesn't look like NPZ archive: ") + fileName).c_str());
+
+  LongType numEntries = readLittleEndian<uint16_t>(data + eocd + 10);
+  LongType directory = readLittleEndian<uint32_t>(data + eocd + 16);
+
+  // zip64 archives keep real values in zip64 end of central directory record, located right before regular one
+  if ((numEntries == 0xFFFF || directory == 0xFFFFFFFFLL) && eocd >= 20 &&
+      readLittleEndian<uint32_t>(data + eocd - 20) == 0x07064b50) {
+    auto eocd64 = static_cast<LongType>(readLittleEndian<uint64_t>(data + eocd - 20 + 8));
+    if (eocd64 + 56 > length || readLittleEndian<uint32_t>(data + eocd64) != 0x06064b50)
+      THROW_EXCEPTION("Malformed zip64 NPZ archive");
+
+    numEntries = static_cast<LongType>(readLittleEndian<uint64_t>(data + eocd64 + 32));
+    directory = static_cast<LongType>(readLittleEndian<uint64_t>(data + eocd64 + 48));
+  }
+
+  std::map<std::string, NDArray*> result;
+  auto cursor = directory;
+  try {
+    for (LongType e = 0; e < numEntries; e++) {
+      if (cursor + 46 > length || readLittleEndian<uint32_t>(data + cursor) != 0x02014b50)
+        THROW_EXCEPTION("Malformed NPZ central directory");
+
+      auto method = readLittleEndian<uint16_t>(data + cursor + 10);
+      LongType compressedSize = readLittleEndian<uint32_t>(data + cursor + 20);
+      LongType uncompressedSize = readLittleEndian<uint32_t>(data + cursor + 24);
+      auto nameLength = readLittleEndian<uint16_t>(data + cursor + 28);
+      auto extraLength = readLittleEndian<uint16_t>(data + cursor + 30);
+      auto commentLength = readLittleEndian<uint16_t>(data + cursor + 32);
+      LongType localHeader = readLittleEndian<uint32_t>(data + cursor + 42);
+
+      std::string name(reinterpret_cast<const char*>(data) + cursor + 46, nameLength);
+
+      // zip64 extra field holds 64 bit values for fields saturated above, in this order
+      for (auto extra = cursor + 46 + nameLength; extra + 4 <= cursor + 46 + nameLength + extraLength;) {
+        auto id = readLittleEndian<uint16_t>(data + extra);
+        auto size = readLittleEndian<uint16_t>(data + extra + 2);
+        if (id == 0x0001) {
+          auto value = data + extra + 4;
+          if (uncompressedSize == 0xFFFFFFFFLL) {
+            uncompressedSize = static_cast<LongType>(readLittleEndian<uint64_t>(value));
+            value += 8;
+          }
+          if (compressedSize == 0xFFFFFFFFLL) {
+            compressedSize = static_cast<LongType>(readLittleEndian<uint64_t>(value));
+            value += 8;
+          }
+          if (localHeader == 0xFFFFFFFFLL) localHeader = static_cast<LongType>(readLittleEndian<uint64_t>(value));
+        }
+        extra += 4 + size;
+      }
+
+      cursor += 46 + nameLength + extraLength + commentLength;
+
+      if (method != 0 || compressedSize != uncompressedSize)
+        THROW_EXCEPTION(("NPZ member [" + name + "] is compressed, it can't be memory mapped").c_str());
+
+      if (localHeader + 30 > length || readLittleEndian<uint32_t>(data + localHeader) != 0x04034b50)
+        THROW_EXCEPTION("Malformed NPZ local header");
+
+      auto start = localHeader + 30 + readLittleEndian<uint16_t>(data + localHeader + 26) +
+                   readLittleEndian<uint16_t>(data + localHeader + 28);
+      if (start + uncompressedSize > length) THROW_EXCEPTION("NPZ archive is truncated");
+
+      if (name.size() > 4 && name.compare(name.size() - 4, 4, ".npy") == 0) name.resize(name.size() - 4);
+
+      result[name] = npyFromMapping(mapping, start, uncompressedSize, context);
+    }
+  } catch (...) {
+    for (auto& v : result) {
+      delete v.second->dataBuffer();
+      delete v.second;
+    }
+    throw;
+  }
+
+  return result;
+}
 }  // namespace sd
@@ -0,0 +1,90 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// NUMA topology discovery
+//
+
+#ifndef SAMEDIFF_NUMATOPOLOGY_H
+#define SAMEDIFF_NUMATOPOLOGY_H
+
+#include <system/common.h>
+
+#include <string>
+#include <vector>
+
+namespace samediff {
+/**
+ * This class describes NUMA nodes of the host and CPUs belonging to each of them.
+ * On Linux topology is read from /sys/devices/system/node, everywhere else (or if sysfs isn't available)
+ * the host is treated as a single node holding all CPUs.
+ */
+class SD_LIB_EXPORT NumaTopology {
+ private:
+  std::vector<std::vector<int>> _nodeCpus;
+  std::vector<int> _cpuNodes;
+
+  NumaTopology();
+  ~NumaTopology() = default;
+
+ public:
+  static NumaTopology& getInstance();
+
+  /**
+   * This method parses sysfs cpulist format, i.e. "0-3,8,10-11"
+   */
+  static std::vector<int> parseCpuList(const std::string& list);
+
+  int numberOfNodes();
+
+  /**
+   * This method returns list of CPUs belonging to the given node
+   */
+  const std::vector<int>& cpusOfNode(int node);
+
+  /**
+   * This method returns node of the given CPU, or 0 if CPU is unknown
+   */
+  int nodeOfCpu(int cpu);
+
+  /**
+   * This method returns node the calling thread is executed on at the moment
+   */
+  int currentNode();
+
+  /**
+   * This method pins calling thread to CPUs of the given node
+   */
+  bool bindThreadToNode(int node);
+
+  /**
+   * This method asks OS to place pages of the given range on the given node. Pages that were already touched
+   * get migrated. Range must start at page boundary and span whole pages, so no memory outside of it is affected,
+   * otherwise nothing is done. It's a hint: returns false if it can't be applied, and memory stays usable anyway
+   */
+  bool bindMemoryToNode(void* ptr, size_t numBytes, int node);
+
+  /**
+   * This method allocates page aligned buffer of at least numBytes, and binds its pages to the given node if
+   * possible. Buffer is released with free()
+   */
+  void* allocateOnNode(size_t numBytes, int node);
+};
+}  // namespace samediff
+
+#endif  // SAMEDIFF_NUMATOPOLOGY_H
@@ -42,6 +42,10 @@ class SD_LIB_EXPORT ThreadPool {
   std::vector<BlockingQueue<CallableWithArguments*>*> _queues;
   std::vector<CallableInterface*> _interfaces;
 
+  // NUMA node of each worker, and number of workers per node. Single group if NUMA awareness is off
+  std::vector<int> _workerNodes;
+  std::vector<int> _nodeWorkers;
+
   std::mutex _lock;
   std::atomic<int> _available;
   std::queue<Ticket*> _tickets;
@@ -57,9 +61,17 @@ class SD_LIB_EXPORT ThreadPool {
    * This method returns list of pointers to threads ONLY if num_threads of threads were available upon request,
    * returning empty list otherwise
    * @param num_threads
+   * @param node - if non-negative, workers of this NUMA node are picked first
+   * @return
+   */
+  Ticket* tryAcquire(int num_threads, int node = -1);
+
+  /**
+   * This method returns number of workers pinned to the given NUMA node
+   * @param node
    * @return
    */
-  Ticket* tryAcquire(int num_threads);
+  int numberOfWorkers(int node);
 
   /**
    * This method marks specified number of threads as released, and available for use
@@ -114,6 +114,10 @@ class SD_LIB_EXPORT Threads {
   /**
    * This function executes 1 dimensional loop for a given number of threads
    * PLEASE NOTE: this function can use smaller number of threads than requested.
+   * PLEASE NOTE: in work-stealing mode (see Environment::setWorkStealing) function can be called more than once with
+   * the same thread_id, for different chunks of the loop and in no particular order. Per-thread results must be merged
+   * into their slot, not assigned, and mustn't depend on order of chunks. This applies to parallel_tad and to
+   * 2D/3D parallel_for as well.
    *
    * @param function
    * @param numThreads
@@ -138,6 +142,20 @@ class SD_LIB_EXPORT Threads {
   static int parallel_tad(FUNC_1D function, long long int start, long long int stop, long long int increment = 1,
                           long long int numThreads = sd::Environment::getInstance().maxMasterThreads());
 
+  /**
+   * This function splits [start, stop) into numBlocks contiguous blocks and calls function exactly once per block,
+   * passing index of the block instead of thread id. Use it instead of parallel_tad when results are stored per
+   * thread_id and merged in order afterwards: blocks don't depend on scheduling mode.
+   *
+   * @param function
+   * @param start
+   * @param stop
+   * @param numBlocks
+   * @return number of blocks, below numBlocks if range is shorter than that
+   */
+  static int parallel_blocks(FUNC_1D function, int64_t start, int64_t stop,
+                             int64_t numBlocks = sd::Environment::getInstance().maxMasterThreads());
+
   /**
    * This method will execute function splitting 2 nested loops space with multiple threads
    *
@@ -200,6 +218,20 @@ class SD_LIB_EXPORT Threads {
   static int parallel_aligned_increment(FUNC_1D function, int64_t start, int64_t stop, int64_t increment,
                                         size_t type_size = sizeof(float),
                                         uint32_t req_numThreads = sd::Environment::getInstance().maxMasterThreads());
+
+  /**
+   * This method caps number of threads used by any parallel loop started from the calling thread.
+   * Used to split cores between graph nodes executed concurrently. 0 removes the cap
+   *
+   * @param numThreads
+   */
+  static void setThreadBudget(int numThreads);
+
+  /**
+   * This method returns thread budget of the calling thread, 0 if there's none
+   * @return
+   */
+  static int threadBudget();
 };
 }  // namespace samediff
 
@@ -0,0 +1,121 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Work-stealing scheduler for samediff::Threads
+//
+
+#ifndef SAMEDIFF_WORKSTEALINGSCHEDULER_H
+#define SAMEDIFF_WORKSTEALINGSCHEDULER_H
+
+#include <system/common.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace samediff {
+/**
+ * This class executes chunked loops over a set of workers, each owning a deque of tasks.
+ * Owner takes chunks one by one from the back of its deque, idle workers steal half of the oldest task
+ * from the front of other deques, so uneven chunks get balanced at runtime.
+ *
+ * Thread calling run() takes part in execution of its own job until it's done, so nested run() calls
+ * made from within a chunk don't block and don't serialize: they push work to the local deque, and idle workers
+ * steal it.
+ */
+class SD_LIB_EXPORT WorkStealingScheduler {
+ public:
+  // (thread id, chunk index)
+  typedef std::function<void(uint64_t, int64_t)> ChunkFunction;
+
+ private:
+  struct Job {
+    const ChunkFunction* _function = nullptr;
+
+    // chunks that aren't finished yet
+    std::atomic<int64_t> _pending{0};
+
+    // threads taking part in this job, index of the thread within this array is its thread id
+    int _maxThreads = 0;
+    std::unique_ptr<std::atomic<std::thread::id>[]> _participants;
+  };
+
+  // range of chunks [_first, _last) of a single job
+  struct Task {
+    Job* _job;
+    int64_t _first;
+    int64_t _last;
+  };
+
+  struct WorkerQueue {
+    std::mutex _lock;
+    std::deque<Task> _tasks;
+  };
+
+  std::vector<std::thread> _threads;
+  std::vector<std::unique_ptr<WorkerQueue>> _queues;
+
+  std::mutex _sleepLock;
+  std::condition_variable _condition;
+
+  // incremented on every push, so sleeping workers know there's something new to look at
+  std::atomic<uint64_t> _epoch{0};
+  std::atomic<uint64_t> _nextQueue{0};
+  std::atomic<bool> _stopped{false};
+
+  WorkStealingScheduler();
+  ~WorkStealingScheduler();
+
+  void workerLoop(int workerId);
+
+  void push(int queue, const Task& task);
+
+  // returns thread id of calling thread within the job, or -1 if job has no free seats left
+  static int claimThreadId(Job* job);
+
+  // takes single chunk from the back of own queue
+  bool popOwn(int workerId, Job* only, Task& result, int& threadId);
+
+  // takes chunks from the front of other queues: half of the task for workers, single chunk for external threads
+  bool steal(int thiefId, Job* only, Task& result, int& threadId);
+
+  // finds some work for the calling thread and executes it. If only != nullptr - only chunks of this job are picked
+  bool runOnce(int workerId, Job* only);
+
+ public:
+  static WorkStealingScheduler& getInstance();
+
+  /**
+   * This method executes function for each chunk within [0, numChunks), using up to numThreads threads,
+   * including the calling one. Function receives thread id, which is below numThreads and unique among chunks running
+   * concurrently within this call, and chunk index. The same thread id can be used for multiple chunks,
+   * one after another. This method returns once all chunks are done.
+   */
+  void run(int numThreads, int64_t numChunks, const ChunkFunction& function);
+
+  int numberOfWorkers();
+};
+}  // namespace samediff
+
+#endif  // SAMEDIFF_WORKSTEALINGSCHEDULER_H
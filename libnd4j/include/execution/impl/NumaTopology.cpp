@@ -0,0 +1,174 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// NUMA topology discovery
+//
+#include <execution/NumaTopology.h>
+#include <helpers/logger.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace samediff {
+
+#if defined(__linux__)
+// we don't want hard dependency on libnuma, so mbind goes through raw syscall
+static const int SD_MPOL_PREFERRED = 1;
+static const unsigned SD_MPOL_MF_MOVE = 1 << 1;
+#endif
+
+std::vector<int> NumaTopology::parseCpuList(const std::string &list) {
+  std::vector<int> result;
+  std::stringstream stream(list);
+  std::string token;
+
+  while (std::getline(stream, token, ',')) {
+    if (token.empty() || token[0] == '\n') continue;
+
+    try {
+      auto dash = token.find('-');
+      if (dash == std::string::npos) {
+        result.push_back(std::stoi(token));
+      } else {
+        auto first = std::stoi(token.substr(0, dash));
+        auto last = std::stoi(token.substr(dash + 1));
+        for (int e = first; e <= last; e++) result.push_back(e);
+      }
+    } catch (std::exception &e) {
+      // malformed token, skipping it
+    }
+  }
+
+  return result;
+}
+
+NumaTopology::NumaTopology() {
+#if defined(__linux__)
+  for (int node = 0;; node++) {
+    std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+    if (!file.is_open()) break;
+
+    std::string list;
+    std::getline(file, list);
+
+    auto cpus = parseCpuList(list);
+
+    // memory-only nodes have no CPUs, we don't schedule anything there
+    if (!cpus.empty()) _nodeCpus.emplace_back(cpus);
+  }
+#endif
+
+  if (_nodeCpus.empty()) {
+    auto numCpus = std::thread::hardware_concurrency();
+    std::vector<int> cpus;
+    for (unsigned int e = 0; e < (numCpus > 0 ? numCpus : 1); e++) cpus.push_back(e);
+
+    _nodeCpus.emplace_back(cpus);
+  }
+
+  for (size_t node = 0; node < _nodeCpus.size(); node++)
+    for (auto cpu : _nodeCpus[node]) {
+      if (cpu >= static_cast<int>(_cpuNodes.size())) _cpuNodes.resize(cpu + 1, 0);
+
+      _cpuNodes[cpu] = static_cast<int>(node);
+    }
+
+  sd_debug("NUMA topology: %i node(s) found\n", static_cast<int>(_nodeCpus.size()));
+}
+
+NumaTopology &NumaTopology::getInstance() {
+  static NumaTopology instance;
+  return instance;
+}
+
+int NumaTopology::numberOfNodes() { return static_cast<int>(_nodeCpus.size()); }
+
+const std::vector<int> &NumaTopology::cpusOfNode(int node) {
+  if (node < 0 || node >= numberOfNodes()) THROW_EXCEPTION("NumaTopology: node index is out of range");
+
+  return _nodeCpus[node];
+}
+
+int NumaTopology::nodeOfCpu(int cpu) {
+  if (cpu < 0 || cpu >= static_cast<int>(_cpuNodes.size())) return 0;
+
+  return _cpuNodes[cpu];
+}
+
+int NumaTopology::currentNode() {
+  if (numberOfNodes() < 2) return 0;
+
+#if defined(__linux__)
+  return nodeOfCpu(sched_getcpu());
+#else
+  return 0;
+#endif
+}
+
+bool NumaTopology::bindThreadToNode(int node) {
+#if defined(__linux__)
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  for (auto cpu : cpusOfNode(node)) CPU_SET(cpu, &cpuset);
+
+  return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset) == 0;
+#else
+  return false;
+#endif
+}
+
+bool NumaTopology::bindMemoryToNode(void *ptr, size_t numBytes, int node) {
+  if (ptr == nullptr || numBytes == 0 || numberOfNodes() < 2 || node < 0 || node >= 64) return false;
+
+#if defined(__linux__) && defined(SYS_mbind)
+  // mbind works on whole pages, partial pages would drag neighbouring allocations along
+  auto pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+  if ((reinterpret_cast<uintptr_t>(ptr) & (pageSize - 1)) != 0 || (numBytes & (pageSize - 1)) != 0) return false;
+
+  // kernel drops the last bit of maxnode, hence + 1
+  unsigned long mask = 1UL << node;
+  return syscall(SYS_mbind, ptr, numBytes, SD_MPOL_PREFERRED, &mask, sizeof(mask) * 8 + 1, SD_MPOL_MF_MOVE) == 0;
+#else
+  return false;
+#endif
+}
+
+void *NumaTopology::allocateOnNode(size_t numBytes, int node) {
+#if defined(__linux__)
+  auto pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  auto alignedBytes = (numBytes + pageSize - 1) / pageSize * pageSize;
+
+  auto ptr = aligned_alloc(pageSize, alignedBytes);
+  if (ptr != nullptr) bindMemoryToNode(ptr, alignedBytes, node);
+
+  return ptr;
+#else
+  return malloc(numBytes);
+#endif
+}
+}  // namespace samediff
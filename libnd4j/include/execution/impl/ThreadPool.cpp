@@ -19,6 +19,7 @@
 //
 // @author raver119@gmail.com
 //
+#include <execution/NumaTopology.h>
 #include <execution/ThreadPool.h>
 #include <helpers/logger.h>
 
@@ -59,7 +60,11 @@ static void executionLoop_(int thread_id, BlockingQueue<CallableWithArguments *>
   }
 }
 
-static void executionLoopWithInterface_(int thread_id, CallableInterface *c) {
+static void executionLoopWithInterface_(int thread_id, CallableInterface *c, int node) {
+  // workers of NUMA-aware pool stay within their node, so their caches and memory stay local
+  if (node >= 0 && !NumaTopology::getInstance().bindThreadToNode(node))
+    sd_debug("Failed to bind worker thread [%i] to NUMA node [%i]\n", thread_id, node);
+
   while (true) {
     // blocking here until there's something to do
     c->waitForTask();
@@ -70,33 +75,35 @@ static void executionLoopWithInterface_(int thread_id, CallableInterface *c) {
 }
 
 ThreadPool::ThreadPool() {
-  // TODO: number of threads must reflect number of cores for UMA system. In case of NUMA it should be per-device pool
   // FIXME: on mobile phones this feature must NOT be used
   _available = sd::Environment::getInstance().maxThreads();
 
   _queues.resize(_available.load());
   _threads.resize(_available.load());
   _interfaces.resize(_available.load());
+  _workerNodes.resize(_available.load(), 0);
+
+  // on NUMA hosts workers are split into per-node groups, proportionally to number of CPUs each node has
+  auto &topology = NumaTopology::getInstance();
+  auto numaAware = sd::Environment::getInstance().isNumaAware() && topology.numberOfNodes() > 1;
+  _nodeWorkers.resize(numaAware ? topology.numberOfNodes() : 1, 0);
+
+  std::vector<int> cpuNodes;
+  for (int node = 0; numaAware && node < topology.numberOfNodes(); node++)
+    cpuNodes.insert(cpuNodes.end(), topology.cpusOfNode(node).size(), node);
 
   // we're not creating threadpool on aurora
   // creating threads here
   for (int e = 0; e < _available.load(); e++) {
+    if (numaAware) _workerNodes[e] = cpuNodes[(static_cast<size_t>(e) * cpuNodes.size()) / _available.load()];
+
+    _nodeWorkers[_workerNodes[e]]++;
+
     _queues[e] = new BlockingQueue<CallableWithArguments *>(2);
     _interfaces[e] = new CallableInterface();
-    _threads[e] = std::thread(executionLoopWithInterface_, e, _interfaces[e]);
+    _threads[e] = std::thread(executionLoopWithInterface_, e, _interfaces[e], numaAware ? _workerNodes[e] : -1);
     _tickets.push(new Ticket());
     // _threads[e] = new std::thread(executionLoop_, e, _queues[e]);
-
-    // TODO: add other platforms here as well
-    // now we must set affinity, and it's going to be platform-specific thing
-#ifdef LINUX_BUILD
-    cpu_set_t cpuset;
-    CPU_ZERO(&cpuset);
-    CPU_SET(e, &cpuset);
-    int rc = pthread_setaffinity_np(_threads[e]->native_handle(), sizeof(cpu_set_t), &cpuset);
-    if (rc != 0) THROW_EXCEPTION("Failed to set pthread affinity");
-#endif
-
   }
   //add an extra ticket to minimize the risk of running out of tickets due to race conditions
   _tickets.push(new Ticket());
@@ -127,7 +134,15 @@ ThreadPool &ThreadPool::getInstance() {
 
 void ThreadPool::release(int numThreads) { _available += numThreads; }
 
-Ticket *ThreadPool::tryAcquire(int numThreads) {
+int ThreadPool::numberOfWorkers(int node) {
+  if (node < 0) return static_cast<int>(_interfaces.size());
+
+  if (node >= static_cast<int>(_nodeWorkers.size())) return 0;
+
+  return _nodeWorkers[node];
+}
+
+Ticket *ThreadPool::tryAcquire(int numThreads, int node) {
   if (numThreads <= 0) return nullptr;
   Ticket *t = nullptr;
   // we check for threads availability first
@@ -148,8 +163,18 @@ Ticket *ThreadPool::tryAcquire(int numThreads) {
       // ticket must contain information about number of threads for the current session
       t->acquiredThreads(numThreads);
 
-      // filling ticket with executable interfaces
-      for (size_t e = 0, i = 0; e < _queues.size() && i < static_cast<size_t>(numThreads); e++) {
+      // filling ticket with executable interfaces, workers of requested node go first
+      size_t i = 0;
+      if (node >= 0 && _nodeWorkers.size() > 1) {
+        for (size_t e = 0; e < _queues.size() && i < static_cast<size_t>(numThreads); e++) {
+          if (_workerNodes[e] == node && _interfaces[e]->available()) {
+            t->attach(i++, _interfaces[e]);
+            _interfaces[e]->markUnavailable();
+          }
+        }
+      }
+
+      for (size_t e = 0; e < _queues.size() && i < static_cast<size_t>(numThreads); e++) {
         if (_interfaces[e]->available()) {
           t->attach(i++, _interfaces[e]);
           _interfaces[e]->markUnavailable();
@@ -19,8 +19,10 @@
 //
 // @author raver119@gmail.com
 //
+#include <execution/NumaTopology.h>
 #include <execution/Threads.h>
 #include <execution/ThreadPool.h>
+#include <execution/WorkStealingScheduler.h>
 #include <vector>
 #include <thread>
 #include <helpers/logger.h>
@@ -353,6 +355,54 @@ int ThreadsHelper::pickLoop3d(int numThreads, uint64_t itersX, uint64_t itersY,
   return 1;
 }
 
+// per-thread cap on number of threads, see Threads::setThreadBudget
+static thread_local int gThreadBudget = 0;
+
+void Threads::setThreadBudget(int numThreads) { gThreadBudget = numThreads > 0 ? numThreads : 0; }
+
+int Threads::threadBudget() { return gThreadBudget; }
+
+template <typename T>
+static void applyBudget(T &numThreads) {
+  if (gThreadBudget > 0 && static_cast<int64_t>(numThreads) > gThreadBudget) numThreads = static_cast<T>(gThreadBudget);
+}
+
+// with NUMA awareness on, parallel region is kept within the node of calling thread:
+// number of threads is capped to what this node has, and node index is returned. -1 means no preference
+template <typename T>
+static int localNode(T &numThreads) {
+  if (!sd::Environment::getInstance().isNumaAware()) return -1;
+
+  auto &topology = NumaTopology::getInstance();
+  if (topology.numberOfNodes() < 2) return -1;
+
+  auto node = topology.currentNode();
+#ifdef _OPENMP
+  T nodeThreads = static_cast<T>(topology.cpusOfNode(node).size());
+#else
+  T nodeThreads = static_cast<T>(ThreadPool::getInstance().numberOfWorkers(node));
+#endif
+  if (nodeThreads > 0 && numThreads > nodeThreads) numThreads = nodeThreads;
+
+  return node;
+}
+
+// in work-stealing mode each thread gets this many chunks on average, so stragglers leave something to steal
+static const int64_t SD_WORK_STEALING_CHUNKS = 8;
+
+static int64_t numberOfChunks(int64_t numThreads, int64_t start, int64_t stop, int64_t increment) {
+  auto iterations = (stop - start + increment - 1) / increment;
+  return sd::math::sd_min<int64_t>(iterations, numThreads * SD_WORK_STEALING_CHUNKS);
+}
+
+// range of the given chunk, aligned to increment. last chunk takes the tail
+static void chunkOf(int64_t chunk, int64_t numChunks, int64_t start, int64_t stop, int64_t increment,
+                    int64_t &chunkStart, int64_t &chunkStop) {
+  auto iterations = (stop - start + increment - 1) / increment;
+  chunkStart = start + (iterations * chunk / numChunks) * increment;
+  chunkStop = chunk == numChunks - 1 ? stop : start + (iterations * (chunk + 1) / numChunks) * increment;
+}
+
 #ifdef _OPENMP
 
 std::mutex Threads::gThreadmutex;
@@ -379,6 +429,7 @@ std::mutex Threads::gThreadmutex;
 
 int Threads::parallel_tad(FUNC_1D function, sd::LongType start, sd::LongType stop, sd::LongType increment,
                           sd::LongType numThreads) {
+  applyBudget(numThreads);
   if (start > stop)
     THROW_EXCEPTION("Threads::parallel_for got start > stop");
 
@@ -390,13 +441,27 @@ int Threads::parallel_tad(FUNC_1D function, sd::LongType start, sd::LongType sto
   if (numThreads == 0)
     return 0;
 
+  auto node = localNode(numThreads);
+
   // shortcut
   if (numThreads == 1) {
     function(0, start, stop, increment);
     return 1;
   }
 
+  if (sd::Environment::getInstance().isWorkStealing()) {
+    auto numChunks = numberOfChunks(numThreads, start, stop, increment);
+    WorkStealingScheduler::getInstance().run(numThreads, numChunks, [&](uint64_t threadId, int64_t chunk) {
+      int64_t chunkStart, chunkStop;
+      chunkOf(chunk, numChunks, start, stop, increment, chunkStart, chunkStop);
+      function(threadId, chunkStart, chunkStop, increment);
+    });
+
+    return numThreads;
+  }
+
 #ifdef _OPENMP
+  (void) node;
   if (tryAcquire(numThreads)) {
 
 			auto span = delta / numThreads;
@@ -420,8 +485,7 @@ int Threads::parallel_tad(FUNC_1D function, sd::LongType start, sd::LongType sto
 		}
 #else
 
-  sd::Environment::getInstance().maxThreads();
-  auto ticket = ThreadPool::getInstance().tryAcquire(numThreads);
+  auto ticket = ThreadPool::getInstance().tryAcquire(numThreads, node);
   if (ticket != nullptr) {
 
     // if we got our threads - we'll run our jobs here
@@ -458,6 +522,7 @@ int Threads::parallel_tad(FUNC_1D function, sd::LongType start, sd::LongType sto
 
 int Threads::parallel_for(FUNC_1D function, sd::LongType start, sd::LongType stop, sd::LongType increment,
                           sd::LongType numThreads) {
+  applyBudget(numThreads);
   if (start > stop)
     THROW_EXCEPTION("Threads::parallel_for got start > stop");
 
@@ -476,7 +541,38 @@ int Threads::parallel_for(FUNC_1D function, sd::LongType start, sd::LongType sto
   return parallel_tad(function, start, stop, increment, numThreads);
 }
 
+int Threads::parallel_blocks(FUNC_1D function, int64_t start, int64_t stop, int64_t numBlocks) {
+  if (start > stop)
+    THROW_EXCEPTION("Threads::parallel_blocks got start > stop");
+
+  auto delta = (stop - start);
+  if (numBlocks > delta)
+    numBlocks = delta;
+
+  if (numBlocks <= 0)
+    return 0;
+
+  if (numBlocks == 1) {
+    function(0, start, stop, 1);
+    return 1;
+  }
+
+  // blocks are fixed before scheduling, so every block index is given to function exactly once,
+  // no matter if parallel_tad splits them statically or workers steal them from each other
+  auto blocks = [&](uint64_t thread_id, int64_t firstBlock, int64_t lastBlock, int64_t increment) {
+    for (auto b = firstBlock; b < lastBlock; b++) {
+      auto blockStart = start + delta * b / numBlocks;
+      auto blockStop = b == numBlocks - 1 ? stop : start + delta * (b + 1) / numBlocks;
+      function(b, blockStart, blockStop, 1);
+    }
+  };
+
+  parallel_tad(blocks, 0, numBlocks, 1, numBlocks);
+  return static_cast<int>(numBlocks);
+}
+
 int Threads::parallel_for(FUNC_2D function, int64_t startX, int64_t stopX, int64_t incX, int64_t startY, int64_t stopY, int64_t incY, uint64_t numThreads, bool debug) {
+  applyBudget(numThreads);
   if (startX > stopX)
     THROW_EXCEPTION("Threads::parallel_for got startX > stopX");
 
@@ -496,6 +592,7 @@ int Threads::parallel_for(FUNC_2D function, int64_t startX, int64_t stopX, int64
 
   // we are checking the case of number of requested threads was smaller
   numThreads = ThreadsHelper::numberOfThreads2d(numThreads, itersX, itersY);
+  auto node = localNode(numThreads);
 
   // basic shortcut for no-threading cases
   if (numThreads == 1) {
@@ -518,8 +615,27 @@ int Threads::parallel_for(FUNC_2D function, int64_t startX, int64_t stopX, int64
     // but we still mimic multithreaded execution
     return numThreads;
   }
+  else if (sd::Environment::getInstance().isWorkStealing()) {
+    // chunks are cut along the same loop we'd split for static spans
+    auto splitStart = splitLoop == 1 ? startX : startY;
+    auto splitStop = splitLoop == 1 ? stopX : stopY;
+    auto splitInc = splitLoop == 1 ? incX : incY;
+    auto numChunks = numberOfChunks(numThreads, splitStart, splitStop, splitInc);
+
+    WorkStealingScheduler::getInstance().run(numThreads, numChunks, [&](uint64_t threadId, int64_t chunk) {
+      int64_t chunkStart, chunkStop;
+      chunkOf(chunk, numChunks, splitStart, splitStop, splitInc, chunkStart, chunkStop);
+      if (splitLoop == 1)
+        function(threadId, chunkStart, chunkStop, incX, startY, stopY, incY);
+      else
+        function(threadId, startX, stopX, incX, chunkStart, chunkStop, incY);
+    });
+
+    return numThreads;
+  }
   else {
 #ifdef _OPENMP
+    (void) node;
 
     if (tryAcquire(numThreads)) {
 #pragma omp parallel for
@@ -540,7 +656,7 @@ int Threads::parallel_for(FUNC_2D function, int64_t startX, int64_t stopX, int64
 
 #else
 
-    auto ticket = ThreadPool::getInstance().tryAcquire(numThreads);
+    auto ticket = ThreadPool::getInstance().tryAcquire(numThreads, node);
     if (ticket != nullptr) {
       for (uint64_t e = 0; e < numThreads; e++) {
         auto threadId = numThreads - e - 1;
@@ -567,6 +683,7 @@ int Threads::parallel_for(FUNC_2D function, int64_t startX, int64_t stopX, int64
 
 
 int Threads::parallel_for(FUNC_3D function, int64_t startX, int64_t stopX, int64_t incX, int64_t startY, int64_t stopY, int64_t incY, int64_t startZ, int64_t stopZ, int64_t incZ, uint64_t numThreads) {
+  applyBudget(numThreads);
   if (startX > stopX)
     THROW_EXCEPTION("Threads::parallel_for got startX > stopX");
 
@@ -585,13 +702,36 @@ int Threads::parallel_for(FUNC_3D function, int64_t startX, int64_t stopX, int64
   auto itersZ = delta_z / incZ;
 
   numThreads = ThreadsHelper::numberOfThreads3d(numThreads, itersX, itersY, itersZ);
+  auto node = localNode(numThreads);
   if (numThreads == 1) {
     // loop is too small - executing function as is
     function(0, startX, stopX, incX, startY, stopY, incY, startZ, stopZ, incZ);
     return 1;
   }
 
+  if (sd::Environment::getInstance().isWorkStealing()) {
+    auto splitLoop = ThreadsHelper::pickLoop3d(numThreads, itersX, itersY, itersZ);
+    auto splitStart = splitLoop == 1 ? startX : splitLoop == 2 ? startY : startZ;
+    auto splitStop = splitLoop == 1 ? stopX : splitLoop == 2 ? stopY : stopZ;
+    auto splitInc = splitLoop == 1 ? incX : splitLoop == 2 ? incY : incZ;
+    auto numChunks = numberOfChunks(numThreads, splitStart, splitStop, splitInc);
+
+    WorkStealingScheduler::getInstance().run(numThreads, numChunks, [&](uint64_t threadId, int64_t chunk) {
+      int64_t chunkStart, chunkStop;
+      chunkOf(chunk, numChunks, splitStart, splitStop, splitInc, chunkStart, chunkStop);
+      if (splitLoop == 1)
+        function(threadId, chunkStart, chunkStop, incX, startY, stopY, incY, startZ, stopZ, incZ);
+      else if (splitLoop == 2)
+        function(threadId, startX, stopX, incX, chunkStart, chunkStop, incY, startZ, stopZ, incZ);
+      else
+        function(threadId, startX, stopX, incX, startY, stopY, incY, chunkStart, chunkStop, incZ);
+    });
+
+    return numThreads;
+  }
+
 #ifdef _OPENMP
+  (void) node;
 
   if (tryAcquire(numThreads)) {
 
@@ -615,7 +755,7 @@ int Threads::parallel_for(FUNC_3D function, int64_t startX, int64_t stopX, int64
 		}
 #else
 
-  auto ticket = ThreadPool::getInstance().tryAcquire(numThreads);
+  auto ticket = ThreadPool::getInstance().tryAcquire(numThreads, node);
   if (ticket != nullptr) {
     auto splitLoop = ThreadsHelper::pickLoop3d(numThreads, itersX, itersY, itersZ);
 
@@ -643,6 +783,7 @@ int Threads::parallel_for(FUNC_3D function, int64_t startX, int64_t stopX, int64
 }
 
 int Threads::parallel_do(FUNC_DO function, sd::LongType numThreads) {
+  applyBudget(numThreads);
 
   if (numThreads == 1) {
     function(0, numThreads);
@@ -696,6 +837,7 @@ int Threads::parallel_do(FUNC_DO function, sd::LongType numThreads) {
 
 int64_t Threads::parallel_long(FUNC_RL function, FUNC_AL aggregator, sd::LongType start, sd::LongType stop,
                                sd::LongType increment, sd::LongType numThreads) {
+  applyBudget(numThreads);
   if (start > stop)
     THROW_EXCEPTION("Threads::parallel_long got start > stop");
 
@@ -758,6 +900,7 @@ int64_t Threads::parallel_long(FUNC_RL function, FUNC_AL aggregator, sd::LongTyp
 }
 
 double Threads::parallel_double(FUNC_RD function, FUNC_AD aggregator, int64_t start, int64_t stop, int64_t increment, uint64_t numThreads) {
+  applyBudget(numThreads);
   if (start > stop)
     THROW_EXCEPTION("Threads::parallel_long got start > stop");
 
@@ -826,6 +969,7 @@ double Threads::parallel_double(FUNC_RD function, FUNC_AD aggregator, int64_t st
 int  Threads::parallel_aligned_increment(FUNC_1D function, int64_t start, int64_t stop, int64_t increment,
                                          size_t type_size,
                                          uint32_t req_numThreads) {
+  applyBudget(req_numThreads);
   if (start > stop)
     THROW_EXCEPTION("Threads::parallel_for got start > stop");
   auto num_elements = (stop - start);
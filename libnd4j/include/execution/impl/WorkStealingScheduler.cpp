@@ -0,0 +1,222 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Work-stealing scheduler for samediff::Threads
+//
+#include <execution/WorkStealingScheduler.h>
+#include <system/Environment.h>
+
+namespace samediff {
+
+// index of the scheduler worker running on this thread, -1 for any other thread
+static thread_local int _currentWorker = -1;
+
+WorkStealingScheduler::WorkStealingScheduler() {
+  // calling thread always takes part in its own job, so we need one worker less than max threads
+  auto numWorkers = sd::Environment::getInstance().maxThreads() - 1;
+  if (numWorkers < 1) numWorkers = 1;
+
+  for (int e = 0; e < numWorkers; e++) _queues.emplace_back(new WorkerQueue());
+
+  for (int e = 0; e < numWorkers; e++) _threads.emplace_back(&WorkStealingScheduler::workerLoop, this, e);
+}
+
+WorkStealingScheduler::~WorkStealingScheduler() {
+  _stopped = true;
+  {
+    std::lock_guard<std::mutex> lock(_sleepLock);
+    _epoch++;
+  }
+  _condition.notify_all();
+
+  for (auto &t : _threads) t.join();
+}
+
+WorkStealingScheduler &WorkStealingScheduler::getInstance() {
+  static WorkStealingScheduler instance;
+  return instance;
+}
+
+int WorkStealingScheduler::numberOfWorkers() { return static_cast<int>(_threads.size()); }
+
+void WorkStealingScheduler::workerLoop(int workerId) {
+  _currentWorker = workerId;
+
+  while (!_stopped.load()) {
+    auto seen = _epoch.load();
+    if (runOnce(workerId, nullptr)) continue;
+
+    // nothing we can take right now, so we sleep till somebody pushes new work
+    std::unique_lock<std::mutex> lock(_sleepLock);
+    _condition.wait(lock, [&] { return _stopped.load() || _epoch.load() != seen; });
+  }
+}
+
+void WorkStealingScheduler::push(int queue, const Task &task) {
+  {
+    std::lock_guard<std::mutex> lock(_queues[queue]->_lock);
+    _queues[queue]->_tasks.push_back(task);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(_sleepLock);
+    _epoch++;
+  }
+  _condition.notify_all();
+}
+
+int WorkStealingScheduler::claimThreadId(Job *job) {
+  auto self = std::this_thread::get_id();
+  for (int e = 0; e < job->_maxThreads; e++) {
+    auto current = job->_participants[e].load();
+    if (current == self) return e;
+
+    if (current == std::thread::id()) {
+      if (job->_participants[e].compare_exchange_strong(current, self)) return e;
+
+      if (current == self) return e;
+    }
+  }
+
+  return -1;
+}
+
+bool WorkStealingScheduler::popOwn(int workerId, Job *only, Task &result, int &threadId) {
+  auto &queue = *_queues[workerId];
+  std::lock_guard<std::mutex> lock(queue._lock);
+
+  for (auto it = queue._tasks.rbegin(); it != queue._tasks.rend(); ++it) {
+    if (only != nullptr && it->_job != only) continue;
+
+    auto id = claimThreadId(it->_job);
+    if (id < 0) continue;
+
+    result = Task{it->_job, it->_last - 1, it->_last};
+    threadId = id;
+
+    if (--it->_last == it->_first) queue._tasks.erase(std::next(it).base());
+
+    return true;
+  }
+
+  return false;
+}
+
+bool WorkStealingScheduler::steal(int thiefId, Job *only, Task &result, int &threadId) {
+  auto numQueues = static_cast<int>(_queues.size());
+  auto first = thiefId >= 0 ? thiefId + 1 : static_cast<int>(_nextQueue.load() % numQueues);
+
+  for (int e = 0; e < numQueues; e++) {
+    auto victim = (first + e) % numQueues;
+    if (victim == thiefId) continue;
+
+    auto &queue = *_queues[victim];
+    std::lock_guard<std::mutex> lock(queue._lock);
+
+    for (auto it = queue._tasks.begin(); it != queue._tasks.end(); ++it) {
+      if (only != nullptr && it->_job != only) continue;
+
+      auto id = claimThreadId(it->_job);
+      if (id < 0) continue;
+
+      // workers take older half of the task, since they can share it further. external threads just take one chunk
+      auto size = it->_last - it->_first;
+      auto take = thiefId >= 0 ? (size + 1) / 2 : 1;
+
+      result = Task{it->_job, it->_first, it->_first + take};
+      threadId = id;
+
+      it->_first += take;
+      if (it->_first == it->_last) queue._tasks.erase(it);
+
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool WorkStealingScheduler::runOnce(int workerId, Job *only) {
+  Task task;
+  int threadId = -1;
+
+  if (workerId >= 0 && popOwn(workerId, only, task, threadId)) {
+    // single chunk, nothing to share
+  } else if (steal(workerId, only, task, threadId)) {
+    // stolen range goes into our own queue, so others can steal from it as well
+    if (workerId >= 0 && task._last - task._first > 1) {
+      push(workerId, Task{task._job, task._first + 1, task._last});
+      task._last = task._first + 1;
+    }
+  } else {
+    return false;
+  }
+
+  auto job = task._job;
+  for (auto chunk = task._first; chunk < task._last; chunk++) (*job->_function)(threadId, chunk);
+
+  // job might be gone right after this decrement
+  job->_pending.fetch_sub(task._last - task._first, std::memory_order_acq_rel);
+  return true;
+}
+
+void WorkStealingScheduler::run(int numThreads, int64_t numChunks, const ChunkFunction &function) {
+  if (numChunks <= 0) return;
+
+  if (numThreads <= 1 || numChunks == 1) {
+    for (int64_t e = 0; e < numChunks; e++) function(0, e);
+
+    return;
+  }
+
+  Job job;
+  job._function = &function;
+  job._pending = numChunks;
+  job._maxThreads = numThreads;
+  job._participants.reset(new std::atomic<std::thread::id>[numThreads]);
+  for (int e = 0; e < numThreads; e++) job._participants[e].store(std::thread::id());
+
+  // calling thread is always the first participant
+  claimThreadId(&job);
+
+  auto workerId = _currentWorker;
+  if (workerId >= 0) {
+    // nested call: all chunks go to local queue, idle workers will steal them
+    push(workerId, Task{&job, 0, numChunks});
+  } else {
+    // external call: chunks are spread over worker queues right away
+    auto numQueues = static_cast<int64_t>(_queues.size());
+    auto blocks = numChunks < numThreads ? numChunks : static_cast<int64_t>(numThreads);
+    if (blocks > numQueues) blocks = numQueues;
+
+    auto offset = _nextQueue.fetch_add(1);
+    for (int64_t b = 0; b < blocks; b++) {
+      auto first = numChunks * b / blocks;
+      auto last = numChunks * (b + 1) / blocks;
+      push(static_cast<int>((offset + b) % numQueues), Task{&job, first, last});
+    }
+  }
+
+  // we take part in our own job till it's done. only its chunks are picked here, so thread id we hold
+  // within some outer job is never reused while we're inside of it
+  while (job._pending.load(std::memory_order_acquire) > 0) {
+    if (!runOnce(workerId, &job)) std::this_thread::yield();
+  }
+}
+}  // namespace samediff
@@ -70,6 +70,10 @@ class SD_LIB_EXPORT Context : public ContextPrototype {
   // special flag used during conversion from Graph exec to FastPath exec
   bool _forbidFastPath = false;
 
+  // set whenever input array is requested via array(), execution plans use it to find out if shape function looked
+  // at input values
+  bool _inputsAccessed = false;
+
  public:
   Context(ContextPrototype* prototype, VariableSpace* variableSpace);
   explicit Context(int nodeId, VariableSpace* variableSpace = nullptr);
@@ -281,6 +285,9 @@ class SD_LIB_EXPORT Context : public ContextPrototype {
   void setShapeFunctionOverride(bool reallyOverride);
   bool shapeFunctionOverride();
 
+  bool inputsAccessed();
+  void resetInputsAccessed();
+
   samediff::ExecutionMode executionMode();
   void setExecutionMode(samediff::ExecutionMode executionMode);
 
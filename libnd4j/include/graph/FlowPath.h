@@ -28,6 +28,7 @@
 #include <system/op_boilerplate.h>
 
 #include <map>
+#include <mutex>
 #include <unordered_map>
 
 namespace sd {
@@ -42,6 +43,9 @@ class SD_LIB_EXPORT FlowPath {
 
   GraphProfile _profile;
 
+  // nodes of the same layer may be executed concurrently, so all state access goes through this lock
+  std::mutex _lock;
+
  public:
   FlowPath() = default;
   ~FlowPath() = default;
@@ -79,6 +83,7 @@ class SD_LIB_EXPORT FlowPath {
   void incrementNumberOfCycles(LongType frameId);
   LongType getNumberOfCycles(LongType frameId);
 
+  // profile isn't guarded, GraphExecutioner only runs nodes concurrently when profiling is off
   GraphProfile* profile();
 };
 }  // namespace graph
@@ -46,6 +46,12 @@ class SD_LIB_EXPORT GraphExecutioner {
 
   static Status executeFlatNode(Graph *graph, Node *node, VariableSpace *variableSpace);
 
+  /**
+   * This method executes independent nodes of one graph layer concurrently
+   * @return
+   */
+  static Status executeLayer(Graph *graph, std::vector<Node *> *layer, VariableSpace *variableSpace);
+
   /**
    * This method executes given Graph
    * @return
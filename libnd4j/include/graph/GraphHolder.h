@@ -21,10 +21,14 @@
 //
 #include <exceptions/unknown_graph_exception.h>
 #include <graph/Graph.h>
+#include <graph/GraphSessionPool.h>
+#include <graph/RequestBatcher.h>
 #include <helpers/SimpleReadWriteLock.h>
 #include <helpers/logger.h>
 
 #include <map>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 
 namespace sd {
@@ -33,11 +37,23 @@ class SD_LIB_EXPORT GraphHolder {
  private:
   SD_MAP_IMPL<LongType, Graph*> _graphF;
 
+  // locks are never removed, so pointers to them stay valid after _mutex is released
   SD_MAP_IMPL<LongType, SimpleReadWriteLock> _locks;
 
-  GraphHolder() = default;
+  SD_MAP_IMPL<LongType, std::shared_ptr<GraphSessionPool>> _pools;
+
+  SD_MAP_IMPL<LongType, std::shared_ptr<RequestBatcher>> _batchers;
+
+  // guards maps above. graph execution itself happens outside of it
+  std::mutex _mutex;
+
+  std::atomic<int> _maxIdleSessions;
+
+  GraphHolder();
   ~GraphHolder() = default;
 
+  SimpleReadWriteLock* graphLock(LongType graphId);
+
  public:
   static GraphHolder& getInstance();
 
@@ -57,36 +73,58 @@ class SD_LIB_EXPORT GraphHolder {
 
   bool hasGraphAny(LongType graphId);
 
+  /**
+   * Executes request using one of pooled sessions of the given graph, so concurrent requests don't clone the graph
+   */
   flatbuffers::Offset<::graph::FlatResult> execute(LongType graphId, flatbuffers::FlatBufferBuilder& builder,
                                           const ::graph::FlatInferenceRequest* request);
 
+  /**
+   * Executes graph for given input variables using one of pooled sessions, bypassing request batching.
+   * Takes ownership of inputs, caller owns returned outputs.
+   */
+  std::vector<Variable*> execute(LongType graphId, std::vector<Variable*>& inputs);
+
   void replaceGraph(LongType graphId, Graph* graph);
 
-  /////////////////////////////
+  /**
+   * Routes requests of the given graph through RequestBatcher: concurrent requests are concatenated along
+   * dimension 0, up to maxBatch rows or until the oldest one waited for maxWaitMicros.
+   */
+  void enableBatching(LongType graphId, int maxBatch, LongType maxWaitMicros);
+
+  void disableBatching(LongType graphId);
 
-  SD_INLINE void lockWrite(LongType graphId) {
-    if (_locks.count(graphId) == 0) return;
+  /**
+   * Returns RequestBatcher of the given graph, or nullptr if batching isn't enabled for it
+   */
+  std::shared_ptr<RequestBatcher> requestBatcher(LongType graphId);
 
-    _locks[graphId].lockWrite();
-  }
+  /**
+   * Returns session pool of the given graph, or nullptr if there's no such graph
+   */
+  std::shared_ptr<GraphSessionPool> sessionPool(LongType graphId);
 
-  SD_INLINE void unlockWrite(LongType graphId) {
-    if (_locks.count(graphId) == 0) return;
+  /**
+   * Builds sessions in advance, so the first numSessions concurrent requests don't pay for graph cloning
+   */
+  void prepareSessions(LongType graphId, int numSessions);
 
-    _locks[graphId].unlockWrite();
-  }
+  /**
+   * Max number of idle sessions kept per graph. Applies to graphs registered after this call
+   */
+  void setMaxIdleSessions(int numSessions);
+  int maxIdleSessions();
+
+  /////////////////////////////
 
-  SD_INLINE void lockRead(LongType graphId) {
-    if (_locks.count(graphId) == 0) return;
+  void lockWrite(LongType graphId);
 
-    _locks[graphId].lockRead();
-  }
+  void unlockWrite(LongType graphId);
 
-  SD_INLINE void unlockRead(LongType graphId) {
-    if (_locks.count(graphId) == 0) return;
+  void lockRead(LongType graphId);
 
-    _locks[graphId].unlockRead();
-  }
+  void unlockRead(LongType graphId);
 };
 }  // namespace graph
 }  // namespace sd
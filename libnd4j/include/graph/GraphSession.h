@@ -0,0 +1,74 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Reusable execution state of a single in-flight request against a stored Graph
+//
+
+#ifndef LIBND4J_GRAPHSESSION_H
+#define LIBND4J_GRAPHSESSION_H
+#include <execution/LaunchContext.h>
+#include <graph/Graph.h>
+#include <graph/VariableProxy.h>
+#include <memory/Workspace.h>
+
+namespace sd {
+namespace graph {
+/**
+ * Session is a Graph clone backed by VariableProxy, plus Workspace used for its intermediate arrays.
+ * Session is built once, and then reset() between requests: only the proxy's own variables are dropped,
+ * nodes and workspace buffer are reused. Session must be used by one request at a time.
+ */
+class SD_LIB_EXPORT GraphSession {
+ private:
+  Graph* _graph = nullptr;
+  VariableProxy* _proxy = nullptr;
+
+  // both are nullptr if session allocates from default LaunchContext
+  memory::Workspace* _workspace = nullptr;
+  LaunchContext* _context = nullptr;
+
+  LongType _executions = 0;
+
+  void shadowNodeVariables();
+
+ public:
+  explicit GraphSession(Graph* origin);
+  ~GraphSession();
+
+  GraphSession(const GraphSession& other) = delete;
+  GraphSession& operator=(const GraphSession& other) = delete;
+
+  Graph* graph();
+  VariableSpace* variableSpace();
+  memory::Workspace* workspace();
+
+  /**
+   * Drops all variables produced by the last request and rewinds workspace
+   */
+  void reset();
+
+  /**
+   * Number of times this session was reset, i.e. number of requests served
+   */
+  LongType executions() const;
+};
+}  // namespace graph
+}  // namespace sd
+
+#endif  // LIBND4J_GRAPHSESSION_H
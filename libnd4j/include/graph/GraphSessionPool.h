@@ -0,0 +1,84 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Pool of GraphSession instances built for a single stored Graph
+//
+
+#ifndef LIBND4J_GRAPHSESSIONPOOL_H
+#define LIBND4J_GRAPHSESSIONPOOL_H
+#include <graph/GraphSession.h>
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace sd {
+namespace graph {
+/**
+ * Sessions are created on demand, so there's never more of them than concurrent requests.
+ * Once request is served, session is reset and returned to the pool, unless pool already holds maxIdle sessions.
+ */
+class SD_LIB_EXPORT GraphSessionPool {
+ private:
+  Graph* _origin;
+  int _maxIdle;
+
+  std::mutex _mutex;
+  std::vector<GraphSession*> _idle;
+
+  std::atomic<LongType> _created{0};
+  std::atomic<LongType> _reused{0};
+
+ public:
+  GraphSessionPool(Graph* origin, int maxIdle);
+  ~GraphSessionPool();
+
+  GraphSessionPool(const GraphSessionPool& other) = delete;
+  GraphSessionPool& operator=(const GraphSessionPool& other) = delete;
+
+  /**
+   * Returns idle session, or builds a new one if there's none
+   */
+  GraphSession* acquire();
+
+  /**
+   * Resets session and puts it back to the pool
+   */
+  void release(GraphSession* session);
+
+  /**
+   * Deletes session instead of returning it, i.e. after failed execution
+   */
+  void discard(GraphSession* session);
+
+  /**
+   * Builds sessions in advance, until pool holds at least numSessions idle ones
+   */
+  void prepare(int numSessions);
+
+  int maxIdle() const;
+  int numberOfIdle();
+
+  LongType created() const;
+  LongType reused() const;
+};
+}  // namespace graph
+}  // namespace sd
+
+#endif  // LIBND4J_GRAPHSESSIONPOOL_H
@@ -0,0 +1,135 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Micro-batching front end for requests served by GraphHolder
+//
+
+#ifndef LIBND4J_REQUESTBATCHER_H
+#define LIBND4J_REQUESTBATCHER_H
+#include <graph/Variable.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace sd {
+namespace graph {
+/**
+ * Snapshot of RequestBatcher metrics. Latencies are measured over the last LATENCY_WINDOW requests.
+ */
+struct SD_LIB_EXPORT BatchingStats {
+  LongType requests = 0;
+  LongType batches = 0;
+
+  // requests waiting for a batch right now, and max number of them seen so far
+  LongType queueDepth = 0;
+  LongType maxQueueDepth = 0;
+
+  double meanBatchSize = 0.0;
+
+  // time from arrival until request's batch started executing
+  double meanQueueMicros = 0.0;
+
+  // time from arrival until outputs are available
+  double meanLatencyMicros = 0.0;
+  LongType p50LatencyMicros = 0;
+  LongType p99LatencyMicros = 0;
+};
+
+/**
+ * Requests against the same graph arriving within maxWaitMicros of each other are concatenated along dimension 0,
+ * executed once, and outputs are split back per request. Batch is executed as soon as it has maxBatch rows,
+ * or once its oldest request waited for maxWaitMicros.
+ *
+ * Requests are batched together only if they have the same set of inputs, with the same data types and the same
+ * shapes besides dimension 0. Graph is expected to treat dimension 0 of its inputs as independent batch entries:
+ * outputs with dimension 0 equal to the batch size are split, any other output is copied to every request.
+ *
+ * There's no dedicated thread: one of waiting callers collects the batch and executes it on behalf of others.
+ */
+class SD_LIB_EXPORT RequestBatcher {
+ private:
+  struct PendingRequest {
+    std::vector<Variable*> inputs;
+    std::vector<Variable*> outputs;
+    std::exception_ptr error;
+
+    // 0 means request can't be batched with anything else
+    LongType rows = 0;
+    std::string signature;
+
+    std::chrono::steady_clock::time_point arrival;
+    bool taken = false;
+    bool done = false;
+  };
+
+  LongType _graphId;
+  int _maxBatch;
+  LongType _maxWaitMicros;
+
+  std::mutex _mutex;
+  std::condition_variable _condition;
+  std::deque<PendingRequest*> _queue;
+  LongType _queuedRows = 0;
+
+  // true while one of callers waits for the batch to fill up
+  bool _collecting = false;
+
+  LongType _requests = 0;
+  LongType _batches = 0;
+  LongType _maxQueueDepth = 0;
+  double _totalQueueMicros = 0.0;
+  double _totalLatencyMicros = 0.0;
+  LongType _completed = 0;
+  std::vector<LongType> _latencies;
+  size_t _latencyPosition = 0;
+
+  static void describe(PendingRequest& request);
+
+  std::vector<PendingRequest*> takeBatch();
+  void executeBatch(std::vector<PendingRequest*>& batch);
+
+ public:
+  static constexpr int LATENCY_WINDOW = 4096;
+
+  RequestBatcher(LongType graphId, int maxBatch, LongType maxWaitMicros);
+  ~RequestBatcher() = default;
+
+  RequestBatcher(const RequestBatcher& other) = delete;
+  RequestBatcher& operator=(const RequestBatcher& other) = delete;
+
+  /**
+   * Executes graph for given inputs, possibly batched with concurrent requests. Blocks until outputs are available.
+   * Takes ownership of inputs, caller owns returned outputs.
+   */
+  std::vector<Variable*> execute(std::vector<Variable*>& inputs);
+
+  int maxBatch() const;
+  LongType maxWaitMicros() const;
+
+  BatchingStats stats();
+};
+}  // namespace graph
+}  // namespace sd
+
+#endif  // LIBND4J_REQUESTBATCHER_H
@@ -27,6 +27,7 @@ class SD_LIB_EXPORT VariableProxy : public VariableSpace {
  protected:
   VariableSpace *_backed = nullptr;
   VariableSpace *_current = nullptr;
+  LaunchContext *_context = nullptr;
 
  public:
   explicit VariableProxy(VariableSpace *reference);
@@ -86,6 +87,19 @@ class SD_LIB_EXPORT VariableProxy : public VariableSpace {
   virtual Stash *getStash();
   virtual void setFlowPath(FlowPath *timers);
   virtual FlowPath *flowPath();
+
+  virtual LaunchContext *launchContext();
+
+  /**
+   * Overrides LaunchContext (and thus Workspace) used for ops executed against this proxy.
+   * Context isn't owned by proxy. nullptr means LaunchContext of backing VariableSpace.
+   */
+  void setLaunchContext(LaunchContext *context);
+
+  /**
+   * Drops everything put into this proxy, backing VariableSpace stays intact
+   */
+  void reset();
 };
 }  // namespace graph
 }  // namespace sd
@@ -60,7 +60,9 @@ class SD_LIB_EXPORT VariableSpace {
 
   int _auto_counter = -1;
 
-  std::mutex _varmap;
+  // guards all maps and lists: nodes of the same layer may be executed concurrently.
+  // recursive, since put/get methods call each other
+  std::recursive_mutex _varmap;
 
   SD_MAP_IMPL<int, sd::graph::Variable*> _temporary;
 
@@ -66,7 +66,11 @@ Context::Context(ContextPrototype *prototype, VariableSpace *variableSpace) {
 DataType Context::dataType(int index) {
   if(numD() < 1) {
     if(width() > 0) {
-      return this->array(index)->dataType();
+      // data type is known from input shape, so this doesn't count as input access
+      const bool inputsAccessed = _inputsAccessed;
+      const auto dtype = this->array(index)->dataType();
+      _inputsAccessed = inputsAccessed;
+      return dtype;
     } else {
       std::string errorMessage;
       errorMessage += std::string("Context::dataType: Unable to determine data type. Both d args and inputs are empty.");
@@ -362,6 +366,8 @@ NDArray *Context::outputArray(int idx) {
 }
 
 NDArray *Context::array(int idx) {
+  _inputsAccessed = true;
+
   // we check for fastpath first
   if (!_fastpath_in.empty() && _fastpath_in.size() > static_cast<size_t>(idx)) {
     return _fastpath_in[idx];
@@ -602,6 +608,10 @@ void Context::setShapeFunctionOverride(bool reallyOverride) { _shapeFunctionOver
 
 bool Context::shapeFunctionOverride() { return _shapeFunctionOverride; }
 
+bool Context::inputsAccessed() { return _inputsAccessed; }
+
+void Context::resetInputsAccessed() { _inputsAccessed = false; }
+
 samediff::ExecutionMode Context::executionMode() { return _execMode; }
 
 void Context::setExecutionMode(samediff::ExecutionMode executionMode) { _execMode = executionMode; }
@@ -39,92 +39,129 @@ void FlowPath::ensureFrame(int frameId) {
 }
 
 void FlowPath::setInnerTime(int nodeId, LongType time) {
+  std::lock_guard<std::mutex> lock(_lock);
   ensureNode(nodeId);
 
   _states[nodeId].setInnerTime(time);
 }
 
 void FlowPath::setOuterTime(int nodeId, LongType time) {
+  std::lock_guard<std::mutex> lock(_lock);
   ensureNode(nodeId);
 
   _states[nodeId].setOuterTime(time);
 }
 
 LongType FlowPath::innerTime(int nodeId) {
+  std::lock_guard<std::mutex> lock(_lock);
   ensureNode(nodeId);
 
   return _states[nodeId].innerTime();
 }
 
 LongType FlowPath::outerTime(int nodeId) {
+  std::lock_guard<std::mutex> lock(_lock);
   ensureNode(nodeId);
 
   return _states[nodeId].outerTime();
 }
 
 bool FlowPath::isNodeActive(int nodeId) {
+  std::lock_guard<std::mutex> lock(_lock);
   ensureNode(nodeId);
 
   return _states[nodeId].isActive();
 }
 
 void FlowPath::markNodeActive(int nodeId, bool isActive) {
+  std::lock_guard<std::mutex> lock(_lock);
   ensureNode(nodeId);
 
   _states[nodeId].markActive(isActive);
 }
 
 int FlowPath::branch(int nodeId) {
+  std::lock_guard<std::mutex> lock(_lock);
   ensureNode(nodeId);
 
   return _states[nodeId].branch();
 }
 
 void FlowPath::markBranch(int nodeId, int index) {
+  std::lock_guard<std::mutex> lock(_lock);
   ensureNode(nodeId);
 
   _states[nodeId].markBranch(index);
 }
 
 bool FlowPath::isFrameActive(LongType frameId) {
+  std::lock_guard<std::mutex> lock(_lock);
   ensureFrame(frameId);
 
   return _frames[frameId].wasActivated();
 }
 
 void FlowPath::markFrameActive(LongType frameId, bool isActive) {
+  std::lock_guard<std::mutex> lock(_lock);
   ensureFrame(frameId);
 
   _frames[frameId].markActivated(isActive);
 }
 
-bool FlowPath::isRewindPlanned(LongType frameId) { return _frames[frameId].isRewindPlanned(); }
+bool FlowPath::isRewindPlanned(LongType frameId) {
+  std::lock_guard<std::mutex> lock(_lock);
+  return _frames[frameId].isRewindPlanned();
+}
 
-void FlowPath::planRewind(LongType frameId, bool reallyRewind) { _frames[frameId].planRewind(reallyRewind); }
+void FlowPath::planRewind(LongType frameId, bool reallyRewind) {
+  std::lock_guard<std::mutex> lock(_lock);
+  _frames[frameId].planRewind(reallyRewind);
+}
 
-int FlowPath::getRewindPosition(LongType frameId) { return _frames[frameId].getRewindPosition(); }
+int FlowPath::getRewindPosition(LongType frameId) {
+  std::lock_guard<std::mutex> lock(_lock);
+  return _frames[frameId].getRewindPosition();
+}
 
-void FlowPath::setRewindPosition(LongType frameId, int position) { _frames[frameId].setRewindPosition(position); }
+void FlowPath::setRewindPosition(LongType frameId, int position) {
+  std::lock_guard<std::mutex> lock(_lock);
+  _frames[frameId].setRewindPosition(position);
+}
 
 void FlowPath::setRewindPositionOnce(LongType frameId, int position) {
+  std::lock_guard<std::mutex> lock(_lock);
   _frames[frameId].setRewindPositionOnce(position);
 }
 
 void FlowPath::registerFrame(LongType frameId) {
+  std::lock_guard<std::mutex> lock(_lock);
   if (_frames.count(frameId) == 0) ensureFrame(frameId);
 }
 
 void FlowPath::forgetFrame(LongType frameId) {
+  std::lock_guard<std::mutex> lock(_lock);
   if (_frames.count(frameId) > 0) _frames.erase(frameId);
 }
 
-void FlowPath::incrementNumberOfCycles(LongType frameId) { _frames[frameId].incrementNumberOfCycles(); }
+void FlowPath::incrementNumberOfCycles(LongType frameId) {
+  std::lock_guard<std::mutex> lock(_lock);
+  _frames[frameId].incrementNumberOfCycles();
+}
 
-LongType FlowPath::getNumberOfCycles(LongType frameId) { return _frames[frameId].getNumberOfCycles(); }
+LongType FlowPath::getNumberOfCycles(LongType frameId) {
+  std::lock_guard<std::mutex> lock(_lock);
+  return _frames[frameId].getNumberOfCycles();
+}
 
-bool FlowPath::wasExecuted(int nodeId) { return _states[nodeId].wasExecuted(); }
+bool FlowPath::wasExecuted(int nodeId) {
+  std::lock_guard<std::mutex> lock(_lock);
+  return _states[nodeId].wasExecuted();
+}
 
-void FlowPath::markExecuted(int nodeId, bool wasExecuted) { _states[nodeId].markExecuted(wasExecuted); }
+void FlowPath::markExecuted(int nodeId, bool wasExecuted) {
+  std::lock_guard<std::mutex> lock(_lock);
+  _states[nodeId].markExecuted(wasExecuted);
+}
 
 GraphProfile* FlowPath::profile() { return &_profile; }
 }  // namespace graph
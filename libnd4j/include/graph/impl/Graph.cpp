@@ -1089,7 +1089,7 @@ Graph *Graph::cloneWithProxy() {
     for (auto x : *(ovec)) {
       auto n = x->clone();
       vec->emplace_back(n);
-      _handles.emplace_back(n);
+      clone->_handles.emplace_back(n);
       (*clone->_mapped)[n->id()] = n;
     }
 
@@ -1134,7 +1134,7 @@ Graph *Graph::clone() {
     for (auto x : *(ovec)) {
       auto n = x->clone();
       vec->emplace_back(n);
-      _handles.emplace_back(n);
+      clone->_handles.emplace_back(n);
       (*clone->_mapped)[n->id()] = n;
     }
 
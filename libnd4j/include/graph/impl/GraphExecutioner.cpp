@@ -43,14 +43,18 @@
 #include <graph/ExecutionResult.h>
 #include <graph/FlatUtils.h>
 #include <graph/ResultWrapper.h>
+#include <execution/ThreadPool.h>
+#include <execution/Threads.h>
 #include <graph/execution/LogicExecutor.h>
 #include <graph/generated/array_generated.h>
 #include <helpers/BitwiseUtils.h>
 #include <helpers/ShapeUtils.h>
 
+#include <atomic>
 #include <chrono>
 #include <ctime>
 #include <deque>
+#include <exception>
 
 namespace sd {
 namespace graph {
@@ -188,6 +192,139 @@ Status GraphExecutioner::executeFlatNode(Graph *graph, Node *node, VariableSpace
   return Status::OK;
 }
 
+/**
+ * This method checks if given Node should be skipped: i.e. if one of its inputs is disabled, or if it's placed on
+ * the branch that wasn't taken. Skipped nodes are marked inactive.
+ */
+static bool shouldSkipNode(Graph *graph, Node *node, FlowPath *flowPath) {
+  if (node->opType() == ::graph::OpType_LOGIC && node->opNum() == logic::Merge) {
+    // Merge node has own checkout logic
+
+    auto inputId0 = node->input()->at(0);
+    auto inputId1 = node->input()->at(1);
+
+    // Merge node can be skipped only both inputs are inactive
+    return !flowPath->isNodeActive(inputId0.first) && !flowPath->isNodeActive(inputId1.first);
+  }
+
+  // let's check for input nodes, if they are disabled or contain divergents
+  for (size_t e = 0; e < node->input()->size(); e++) {
+    auto inputId = node->input()->at(e);
+
+    // not a node. skipping checks
+    if (graph->getMapped()->count(inputId.first) == 0) continue;
+
+    /**
+     * We can skip current node, in two cases:
+     * 1) If previous node was disabled
+     * 2) If previous node was divergent node (i.e. IF op) and code went other way
+     */
+    Node *prevNode = graph->getMapped()->at(inputId.first);
+    if (!flowPath->isNodeActive(inputId.first)) {
+      flowPath->markNodeActive(node->id(), false);
+
+      sd_debug("Skipping Node_%i due to inactive input [%i]\n", node->id(), inputId.first);
+      return true;
+
+    } else if (prevNode->isDivergencePoint()) {  // literally checking for switch here
+      if (flowPath->branch(inputId.first) != inputId.second) {
+        flowPath->markNodeActive(node->id(), false);
+        sd_debug("Skipping Node_%i due to divergent branch [%i]\n", node->id(), inputId.first);
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+/**
+ * Nodes of a layer can be executed concurrently only if all of them are plain ops: logic ops drive frames and
+ * branches, and embedded graphs have their own execution flow
+ */
+static bool isIndependentLayer(std::vector<Node *> *layer) {
+  if (layer->size() < 2) return false;
+
+  for (auto node : *layer)
+    if (node->opType() == ::graph::OpType_LOGIC || node->hasGraphEmbedded()) return false;
+
+  return true;
+}
+
+/**
+ * This method executes nodes of a single onion layer concurrently. Nodes within a layer don't depend on each other,
+ * so they're spread over ThreadPool workers, and each node gets an equal share of threads for its own parallel loops.
+ *
+ * Results are processed in the same order as in sequential mode, and the first failure is reported.
+ */
+Status GraphExecutioner::executeLayer(Graph *graph, std::vector<Node *> *layer, VariableSpace *variableSpace) {
+  auto flowPath = variableSpace->flowPath();
+
+  std::vector<Node *> nodes;
+  for (auto node : *layer) {
+    if (shouldSkipNode(graph, node, flowPath)) continue;
+
+    flowPath->markNodeActive(node->id(), true);
+    nodes.emplace_back(node);
+  }
+
+  const int numNodes = static_cast<int>(nodes.size());
+  if (numNodes == 0) return Status::OK;
+
+  std::vector<Status> statuses(numNodes, Status::OK);
+  std::vector<std::exception_ptr> exceptions(numNodes);
+  std::vector<LongType> times(numNodes, 0);
+  std::atomic<int> nextNode{0};
+
+  const int maxThreads = Environment::getInstance().maxMasterThreads();
+  int numWorkers = math::sd_min<int>(numNodes, maxThreads);
+  auto ticket = numWorkers > 1 ? samediff::ThreadPool::getInstance().tryAcquire(numWorkers - 1) : nullptr;
+  if (ticket == nullptr) numWorkers = 1;
+
+  const int budget = math::sd_max<int>(1, maxThreads / numWorkers);
+
+  auto func = [&](LongType thread_id, LongType numThreads) {
+    auto previousBudget = samediff::Threads::threadBudget();
+    samediff::Threads::setThreadBudget(budget);
+
+    for (int e = nextNode++; e < numNodes; e = nextNode++) {
+      auto timeStart = std::chrono::system_clock::now();
+
+      try {
+        statuses[e] = executeFlatNode(graph, nodes[e], variableSpace);
+      } catch (...) {
+        exceptions[e] = std::current_exception();
+      }
+
+      auto timeEnd = std::chrono::system_clock::now();
+      times[e] = std::chrono::duration_cast<std::chrono::nanoseconds>(timeEnd - timeStart).count();
+    }
+
+    samediff::Threads::setThreadBudget(previousBudget);
+  };
+
+  if (ticket != nullptr) {
+    for (int e = 0; e < numWorkers - 1; e++) ticket->enqueue(e, numWorkers, func);
+
+    func(numWorkers - 1, numWorkers);
+
+    ticket->waitAndRelease();
+  } else {
+    func(0, 1);
+  }
+
+  for (int e = 0; e < numNodes; e++) {
+    if (exceptions[e] != nullptr) std::rethrow_exception(exceptions[e]);
+
+    flowPath->setOuterTime(nodes[e]->id(), times[e]);
+    if (statuses[e] != Status::OK) return statuses[e];
+
+    flowPath->markExecuted(nodes[e]->id(), true);
+  }
+
+  return Status::OK;
+}
+
 /**
  * This method executes given Graph instance, and returns error code.
  *
@@ -221,7 +358,10 @@ Status GraphExecutioner::execute(Graph *graph, VariableSpace *variableSpace) {
 
   LongType timeStart = Environment::getInstance().isProfiling() ? GraphProfile::currentTime() : 0L;
 
-  bool pe = graph->getExecutorConfiguration()->_executionMode == ::graph::ExecutionMode_AUTO;
+  // in AUTO mode independent nodes of the same layer are executed concurrently. profiling and verbose modes
+  // rely on sequential execution
+  bool pe = graph->getExecutorConfiguration()->_executionMode == ::graph::ExecutionMode_AUTO &&
+            !Environment::getInstance().isProfiling() && !Environment::getInstance().isDebugAndVerbose();
 
   // basically if at some point code diverges, code branch might be _DISABLED_, and all nodes within that branch will be
   // disabled as well
@@ -236,8 +376,18 @@ Status GraphExecutioner::execute(Graph *graph, VariableSpace *variableSpace) {
   for (int l = 0; l < (int)graph->getOnion()->size(); l++) {
     int layerSize = graph->getOnion()->count(l) == 1 ? graph->getOnion()->at(l)->size() : 0;
 
+    // frames are handled node by node, so layers are executed concurrently only outside of loops
+    if (pe && frames.empty() && isIndependentLayer(graph->getOnion()->at(l))) {
+      exec_counter += layerSize;
+      if (exec_counter > 10000) return Logger::logKernelFailureMsg("Early termination hit");
+
+      auto status = executeLayer(graph, graph->getOnion()->at(l), __variableSpace);
+      if (status != Status::OK) return status;
+
+      continue;
+    }
+
     int n = 0;
-    // this omp block will probably never be the case
     for (; n < layerSize; n++) {
       if (++exec_counter > 10000) {
         l = graph->getOnion()->size();
@@ -273,49 +423,7 @@ Status GraphExecutioner::execute(Graph *graph, VariableSpace *variableSpace) {
         }
 
         // TODO: move inactivity check right here
-        bool shouldSkip = false;
-        if (node->opType() == ::graph::OpType_LOGIC && node->opNum() == logic::Merge) {
-          // Merge node has own checkout logic
-
-          auto inputId0 = node->input()->at(0);
-          auto inputId1 = node->input()->at(1);
-
-          // Merge node can be skipped only both inputs are inactive
-          if (!flowPath->isNodeActive(inputId0.first) && !flowPath->isNodeActive(inputId1.first)) shouldSkip = true;
-
-        } else {
-          // let's check for input nodes, if they are disabled or contain divergents
-          for (size_t e = 0; e < node->input()->size(); e++) {
-            auto inputId = node->input()->at(e);
-
-            // not a node. skipping checks
-            if (graph->getMapped()->count(inputId.first) == 0) continue;
-
-            /**
-             * We can skip current node, in two cases:
-             * 1) If previous node was disabled
-             * 2) If previous node was divergent node (i.e. IF op) and code went other way
-             */
-            Node *prevNode = graph->getMapped()->at(inputId.first);
-            if (!flowPath->isNodeActive(inputId.first)) {
-              shouldSkip = true;
-              flowPath->markNodeActive(node->id(), false);
-
-              sd_debug("Skipping Node_%i due to inactive input [%i]\n", node->id(), inputId.first);
-              break;
-
-            } else if (prevNode->isDivergencePoint()) {  // literally checking for switch here
-              if (flowPath->branch(inputId.first) != inputId.second) {
-                shouldSkip = true;
-                flowPath->markNodeActive(node->id(), false);
-                sd_debug("Skipping Node_%i due to divergent branch [%i]\n", node->id(), inputId.first);
-                break;
-              }
-            }
-          }
-        }
-
-        if (shouldSkip) continue;
+        if (shouldSkipNode(graph, node, flowPath)) continue;
       }
 
       // we're propagating frameId here (but only if wasn't set earlier)
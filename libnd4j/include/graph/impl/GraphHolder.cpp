@@ -21,60 +21,77 @@
 //
 #include <exceptions/graph_execution_exception.h>
 #include <exceptions/graph_exists_exception.h>
+#include <exceptions/no_results_exception.h>
 #include <graph/GraphExecutioner.h>
 #include <graph/GraphHolder.h>
+#include <system/Environment.h>
 
 namespace sd {
 namespace graph {
+GraphHolder::GraphHolder() { _maxIdleSessions = Environment::getInstance().maxMasterThreads(); }
+
 GraphHolder& GraphHolder::getInstance() {
   static GraphHolder instance;
   return instance;
 };
 
-void GraphHolder::registerGraph(sd::LongType graphId, Graph* graph) {
-  if (hasGraphAny(graphId)) throw graph_exists_exception(graphId);
+void GraphHolder::registerGraph(LongType graphId, Graph* graph) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (_graphF.count(graphId) > 0) throw graph_exists_exception(graphId);
 
   _graphF[graphId] = graph;
+  _pools[graphId] = std::make_shared<GraphSessionPool>(graph, _maxIdleSessions.load());
 
-  sd::SimpleReadWriteLock lock;
-  _locks[graphId] = lock;
+  // lock of previously dropped graph with the same id is kept, somebody might still wait on it
+  _locks.try_emplace(graphId);
 }
 
-Graph* GraphHolder::cloneGraph(sd::LongType graphId) {
-  if (!this->hasGraph(graphId)) {
-    sd_printf("GraphHolder doesn't have graph stored for [%lld]\n", graphId);
-    THROW_EXCEPTION("Bad argument");
-  }
-
-  auto graph = _graphF[graphId]->cloneWithProxy();
+Graph* GraphHolder::cloneGraph(LongType graphId) {
+  auto graph = pullGraph(graphId);
 
-  return graph;
+  return graph->cloneWithProxy();
 }
 
-Graph* GraphHolder::pullGraph(sd::LongType graphId) {
-  if (!this->hasGraph(graphId)) {
+Graph* GraphHolder::pullGraph(LongType graphId) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (_graphF.count(graphId) == 0) {
     sd_printf("GraphHolder doesn't have graph stored for [%lld]\n", graphId);
     THROW_EXCEPTION("Bad argument");
   }
 
-  auto graph = _graphF[graphId];
-
-  return graph;
+  return _graphF[graphId];
 }
 
-void GraphHolder::forgetGraph(sd::LongType graphId) {
-  if (this->hasGraph(graphId)) _graphF.erase(graphId);
+void GraphHolder::forgetGraph(LongType graphId) {
+  std::shared_ptr<GraphSessionPool> pool;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_graphF.count(graphId) == 0) return;
+
+    _graphF.erase(graphId);
+    pool = _pools[graphId];
+    _pools.erase(graphId);
+    _batchers.erase(graphId);
+  }
+
+  // idle sessions are released here, outside of the lock
+  pool.reset();
 }
 
-void GraphHolder::dropGraph(sd::LongType graphId) {
-  if (this->hasGraph(graphId)) {
-    auto g = _graphF[graphId];
-    forgetGraph(graphId);
-    delete g;
+void GraphHolder::dropGraph(LongType graphId) {
+  Graph* g = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_graphF.count(graphId) == 0) return;
+
+    g = _graphF[graphId];
   }
+
+  forgetGraph(graphId);
+  delete g;
 }
 
-void GraphHolder::dropGraphAny(sd::LongType graphId) {
+void GraphHolder::dropGraphAny(LongType graphId) {
   if (!hasGraphAny(graphId)) return;
 
   this->lockWrite(graphId);
@@ -84,11 +101,14 @@ void GraphHolder::dropGraphAny(sd::LongType graphId) {
   this->unlockWrite(graphId);
 }
 
-bool GraphHolder::hasGraphAny(sd::LongType graphId) { return this->hasGraph(graphId); }
+bool GraphHolder::hasGraphAny(LongType graphId) { return this->hasGraph(graphId); }
 
-bool GraphHolder::hasGraph(sd::LongType graphId) { return _graphF.count(graphId) > 0; }
+bool GraphHolder::hasGraph(LongType graphId) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _graphF.count(graphId) > 0;
+}
 
-void GraphHolder::replaceGraph(sd::LongType graphId, Graph* graph) {
+void GraphHolder::replaceGraph(LongType graphId, Graph* graph) {
   if (!hasGraph(graphId)) {
     registerGraph(graphId, graph);
     return;
@@ -96,24 +116,170 @@ void GraphHolder::replaceGraph(sd::LongType graphId, Graph* graph) {
 
   this->lockWrite(graphId);
 
-  _graphF[graphId] = graph;
+  // sessions of the previous graph reference its nodes and variables, so they're dropped together with it
+  std::shared_ptr<GraphSessionPool> pool;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _graphF[graphId] = graph;
+    pool = _pools[graphId];
+    _pools[graphId] = std::make_shared<GraphSessionPool>(graph, _maxIdleSessions.load());
+  }
+  pool.reset();
 
   this->unlockWrite(graphId);
 }
 
-flatbuffers::Offset<::graph::FlatResult> GraphHolder::execute(sd::LongType graphId, flatbuffers::FlatBufferBuilder& builder,
+std::shared_ptr<GraphSessionPool> GraphHolder::sessionPool(LongType graphId) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  auto it = _pools.find(graphId);
+  return it == _pools.end() ? nullptr : it->second;
+}
+
+void GraphHolder::prepareSessions(LongType graphId, int numSessions) {
+  auto pool = sessionPool(graphId);
+  if (pool == nullptr) throw unknown_graph_exception(graphId);
+
+  lockRead(graphId);
+  try {
+    pool->prepare(numSessions);
+  } catch (...) {
+    unlockRead(graphId);
+    throw;
+  }
+  unlockRead(graphId);
+}
+
+void GraphHolder::enableBatching(LongType graphId, int maxBatch, LongType maxWaitMicros) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (_graphF.count(graphId) == 0) throw unknown_graph_exception(graphId);
+
+  // requests already queued in previous batcher are served by it
+  _batchers[graphId] = std::make_shared<RequestBatcher>(graphId, maxBatch, maxWaitMicros);
+}
+
+void GraphHolder::disableBatching(LongType graphId) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _batchers.erase(graphId);
+}
+
+std::shared_ptr<RequestBatcher> GraphHolder::requestBatcher(LongType graphId) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  auto it = _batchers.find(graphId);
+  return it == _batchers.end() ? nullptr : it->second;
+}
+
+void GraphHolder::setMaxIdleSessions(int numSessions) { _maxIdleSessions = numSessions; }
+
+int GraphHolder::maxIdleSessions() { return _maxIdleSessions.load(); }
+
+SimpleReadWriteLock* GraphHolder::graphLock(LongType graphId) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  auto it = _locks.find(graphId);
+  return it == _locks.end() ? nullptr : &it->second;
+}
+
+void GraphHolder::lockWrite(LongType graphId) {
+  auto lock = graphLock(graphId);
+  if (lock != nullptr) lock->lockWrite();
+}
+
+void GraphHolder::unlockWrite(LongType graphId) {
+  auto lock = graphLock(graphId);
+  if (lock != nullptr) lock->unlockWrite();
+}
+
+void GraphHolder::lockRead(LongType graphId) {
+  auto lock = graphLock(graphId);
+  if (lock != nullptr) lock->lockRead();
+}
+
+void GraphHolder::unlockRead(LongType graphId) {
+  auto lock = graphLock(graphId);
+  if (lock != nullptr) lock->unlockRead();
+}
+
+flatbuffers::Offset<::graph::FlatResult> GraphHolder::execute(LongType graphId, flatbuffers::FlatBufferBuilder& builder,
                                                      const ::graph::FlatInferenceRequest* request) {
   if (!hasGraph(graphId)) throw unknown_graph_exception(graphId);
 
+  auto batcher = requestBatcher(graphId);
+  if (batcher != nullptr) {
+    std::vector<Variable*> inputs;
+    if (request != nullptr && request->variables() != nullptr) {
+      auto vars = request->variables();
+      for (size_t e = 0; e < vars->size(); e++) inputs.emplace_back(new Variable(vars->Get(e)));
+    }
+
+    auto outputs = batcher->execute(inputs);
+    if (outputs.empty()) throw no_results_exception(graphId);
+
+    ExecutionResult result;
+    for (auto v : outputs) result.emplace_back(v);
+
+    auto t = result.asFlatResult(builder);
+
+    for (auto v : outputs) delete v;
+
+    return t;
+  }
+
   lockRead(graphId);
 
-  auto graph = cloneGraph(graphId);
-  auto res = GraphExecutioner::execute(graph, builder, request);
-  delete graph;
+  // graph might've been dropped before we got the lock
+  auto pool = sessionPool(graphId);
+  if (pool == nullptr) {
+    unlockRead(graphId);
+    throw unknown_graph_exception(graphId);
+  }
+
+  auto session = pool->acquire();
+  try {
+    auto res = GraphExecutioner::execute(session->graph(), builder, request);
+    pool->release(session);
+    unlockRead(graphId);
 
-  unlockRead(graphId);
+    return res;
+  } catch (...) {
+    // session state is unknown after failure, so it isn't reused
+    pool->discard(session);
+    unlockRead(graphId);
+    throw;
+  }
+}
+
+std::vector<Variable*> GraphHolder::execute(LongType graphId, std::vector<Variable*>& inputs) {
+  lockRead(graphId);
 
-  return res;
+  auto pool = sessionPool(graphId);
+  if (pool == nullptr) {
+    unlockRead(graphId);
+    for (auto v : inputs) delete v;
+    throw unknown_graph_exception(graphId);
+  }
+
+  auto session = pool->acquire();
+  try {
+    // session takes ownership of inputs, they're released on its reset
+    auto varSpace = session->variableSpace();
+    for (auto v : inputs) varSpace->replaceVariable(v);
+
+    auto status = GraphExecutioner::execute(session->graph());
+    if (status != Status::OK) throw graph_execution_exception(graphId);
+
+    auto outputs = session->graph()->fetchOutputs();
+    std::vector<Variable*> result;
+    for (auto v : *outputs) result.emplace_back(v->clone());
+    delete outputs;
+
+    pool->release(session);
+    unlockRead(graphId);
+
+    return result;
+  } catch (...) {
+    pool->discard(session);
+    unlockRead(graphId);
+    throw;
+  }
 }
 }  // namespace graph
 }  // namespace sd
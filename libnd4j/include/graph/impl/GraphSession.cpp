@@ -0,0 +1,85 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+#include <graph/GraphSession.h>
+#include <system/Environment.h>
+
+namespace sd {
+namespace graph {
+GraphSession::GraphSession(Graph* origin) {
+  _graph = origin->cloneWithProxy();
+  _proxy = static_cast<VariableProxy*>(_graph->getVariableSpace());
+
+  // on CUDA default LaunchContext holds streams and scratch pointers, so session keeps using it
+  if (Environment::getInstance().isCPU()) {
+    _workspace = new memory::Workspace();
+    _context = new LaunchContext();
+    _context->setWorkspace(_workspace);
+    _proxy->setLaunchContext(_context);
+  }
+
+  shadowNodeVariables();
+}
+
+GraphSession::~GraphSession() {
+  // proxy is owned by graph
+  delete _graph;
+  delete _context;
+  delete _workspace;
+}
+
+Graph* GraphSession::graph() { return _graph; }
+
+VariableSpace* GraphSession::variableSpace() { return _proxy; }
+
+memory::Workspace* GraphSession::workspace() { return _workspace; }
+
+void GraphSession::reset() {
+  // variables have to go first, their arrays may live in workspace
+  _proxy->reset();
+  shadowNodeVariables();
+
+  if (_workspace != nullptr) {
+    _workspace->scopeOut();
+    _workspace->scopeIn();
+  }
+
+  _executions++;
+}
+
+void GraphSession::shadowNodeVariables() {
+  // node outputs are declared in VariableSpace of the original graph, so without local copies
+  // every session would be writing its results into variables shared with other sessions
+  for (auto id : *_graph->nodes()) {
+    for (int e = 0; _proxy->hasVariable(id, e); e++) {
+      auto origin = _proxy->getVariable(id, e);
+      auto shadow = new Variable(nullptr, nullptr, id, e);
+      if (origin->getName() != nullptr) shadow->setName(origin->getName());
+
+      // arrays node propagates into external variables stay shared
+      if (!origin->isRemovable() && origin->hasNDArray()) shadow->setNDArray(origin->getNDArray());
+
+      shadow->markRemovable(origin->isRemovable());
+      _proxy->putVariable(id, e, shadow);
+    }
+  }
+}
+
+LongType GraphSession::executions() const { return _executions; }
+}  // namespace graph
+}  // namespace sd
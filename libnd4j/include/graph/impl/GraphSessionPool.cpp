@@ -0,0 +1,93 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+#include <graph/GraphSessionPool.h>
+
+namespace sd {
+namespace graph {
+GraphSessionPool::GraphSessionPool(Graph* origin, int maxIdle) : _origin(origin), _maxIdle(maxIdle > 0 ? maxIdle : 1) {}
+
+GraphSessionPool::~GraphSessionPool() {
+  for (auto s : _idle) delete s;
+}
+
+GraphSession* GraphSessionPool::acquire() {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_idle.empty()) {
+      auto session = _idle.back();
+      _idle.pop_back();
+      _reused++;
+      return session;
+    }
+  }
+
+  // cloning happens outside of the lock, other requests may keep going meanwhile
+  _created++;
+  return new GraphSession(_origin);
+}
+
+void GraphSessionPool::release(GraphSession* session) {
+  if (session == nullptr) return;
+
+  session->reset();
+
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (static_cast<int>(_idle.size()) < _maxIdle) {
+      _idle.emplace_back(session);
+      return;
+    }
+  }
+
+  delete session;
+}
+
+void GraphSessionPool::discard(GraphSession* session) { delete session; }
+
+void GraphSessionPool::prepare(int numSessions) {
+  numSessions = numSessions > _maxIdle ? _maxIdle : numSessions;
+
+  while (numberOfIdle() < numSessions) {
+    _created++;
+    auto session = new GraphSession(_origin);
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (static_cast<int>(_idle.size()) >= _maxIdle) {
+      // concurrent releases filled the pool already
+      lock.unlock();
+      delete session;
+      return;
+    }
+
+    _idle.emplace_back(session);
+  }
+}
+
+int GraphSessionPool::maxIdle() const { return _maxIdle; }
+
+int GraphSessionPool::numberOfIdle() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return static_cast<int>(_idle.size());
+}
+
+LongType GraphSessionPool::created() const { return _created.load(); }
+
+LongType GraphSessionPool::reused() const { return _reused.load(); }
+}  // namespace graph
+}  // namespace sd
@@ -0,0 +1,271 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+#include <graph/GraphHolder.h>
+#include <graph/RequestBatcher.h>
+
+#include <algorithm>
+#include <memory>
+
+namespace sd {
+namespace graph {
+RequestBatcher::RequestBatcher(LongType graphId, int maxBatch, LongType maxWaitMicros)
+    : _graphId(graphId), _maxBatch(maxBatch > 0 ? maxBatch : 1), _maxWaitMicros(maxWaitMicros > 0 ? maxWaitMicros : 0) {}
+
+int RequestBatcher::maxBatch() const { return _maxBatch; }
+
+LongType RequestBatcher::maxWaitMicros() const { return _maxWaitMicros; }
+
+void RequestBatcher::describe(PendingRequest& request) {
+  request.rows = 0;
+
+  // inputs are concatenated position by position, so signature follows their order
+  std::string signature;
+  LongType rows = -1;
+  for (auto v : request.inputs) {
+    if (!v->hasNDArray()) return;
+
+    auto array = v->getNDArray();
+    if (array->rankOf() < 1 || array->isEmpty() || array->isS()) return;
+    if (rows >= 0 && array->sizeAt(0) != rows) return;
+    rows = array->sizeAt(0);
+
+    signature += std::to_string(v->id()) + ":" + std::to_string(v->index()) + ":";
+    if (v->getName() != nullptr) signature += *v->getName();
+    signature += ":" + std::to_string(static_cast<int>(array->dataType()));
+    for (int e = 1; e < array->rankOf(); e++) signature += "," + std::to_string(array->sizeAt(e));
+    signature += ";";
+  }
+
+  if (rows < 1) return;
+
+  request.rows = rows;
+  request.signature = signature;
+}
+
+static LongType queueWeight(LongType rows) { return rows > 0 ? rows : 1; }
+
+std::vector<RequestBatcher::PendingRequest*> RequestBatcher::takeBatch() {
+  std::vector<PendingRequest*> batch;
+
+  auto front = _queue.front();
+  batch.emplace_back(front);
+
+  LongType rows = front->rows;
+  if (rows > 0) {
+    for (size_t e = 1; e < _queue.size() && rows < _maxBatch; e++) {
+      auto r = _queue[e];
+      if (r->rows > 0 && rows + r->rows <= _maxBatch && r->signature == front->signature) {
+        batch.emplace_back(r);
+        rows += r->rows;
+      }
+    }
+  }
+
+  for (auto r : batch) {
+    r->taken = true;
+    _queuedRows -= queueWeight(r->rows);
+  }
+
+  _queue.erase(std::remove_if(_queue.begin(), _queue.end(), [](PendingRequest* r) { return r->taken; }), _queue.end());
+
+  return batch;
+}
+
+void RequestBatcher::executeBatch(std::vector<PendingRequest*>& batch) {
+  try {
+    if (batch.size() == 1) {
+      auto inputs = batch[0]->inputs;
+      batch[0]->inputs.clear();
+      batch[0]->outputs = GraphHolder::getInstance().execute(_graphId, inputs);
+      return;
+    }
+
+    LongType totalRows = 0;
+    for (auto r : batch) totalRows += r->rows;
+
+    // batched inputs are owned here until GraphHolder takes them, so failed merge doesn't leak them
+    std::vector<std::unique_ptr<Variable>> batched;
+    auto& first = batch[0]->inputs;
+    batched.reserve(first.size());
+    for (size_t i = 0; i < first.size(); i++) {
+      auto proto = first[i]->getNDArray();
+      auto shape = proto->getShapeAsVector();
+      shape[0] = totalRows;
+      std::unique_ptr<NDArray> merged(new NDArray('c', shape, proto->dataType(), LaunchContext::defaultContext()));
+
+      LongType row = 0;
+      for (auto r : batch) {
+        std::vector<LongType> idx(2 * shape.size(), 0);
+        idx[0] = row;
+        idx[1] = row + r->rows;
+
+        auto& rows = (*merged)(idx, true);
+        rows.assign(r->inputs[i]->getNDArray());
+        delete &rows;
+
+        row += r->rows;
+      }
+
+      auto name = first[i]->getName();
+      batched.emplace_back(new Variable(merged.get(), name != nullptr && !name->empty() ? name->c_str() : nullptr,
+                                        first[i]->id(), first[i]->index()));
+      merged.release();
+    }
+
+    // per-request inputs are copied into batched ones already
+    for (auto r : batch) {
+      for (auto v : r->inputs) delete v;
+      r->inputs.clear();
+    }
+
+    std::vector<Variable*> inputs;
+    for (auto& v : batched) inputs.emplace_back(v.release());
+
+    // GraphHolder owns inputs from here on, outputs are ours
+    std::vector<std::unique_ptr<Variable>> outputs;
+    for (auto o : GraphHolder::getInstance().execute(_graphId, inputs)) outputs.emplace_back(o);
+
+    for (auto& o : outputs) {
+      auto array = o->hasNDArray() ? o->getNDArray() : nullptr;
+      bool split = array != nullptr && array->rankOf() > 0 && array->sizeAt(0) == totalRows;
+
+      LongType row = 0;
+      for (auto r : batch) {
+        if (!split) {
+          r->outputs.emplace_back(o->clone());
+          continue;
+        }
+
+        std::vector<LongType> idx(2 * array->rankOf(), 0);
+        idx[0] = row;
+        idx[1] = row + r->rows;
+
+        auto& rows = (*array)(idx, true);
+        auto name = o->getName();
+        r->outputs.emplace_back(new Variable(new NDArray(rows.dup(rows.ordering())),
+                                             name != nullptr && !name->empty() ? name->c_str() : nullptr, o->id(),
+                                             o->index()));
+        delete &rows;
+
+        row += r->rows;
+      }
+    }
+  } catch (...) {
+    auto error = std::current_exception();
+    for (auto r : batch) {
+      for (auto v : r->inputs) delete v;
+      r->inputs.clear();
+
+      for (auto v : r->outputs) delete v;
+      r->outputs.clear();
+
+      r->error = error;
+    }
+  }
+}
+
+std::vector<Variable*> RequestBatcher::execute(std::vector<Variable*>& inputs) {
+  PendingRequest request;
+  request.inputs = inputs;
+  request.arrival = std::chrono::steady_clock::now();
+  describe(request);
+
+  std::unique_lock<std::mutex> lock(_mutex);
+  _queue.push_back(&request);
+  _queuedRows += queueWeight(request.rows);
+  _requests++;
+  _maxQueueDepth = std::max(_maxQueueDepth, static_cast<LongType>(_queue.size()));
+  _condition.notify_all();
+
+  while (!request.done) {
+    if (!request.taken && !_collecting) {
+      // this caller collects the next batch. own request might not get into it, if queue holds more than maxBatch
+      _collecting = true;
+      auto deadline = _queue.front()->arrival + std::chrono::microseconds(_maxWaitMicros);
+      _condition.wait_until(lock, deadline, [&] { return _queuedRows >= _maxBatch; });
+
+      auto batch = takeBatch();
+      _collecting = false;
+      _condition.notify_all();
+      lock.unlock();
+
+      auto started = std::chrono::steady_clock::now();
+      executeBatch(batch);
+
+      lock.lock();
+      _batches++;
+      for (auto r : batch) {
+        _totalQueueMicros += std::chrono::duration_cast<std::chrono::microseconds>(started - r->arrival).count();
+        r->done = true;
+      }
+      _condition.notify_all();
+    } else {
+      _condition.wait(lock, [&] { return request.done || (!request.taken && !_collecting); });
+    }
+  }
+
+  auto latency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+                                                                       request.arrival).count();
+  _completed++;
+  _totalLatencyMicros += latency;
+  if (_latencies.size() < static_cast<size_t>(LATENCY_WINDOW))
+    _latencies.emplace_back(latency);
+  else
+    _latencies[_latencyPosition] = latency;
+  _latencyPosition = (_latencyPosition + 1) % LATENCY_WINDOW;
+  lock.unlock();
+
+  if (request.error) std::rethrow_exception(request.error);
+
+  return request.outputs;
+}
+
+BatchingStats RequestBatcher::stats() {
+  BatchingStats result;
+  std::vector<LongType> latencies;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    result.requests = _requests;
+    result.batches = _batches;
+    result.queueDepth = static_cast<LongType>(_queue.size());
+    result.maxQueueDepth = _maxQueueDepth;
+    if (_completed > 0) {
+      result.meanBatchSize = static_cast<double>(_completed) / static_cast<double>(_batches);
+      result.meanQueueMicros = _totalQueueMicros / static_cast<double>(_completed);
+      result.meanLatencyMicros = _totalLatencyMicros / static_cast<double>(_completed);
+    }
+
+    latencies = _latencies;
+  }
+
+  if (!latencies.empty()) {
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double q) {
+      auto position = static_cast<size_t>(q * static_cast<double>(latencies.size()));
+      return latencies[std::min(position, latencies.size() - 1)];
+    };
+
+    result.p50LatencyMicros = percentile(0.50);
+    result.p99LatencyMicros = percentile(0.99);
+  }
+
+  return result;
+}
+}  // namespace graph
+}  // namespace sd
@@ -192,5 +192,14 @@ VariableSpace &VariableProxy::operator=(const VariableSpace &other) {
 }
 
 memory::Workspace *VariableProxy::workspace() { return _workspace; }
+
+LaunchContext *VariableProxy::launchContext() { return _context != nullptr ? _context : _backed->launchContext(); }
+
+void VariableProxy::setLaunchContext(LaunchContext *context) { _context = context; }
+
+void VariableProxy::reset() {
+  delete _current;
+  _current = new VariableSpace();
+}
 }  // namespace graph
 }  // namespace sd
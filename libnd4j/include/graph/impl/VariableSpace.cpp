@@ -59,6 +59,7 @@ sd::graph::VariableSpace* sd::graph::VariableSpace::asT() {
 }
 
 void sd::graph::VariableSpace::injectVariable(std::pair<int, int>& pair, Variable* variable) {
+  std::lock_guard<std::recursive_mutex> lock(_varmap);
   if (pair.second == 0) {
     if (pair.first < 0)
       this->_variables[pair.first] = variable;
@@ -78,9 +79,15 @@ std::vector<sd::graph::Variable*>* sd::graph::VariableSpace::getPlaceholders() {
 
 int sd::graph::VariableSpace ::numberOfPlaceholders() { return _placeholders.size(); }
 
-bool sd::graph::VariableSpace::hasVariable(std::string* symbol) { return _symbolic.count(*symbol) == 1; }
+bool sd::graph::VariableSpace::hasVariable(std::string* symbol) {
+  std::lock_guard<std::recursive_mutex> lock(_varmap);
+  return _symbolic.count(*symbol) == 1;
+}
 
-sd::graph::Variable* sd::graph::VariableSpace::getVariable(std::string* symbol) { return _symbolic.at(*symbol); }
+sd::graph::Variable* sd::graph::VariableSpace::getVariable(std::string* symbol) {
+  std::lock_guard<std::recursive_mutex> lock(_varmap);
+  return _symbolic.at(*symbol);
+}
 
 bool sd::graph::VariableSpace::hasVariable(int id, int index) {
   std::pair<int, int> pair(id, index);
@@ -114,6 +121,7 @@ sd::graph::Variable* sd::graph::VariableSpace::getVariable(int id, int index) {
 }
 
 sd::graph::Variable* sd::graph::VariableSpace::getVariable(std::pair<int, int>& pair) {
+  std::lock_guard<std::recursive_mutex> lock(_varmap);
   if (pair.first < 0) {
     return getVariable(pair.first);
   } else {
@@ -124,9 +132,15 @@ sd::graph::Variable* sd::graph::VariableSpace::getVariable(std::pair<int, int>&
   return nullptr;
 }
 
-bool sd::graph::VariableSpace::hasVariable(int id) { return _variables.count(id) == 1 || _temporary.count(id) == 1; }
+bool sd::graph::VariableSpace::hasVariable(int id) {
+  std::lock_guard<std::recursive_mutex> lock(_varmap);
+  return _variables.count(id) == 1 || _temporary.count(id) == 1;
+}
 
-bool sd::graph::VariableSpace::hasVariable(std::pair<int, int>& id) { return _paired.count(id) > 0; }
+bool sd::graph::VariableSpace::hasVariable(std::pair<int, int>& id) {
+  std::lock_guard<std::recursive_mutex> lock(_varmap);
+  return _paired.count(id) > 0;
+}
 
 void sd::graph::VariableSpace::putOutputVariable(Variable* variable) {
   putVariable(variable->id(), variable);
@@ -148,6 +162,7 @@ sd::LongType sd::graph::VariableSpace::externalMemory() {
 }
 
 std::vector<Variable*> VariableSpace::getVariables() {
+  std::lock_guard<std::recursive_mutex> lock(_varmap);
   std::vector<Variable*> result;
 
   for (auto v : _internal) result.emplace_back(v);
@@ -185,14 +200,12 @@ void sd::graph::VariableSpace::putVariable(int node, int idx, Variable* variable
 }
 
 void sd::graph::VariableSpace::silentPutVariable(std::pair<int, int>& pair, Variable* variable) {
-  _varmap.lock();
-
+  std::lock_guard<std::recursive_mutex> lock(_varmap);
   _paired[pair] = variable;
-
-  _varmap.unlock();
 }
 
 void sd::graph::VariableSpace::putVariable(std::pair<int, int>& pair, Variable* variable) {
+  std::lock_guard<std::recursive_mutex> lock(_varmap);
   silentPutVariable(pair, variable);
 
   if (variable->isPlaceholder()) _placeholders.push_back(variable);
@@ -205,17 +218,17 @@ void sd::graph::VariableSpace::putVariable(std::pair<int, int>& pair, Variable*
       _symbolic[*(variable->getName())] = variable;
     }
 
-    _varmap.lock();
-
     _handles->push_back(variable);
-
-    _varmap.unlock();
   }
 }
 
-void VariableSpace::trackList(sd::NDArrayList* list) { _lists.emplace_back(list); }
+void VariableSpace::trackList(sd::NDArrayList* list) {
+  std::lock_guard<std::recursive_mutex> lock(_varmap);
+  _lists.emplace_back(list);
+}
 
 void sd::graph::VariableSpace::putVariable(int id, Variable* variable) {
+  std::lock_guard<std::recursive_mutex> lock(_varmap);
   // we don't want to add variables more then once
   if (_variables.count(id) > 0 || _temporary.count(id) > 0) {
     auto local = id < 0 ? _variables.at(id) : _temporary.at(id);
@@ -231,8 +244,6 @@ void sd::graph::VariableSpace::putVariable(int id, Variable* variable) {
     return;
   }
 
-  _varmap.lock();
-
   _handles->emplace_back(variable);
 
   if (_auto_counter >= id) _auto_counter = id - 1;
@@ -255,8 +266,6 @@ void sd::graph::VariableSpace::putVariable(int id, Variable* variable) {
     _temporary[id] = variable;
   }
 
-  _varmap.unlock();
-
   std::pair<int, int> pair(id, 0);
   if (!hasVariable(pair)) {
     this->silentPutVariable(pair, variable);
@@ -266,6 +275,7 @@ void sd::graph::VariableSpace::putVariable(int id, Variable* variable) {
 }
 
 void sd::graph::VariableSpace::putVariable(int id, int idx, NDArray& array) {
+  std::lock_guard<std::recursive_mutex> lock(_varmap);
   auto* var = new sd::graph::Variable(&array, "", id, idx);
   var->markRemovable(false);
   var->markReadOnly(true);
@@ -285,6 +295,7 @@ void sd::graph::VariableSpace::putVariable(int id, NDArray* array) {
 }
 
 sd::graph::Variable* sd::graph::VariableSpace::getVariable(int id) {
+  std::lock_guard<std::recursive_mutex> lock(_varmap);
   if (id < 0) {
     return _variables.at(id);
   } else {
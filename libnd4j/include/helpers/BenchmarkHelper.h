@@ -0,0 +1,135 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+
+#ifndef LIBND4J_BENCHMARKHELPER_H
+#define LIBND4J_BENCHMARKHELPER_H
+#include <graph/Context.h>
+#include <helpers/OpBenchmark.h>
+#include <helpers/benchmark/BroadcastBenchmark.h>
+#include <helpers/benchmark/DeclarableBenchmark.h>
+#include <helpers/benchmark/MatrixBenchmark.h>
+#include <helpers/benchmark/PairwiseBenchmark.h>
+#include <helpers/benchmark/Parameters.h>
+#include <helpers/benchmark/ParametersBatch.h>
+#include <helpers/benchmark/ReductionBenchmark.h>
+#include <helpers/benchmark/ScalarBenchmark.h>
+#include <helpers/benchmark/TransformBenchmark.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+// generators for parametric benchmarks: they allocate arrays (or Context) for given parameters,
+// BenchmarkHelper releases them once benchmark for these parameters is done
+#define PARAMETRIC_XZ() [&](sd::Parameters & p, std::vector<sd::NDArray *> & x, std::vector<sd::NDArray *> & z)
+#define PARAMETRIC_XYZ()                                                                               \
+  [&](sd::Parameters & p, std::vector<sd::NDArray *> & x, std::vector<sd::NDArray *> & y, \
+      std::vector<sd::NDArray *> & z)
+#define PARAMETRIC_D() [&](sd::Parameters & p) -> sd::graph::Context *
+
+namespace sd {
+
+enum class BenchmarkFormat { TEXT, CSV, JSON };
+
+/**
+ * Timings of one benchmark for one set of parameters, in microseconds
+ */
+struct SD_LIB_EXPORT BenchmarkResult {
+  std::string suite;
+  std::string name;
+  std::string parameters;
+  std::string dataType;
+  std::string shape;
+  std::string orders;
+  std::string strides;
+  std::string axis;
+  std::string inplace;
+  std::string extra;
+  LongType iterations = 0;
+  double min = 0.0;
+  double median = 0.0;
+  double mean = 0.0;
+  double p99 = 0.0;
+  double max = 0.0;
+  double stdDev = 0.0;
+};
+
+class SD_LIB_EXPORT BenchmarkHelper {
+ public:
+  using XZGenerator = std::function<void(Parameters &, std::vector<NDArray *> &, std::vector<NDArray *> &)>;
+  using XYZGenerator = std::function<void(Parameters &, std::vector<NDArray *> &, std::vector<NDArray *> &,
+                                          std::vector<NDArray *> &)>;
+  using ContextGenerator = std::function<graph::Context *(Parameters &)>;
+
+ private:
+  unsigned int _warmUpIterations;
+  unsigned int _runIterations;
+  bool _printOut = true;
+  std::string _filter;
+  std::vector<BenchmarkResult> _results;
+
+  void benchmarkOperation(OpBenchmark &benchmark, const std::string &suite, const Parameters &parameters);
+  void releaseArrays(std::vector<NDArray *> &x, std::vector<NDArray *> &y, std::vector<NDArray *> &z);
+  bool accepts(const std::string &suite, OpBenchmark *op) const;
+
+ public:
+  explicit BenchmarkHelper(unsigned int warmUpIterations = 10, unsigned int runIterations = 100);
+
+  /**
+   * Only suites or benchmarks which name contains this substring will be executed
+   */
+  void setFilter(const std::string &filter);
+  void setPrintOut(bool printOut);
+
+  unsigned int warmUpIterations() const;
+  unsigned int runIterations() const;
+
+  /**
+   * Runs benchmark once, for arrays it already has
+   */
+  void runOperationSuit(OpBenchmark *op, const char *message = nullptr);
+
+  /**
+   * Runs benchmark for every combination of parameters, arrays are provided by generator
+   */
+  void runOperationSuit(OpBenchmark *op, const XZGenerator &func, const ParametersBatch &parametersBatch,
+                        const char *message = nullptr);
+  void runOperationSuit(OpBenchmark *op, const XYZGenerator &func, const ParametersBatch &parametersBatch,
+                        const char *message = nullptr);
+  void runOperationSuit(DeclarableBenchmark *op, const ContextGenerator &func, const ParametersBatch &parametersBatch,
+                        const char *message = nullptr);
+
+  const std::vector<BenchmarkResult> &results() const;
+
+  /**
+   * Returns all results collected so far in given format
+   */
+  std::string report(BenchmarkFormat format) const;
+
+  /**
+   * Turns per-iteration timings (in nanoseconds) into summary statistics
+   */
+  static void summarize(std::vector<LongType> &timings, BenchmarkResult &result);
+};
+}  // namespace sd
+
+#endif  // LIBND4J_BENCHMARKHELPER_H
@@ -68,6 +68,13 @@ class SD_LIB_EXPORT ConstantShapeHelper {
   LongType* emptyShapeInfoWithShape(const DataType dataType, std::vector<LongType>& shape);
   ConstantShapeBuffer* createConstBuffFromExisting(sd::LongType* shapeInfo);
   ConstantShapeBuffer* createSubArrShapeInfo(LongType* shapeInfo, LongType* dims, LongType rank);
+
+  /**
+   * Underlying cache, exposed for statistics
+   */
+  DirectShapeTrie& cache() { return _shapeTrie; }
+
+  LongType totalCachedEntries() { return _shapeTrie.entries(); }
 };
 }  // namespace sd
 
@@ -58,6 +58,13 @@ class SD_LIB_EXPORT ConstantTadHelper {
 
   TadPack *tadForDimensions(LongType *originalShape, LongType dimension);
   TadPack *tadForDimensions(LongType *originalShape, std::vector<LongType> *dimensions);
+
+  /**
+   * Underlying cache, exposed for statistics
+   */
+  DirectTadTrie &cache() { return _trie; }
+
+  LongType totalCachedEntries() { return _trie.entries(); }
 };
 }  // namespace sd
 
@@ -0,0 +1,98 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Runtime instruction set dispatch for hot loops: one binary carries generic, AVX2 and AVX-512 clones
+// of a loop and picks one of them on the host it runs on.
+//
+
+#ifndef LIBND4J_CPUISA_H
+#define LIBND4J_CPUISA_H
+
+#include <system/common.h>
+
+// clones are produced via target attributes, so this needs gcc/clang on x86-64 and a host-side build
+#if (defined(__x86_64__) || defined(_M_X64)) && (defined(__GNUC__) || defined(__clang__)) && \
+    !defined(__CUDACC__) && !defined(_WIN32) && !defined(SD_DISABLE_ISA_DISPATCH)
+#define SD_ISA_DISPATCH 1
+#define SD_TARGET_AVX2 __attribute__((target("avx2,fma"), flatten))
+#define SD_TARGET_AVX512 __attribute__((target("avx512f,avx512vl,avx512bw,avx512dq,avx512cd,avx2,fma"), flatten))
+#else
+#define SD_ISA_DISPATCH 0
+#endif
+
+namespace sd {
+
+class SD_LIB_EXPORT CpuIsa {
+ public:
+  // same numbering as binaryLevel() / optimalLevel() in NativeOps
+  enum Level {
+    GENERIC = 1,
+    AVX2 = 2,
+    AVX512 = 3,
+  };
+
+  /**
+   * Best level supported by this host (including OS support for the wider registers), detected once
+   */
+  static int hostLevel();
+
+  /**
+   * Level hot loops run at: hostLevel() capped by Environment::maxIsaLevel()
+   */
+  static int activeLevel();
+
+  /**
+   * Runs f compiled for activeLevel(). f is expected to be a lambda holding one tight loop: it gets inlined
+   * into a target-specific clone together with everything it calls, so the loop is vectorized for that ISA.
+   * Levels below the build flags of the binary simply end up with the generic code.
+   */
+  template <typename F>
+  static SD_INLINE void dispatch(const F &f) {
+#if SD_ISA_DISPATCH
+    switch (activeLevel()) {
+      case AVX512:
+        runAvx512(f);
+        return;
+      case AVX2:
+        runAvx2(f);
+        return;
+      default:
+        break;
+    }
+#endif
+    f();
+  }
+
+ private:
+#if SD_ISA_DISPATCH
+  template <typename F>
+  SD_TARGET_AVX2 static void runAvx2(const F &f) {
+    f();
+  }
+
+  template <typename F>
+  SD_TARGET_AVX512 static void runAvx512(const F &f) {
+    f();
+  }
+#endif
+};
+
+}  // namespace sd
+
+#endif  // LIBND4J_CPUISA_H
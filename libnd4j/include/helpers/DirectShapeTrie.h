@@ -24,15 +24,39 @@
 #include <array>
 #include <atomic>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <vector>
+#include "./generic/CacheBookkeeping.h"
 #include "./generic/StripedLocks.h"
 namespace sd {
 
 
 
 class SD_LIB_EXPORT ShapeTrieNode {
+ public:
+  struct ChildKey {
+    LongType value;
+    int level;
+    int shapeHash;
+    bool isShape;
+
+    bool operator==(const ChildKey& other) const {
+      return value == other.value && level == other.level && shapeHash == other.shapeHash && isShape == other.isShape;
+    }
+  };
+
+  struct ChildKeyHash {
+    size_t operator()(const ChildKey& key) const {
+      size_t hash = std::hash<LongType>()(key.value);
+      hash = hash * 31 + static_cast<size_t>(key.shapeHash);
+      hash = hash * 13 + static_cast<size_t>(key.level) * 2 + (key.isShape ? 1 : 0);
+      return hash;
+    }
+  };
+
  private:
-  std::vector<ShapeTrieNode*> _children;
+  std::unordered_map<ChildKey, ShapeTrieNode*, ChildKeyHash> _children;
   LongType _value;
   int _level;
   bool _isShape;
@@ -50,8 +74,8 @@ class SD_LIB_EXPORT ShapeTrieNode {
 
   ~ShapeTrieNode() {
     // Delete children
-    for (auto* child : _children) {
-      delete child;
+    for (auto& child : _children) {
+      delete child.second;
     }
     _children.clear();
 
@@ -63,31 +87,26 @@ class SD_LIB_EXPORT ShapeTrieNode {
   }
 
 
-  // Replace the current findOrCreateChild with this more defensive version
   ShapeTrieNode* findOrCreateChild(LongType value, int level, bool isShape, int shapeHash) {
-    // First search for existing child
-    for (auto* child : _children) {
-      if (child != nullptr &&
-          child->value() == value &&
-          child->level() == level &&
-          child->isShape() == isShape &&
-          (shapeHash == 0 || child->shapeHash() == shapeHash)) {
-        return child;
-      }
-    }
+    ChildKey key{value, level, shapeHash, isShape};
+    auto it = _children.find(key);
+    if (it != _children.end()) return it->second;
 
-    // Create new node with standard allocation
     try {
       auto* newNode = new ShapeTrieNode(value, level, isShape, shapeHash);
-      // Add to children using standard vector operations
-      _children.push_back(newNode);
+      _children.emplace(key, newNode);
       return newNode;
     } catch (const std::exception& e) {
       return nullptr;
     }
   }
 
-  const std::vector<ShapeTrieNode*>& children() const { return _children; }
+  const ShapeTrieNode* findChild(LongType value, int level, bool isShape, int shapeHash) const {
+    auto it = _children.find(ChildKey{value, level, shapeHash, isShape});
+    return it != _children.end() ? it->second : nullptr;
+  }
+
+  const std::unordered_map<ChildKey, ShapeTrieNode*, ChildKeyHash>& children() const { return _children; }
   LongType value() const { return _value; }
   int level() const { return _level; }
   bool isShape() const { return _isShape; }
@@ -107,6 +126,8 @@ class SD_LIB_EXPORT DirectShapeTrie {
   std::array<ShapeTrieNode*, NUM_STRIPES> *_roots;
   std::array<MUTEX_TYPE*, NUM_STRIPES> *_mutexes = nullptr;
 
+  generic::CacheBookkeeping _bookkeeping;
+
   // Helper method to create a fallback buffer when trie insertion fails
   // Always returns a valid shape buffer or throws an exception
   ConstantShapeBuffer* createFallbackBuffer(const LongType* shapeInfo, int rank);
@@ -174,6 +195,14 @@ class SD_LIB_EXPORT DirectShapeTrie {
 
   // Calculate a unique shape signature for additional validation
   int calculateShapeSignature(const LongType* shapeInfo) const;
+
+  LongType hits() const { return _bookkeeping.hits(); }
+  LongType misses() const { return _bookkeeping.misses(); }
+  LongType entries() const { return _bookkeeping.entries(); }
+  LongType cachedBytes() const { return _bookkeeping.bytes(); }
+
+ private:
+  const ShapeTrieNode* searchNode(const LongType* shapeInfo, size_t stripeIdx) const;
 };
 
 }  // namespace sd
@@ -24,6 +24,9 @@
 #include <array>
 #include <atomic>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
+#include "./generic/CacheBookkeeping.h"
 #include "./generic/StripedLocks.h"
 
 #include <vector>
@@ -34,8 +37,30 @@ namespace sd {
 #ifndef __JAVACPP_HACK__
 
 class SD_LIB_EXPORT TadTrieNode {
+ public:
+  struct ChildKey {
+    LongType value;
+    int level;
+    int shapeRank;
+    bool isDimension;
+
+    bool operator==(const ChildKey& other) const {
+      return value == other.value && level == other.level && shapeRank == other.shapeRank &&
+             isDimension == other.isDimension;
+    }
+  };
+
+  struct ChildKeyHash {
+    size_t operator()(const ChildKey& key) const {
+      size_t hash = std::hash<LongType>()(key.value);
+      hash = hash * 31 + static_cast<size_t>(key.shapeRank);
+      hash = hash * 13 + static_cast<size_t>(key.level) * 2 + (key.isDimension ? 1 : 0);
+      return hash;
+    }
+  };
+
  private:
-  std::vector<std::unique_ptr<TadTrieNode>> _children;
+  std::unordered_map<ChildKey, std::unique_ptr<TadTrieNode>, ChildKeyHash> _children;
   LongType _value;
   int _level;
   bool _isDimension;
@@ -44,6 +69,7 @@ class SD_LIB_EXPORT TadTrieNode {
   size_t _nodeHash;   // Additional hash for quick comparison
   LongType* _originalStrides; // Store the original strides signature (optional)
   int _stridesLength;  // Length of the strides array
+  std::vector<LongType> _originalShape;  // rank, shape, strides, data type and order of the source array
 
  public:
   TadTrieNode(LongType value = 0, int level = 0, bool isDimension = true, int shapeRank = 0)
@@ -58,32 +84,24 @@ class SD_LIB_EXPORT TadTrieNode {
     }
   }
 
-  // Improved child finding with hash-based optimization
   TadTrieNode* findOrCreateChild(LongType value, int level, bool isDimension, int shapeRank = 0) {
-    // First check using hash-based comparison if available
-    size_t childHash = computeChildHash(value, isDimension, shapeRank);
-
-    for (auto& child : _children) {
-      if (child->_nodeHash == childHash) {
-        // Fast path: hash match, do detailed comparison
-        if (child->value() == value &&
-            child->isDimension() == isDimension &&
-            child->shapeRank() == shapeRank) {
-          return child.get();
-        }
-      }
-    }
+    ChildKey key{value, level, shapeRank, isDimension};
+    auto it = _children.find(key);
+    if (it != _children.end()) return it->second.get();
 
     // Not found, create new child
-#ifndef __JAVACPP_HACK__
     auto newNode = std::make_unique<TadTrieNode>(value, level, isDimension, shapeRank);
-    newNode->_nodeHash = childHash;
+    newNode->_nodeHash = computeChildHash(value, isDimension, shapeRank);
     auto* ptr = newNode.get();
-    _children.push_back(std::move(newNode));
-#endif
+    _children.emplace(key, std::move(newNode));
     return ptr;
   }
 
+  const TadTrieNode* findChild(LongType value, int level, bool isDimension, int shapeRank) const {
+    auto it = _children.find(ChildKey{value, level, shapeRank, isDimension});
+    return it != _children.end() ? it->second.get() : nullptr;
+  }
+
   // Compute hash for faster child comparison
   size_t computeChildHash(LongType value, bool isDimension, int shapeRank) const {
     size_t hash = 17;
@@ -111,8 +129,24 @@ class SD_LIB_EXPORT TadTrieNode {
   }
 
 
+  // Remembers the parts of source shape TAD pack depends on
+  void storeOriginalShape(const LongType* shapeInfo) {
+    int rank = shape::rank(shapeInfo);
+    _originalShape.assign(shapeInfo, shapeInfo + 1 + 2 * rank);
+    _originalShape.push_back(static_cast<LongType>(ArrayOptions::dataType(shapeInfo)));
+    _originalShape.push_back(static_cast<LongType>(shape::order(shapeInfo)));
+  }
+
+  bool matchesOriginalShape(const LongType* shapeInfo) const {
+    int rank = shape::rank(shapeInfo);
+    if (_originalShape.size() != static_cast<size_t>(3 + 2 * rank)) return false;
+    if (!std::equal(shapeInfo, shapeInfo + 1 + 2 * rank, _originalShape.begin())) return false;
+    return _originalShape[1 + 2 * rank] == static_cast<LongType>(ArrayOptions::dataType(shapeInfo)) &&
+           _originalShape[2 + 2 * rank] == static_cast<LongType>(shape::order(shapeInfo));
+  }
+
   // Standard getters
-  const std::vector<std::unique_ptr<TadTrieNode>>& children() const { return _children; }
+  const std::unordered_map<ChildKey, std::unique_ptr<TadTrieNode>, ChildKeyHash>& children() const { return _children; }
   LongType value() const { return _value; }
   int level() const { return _level; }
   bool isDimension() const { return _isDimension; }
@@ -192,6 +226,11 @@ class SD_LIB_EXPORT DirectTadTrie {
   mutable std::array<MUTEX_TYPE, NUM_STRIPES> _mutexes = {};
   std::array<std::atomic<int>, NUM_STRIPES> _stripeCounts = {};
 
+  generic::CacheBookkeeping _bookkeeping;
+
+  const TadTrieNode* searchNode(const std::vector<LongType>& dimensions, LongType* originalShape,
+                                size_t stripeIdx) const;
+
  public:
   // Constructor
   DirectTadTrie() {
@@ -275,10 +314,15 @@ class SD_LIB_EXPORT DirectTadTrie {
   bool exists(const std::vector<LongType>& dimensions, LongType* originalShape) const;
 
   // Original helper methods preserved
-  TadPack* search(const std::vector<LongType>& dimensions, int originalShapeRank, size_t stripeIdx) const;
+  TadPack* search(const std::vector<LongType>& dimensions, LongType* originalShape, size_t stripeIdx) const;
   std::vector<LongType> sortDimensions(const std::vector<LongType>& dimensions) const;
   const TadTrieNode* findChild(const TadTrieNode* node, LongType value, int level, bool isDimension, int shapeRank) const;
   TadPack* insert(std::vector<LongType>& dimensions, LongType* originalShape);
+
+  LongType hits() const { return _bookkeeping.hits(); }
+  LongType misses() const { return _bookkeeping.misses(); }
+  LongType entries() const { return _bookkeeping.entries(); }
+  LongType cachedBytes() const { return _bookkeeping.bytes(); }
 };
 
 }  // namespace sd
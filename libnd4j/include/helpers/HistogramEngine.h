@@ -0,0 +1,150 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Histogram engine used by histogram and histogram_fixed_width: every thread counts its own chunk of input into
+// private 64-bit bins, private bins are then summed pairwise (tree merge), so there are no locks or atomics.
+//
+// Bin indices are computed for a block of values first and only then counted, which keeps the index loop free of
+// memory dependencies, so it vectorises.
+//
+
+#ifndef LIBND4J_HISTOGRAMENGINE_H
+#define LIBND4J_HISTOGRAMENGINE_H
+
+#include <array/NDArray.h>
+#include <execution/Threads.h>
+#include <math/templatemath.h>
+#include <system/op_boilerplate.h>
+
+#include <memory>
+#include <vector>
+
+namespace sd {
+namespace histogram {
+
+// minimal number of input elements per thread
+static constexpr LongType HISTOGRAM_MIN_CHUNK = 1 << 15;
+// upper limit for all private bins together, fewer threads are used for really large number of bins
+static constexpr LongType HISTOGRAM_MAX_PRIVATE_BINS = 1 << 22;
+// bin indices are computed for this many values at once
+static constexpr int HISTOGRAM_BLOCK = 256;
+
+/**
+ * Maps value into bin with equal width bins over [leftEdge, rightEdge), values outside go into the first or the
+ * last bin, and so does NaN (the first one)
+ */
+struct FixedWidthBins {
+  double leftEdge;
+  double binWidth;
+  LongType numBins;
+
+  template <typename X>
+  SD_INLINE LongType operator()(X value) const {
+    double bin = (static_cast<double>(value) - leftEdge) / binWidth;
+    // written this way so NaN lands in the first bin instead of an undefined conversion
+    bin = !(bin > 0.) ? 0. : (bin >= static_cast<double>(numBins) ? static_cast<double>(numBins - 1) : bin);
+    return static_cast<LongType>(bin);
+  }
+};
+
+/**
+ * bins[b] = number of values in dense buffer x for which binOf(value) == b, binOf must return values in
+ * [0, numBins)
+ */
+template <typename X, typename BinOf>
+static void countBins(const X* x, const LongType length, const LongType numBins, const BinOf& binOf, LongType* bins) {
+  const int maxThreads = Environment::getInstance().maxMasterThreads();
+  LongType numChunks = sd::math::sd_min<LongType>(maxThreads, length / HISTOGRAM_MIN_CHUNK);
+  numChunks =
+      sd::math::sd_min<LongType>(numChunks, HISTOGRAM_MAX_PRIVATE_BINS / sd::math::sd_max<LongType>(1, numBins));
+  numChunks = sd::math::sd_max<LongType>(1, numChunks);
+
+  std::vector<LongType> privateBins(numChunks * numBins, 0);
+  const LongType chunkLength = (length + numChunks - 1) / numChunks;
+
+  auto count = PRAGMA_THREADS_FOR {
+    LongType index[HISTOGRAM_BLOCK];
+
+    for (auto c = start; c < stop; c++) {
+      LongType* chunkBins = privateBins.data() + c * numBins;
+      const LongType last = sd::math::sd_min<LongType>(length, (c + 1) * chunkLength);
+
+      for (LongType b = c * chunkLength; b < last; b += HISTOGRAM_BLOCK) {
+        const int blockLength = static_cast<int>(sd::math::sd_min<LongType>(HISTOGRAM_BLOCK, last - b));
+        const X* block = x + b;
+
+        PRAGMA_OMP_SIMD
+        for (int e = 0; e < blockLength; e++) index[e] = binOf(block[e]);
+
+        for (int e = 0; e < blockLength; e++) chunkBins[index[e]]++;
+      }
+    }
+  };
+
+  samediff::Threads::parallel_for(count, 0, numChunks, 1, numChunks);
+
+  // every level adds chunk c + stride into chunk c, after the last one chunk 0 holds the total
+  for (LongType stride = 1; stride < numChunks; stride *= 2) {
+    auto merge = PRAGMA_THREADS_FOR {
+      for (LongType c = 0; c + stride < numChunks; c += 2 * stride) {
+        LongType* dst = privateBins.data() + c * numBins;
+        const LongType* src = privateBins.data() + (c + stride) * numBins;
+
+        PRAGMA_OMP_SIMD
+        for (auto b = start; b < stop; b++) dst[b] += src[b];
+      }
+    };
+
+    samediff::Threads::parallel_for(merge, 0, numBins);
+  }
+
+  for (LongType b = 0; b < numBins; b++) bins[b] = privateBins[b];
+}
+
+/**
+ * Histogram of any input into output of any integer type, input which is not dense 'c' is copied once.
+ * Counts are added to whatever output already holds, callers nullify output first if they need a fresh histogram
+ */
+template <typename X, typename Z, typename BinOf>
+static void histogram(NDArray& input, NDArray& output, const BinOf& binOf) {
+  const LongType numBins = output.lengthOf();
+  if (numBins == 0) return;
+
+  NDArray* x = &input;
+  std::unique_ptr<NDArray> copy;
+  if (input.ordering() != 'c' || !shape::isDense(input.shapeInfo())) {
+    copy.reset(new NDArray(input.dup('c')));
+    x = copy.get();
+  }
+
+  std::vector<LongType> bins(numBins, 0);
+  countBins<X>(x->bufferAsT<X>(), x->lengthOf(), numBins, binOf, bins.data());
+
+  if (output.ordering() == 'c' && shape::isDense(output.shapeInfo())) {
+    auto z = output.bufferAsT<Z>();
+    for (LongType b = 0; b < numBins; b++) z[b] += static_cast<Z>(bins[b]);
+  } else {
+    for (LongType b = 0; b < numBins; b++) output.p<LongType>(b, output.e<LongType>(b) + bins[b]);
+  }
+}
+
+}  // namespace histogram
+}  // namespace sd
+
+#endif  // LIBND4J_HISTOGRAMENGINE_H
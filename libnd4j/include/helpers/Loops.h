@@ -25,6 +25,7 @@
 #include <array/DataTypeUtils.h>
 #include <execution/Threads.h>
 #include <helpers/ConstantTadHelper.h>
+#include <helpers/CpuIsa.h>
 #include <helpers/LoopKind.h>
 #include <helpers/OmpLaunchHelper.h>
 #include <helpers/shape.h>
@@ -954,6 +955,18 @@ SD_LIB_HIDDEN void TransformLoops<X, Z, E>::loopTransform(const X* x,
   const LongType* xStride = shape::stride(const_cast<LongType*>(xShapeInfo));
   const LongType* zStride = shape::stride(const_cast<LongType*>(zShapeInfo));
   const LongType len = shape::length(xShapeInfo);
+
+  // dense arrays sharing shape and strides map linear index i to offset i in both buffers
+  if (shape::haveSameShapeAndStrides(xShapeInfo, zShapeInfo) && shape::isDense(xShapeInfo)) {
+    auto span = samediff::Span::build(threadId, numThreads, 0, len, 1);
+    const auto start = span.startX();
+    const auto stop = span.stopX();
+    CpuIsa::dispatch([&]() {
+      for (auto i = start; i < stop; i++) z[i] = static_cast<Z>(OpType::op(x[i], extraParams));
+    });
+    return;
+  }
+
   switch (kindOfLoop) {
     //*********************************************//
     default: {
@@ -32,6 +32,10 @@
 #include <legacy/NativeOpExecutioner.h>
 
 namespace sd {
+
+/**
+ * Single benchmarked operation. Benchmark doesn't own arrays it's given: BenchmarkHelper takes care of them.
+ */
 class SD_LIB_EXPORT OpBenchmark {
  protected:
   int _opNum = 0;
@@ -39,10 +43,11 @@ class SD_LIB_EXPORT OpBenchmark {
   NDArray *_x = nullptr;
   NDArray *_y = nullptr;
   NDArray *_z = nullptr;
-  std::vector<LongType> *_axis;
+  std::vector<LongType> _axis;
 
  public:
   OpBenchmark() = default;
+  virtual ~OpBenchmark() = default;
   OpBenchmark(std::string name, NDArray *x, NDArray *y, NDArray *z);
   OpBenchmark(std::string name, NDArray *x, NDArray *z);
   OpBenchmark(std::string name, NDArray *x, NDArray *z, std::initializer_list<LongType> *axis);
@@ -65,11 +70,11 @@ class SD_LIB_EXPORT OpBenchmark {
 
   virtual std::string extra();
   virtual std::string dataType();
-  virtual std::string axis() = 0;
-  virtual std::string orders() = 0;
-  virtual std::string strides() = 0;
+  virtual std::string axis();
+  virtual std::string orders();
+  virtual std::string strides();
   virtual std::string shape();
-  virtual std::string inplace() = 0;
+  virtual std::string inplace();
 
   virtual void executeOnce() = 0;
 
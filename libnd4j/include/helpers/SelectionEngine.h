@@ -0,0 +1,172 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Selection engine used by top_k, in_top_k, nth_element and percentile. Every row is a (possibly strided) vector
+// along the last dimension, rows are processed in parallel and never sorted as a whole.
+//
+// Values are ranked in descending order, NaN ranks above any number and equal values rank by position, so results
+// are deterministic. Small k keeps a bounded heap of the k best entries seen so far, most values are rejected by a
+// single comparison against its top. Large k selects with introselect (std::nth_element) and sorts only the k
+// selected entries. Order statistics (nth_element, percentile) partition a copy of the row only as far as needed to
+// put every requested rank in place.
+//
+
+#ifndef LIBND4J_SELECTIONENGINE_H
+#define LIBND4J_SELECTIONENGINE_H
+
+#include <math/templatemath.h>
+#include <system/common.h>
+#include <system/op_boilerplate.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace sd {
+namespace selection {
+
+// bounded heap is used while k * SELECTION_HEAP_RATIO <= width, introselect otherwise
+static constexpr LongType SELECTION_HEAP_RATIO = 16;
+
+template <typename T>
+struct Entry {
+  T value;
+  LongType index;
+};
+
+/**
+ * true if (a, ia) ranks strictly before (b, ib) in descending order
+ */
+template <typename T>
+SD_INLINE bool ranksBefore(const T a, const LongType ia, const T b, const LongType ib) {
+  const bool nanA = sd::math::sd_isnan<T>(a);
+  const bool nanB = sd::math::sd_isnan<T>(b);
+  if (nanA != nanB) return nanA;
+  if (!nanA && a != b) return b < a;
+  return ia < ib;
+}
+
+template <typename T>
+SD_INLINE bool entryBefore(const Entry<T>& a, const Entry<T>& b) {
+  return ranksBefore<T>(a.value, a.index, b.value, b.index);
+}
+
+template <typename T>
+SD_INLINE bool indexBefore(const Entry<T>& a, const Entry<T>& b) {
+  return a.index < b.index;
+}
+
+/**
+ * Selects k best entries of row x[0, stride, ..., (width - 1) * stride] into top[0, k), ordered by rank when
+ * sortByValue is true and by position otherwise. scratch is reused between rows of the same thread.
+ */
+template <typename T>
+static void topK(const T* x, const LongType width, const LongType stride, const LongType k, const bool sortByValue,
+                 Entry<T>* top, std::vector<Entry<T>>& scratch) {
+  if (k == 1) {
+    Entry<T> best = {x[0], 0};
+    for (LongType i = 1; i < width; i++)
+      if (ranksBefore<T>(x[i * stride], i, best.value, best.index)) best = {x[i * stride], i};
+    top[0] = best;
+    return;
+  }
+
+  if (k * SELECTION_HEAP_RATIO <= width) {
+    // heap front is the worst of the entries kept so far
+    scratch.resize(k);
+    for (LongType i = 0; i < k; i++) scratch[i] = {x[i * stride], i};
+    std::make_heap(scratch.begin(), scratch.end(), entryBefore<T>);
+
+    for (LongType i = k; i < width; i++) {
+      const T value = x[i * stride];
+      if (!ranksBefore<T>(value, i, scratch.front().value, scratch.front().index)) continue;
+
+      std::pop_heap(scratch.begin(), scratch.end(), entryBefore<T>);
+      scratch.back() = {value, i};
+      std::push_heap(scratch.begin(), scratch.end(), entryBefore<T>);
+    }
+  } else {
+    scratch.resize(width);
+    for (LongType i = 0; i < width; i++) scratch[i] = {x[i * stride], i};
+    if (k < width) std::nth_element(scratch.begin(), scratch.begin() + k, scratch.end(), entryBefore<T>);
+  }
+
+  std::sort(scratch.begin(), scratch.begin() + k, sortByValue ? entryBefore<T> : indexBefore<T>);
+  std::copy(scratch.begin(), scratch.begin() + k, top);
+}
+
+/**
+ * true if x[target] is among k best values of the row, values equal to x[target] do not push it out, so ties on
+ * the boundary are all counted in. NaN target or target outside of the row is never in top k.
+ */
+template <typename T>
+static bool inTopK(const T* x, const LongType width, const LongType stride, const LongType target, const LongType k) {
+  if (target < 0 || target >= width) return false;
+
+  const T value = x[target * stride];
+  if (sd::math::sd_isnan<T>(value)) return false;
+
+  LongType better = 0;
+  for (LongType i = 0; i < width && better < k; i++) {
+    const T other = x[i * stride];
+    if (sd::math::sd_isnan<T>(other) || value < other) better++;
+  }
+
+  return better < k;
+}
+
+template <typename T>
+SD_INLINE bool valueBefore(const T a, const T b) {
+  return ranksBefore<T>(b, 0, a, 0);
+}
+
+/**
+ * Partially orders x[lo, hi) so that x[r] is the value of rank r in ascending order (NaN after numbers) for every r
+ * in ranks[0, numRanks), ranks must be sorted, unique and within [lo, hi). Every selection partitions only the part
+ * between neighbouring ranks, so several ranks cost little more than one.
+ */
+template <typename T>
+static void selectRanks(T* x, const LongType lo, const LongType hi, const LongType* ranks, const LongType numRanks) {
+  if (numRanks <= 0) return;
+
+  const LongType middle = numRanks / 2;
+  const LongType rank = ranks[middle];
+  std::nth_element(x + lo, x + rank, x + hi, valueBefore<T>);
+
+  selectRanks<T>(x, lo, rank, ranks, middle);
+  selectRanks<T>(x, rank + 1, hi, ranks + middle + 1, numRanks - middle - 1);
+}
+
+/**
+ * n-th value of the row in ascending order (descending if reverse), NaN goes after numbers in ascending order
+ */
+template <typename T>
+static T nthElement(const T* x, const LongType width, const LongType stride, const LongType n, const bool reverse,
+                    std::vector<T>& scratch) {
+  scratch.resize(width);
+  for (LongType i = 0; i < width; i++) scratch[i] = x[i * stride];
+
+  const LongType rank = reverse ? width - 1 - n : n;
+  selectRanks<T>(scratch.data(), 0, width, &rank, 1);
+  return scratch[rank];
+}
+
+}  // namespace selection
+}  // namespace sd
+
+#endif  // LIBND4J_SELECTIONENGINE_H
@@ -0,0 +1,410 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Sorting engine used by SpecialMethods/DoubleMethods: 64-bit indexing, parallel LSD radix sort and parallel
+// merge sort, both stable.
+//
+// Keys are first encoded into unsigned integers of the same width, whose natural order matches order of the
+// original values (sign bit flipped for signed integers, all bits flipped for negative floats), and inverted
+// for descending sorts. After that every sort works on plain unsigned integers.
+//
+
+#ifndef LIBND4J_SORTENGINE_H
+#define LIBND4J_SORTENGINE_H
+
+#include <array/NDArray.h>
+#include <execution/Threads.h>
+#include <helpers/shape.h>
+#include <math/templatemath.h>
+#include <system/op_boilerplate.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace sd {
+namespace sorting {
+
+// arrays shorter than this are sorted with std::stable_sort
+static constexpr LongType SORT_SMALL_ARRAY = 256;
+// radix sort is used for 8-byte keys only starting from this length, below it merge sort does fewer passes
+static constexpr LongType SORT_RADIX_WIDE_KEYS = 1 << 16;
+// minimal number of elements per thread
+static constexpr LongType SORT_MIN_CHUNK = 1 << 14;
+
+template <int BYTES>
+struct KeyBitsOf;
+template <>
+struct KeyBitsOf<1> {
+  using type = uint8_t;
+};
+template <>
+struct KeyBitsOf<2> {
+  using type = uint16_t;
+};
+template <>
+struct KeyBitsOf<4> {
+  using type = uint32_t;
+};
+template <>
+struct KeyBitsOf<8> {
+  using type = uint64_t;
+};
+
+/**
+ * Order-preserving mapping of T into unsigned integer of the same width
+ */
+template <typename T>
+struct RadixKey {
+  using Bits = typename KeyBitsOf<sizeof(T)>::type;
+
+  static constexpr bool isFloat = !std::is_integral<T>::value;
+  static constexpr bool isSigned = std::is_integral<T>::value && std::is_signed<T>::value;
+  static constexpr Bits SIGN = static_cast<Bits>(Bits(1) << (sizeof(T) * 8 - 1));
+
+  static SD_INLINE Bits encode(T value, bool descending) {
+    Bits bits;
+    std::memcpy(&bits, &value, sizeof(T));
+
+    if (isFloat)
+      bits = (bits & SIGN) ? static_cast<Bits>(~bits) : static_cast<Bits>(bits | SIGN);
+    else if (isSigned)
+      bits = static_cast<Bits>(bits ^ SIGN);
+
+    return descending ? static_cast<Bits>(~bits) : bits;
+  }
+
+  static SD_INLINE T decode(Bits bits, bool descending) {
+    if (descending) bits = static_cast<Bits>(~bits);
+
+    if (isFloat)
+      bits = (bits & SIGN) ? static_cast<Bits>(bits & ~SIGN) : static_cast<Bits>(~bits);
+    else if (isSigned)
+      bits = static_cast<Bits>(bits ^ SIGN);
+
+    T value;
+    std::memcpy(&value, &bits, sizeof(T));
+    return value;
+  }
+};
+
+/**
+ * Key together with its payload, for sorting by key
+ */
+template <typename K, typename V>
+struct KeyValue {
+  K key;
+  V value;
+};
+
+template <typename Bits>
+static SD_INLINE Bits keyOf(const Bits &item) {
+  return item;
+}
+
+template <typename Bits, typename V>
+static SD_INLINE Bits keyOf(const KeyValue<Bits, V> &item) {
+  return item.key;
+}
+
+template <typename Item>
+static SD_INLINE bool lessByKey(const Item &a, const Item &b) {
+  return keyOf(a) < keyOf(b);
+}
+
+static SD_INLINE LongType chunkStart(LongType n, LongType numChunks, LongType chunk) {
+  // n * chunk might not fit into 64 bits for really huge arrays only, so plain arithmetic is fine here
+  return n / numChunks * chunk + sd::math::sd_min<LongType>(chunk, n % numChunks);
+}
+
+/**
+ * Stable LSD radix sort over 8-bit digits. Each pass computes per-chunk histograms in parallel, then every
+ * chunk scatters its elements into its own precomputed slots, which keeps the order stable.
+ * Passes where all keys share the same digit are skipped.
+ *
+ * @return pointer to the buffer (src or dst) holding sorted data
+ */
+template <typename Item>
+static Item *radixSort(Item *src, Item *dst, LongType n, int keyBytes, int numThreads) {
+  const LongType numChunks =
+      sd::math::sd_max<LongType>(1, sd::math::sd_min<LongType>(numThreads, n / SORT_MIN_CHUNK));
+  std::vector<LongType> counts(numChunks * 256);
+
+  for (int pass = 0; pass < keyBytes; pass++) {
+    const int shift = pass * 8;
+
+    auto histogram = PRAGMA_THREADS_FOR {
+      for (auto c = start; c < stop; c++) {
+        auto h = counts.data() + c * 256;
+        std::fill(h, h + 256, 0);
+
+        const auto last = chunkStart(n, numChunks, c + 1);
+        for (auto i = chunkStart(n, numChunks, c); i < last; i++) h[(keyOf(src[i]) >> shift) & 0xFF]++;
+      }
+    };
+    samediff::Threads::parallel_tad(histogram, 0, numChunks, 1, numChunks);
+
+    // turning counts into starting positions, digit-major, so chunk order is preserved within each digit
+    bool trivial = false;
+    LongType sum = 0;
+    for (int d = 0; d < 256 && !trivial; d++) {
+      LongType digitTotal = 0;
+      for (LongType c = 0; c < numChunks; c++) {
+        auto t = counts[c * 256 + d];
+        counts[c * 256 + d] = sum;
+        sum += t;
+        digitTotal += t;
+      }
+
+      trivial = digitTotal == n;
+    }
+
+    if (trivial) continue;
+
+    auto scatter = PRAGMA_THREADS_FOR {
+      for (auto c = start; c < stop; c++) {
+        auto h = counts.data() + c * 256;
+
+        const auto last = chunkStart(n, numChunks, c + 1);
+        for (auto i = chunkStart(n, numChunks, c); i < last; i++) dst[h[(keyOf(src[i]) >> shift) & 0xFF]++] = src[i];
+      }
+    };
+    samediff::Threads::parallel_tad(scatter, 0, numChunks, 1, numChunks);
+
+    std::swap(src, dst);
+  }
+
+  return src;
+}
+
+/**
+ * Number of elements of a that get into first d elements of stable merge of a and b
+ */
+template <typename Item>
+static LongType coRank(LongType d, const Item *a, LongType na, const Item *b, LongType nb) {
+  LongType lo = sd::math::sd_max<LongType>(0, d - nb);
+  LongType hi = sd::math::sd_min<LongType>(d, na);
+
+  while (lo < hi) {
+    const LongType i = lo + (hi - lo) / 2;
+    const LongType j = d - i;
+
+    // ties go to a, so a[i] precedes b[j - 1] unless it's strictly greater
+    if (j > 0 && !lessByKey(b[j - 1], a[i]))
+      lo = i + 1;
+    else
+      hi = i;
+  }
+
+  return lo;
+}
+
+/**
+ * Stable parallel merge sort: runs are sorted independently, then merged pairwise. Each merge is split into
+ * equal parts along the output (merge path), so the last rounds keep all threads busy as well.
+ *
+ * @return pointer to the buffer (src or dst) holding sorted data
+ */
+template <typename Item>
+static Item *mergeSort(Item *src, Item *dst, LongType n, int numThreads) {
+  const LongType numRuns = sd::math::sd_max<LongType>(1, sd::math::sd_min<LongType>(numThreads, n / SORT_MIN_CHUNK));
+
+  std::vector<LongType> bounds(numRuns + 1);
+  for (LongType r = 0; r <= numRuns; r++) bounds[r] = chunkStart(n, numRuns, r);
+
+  auto sortRuns = PRAGMA_THREADS_FOR {
+    for (auto r = start; r < stop; r++) std::stable_sort(src + bounds[r], src + bounds[r + 1], lessByKey<Item>);
+  };
+  samediff::Threads::parallel_tad(sortRuns, 0, numRuns, 1, numRuns);
+
+  while (bounds.size() > 2) {
+    const LongType runs = bounds.size() - 1;
+    const LongType merges = runs / 2;
+    const LongType tails = runs % 2;
+    const LongType parts = sd::math::sd_max<LongType>(1, numThreads / merges);
+
+    auto merge = PRAGMA_THREADS_FOR {
+      for (auto t = start; t < stop; t++) {
+        const auto m = t / parts;
+        const auto p = t % parts;
+
+        // odd run has no pair in this round
+        if (m == merges) {
+          if (p == 0) std::copy(src + bounds[runs - 1], src + n, dst + bounds[runs - 1]);
+          continue;
+        }
+
+        const auto lo = bounds[2 * m];
+        const auto mid = bounds[2 * m + 1];
+        const auto hi = bounds[2 * m + 2];
+        const auto na = mid - lo;
+        const auto nb = hi - mid;
+        const auto total = na + nb;
+
+        const auto dStart = total / parts * p + sd::math::sd_min<LongType>(p, total % parts);
+        const auto dStop = total / parts * (p + 1) + sd::math::sd_min<LongType>(p + 1, total % parts);
+        const auto iStart = coRank(dStart, src + lo, na, src + mid, nb);
+        const auto iStop = coRank(dStop, src + lo, na, src + mid, nb);
+
+        std::merge(src + lo + iStart, src + lo + iStop, src + mid + (dStart - iStart), src + mid + (dStop - iStop),
+                   dst + lo + dStart, lessByKey<Item>);
+      }
+    };
+    samediff::Threads::parallel_tad(merge, 0, (merges + tails) * parts, 1, numThreads);
+
+    std::vector<LongType> next;
+    for (LongType m = 0; m < merges; m++) next.emplace_back(bounds[2 * m]);
+    if (tails > 0) next.emplace_back(bounds[runs - 1]);
+    next.emplace_back(n);
+
+    bounds.swap(next);
+    std::swap(src, dst);
+  }
+
+  return src;
+}
+
+/**
+ * Sorts items by their encoded keys, picking the algorithm by array length and key width
+ *
+ * @return pointer to the buffer (items or aux) holding sorted data
+ */
+template <typename Item>
+static Item *sortItems(Item *items, Item *aux, LongType n, int keyBytes, int numThreads) {
+  if (n <= SORT_SMALL_ARRAY) {
+    std::stable_sort(items, items + n, lessByKey<Item>);
+    return items;
+  }
+
+  if (keyBytes <= 4 || n >= SORT_RADIX_WIDE_KEYS) return radixSort(items, aux, n, keyBytes, numThreads);
+
+  return mergeSort(items, aux, n, numThreads);
+}
+
+/**
+ * Maps logical ('c' order) index of an element into its offset within array buffer
+ */
+class ElementOffsets {
+ private:
+  const LongType *_shapeInfo;
+  LongType _ews;
+
+ public:
+  explicit ElementOffsets(NDArray *array) {
+    _shapeInfo = array->shapeInfo();
+    _ews = array->ordering() == 'c' || array->rankOf() <= 1 ? array->ews() : 0;
+  }
+
+  SD_INLINE LongType operator()(LongType index) const {
+    if (_ews > 0) return index * _ews;
+
+    LongType coords[SD_MAX_RANK];
+    LongType offset;
+    INDEX2COORDS(index, shape::rank(_shapeInfo), shape::shapeOf(_shapeInfo), coords);
+    COORDS2INDEX(shape::rank(_shapeInfo), shape::stride(_shapeInfo), coords, offset);
+    return offset;
+  }
+};
+
+/**
+ * Sorts all elements of the array, in logical order
+ */
+template <typename T>
+static void sortArray(NDArray *array, bool descending, int numThreads) {
+  using Bits = typename RadixKey<T>::Bits;
+
+  const LongType n = array->lengthOf();
+  if (n < 2) return;
+
+  auto buffer = array->bufferAsT<T>();
+  ElementOffsets offsets(array);
+
+  std::vector<Bits> items(n), aux(n);
+
+  auto gather = PRAGMA_THREADS_FOR {
+    for (auto i = start; i < stop; i++) items[i] = RadixKey<T>::encode(buffer[offsets(i)], descending);
+  };
+  samediff::Threads::parallel_for(gather, 0, n, 1, numThreads);
+
+  auto sorted = sortItems(items.data(), aux.data(), n, sizeof(T), numThreads);
+
+  auto scatter = PRAGMA_THREADS_FOR {
+    for (auto i = start; i < stop; i++) buffer[offsets(i)] = RadixKey<T>::decode(sorted[i], descending);
+  };
+  samediff::Threads::parallel_for(scatter, 0, n, 1, numThreads);
+}
+
+/**
+ * Sorts keys array, and applies the same permutation to values array. Both arrays must have the same length
+ */
+template <typename K, typename V>
+static void sortArrayByKey(NDArray *keys, NDArray *values, bool descending, int numThreads) {
+  using Bits = typename RadixKey<K>::Bits;
+  using Item = KeyValue<Bits, V>;
+
+  const LongType n = keys->lengthOf();
+  if (n < 2) return;
+
+  auto kBuffer = keys->bufferAsT<K>();
+  auto vBuffer = values->bufferAsT<V>();
+  ElementOffsets kOffsets(keys);
+  ElementOffsets vOffsets(values);
+
+  std::vector<Item> items(n), aux(n);
+
+  auto gather = PRAGMA_THREADS_FOR {
+    for (auto i = start; i < stop; i++) {
+      items[i].key = RadixKey<K>::encode(kBuffer[kOffsets(i)], descending);
+      items[i].value = vBuffer[vOffsets(i)];
+    }
+  };
+  samediff::Threads::parallel_for(gather, 0, n, 1, numThreads);
+
+  auto sorted = sortItems(items.data(), aux.data(), n, sizeof(K), numThreads);
+
+  auto scatter = PRAGMA_THREADS_FOR {
+    for (auto i = start; i < stop; i++) {
+      kBuffer[kOffsets(i)] = RadixKey<K>::decode(sorted[i].key, descending);
+      vBuffer[vOffsets(i)] = sorted[i].value;
+    }
+  };
+  samediff::Threads::parallel_for(scatter, 0, n, 1, numThreads);
+}
+
+/**
+ * Calls func(tadIndex, threadsPerTad) for every TAD: many short TADs are sorted one per thread,
+ * and few long ones get threads of their own
+ */
+template <typename F>
+static void forEachTad(LongType numTads, F func) {
+  const int maxThreads = Environment::getInstance().maxMasterThreads();
+  const int threadsPerTad = sd::math::sd_max<int>(1, maxThreads / sd::math::sd_max<LongType>(1, numTads));
+
+  auto tads = PRAGMA_THREADS_FOR {
+    for (auto r = start; r < stop; r++) func(r, threadsPerTad);
+  };
+  samediff::Threads::parallel_tad(tads, 0, numTads, 1, sd::math::sd_min<LongType>(numTads, maxThreads));
+}
+
+}  // namespace sorting
+}  // namespace sd
+
+#endif  // LIBND4J_SORTENGINE_H
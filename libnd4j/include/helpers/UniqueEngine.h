@@ -0,0 +1,343 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Hash based deduplication used by unique, unique_with_counts and listdiff.
+//
+// Values are hashed by their bit pattern, with -0.0 folded into 0.0 so that equal values under == always share
+// a key. NaN is never equal to anything, so every NaN is a unique value of its own, as it was with linear search.
+//
+// Short inputs go through a single open addressing table. Long inputs are partitioned by the top bits of the hash,
+// every partition is deduplicated by its own thread, and partitions are merged back into order of first occurrence
+// with a prefix sum over input positions.
+//
+
+#ifndef LIBND4J_UNIQUEENGINE_H
+#define LIBND4J_UNIQUEENGINE_H
+
+#include <execution/Threads.h>
+#include <helpers/SortEngine.h>
+#include <math/templatemath.h>
+#include <system/op_boilerplate.h>
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace sd {
+namespace dedup {
+
+// inputs shorter than this are deduplicated by a single thread
+static constexpr LongType UNIQUE_PARALLEL_LENGTH = 1 << 18;
+// minimal number of input elements per thread
+static constexpr LongType UNIQUE_MIN_CHUNK = 1 << 15;
+// initial table capacity is capped, tables grow with number of distinct values instead of input length
+static constexpr LongType UNIQUE_INITIAL_CAPACITY = 1 << 12;
+
+static SD_INLINE uint64_t mixBits(uint64_t h) {
+  // finalizer of MurmurHash3, spreads every input bit over the whole word
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+/**
+ * Bit pattern of T used as hash key
+ */
+template <typename T>
+struct HashKey {
+  using Bits = typename sorting::KeyBitsOf<sizeof(T)>::type;
+
+  static constexpr bool isFloat = !std::is_integral<T>::value;
+
+  static SD_INLINE bool isNaN(T value) { return isFloat && value != value; }
+
+  static SD_INLINE Bits encode(T value) {
+    if (isFloat && value == static_cast<T>(0)) value = static_cast<T>(0);
+
+    Bits bits;
+    std::memcpy(&bits, &value, sizeof(T));
+    return bits;
+  }
+
+  static SD_INLINE uint64_t hash(Bits bits) { return mixBits(static_cast<uint64_t>(bits)); }
+};
+
+/**
+ * Open addressing table with linear probing, maps keys to dense ids given on insertion
+ */
+template <typename Bits>
+class HashTable {
+ public:
+  explicit HashTable(LongType expected) {
+    LongType capacity = 16;
+    while (capacity < 2 * sd::math::sd_min<LongType>(expected, UNIQUE_INITIAL_CAPACITY)) capacity *= 2;
+    reset(capacity);
+  }
+
+  /**
+   * returns id of key, key is inserted with id newId when absent
+   */
+  SD_INLINE LongType findOrInsert(Bits key, uint64_t hash, LongType newId) {
+    auto slot = hash & _mask;
+    while (_ids[slot] >= 0) {
+      if (_keys[slot] == key) return _ids[slot];
+      slot = (slot + 1) & _mask;
+    }
+
+    _keys[slot] = key;
+    _ids[slot] = newId;
+    if (++_size * 2 > static_cast<LongType>(_ids.size())) grow();
+
+    return newId;
+  }
+
+  /**
+   * returns id of key, or -1 when absent
+   */
+  SD_INLINE LongType find(Bits key, uint64_t hash) const {
+    auto slot = hash & _mask;
+    while (_ids[slot] >= 0) {
+      if (_keys[slot] == key) return _ids[slot];
+      slot = (slot + 1) & _mask;
+    }
+    return -1;
+  }
+
+ private:
+  void reset(LongType capacity) {
+    _keys.assign(capacity, Bits(0));
+    _ids.assign(capacity, -1);
+    _mask = static_cast<uint64_t>(capacity - 1);
+    _size = 0;
+  }
+
+  void grow() {
+    auto keys = std::move(_keys);
+    auto ids = std::move(_ids);
+    reset(static_cast<LongType>(ids.size()) * 2);
+
+    for (size_t e = 0; e < ids.size(); e++) {
+      if (ids[e] < 0) continue;
+      auto slot = mixBits(static_cast<uint64_t>(keys[e])) & _mask;
+      while (_ids[slot] >= 0) slot = (slot + 1) & _mask;
+      _keys[slot] = keys[e];
+      _ids[slot] = ids[e];
+      _size++;
+    }
+  }
+
+  std::vector<Bits> _keys;
+  std::vector<LongType> _ids;
+  uint64_t _mask = 0;
+  LongType _size = 0;
+};
+
+/**
+ * Deduplicates x[position(i)] for i in [0, length) in this order: ids[position(i)] gets id of the value, and
+ * firsts/counts get position of the first occurrence and number of occurrences of every new value
+ */
+template <typename T, typename Position>
+static void deduplicate(const T* x, LongType length, Position position, LongType* ids, std::vector<LongType>& firsts,
+                        std::vector<LongType>& counts) {
+  using Key = HashKey<T>;
+  HashTable<typename Key::Bits> table(length);
+
+  for (LongType i = 0; i < length; i++) {
+    const auto e = position(i);
+    const T value = x[e];
+    const auto newId = static_cast<LongType>(firsts.size());
+
+    LongType id = newId;
+    if (!Key::isNaN(value)) {
+      const auto bits = Key::encode(value);
+      id = table.findOrInsert(bits, Key::hash(bits), newId);
+    }
+
+    if (id == newId) {
+      firsts.push_back(e);
+      counts.push_back(1);
+    } else {
+      counts[id]++;
+    }
+    ids[e] = id;
+  }
+}
+
+/**
+ * Distinct values of dense buffer x in order of first occurrence
+ *
+ * @param ids    optional, ids[e] is number of x[e] in the list of distinct values
+ * @param firsts position of first occurrence of every distinct value, increasing
+ * @param counts number of occurrences of every distinct value
+ */
+template <typename T>
+static void uniqueOf(const T* x, const LongType length, LongType* ids, std::vector<LongType>& firsts,
+                     std::vector<LongType>& counts) {
+  using Key = HashKey<T>;
+
+  firsts.clear();
+  counts.clear();
+
+  std::vector<LongType> ownIds;
+  if (ids == nullptr) {
+    ownIds.resize(length);
+    ids = ownIds.data();
+  }
+
+  const int maxThreads = Environment::getInstance().maxMasterThreads();
+  const LongType numChunks = sd::math::sd_min<LongType>(maxThreads, length / UNIQUE_MIN_CHUNK);
+
+  if (length < UNIQUE_PARALLEL_LENGTH || numChunks < 2) {
+    deduplicate(x, length, [](LongType i) { return i; }, ids, firsts, counts);
+    return;
+  }
+
+  int partitionBits = 1;
+  while ((LongType(1) << partitionBits) < 2 * numChunks) partitionBits++;
+  const LongType numPartitions = LongType(1) << partitionBits;
+
+  const auto partitionOf = [partitionBits](T value) -> LongType {
+    return static_cast<LongType>(Key::hash(Key::encode(value)) >> (64 - partitionBits));
+  };
+
+  // 1. stable scatter of input positions by partition, positions stay increasing within every partition
+  std::vector<LongType> offsets(numChunks * numPartitions, 0);
+  auto countPartitions = PRAGMA_THREADS_FOR {
+    for (auto c = start; c < stop; c++) {
+      LongType* chunkOffsets = offsets.data() + c * numPartitions;
+      const auto last = sorting::chunkStart(length, numChunks, c + 1);
+      for (auto e = sorting::chunkStart(length, numChunks, c); e < last; e++) chunkOffsets[partitionOf(x[e])]++;
+    }
+  };
+  samediff::Threads::parallel_for(countPartitions, 0, numChunks, 1, numChunks);
+
+  std::vector<LongType> partitionStart(numPartitions + 1, 0);
+  LongType total = 0;
+  for (LongType p = 0; p < numPartitions; p++) {
+    partitionStart[p] = total;
+    for (LongType c = 0; c < numChunks; c++) {
+      const auto cnt = offsets[c * numPartitions + p];
+      offsets[c * numPartitions + p] = total;
+      total += cnt;
+    }
+  }
+  partitionStart[numPartitions] = total;
+
+  std::vector<LongType> order(length);
+  auto scatter = PRAGMA_THREADS_FOR {
+    for (auto c = start; c < stop; c++) {
+      LongType* chunkOffsets = offsets.data() + c * numPartitions;
+      const auto last = sorting::chunkStart(length, numChunks, c + 1);
+      for (auto e = sorting::chunkStart(length, numChunks, c); e < last; e++)
+        order[chunkOffsets[partitionOf(x[e])]++] = e;
+    }
+  };
+  samediff::Threads::parallel_for(scatter, 0, numChunks, 1, numChunks);
+
+  // 2. every partition is deduplicated on its own, ids are local to partition for now
+  std::vector<std::vector<LongType>> partFirsts(numPartitions);
+  std::vector<std::vector<LongType>> partCounts(numPartitions);
+  auto dedupPartitions = PRAGMA_THREADS_FOR {
+    for (auto p = start; p < stop; p++) {
+      const LongType* partOrder = order.data() + partitionStart[p];
+      deduplicate(x, partitionStart[p + 1] - partitionStart[p], [partOrder](LongType i) { return partOrder[i]; },
+                  ids, partFirsts[p], partCounts[p]);
+    }
+  };
+  samediff::Threads::parallel_tad(dedupPartitions, 0, numPartitions);
+
+  // 3. global id of every distinct value is number of first occurrences before it
+  std::vector<std::vector<LongType>> globalIds(numPartitions);
+  for (LongType p = 0; p < numPartitions; p++) globalIds[p].resize(partFirsts[p].size());
+
+  std::vector<uint8_t> isFirst(length, 0);
+  for (LongType p = 0; p < numPartitions; p++)
+    for (auto e : partFirsts[p]) isFirst[e] = 1;
+
+  std::vector<LongType> chunkFirsts(numChunks + 1, 0);
+  auto countFirsts = PRAGMA_THREADS_FOR {
+    for (auto c = start; c < stop; c++) {
+      LongType cnt = 0;
+      const auto last = sorting::chunkStart(length, numChunks, c + 1);
+      for (auto e = sorting::chunkStart(length, numChunks, c); e < last; e++) cnt += isFirst[e];
+      chunkFirsts[c + 1] = cnt;
+    }
+  };
+  samediff::Threads::parallel_for(countFirsts, 0, numChunks, 1, numChunks);
+  for (LongType c = 0; c < numChunks; c++) chunkFirsts[c + 1] += chunkFirsts[c];
+
+  const LongType numUnique = chunkFirsts[numChunks];
+  firsts.resize(numUnique);
+  counts.resize(numUnique);
+
+  auto rankFirsts = PRAGMA_THREADS_FOR {
+    for (auto c = start; c < stop; c++) {
+      LongType rank = chunkFirsts[c];
+      const auto last = sorting::chunkStart(length, numChunks, c + 1);
+      for (auto e = sorting::chunkStart(length, numChunks, c); e < last; e++) {
+        if (!isFirst[e]) continue;
+        const auto p = partitionOf(x[e]);
+        globalIds[p][ids[e]] = rank;
+        firsts[rank] = e;
+        counts[rank] = partCounts[p][ids[e]];
+        rank++;
+      }
+    }
+  };
+  samediff::Threads::parallel_for(rankFirsts, 0, numChunks, 1, numChunks);
+
+  auto remap = PRAGMA_THREADS_FOR {
+    for (auto e = start; e < stop; e++) ids[e] = globalIds[partitionOf(x[e])][ids[e]];
+  };
+  samediff::Threads::parallel_for(remap, 0, length);
+}
+
+/**
+ * Set of values of dense buffer, for membership tests
+ */
+template <typename T>
+class HashSet {
+ public:
+  HashSet(const T* x, LongType length) : _table(length) {
+    for (LongType e = 0; e < length; e++) {
+      if (Key::isNaN(x[e])) continue;
+      const auto bits = Key::encode(x[e]);
+      _table.findOrInsert(bits, Key::hash(bits), 0);
+    }
+  }
+
+  SD_INLINE bool contains(T value) const {
+    if (Key::isNaN(value)) return false;
+    const auto bits = Key::encode(value);
+    return _table.find(bits, Key::hash(bits)) >= 0;
+  }
+
+ private:
+  using Key = HashKey<T>;
+  HashTable<typename Key::Bits> _table;
+};
+
+}  // namespace dedup
+}  // namespace sd
+
+#endif  // LIBND4J_UNIQUEENGINE_H
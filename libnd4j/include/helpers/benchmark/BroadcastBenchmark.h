@@ -0,0 +1,55 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+
+#ifndef LIBND4J_BROADCASTBENCHMARK_H
+#define LIBND4J_BROADCASTBENCHMARK_H
+#include <helpers/OpBenchmark.h>
+
+namespace sd {
+
+/**
+ * Broadcast of y along given axis of x
+ */
+class SD_LIB_EXPORT BroadcastBenchmark : public OpBenchmark {
+ public:
+  BroadcastBenchmark() : OpBenchmark() {}
+
+  BroadcastBenchmark(broadcast::Ops op, const std::string &testName, const std::vector<LongType> &axis)
+      : OpBenchmark() {
+    _opNum = (int)op;
+    _testName = testName;
+    _axis = axis;
+  }
+
+  void executeOnce() override { _x->applyBroadcast((broadcast::Ops)_opNum, &_axis, _y, _z); }
+
+  OpBenchmark *clone() override {
+    auto result = new BroadcastBenchmark((broadcast::Ops)_opNum, _testName, _axis);
+    result->setX(_x);
+    result->setY(_y);
+    result->setZ(_z);
+    return result;
+  }
+};
+}  // namespace sd
+
+#endif  // LIBND4J_BROADCASTBENCHMARK_H
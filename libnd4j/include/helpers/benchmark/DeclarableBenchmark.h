@@ -0,0 +1,93 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+
+#ifndef LIBND4J_DECLARABLEBENCHMARK_H
+#define LIBND4J_DECLARABLEBENCHMARK_H
+#include <graph/Context.h>
+#include <helpers/OpBenchmark.h>
+#include <ops/declarable/DeclarableOp.h>
+
+namespace sd {
+
+/**
+ * Custom op executed against prepared Context. Context is owned by BenchmarkHelper
+ */
+class SD_LIB_EXPORT DeclarableBenchmark : public OpBenchmark {
+ protected:
+  ops::DeclarableOp *_op = nullptr;
+  graph::Context *_context = nullptr;
+
+ public:
+  DeclarableBenchmark(ops::DeclarableOp &op, const std::string &name = "") : OpBenchmark() {
+    _op = &op;
+    _testName = name;
+  }
+
+  void setContext(graph::Context *ctx) {
+    _context = ctx;
+    _x = ctx != nullptr && !ctx->fastpath_in().empty() ? ctx->fastpath_in()[0] : nullptr;
+    _z = ctx != nullptr && !ctx->fastpath_out().empty() ? ctx->fastpath_out()[0] : nullptr;
+  }
+
+  void executeOnce() override {
+    auto status = _op->execute(_context);
+    if (status != Status::OK) THROW_EXCEPTION(("DeclarableBenchmark: op " + _testName + " failed").c_str());
+  }
+
+  std::string axis() override { return "N/A"; }
+
+  std::string orders() override {
+    if (_context == nullptr) return "N/A";
+
+    std::string result;
+    for (auto array : _context->fastpath_in()) {
+      if (array == nullptr) continue;
+      if (!result.empty()) result += "/";
+      result += array->ordering();
+    }
+
+    return result.empty() ? "N/A" : result;
+  }
+
+  std::string strides() override {
+    if (_context == nullptr) return "N/A";
+
+    std::string result;
+    for (auto array : _context->fastpath_in()) {
+      if (array == nullptr) continue;
+      if (!result.empty()) result += "/";
+      result += ShapeUtils::strideAsString(array);
+    }
+
+    return result.empty() ? "N/A" : result;
+  }
+
+  std::string inplace() override {
+    if (_context == nullptr) return "N/A";
+    return _context->isInplace() ? "true" : "false";
+  }
+
+  OpBenchmark *clone() override { return new DeclarableBenchmark(*_op, _testName); }
+};
+}  // namespace sd
+
+#endif  // LIBND4J_DECLARABLEBENCHMARK_H
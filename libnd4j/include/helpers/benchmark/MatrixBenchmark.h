@@ -0,0 +1,81 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+
+#ifndef LIBND4J_MATRIXBENCHMARK_H
+#define LIBND4J_MATRIXBENCHMARK_H
+#include <helpers/MmulHelper.h>
+#include <helpers/OpBenchmark.h>
+
+#include <memory>
+
+namespace sd {
+
+/**
+ * z = alpha * op(x) * op(y) + beta * z, where op is optional transpose
+ */
+class SD_LIB_EXPORT MatrixBenchmark : public OpBenchmark {
+ private:
+  double _alpha = 1.0;
+  double _beta = 0.0;
+  bool _tA = false;
+  bool _tB = false;
+
+ public:
+  MatrixBenchmark() : OpBenchmark() {}
+
+  MatrixBenchmark(double alpha, double beta, bool transposeA, bool transposeB, const std::string &testName)
+      : OpBenchmark() {
+    _alpha = alpha;
+    _beta = beta;
+    _tA = transposeA;
+    _tB = transposeB;
+    _testName = testName;
+  }
+
+  void executeOnce() override {
+    // transposes are views, so they only cost a shape
+    std::unique_ptr<NDArray> a(_tA ? new NDArray(_x->transpose()) : nullptr);
+    std::unique_ptr<NDArray> b(_tB ? new NDArray(_y->transpose()) : nullptr);
+
+    MmulHelper::mmul(_tA ? a.get() : _x, _tB ? b.get() : _y, _z, _alpha, _beta, _z->ordering());
+  }
+
+  std::string axis() override { return "N/A"; }
+
+  std::string inplace() override { return "N/A"; }
+
+  std::string extra() override {
+    return "transA=" + std::to_string(_tA) + ";transB=" + std::to_string(_tB) + ";alpha=" + std::to_string(_alpha) +
+           ";beta=" + std::to_string(_beta);
+  }
+
+  OpBenchmark *clone() override {
+    auto result = new MatrixBenchmark(_alpha, _beta, _tA, _tB, _testName);
+    result->setX(_x);
+    result->setY(_y);
+    result->setZ(_z);
+    return result;
+  }
+};
+}  // namespace sd
+
+#endif  // LIBND4J_MATRIXBENCHMARK_H
@@ -19,4 +19,30 @@
 //
 // @author raver119@gmail.com
 //
-#include <performance/benchmarking/BenchmarkSuit.h>
+
+#ifndef LIBND4J_PAIRWISEBENCHMARK_H
+#define LIBND4J_PAIRWISEBENCHMARK_H
+#include <helpers/OpBenchmark.h>
+
+namespace sd {
+class SD_LIB_EXPORT PairwiseBenchmark : public OpBenchmark {
+ public:
+  PairwiseBenchmark() : OpBenchmark() {}
+
+  PairwiseBenchmark(pairwise::Ops op, const std::string &testName) : OpBenchmark() {
+    _opNum = (int)op;
+    _testName = testName;
+  }
+
+  PairwiseBenchmark(pairwise::Ops op, const std::string &testName, NDArray *x, NDArray *y, NDArray *z)
+      : OpBenchmark(testName, x, y, z) {
+    _opNum = (int)op;
+  }
+
+  void executeOnce() override { _x->applyPairwiseTransform((pairwise::Ops)_opNum, _y, _z); }
+
+  OpBenchmark *clone() override { return new PairwiseBenchmark((pairwise::Ops)_opNum, _testName, _x, _y, _z); }
+};
+}  // namespace sd
+
+#endif  // LIBND4J_PAIRWISEBENCHMARK_H
@@ -0,0 +1,73 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+
+#ifndef LIBND4J_PARAMETERS_H
+#define LIBND4J_PARAMETERS_H
+#include <system/common.h>
+#include <system/op_boilerplate.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace sd {
+
+/**
+ * Single point of parametric benchmark space: named integer parameters
+ */
+class SD_LIB_EXPORT Parameters {
+ private:
+  std::map<std::string, int> _intParams;
+  std::vector<std::string> _names;
+
+ public:
+  Parameters() = default;
+
+  Parameters *addIntParam(const std::string &string, int param) {
+    if (_intParams.count(string) == 0) _names.emplace_back(string);
+    _intParams[string] = param;
+    return this;
+  }
+
+  int getIntParam(const std::string &string) const {
+    auto it = _intParams.find(string);
+    if (it == _intParams.end()) THROW_EXCEPTION(("Parameters: no parameter with name " + string).c_str());
+
+    return it->second;
+  }
+
+  /**
+   * Returns parameters as "name=value" pairs, in order they were added, separated by ';'
+   */
+  std::string asString() const {
+    std::string result;
+    for (const auto &name : _names) {
+      if (!result.empty()) result += ";";
+      result += name + "=" + std::to_string(_intParams.at(name));
+    }
+
+    return result;
+  }
+};
+}  // namespace sd
+
+#endif  // LIBND4J_PARAMETERS_H
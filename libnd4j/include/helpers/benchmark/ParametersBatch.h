@@ -0,0 +1,73 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+
+#ifndef LIBND4J_PARAMETERSBATCH_H
+#define LIBND4J_PARAMETERSBATCH_H
+#include <helpers/benchmark/Parameters.h>
+#include <helpers/benchmark/ParametersSpace.h>
+
+#include <vector>
+
+namespace sd {
+
+/**
+ * Cartesian product of parameter spaces. Spaces aren't owned, and must outlive the batch
+ */
+class ParametersBatch {
+ protected:
+  std::vector<ParametersSpace *> _spaces;
+
+ public:
+  ParametersBatch() = default;
+  ParametersBatch(std::initializer_list<ParametersSpace *> spaces) : _spaces(spaces) {}
+  explicit ParametersBatch(const std::vector<ParametersSpace *> &spaces) : _spaces(spaces) {}
+
+  void append(ParametersSpace *space) { _spaces.emplace_back(space); }
+
+  /**
+   * Returns every combination of parameter values, last space changing fastest.
+   * Empty batch gives a single empty combination, so parameterless benchmarks still run once.
+   */
+  std::vector<Parameters> parameters() const {
+    std::vector<Parameters> result(1);
+
+    for (auto space : _spaces) {
+      auto values = space->evaluate();
+      std::vector<Parameters> expanded;
+      expanded.reserve(result.size() * values.size());
+
+      for (const auto &p : result)
+        for (auto v : values) {
+          Parameters copy(p);
+          copy.addIntParam(space->name(), v);
+          expanded.emplace_back(copy);
+        }
+
+      result.swap(expanded);
+    }
+
+    return result;
+  }
+};
+}  // namespace sd
+
+#endif  // LIBND4J_PARAMETERSBATCH_H
@@ -0,0 +1,120 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+
+#ifndef LIBND4J_PARAMETERSSPACE_H
+#define LIBND4J_PARAMETERSSPACE_H
+#include <system/common.h>
+
+#include <string>
+#include <vector>
+
+namespace sd {
+
+/**
+ * Set of values a single named benchmark parameter iterates over
+ */
+class ParametersSpace {
+ protected:
+  std::string _name;
+
+ public:
+  explicit ParametersSpace(const std::string &name) : _name(name) {}
+  virtual ~ParametersSpace() = default;
+
+  std::string name() const { return _name; }
+
+  virtual std::vector<int> evaluate() const = 0;
+};
+
+/**
+ * Linear range: start, start + step, ..., up to stop inclusive
+ */
+class IntParameters : public ParametersSpace {
+ protected:
+  int _start;
+  int _stop;
+  int _step;
+
+ public:
+  IntParameters(const std::string &name, int start, int stop, int step = 1)
+      : ParametersSpace(name), _start(start), _stop(stop), _step(step) {}
+
+  std::vector<int> evaluate() const override {
+    std::vector<int> result;
+    for (int e = _start; e <= _stop; e += _step) result.emplace_back(e);
+
+    return result;
+  }
+};
+
+/**
+ * Powers of base: base^start, base^(start + step), ..., up to base^stop inclusive
+ */
+class IntPowerParameters : public ParametersSpace {
+ protected:
+  int _base;
+  int _start;
+  int _stop;
+  int _step;
+
+ public:
+  IntPowerParameters(const std::string &name, int base, int start, int stop, int step = 1)
+      : ParametersSpace(name), _base(base), _start(start), _stop(stop), _step(step) {}
+
+  std::vector<int> evaluate() const override {
+    std::vector<int> result;
+    for (int e = _start; e <= _stop; e += _step) {
+      int value = 1;
+      for (int p = 0; p < e; p++) value *= _base;
+      result.emplace_back(value);
+    }
+
+    return result;
+  }
+};
+
+/**
+ * false/true, as 0 and 1
+ */
+class BoolParameters : public ParametersSpace {
+ public:
+  explicit BoolParameters(const std::string &name) : ParametersSpace(name) {}
+
+  std::vector<int> evaluate() const override { return {0, 1}; }
+};
+
+/**
+ * Explicitly listed values
+ */
+class PredefinedParameters : public ParametersSpace {
+ protected:
+  std::vector<int> _values;
+
+ public:
+  PredefinedParameters(const std::string &name, const std::vector<int> &values)
+      : ParametersSpace(name), _values(values) {}
+
+  std::vector<int> evaluate() const override { return _values; }
+};
+}  // namespace sd
+
+#endif  // LIBND4J_PARAMETERSSPACE_H
@@ -0,0 +1,86 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+
+#ifndef LIBND4J_REDUCTIONBENCHMARK_H
+#define LIBND4J_REDUCTIONBENCHMARK_H
+#include <helpers/OpBenchmark.h>
+
+namespace sd {
+
+/**
+ * Reduction along axis. If axis wasn't set, y might hold it as a scalar, otherwise whole array is reduced
+ */
+class SD_LIB_EXPORT ReductionBenchmark : public OpBenchmark {
+ protected:
+  bool _floatOps = false;
+
+ public:
+  ReductionBenchmark() : OpBenchmark() {}
+
+  ReductionBenchmark(reduce::SameOps op, const std::string &testName) : OpBenchmark() {
+    _opNum = (int)op;
+    _testName = testName;
+  }
+
+  ReductionBenchmark(reduce::FloatOps op, const std::string &testName) : OpBenchmark() {
+    _opNum = (int)op;
+    _testName = testName;
+    _floatOps = true;
+  }
+
+  void executeOnce() override {
+    std::vector<LongType> dimensions = _axis;
+    if (dimensions.empty() && _y != nullptr && !_y->isEmpty()) dimensions.emplace_back(_y->e<LongType>(0));
+
+    if (dimensions.empty())
+      for (int e = 0; e < _x->rankOf(); e++) dimensions.emplace_back(e);
+
+    if (_floatOps)
+      _x->reduceAlongDimension((reduce::FloatOps)_opNum, _z, &dimensions);
+    else
+      _x->reduceAlongDimension((reduce::SameOps)_opNum, _z, &dimensions);
+  }
+
+  std::string axis() override {
+    if (_axis.empty() && _y != nullptr && !_y->isEmpty()) return "[" + std::to_string(_y->e<LongType>(0)) + "]";
+    return _axis.empty() ? "ALL" : OpBenchmark::axis();
+  }
+
+  std::string orders() override { return _x == nullptr ? "N/A" : std::string(1, _x->ordering()); }
+
+  std::string inplace() override { return "N/A"; }
+
+  OpBenchmark *clone() override {
+    auto result = new ReductionBenchmark();
+    result->_opNum = _opNum;
+    result->_testName = _testName;
+    result->_floatOps = _floatOps;
+    result->_axis = _axis;
+    result->setX(_x);
+    result->setY(_y);
+    result->setZ(_z);
+    return result;
+  }
+};
+}  // namespace sd
+
+#endif  // LIBND4J_REDUCTIONBENCHMARK_H
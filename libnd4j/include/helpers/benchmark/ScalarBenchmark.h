@@ -0,0 +1,50 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+
+#ifndef LIBND4J_SCALARBENCHMARK_H
+#define LIBND4J_SCALARBENCHMARK_H
+#include <helpers/OpBenchmark.h>
+
+namespace sd {
+class SD_LIB_EXPORT ScalarBenchmark : public OpBenchmark {
+ public:
+  ScalarBenchmark() : OpBenchmark() {}
+
+  ScalarBenchmark(scalar::Ops op, const std::string &testName) : OpBenchmark() {
+    _opNum = (int)op;
+    _testName = testName;
+  }
+
+  ScalarBenchmark(scalar::Ops op, const std::string &testName, NDArray *x, NDArray *y, NDArray *z)
+      : OpBenchmark(testName, x, y, z) {
+    _opNum = (int)op;
+  }
+
+  void executeOnce() override { _x->applyScalarArr((scalar::Ops)_opNum, _y, _z); }
+
+  std::string extra() override { return _y == nullptr ? "N/A" : "scalar=" + std::to_string(_y->e<double>(0)); }
+
+  OpBenchmark *clone() override { return new ScalarBenchmark((scalar::Ops)_opNum, _testName, _x, _y, _z); }
+};
+}  // namespace sd
+
+#endif  // LIBND4J_SCALARBENCHMARK_H
@@ -0,0 +1,73 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+#ifndef LIBND4J_SORTBENCHMARK_H
+#define LIBND4J_SORTBENCHMARK_H
+#include <helpers/OpBenchmark.h>
+#include <ops/specials.h>
+
+namespace sd {
+
+/**
+ * Sorts z, or sorts z as keys and y as values if y is given. x holds unsorted input: it's copied into z
+ * before every sort, otherwise all iterations but the first one would sort already sorted data
+ */
+class SD_LIB_EXPORT SortBenchmark : public OpBenchmark {
+ private:
+  bool _descending = false;
+
+ public:
+  SortBenchmark() : OpBenchmark() {}
+
+  SortBenchmark(bool descending, const std::string &testName) : OpBenchmark() {
+    _descending = descending;
+    _testName = testName;
+  }
+
+  void executeOnce() override {
+    _z->assign(_x);
+
+    if (_y == nullptr) {
+      NativeOpExecutioner::execSort(_z, _descending);
+    } else {
+      auto xType = _z->dataType();
+      auto yType = _y->dataType();
+      BUILD_DOUBLE_SELECTOR(xType, yType, DoubleMethods, ::sortByKey(_z, _y, _descending), SD_NUMERIC_TYPES,
+                            SD_NUMERIC_TYPES);
+    }
+  }
+
+  std::string axis() override { return "N/A"; }
+
+  std::string inplace() override { return "N/A"; }
+
+  std::string extra() override {
+    return std::string(_y == nullptr ? "byKey=0" : "byKey=1") + ";descending=" + std::to_string(_descending);
+  }
+
+  OpBenchmark *clone() override {
+    auto result = new SortBenchmark(_descending, _testName);
+    result->setX(_x);
+    result->setY(_y);
+    result->setZ(_z);
+    return result;
+  }
+};
+}  // namespace sd
+
+#endif  // LIBND4J_SORTBENCHMARK_H
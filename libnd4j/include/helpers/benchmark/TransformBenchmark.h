@@ -0,0 +1,95 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+
+#ifndef LIBND4J_TRANSFORMBENCHMARK_H
+#define LIBND4J_TRANSFORMBENCHMARK_H
+#include <helpers/OpBenchmark.h>
+
+namespace sd {
+class SD_LIB_EXPORT TransformBenchmark : public OpBenchmark {
+ public:
+  enum class TransformType { STRICT, SAME, FLOAT, ANY, BOOL };
+
+ protected:
+  TransformType _type = TransformType::STRICT;
+
+ public:
+  TransformBenchmark() : OpBenchmark() {}
+
+  TransformBenchmark(transform::StrictOps op, const std::string &testName) : TransformBenchmark() {
+    init((int)op, TransformType::STRICT, testName);
+  }
+
+  TransformBenchmark(transform::SameOps op, const std::string &testName) : TransformBenchmark() {
+    init((int)op, TransformType::SAME, testName);
+  }
+
+  TransformBenchmark(transform::FloatOps op, const std::string &testName) : TransformBenchmark() {
+    init((int)op, TransformType::FLOAT, testName);
+  }
+
+  TransformBenchmark(transform::AnyOps op, const std::string &testName) : TransformBenchmark() {
+    init((int)op, TransformType::ANY, testName);
+  }
+
+  TransformBenchmark(transform::BoolOps op, const std::string &testName) : TransformBenchmark() {
+    init((int)op, TransformType::BOOL, testName);
+  }
+
+  void executeOnce() override {
+    switch (_type) {
+      case TransformType::STRICT:
+        _x->applyTransform((transform::StrictOps)_opNum, _z);
+        break;
+      case TransformType::SAME:
+        _x->applyTransform((transform::SameOps)_opNum, _z);
+        break;
+      case TransformType::FLOAT:
+        _x->applyTransform((transform::FloatOps)_opNum, _z);
+        break;
+      case TransformType::ANY:
+        _x->applyTransform((transform::AnyOps)_opNum, _z);
+        break;
+      case TransformType::BOOL:
+        _x->applyTransform((transform::BoolOps)_opNum, _z);
+        break;
+    }
+  }
+
+  OpBenchmark *clone() override {
+    auto result = new TransformBenchmark();
+    result->init(_opNum, _type, _testName);
+    result->setX(_x);
+    result->setZ(_z);
+    return result;
+  }
+
+ protected:
+  void init(int opNum, TransformType type, const std::string &testName) {
+    _opNum = opNum;
+    _type = type;
+    _testName = testName;
+  }
+};
+}  // namespace sd
+
+#endif  // LIBND4J_TRANSFORMBENCHMARK_H
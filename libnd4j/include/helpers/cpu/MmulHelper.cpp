@@ -27,6 +27,7 @@
 #include <execution/Threads.h>
 #include <helpers/BlasHelper.h>
 #include <helpers/ShapeUtils.h>
+#include <ops/gemm.h>
 
 namespace sd {
 
@@ -49,6 +50,14 @@ static void usualGemm(NDArray* vA, NDArray* vB, NDArray* vC, const int aMaxis, c
     THROW_EXCEPTION("usualGemm: C is nullptr");
   }
 
+  // plain matrices go to the packed and blocked kernel, strides are passed as they are so views aren't copied
+  if (vA->rankOf() == 2 && vB->rankOf() == 2 && vC->rankOf() == 2) {
+    blas::GEMM<T1, T2, T3>::op(vC->sizeAt(cMaxis), vC->sizeAt(cNaxis), vA->sizeAt(aKaxis), alpha, A,
+                               vA->strideAt(aMaxis), vA->strideAt(aKaxis), B, vB->strideAt(bKaxis),
+                               vB->strideAt(bNaxis), beta, C, vC->strideAt(cMaxis), vC->strideAt(cNaxis));
+    return;
+  }
+
   const T3 alphaZ = alpha;
   const T3 betaZ = beta;
 
@@ -0,0 +1,65 @@
+/* ******************************************************************************
+*
+* Copyright (c) 2024 Konduit K.K.
+* This program and the accompanying materials are made available under the
+* terms of the Apache License, Version 2.0 which is available at
+* https://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations
+* under the License.
+*
+* SPDX-License-Identifier: Apache-2.0
+******************************************************************************/
+
+#ifndef SD_GENERIC_CACHE_BOOKKEEPING_H_
+#define SD_GENERIC_CACHE_BOOKKEEPING_H_
+
+#include <system/common.h>
+
+#include <atomic>
+
+namespace sd {
+namespace generic {
+
+/**
+ * Counters shared by constant caches (DirectShapeTrie, DirectTadTrie).
+ *
+ * Entries are never removed from these caches: arrays and TAD consumers keep raw pointers into cached
+ * shape infos and offsets, so the counters are only there to report how big the caches grow and how often
+ * they're hit.
+ */
+class CacheBookkeeping {
+ private:
+  std::atomic<LongType> _hits{0};
+  std::atomic<LongType> _misses{0};
+  std::atomic<LongType> _entries{0};
+  std::atomic<LongType> _bytes{0};
+
+ public:
+  CacheBookkeeping() = default;
+  ~CacheBookkeeping() = default;
+
+  CacheBookkeeping(const CacheBookkeeping&) = delete;
+  CacheBookkeeping& operator=(const CacheBookkeeping&) = delete;
+
+  void hit() { _hits.fetch_add(1, std::memory_order_relaxed); }
+
+  void miss(LongType numBytes) {
+    _misses.fetch_add(1, std::memory_order_relaxed);
+    _entries.fetch_add(1, std::memory_order_relaxed);
+    _bytes.fetch_add(numBytes, std::memory_order_relaxed);
+  }
+
+  LongType hits() const { return _hits.load(std::memory_order_relaxed); }
+  LongType misses() const { return _misses.load(std::memory_order_relaxed); }
+  LongType entries() const { return _entries.load(std::memory_order_relaxed); }
+  LongType bytes() const { return _bytes.load(std::memory_order_relaxed); }
+};
+
+}  // namespace generic
+}  // namespace sd
+
+#endif  // SD_GENERIC_CACHE_BOOKKEEPING_H_
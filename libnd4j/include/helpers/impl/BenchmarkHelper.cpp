@@ -0,0 +1,296 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+#include <helpers/BenchmarkHelper.h>
+#include <helpers/StringUtils.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <set>
+#include <sstream>
+
+namespace sd {
+
+BenchmarkHelper::BenchmarkHelper(unsigned int warmUpIterations, unsigned int runIterations) {
+  _warmUpIterations = warmUpIterations;
+  _runIterations = runIterations > 0 ? runIterations : 1;
+}
+
+void BenchmarkHelper::setFilter(const std::string &filter) { _filter = filter; }
+
+void BenchmarkHelper::setPrintOut(bool printOut) { _printOut = printOut; }
+
+unsigned int BenchmarkHelper::warmUpIterations() const { return _warmUpIterations; }
+
+unsigned int BenchmarkHelper::runIterations() const { return _runIterations; }
+
+const std::vector<BenchmarkResult> &BenchmarkHelper::results() const { return _results; }
+
+bool BenchmarkHelper::accepts(const std::string &suite, OpBenchmark *op) const {
+  if (_filter.empty()) return true;
+  return suite.find(_filter) != std::string::npos || op->testName().find(_filter) != std::string::npos;
+}
+
+void BenchmarkHelper::summarize(std::vector<LongType> &timings, BenchmarkResult &result) {
+  result.iterations = timings.size();
+  if (timings.empty()) return;
+
+  std::sort(timings.begin(), timings.end());
+
+  const auto n = timings.size();
+  double sum = 0.0;
+  for (auto t : timings) sum += t;
+  const double mean = sum / n;
+
+  double variance = 0.0;
+  for (auto t : timings) variance += (t - mean) * (t - mean);
+
+  // nearest-rank percentiles
+  auto percentile = [&](double p) -> double {
+    auto rank = static_cast<size_t>(std::ceil(p / 100.0 * n));
+    return timings[rank > 0 ? rank - 1 : 0];
+  };
+
+  const double median = n % 2 == 1 ? timings[n / 2] : (timings[n / 2 - 1] + timings[n / 2]) / 2.0;
+
+  // nanoseconds to microseconds
+  result.min = timings.front() / 1000.0;
+  result.median = median / 1000.0;
+  result.mean = mean / 1000.0;
+  result.p99 = percentile(99.0) / 1000.0;
+  result.max = timings.back() / 1000.0;
+  result.stdDev = std::sqrt(variance / n) / 1000.0;
+}
+
+void BenchmarkHelper::benchmarkOperation(OpBenchmark &benchmark, const std::string &suite,
+                                         const Parameters &parameters) {
+  std::vector<LongType> timings(_runIterations);
+
+  // failing benchmark shouldn't take the rest of the suite down, it just doesn't get reported
+  try {
+    for (unsigned int e = 0; e < _warmUpIterations; e++) benchmark.executeOnce();
+
+    for (unsigned int e = 0; e < _runIterations; e++) {
+      auto timeStart = std::chrono::steady_clock::now();
+      benchmark.executeOnce();
+      auto timeEnd = std::chrono::steady_clock::now();
+
+      timings[e] = std::chrono::duration_cast<std::chrono::nanoseconds>(timeEnd - timeStart).count();
+    }
+  } catch (std::exception &e) {
+    sd_printf("%s: %s [%s] failed: %s\n", suite.c_str(), benchmark.testName().c_str(), parameters.asString().c_str(),
+              e.what());
+    return;
+  }
+
+  BenchmarkResult result;
+  result.suite = suite;
+  result.name = benchmark.testName();
+  result.parameters = parameters.asString();
+  result.dataType = benchmark.dataType();
+  result.shape = benchmark.shape();
+  result.orders = benchmark.orders();
+  result.strides = benchmark.strides();
+  result.axis = benchmark.axis();
+  result.inplace = benchmark.inplace();
+  result.extra = benchmark.extra();
+  summarize(timings, result);
+
+  if (_printOut)
+    sd_printf("%s: %s [%s] %s; median: %.2f us; p99: %.2f us\n", result.suite.c_str(), result.name.c_str(),
+              result.parameters.c_str(), result.shape.c_str(), result.median, result.p99);
+
+  _results.emplace_back(result);
+}
+
+void BenchmarkHelper::releaseArrays(std::vector<NDArray *> &x, std::vector<NDArray *> &y, std::vector<NDArray *> &z) {
+  // inplace benchmarks share arrays between x and z, so every array is deleted once
+  std::set<NDArray *> unique;
+  for (auto v : {&x, &y, &z})
+    for (auto a : *v)
+      if (a != nullptr) unique.insert(a);
+
+  for (auto a : unique) delete a;
+
+  x.clear();
+  y.clear();
+  z.clear();
+}
+
+void BenchmarkHelper::runOperationSuit(OpBenchmark *op, const char *message) {
+  std::string suite = message != nullptr ? message : op->testName();
+  if (!accepts(suite, op)) return;
+
+  benchmarkOperation(*op, suite, Parameters());
+}
+
+void BenchmarkHelper::runOperationSuit(OpBenchmark *op, const XZGenerator &func, const ParametersBatch &parametersBatch,
+                                       const char *message) {
+  XYZGenerator wrapper = [&func](Parameters &p, std::vector<NDArray *> &x, std::vector<NDArray *> &y,
+                                 std::vector<NDArray *> &z) { func(p, x, z); };
+
+  runOperationSuit(op, wrapper, parametersBatch, message);
+}
+
+void BenchmarkHelper::runOperationSuit(OpBenchmark *op, const XYZGenerator &func,
+                                       const ParametersBatch &parametersBatch, const char *message) {
+  std::string suite = message != nullptr ? message : op->testName();
+  if (!accepts(suite, op)) return;
+
+  for (auto &p : parametersBatch.parameters()) {
+    std::vector<NDArray *> x, y, z;
+    func(p, x, y, z);
+
+    for (size_t e = 0; e < x.size(); e++) {
+      op->setX(x[e]);
+      op->setY(e < y.size() ? y[e] : nullptr);
+      op->setZ(e < z.size() ? z[e] : nullptr);
+
+      benchmarkOperation(*op, suite, p);
+    }
+
+    op->setX(nullptr);
+    op->setY(nullptr);
+    op->setZ(nullptr);
+    releaseArrays(x, y, z);
+  }
+}
+
+void BenchmarkHelper::runOperationSuit(DeclarableBenchmark *op, const ContextGenerator &func,
+                                       const ParametersBatch &parametersBatch, const char *message) {
+  std::string suite = message != nullptr ? message : op->testName();
+  if (!accepts(suite, op)) return;
+
+  for (auto &p : parametersBatch.parameters()) {
+    auto ctx = func(p);
+    op->setContext(ctx);
+
+    benchmarkOperation(*op, suite, p);
+
+    op->setContext(nullptr);
+    delete ctx;
+  }
+}
+
+static std::string escapeCsv(const std::string &value) {
+  if (value.find_first_of(",\"\n") == std::string::npos) return value;
+
+  std::string result = "\"";
+  for (auto c : value) {
+    if (c == '"') result += '"';
+    result += c;
+  }
+
+  return result + "\"";
+}
+
+static std::string escapeJson(const std::string &value) {
+  std::string result;
+  for (auto c : value) {
+    switch (c) {
+      case '"':
+        result += "\\\"";
+        break;
+      case '\\':
+        result += "\\\\";
+        break;
+      case '\n':
+        result += "\\n";
+        break;
+      case '\t':
+        result += "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          char buffer[8];
+          snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+          result += buffer;
+        } else {
+          result += c;
+        }
+    }
+  }
+
+  return result;
+}
+
+std::string BenchmarkHelper::report(BenchmarkFormat format) const {
+  std::ostringstream out;
+  out.precision(3);
+  out << std::fixed;
+
+  switch (format) {
+    case BenchmarkFormat::CSV: {
+      out << "suite,name,parameters,dataType,shape,orders,strides,axis,inplace,extra,iterations,"
+          << "min_us,median_us,mean_us,p99_us,max_us,stddev_us\n";
+      for (const auto &r : _results) {
+        for (auto v : {&r.suite, &r.name, &r.parameters, &r.dataType, &r.shape, &r.orders, &r.strides, &r.axis,
+                       &r.inplace, &r.extra})
+          out << escapeCsv(*v) << ",";
+
+        out << r.iterations << "," << r.min << "," << r.median << "," << r.mean << "," << r.p99 << "," << r.max
+            << "," << r.stdDev << "\n";
+      }
+    } break;
+    case BenchmarkFormat::JSON: {
+      out << "{\n  \"warmup\": " << _warmUpIterations << ",\n  \"iterations\": " << _runIterations
+          << ",\n  \"threads\": " << Environment::getInstance().maxMasterThreads() << ",\n  \"results\": [";
+
+      for (size_t e = 0; e < _results.size(); e++) {
+        const auto &r = _results[e];
+        out << (e > 0 ? "," : "") << "\n    {";
+        out << "\"suite\": \"" << escapeJson(r.suite) << "\", ";
+        out << "\"name\": \"" << escapeJson(r.name) << "\", ";
+        out << "\"parameters\": \"" << escapeJson(r.parameters) << "\", ";
+        out << "\"dataType\": \"" << escapeJson(r.dataType) << "\", ";
+        out << "\"shape\": \"" << escapeJson(r.shape) << "\", ";
+        out << "\"orders\": \"" << escapeJson(r.orders) << "\", ";
+        out << "\"strides\": \"" << escapeJson(r.strides) << "\", ";
+        out << "\"axis\": \"" << escapeJson(r.axis) << "\", ";
+        out << "\"inplace\": \"" << escapeJson(r.inplace) << "\", ";
+        out << "\"extra\": \"" << escapeJson(r.extra) << "\", ";
+        out << "\"iterations\": " << r.iterations << ", ";
+        out << "\"min_us\": " << r.min << ", ";
+        out << "\"median_us\": " << r.median << ", ";
+        out << "\"mean_us\": " << r.mean << ", ";
+        out << "\"p99_us\": " << r.p99 << ", ";
+        out << "\"max_us\": " << r.max << ", ";
+        out << "\"stddev_us\": " << r.stdDev << "}";
+      }
+
+      out << "\n  ]\n}\n";
+    } break;
+    default: {
+      for (const auto &r : _results) {
+        out << r.suite << " | " << r.name << " | " << r.parameters << " | " << r.dataType << " | " << r.shape
+            << " | orders: " << r.orders << " | axis: " << r.axis << " | inplace: " << r.inplace
+            << " | median: " << r.median << " us | p99: " << r.p99 << " us | min: " << r.min
+            << " us | max: " << r.max << " us\n";
+      }
+    }
+  }
+
+  return out.str();
+}
+
+}  // namespace sd
@@ -0,0 +1,63 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Host instruction set detection for CpuIsa::dispatch
+//
+#include <helpers/CpuIsa.h>
+#include <system/Environment.h>
+
+#include <algorithm>
+
+#if defined(CPU_FEATURES) && SD_ISA_DISPATCH
+#include <cpuinfo_x86.h>
+#endif
+
+namespace sd {
+
+static int detectHostLevel() {
+#if SD_ISA_DISPATCH
+#ifdef CPU_FEATURES
+  // cpu_features checks XCR0 as well, so these bits are only set when the OS saves the wider registers
+  auto features = cpu_features::GetX86Info().features;
+  if (features.avx2 && features.fma3 && features.avx512f && features.avx512vl && features.avx512bw &&
+      features.avx512dq && features.avx512cd)
+    return CpuIsa::AVX512;
+
+  if (features.avx2 && features.fma3) return CpuIsa::AVX2;
+#else
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") && __builtin_cpu_supports("avx512f") &&
+      __builtin_cpu_supports("avx512vl") && __builtin_cpu_supports("avx512bw") &&
+      __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512cd"))
+    return CpuIsa::AVX512;
+
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return CpuIsa::AVX2;
+#endif
+#endif
+  return CpuIsa::GENERIC;
+}
+
+int CpuIsa::hostLevel() {
+  static const int level = detectHostLevel();
+  return level;
+}
+
+int CpuIsa::activeLevel() { return std::min(hostLevel(), Environment::getInstance().maxIsaLevel()); }
+
+}  // namespace sd
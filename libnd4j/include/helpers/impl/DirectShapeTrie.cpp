@@ -25,6 +25,7 @@
 
 #include <atomic>
 #include <memory>
+#include <mutex>
 
 #include "helpers/ShapeBufferCreatorHelper.h"
 
@@ -49,6 +50,10 @@ void ShapeTrieNode::setBuffer(ConstantShapeBuffer* buf) {
 }
 
 
+static LongType bufferBytes(ConstantShapeBuffer* buffer) {
+  return shape::shapeInfoLength(shape::rank(buffer->primary())) * sizeof(LongType);
+}
+
 #if defined(SD_GCC_FUNCTRACE)
 void ShapeTrieNode::collectStoreStackTrace() {
   this->storeStackTrace = backward::StackTrace();
@@ -167,20 +172,16 @@ void DirectShapeTrie::validateShapeInfo(const LongType* shapeInfo) const {
 const ShapeTrieNode* DirectShapeTrie::findChild(const ShapeTrieNode* node, LongType value,
                                                 int level, bool isShape, int shapeHash) const {
   if (!node) return nullptr;
+  return node->findChild(value, level, isShape, shapeHash);
+}
 
-  for (const auto& child : node->children()) {
-    if (child->value() == value &&
-        child->level() == level &&
-        child->isShape() == isShape &&
-        (shapeHash == 0 || child->shapeHash() == shapeHash)) {
-      return child;
-    }
-  }
-  return nullptr;
+ConstantShapeBuffer* DirectShapeTrie::search(const LongType* shapeInfo, size_t stripeIdx) const {
+  auto node = searchNode(shapeInfo, stripeIdx);
+  return node ? node->buffer() : nullptr;
 }
 
 // Modified search method - still returns null when shape not found but with improved debugging
-ConstantShapeBuffer* DirectShapeTrie::search(const LongType* shapeInfo, size_t stripeIdx) const {
+const ShapeTrieNode* DirectShapeTrie::searchNode(const LongType* shapeInfo, size_t stripeIdx) const {
   // Validate input
   if (shapeInfo == nullptr) {
     std::string msg = "Null shapeInfo passed to search method";
@@ -247,7 +248,7 @@ ConstantShapeBuffer* DirectShapeTrie::search(const LongType* shapeInfo, size_t s
     }
   }
 
-  return current ? current->buffer() : nullptr;
+  return current;
 }
 
 
@@ -323,21 +324,25 @@ ConstantShapeBuffer* DirectShapeTrie::getOrCreate(const LongType* shapeInfo) {
   // First try a read-only lookup without obtaining a write lock
   {
     SHARED_LOCK_TYPE<MUTEX_TYPE> readLock(*(*_mutexes)[stripeIdx]);
-    ConstantShapeBuffer* existing = search(shapeInfo, stripeIdx);
+    auto node = searchNode(shapeInfo, stripeIdx);
+    ConstantShapeBuffer* existing = node ? node->buffer() : nullptr;
     if (existing != nullptr) {
       if (shapeInfoEqual(existing->primary(), shapeInfo)) {
+        _bookkeeping.hit();
         return existing;
       }
     }
   }
 
   // If not found or not matching, grab exclusive lock and try again
-  SHARED_LOCK_TYPE<MUTEX_TYPE> writeLock(*(*_mutexes)[stripeIdx]);
+  std::unique_lock<MUTEX_TYPE> writeLock(*(*_mutexes)[stripeIdx]);
 
   // Check again under the write lock
-  ConstantShapeBuffer* existing = search(shapeInfo, stripeIdx);
+  auto node = searchNode(shapeInfo, stripeIdx);
+  ConstantShapeBuffer* existing = node ? node->buffer() : nullptr;
   if (existing != nullptr) {
     if (shapeInfoEqual(existing->primary(), shapeInfo)) {
+      _bookkeeping.hit();
       return existing;
     }
   }
@@ -420,6 +425,7 @@ ConstantShapeBuffer* DirectShapeTrie::getOrCreate(const LongType* shapeInfo) {
   }
 
   // Set the buffer - setBuffer handles ownership properly
+  bool inserted = current->buffer() == nullptr;
   current->setBuffer(buffer);
 
   // Return the buffer from the node (could be the one we just set or a pre-existing one)
@@ -428,6 +434,8 @@ ConstantShapeBuffer* DirectShapeTrie::getOrCreate(const LongType* shapeInfo) {
     return buffer;
   }
 
+  if (inserted) _bookkeeping.miss(bufferBytes(resultBuffer));
+
   return resultBuffer;
 }
 
@@ -518,6 +526,7 @@ ConstantShapeBuffer* DirectShapeTrie::insert(const LongType* shapeInfo, size_t s
       auto buffer = new ConstantShapeBuffer(hPtr);
 
       current->setBuffer(buffer);
+      _bookkeeping.miss(bufferBytes(buffer));
       return buffer;
     } catch (const std::exception& e) {
       std::string msg = "Shape buffer creation failed: ";
@@ -532,4 +541,4 @@ ConstantShapeBuffer* DirectShapeTrie::insert(const LongType* shapeInfo, size_t s
   return current->buffer();
 }
 
-}  // namespace sd
\ No newline at end of file
+}  // namespace sd
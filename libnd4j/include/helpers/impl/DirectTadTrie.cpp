@@ -27,7 +27,12 @@
 
 namespace sd {
 
-TadPack* DirectTadTrie::enhancedSearch(const std::vector<LongType>& dimensions, LongType* originalShape, size_t stripeIdx) {
+static LongType packBytes(TadPack* pack) {
+  return (pack->numberOfTads() + shape::shapeInfoLength(shape::rank(pack->primaryShapeInfo()))) * sizeof(LongType);
+}
+
+const TadTrieNode* DirectTadTrie::searchNode(const std::vector<LongType>& dimensions, LongType* originalShape,
+                                             size_t stripeIdx) const {
   const TadTrieNode* current = _roots[stripeIdx].get();
   int rank = shape::rank(originalShape);
 
@@ -41,46 +46,19 @@ TadPack* DirectTadTrie::enhancedSearch(const std::vector<LongType>& dimensions,
     if (!current) return nullptr;
   }
 
-  // Found a matching node, now verify TadPack compatibility with shape signature
-  TadPack* pack = current->pack();
-  if (!pack) return nullptr;
-
-  // Get the stored shape info from the TadPack
-  LongType* storedShapeInfo = pack->primaryShapeInfo();
-  LongType* storedStrides = shape::stride(storedShapeInfo);
-  int storedRank = shape::rank(storedShapeInfo);
-
-  // Compare with expected strides and shape
-  // Create a temporary calculator to check what the strides should be
-  TadCalculator *tempCalc = new TadCalculator(originalShape);
-  tempCalc->createTadPack(dimensions);
-  LongType* expectedShapeInfo = tempCalc->tadShape()->primary();
-  LongType* expectedStrides = shape::stride(expectedShapeInfo);
-
-  // Check if strides are compatible
-  for (int i = 0; i < storedRank; i++) {
-    if (storedStrides[i] != expectedStrides[i]) {
-      return nullptr; // Strides don't match, not the right TadPack
-    }
-  }
-
-  // Additional verification for shape dimensions
-  LongType* storedShape = shape::shapeOf(storedShapeInfo);
-  LongType* expectedShape = shape::shapeOf(expectedShapeInfo);
-  for (int i = 0; i < storedRank; i++) {
-    if (storedShape[i] != expectedShape[i]) {
-      return nullptr; // Shape dimensions don't match
-    }
+  // Leaves are keyed by the hash of the source shape, collisions are resolved by probing next values
+  const int leafLevel = dimensions.size() + 1;
+  auto key = static_cast<LongType>(calculateShapeHash(originalShape));
+  for (auto leaf = findChild(current, key, leafLevel, false, rank); leaf != nullptr;
+       leaf = findChild(current, ++key, leafLevel, false, rank)) {
+    if (leaf->matchesOriginalShape(originalShape)) return leaf;
   }
 
-  // Verify order and data type match
-  if (shape::order(storedShapeInfo) != shape::order(expectedShapeInfo) ||
-      ArrayOptions::dataType(storedShapeInfo) != ArrayOptions::dataType(expectedShapeInfo)) {
-    return nullptr;
-  }
+  return nullptr;
+}
 
-  // If everything matches, return the found TadPack
-  return pack;
+TadPack* DirectTadTrie::enhancedSearch(const std::vector<LongType>& dimensions, LongType* originalShape, size_t stripeIdx) {
+  return search(dimensions, originalShape, stripeIdx);
 }
 
 // Enhanced stride-aware hash computation
@@ -127,7 +105,7 @@ size_t DirectTadTrie::computeStrideAwareHash(const std::vector<LongType>& dimens
 bool DirectTadTrie::exists(const std::vector<LongType>& dimensions, LongType* originalShape)  {
   if (!originalShape) return false;
 
-  const size_t stripeIdx = computeStripeIndex(dimensions, originalShape);
+  const size_t stripeIdx = computeStrideAwareHash(dimensions, originalShape);
   SHARED_LOCK_TYPE<MUTEX_TYPE> lock(_mutexes[stripeIdx]);
 
   // Using the enhanced search method which verifies TadPack compatibility
@@ -140,21 +118,10 @@ std::vector<LongType> DirectTadTrie::sortDimensions(const std::vector<LongType>&
   return sorted;
 }
 
-TadPack* DirectTadTrie::search(const std::vector<LongType>& dimensions, int originalShapeRank, size_t stripeIdx) const {
+TadPack* DirectTadTrie::search(const std::vector<LongType>& dimensions, LongType* originalShape, size_t stripeIdx) const {
   // No need for locking - caller handles locking (e.g., in getOrCreate)
-  const TadTrieNode* current = _roots[stripeIdx].get();
-
-  // First level: dimension length
-  current = findChild(current, dimensions.size(), 0, false, originalShapeRank);
-  if (!current) return nullptr;
-
-  // Second level: dimensions
-  for (size_t i = 0; i < dimensions.size(); i++) {
-    current = findChild(current, dimensions[i], i + 1, true, originalShapeRank);
-    if (!current) return nullptr;
-  }
-
-  return current->pack();
+  auto node = searchNode(dimensions, originalShape, stripeIdx);
+  return node != nullptr ? node->pack() : nullptr;
 }
 
 // Critical method that needs revision for better thread safety
@@ -169,9 +136,10 @@ TadPack* DirectTadTrie::getOrCreate(std::vector<LongType>& dimensions, LongType*
   // First try a read-only lookup
   {
     SHARED_LOCK_TYPE<MUTEX_TYPE> readLock(_mutexes[stripeIdx]);
-    TadPack* existing = enhancedSearch(dimensions, originalShape, stripeIdx);
-    if (existing) {
-      return existing;
+    auto node = searchNode(dimensions, originalShape, stripeIdx);
+    if (node != nullptr && node->pack() != nullptr) {
+      _bookkeeping.hit();
+      return node->pack();
     }
   }
 
@@ -187,12 +155,13 @@ TadPack* DirectTadTrie::insert(std::vector<LongType>& dimensions, LongType* orig
   int rank = shape::rank(originalShape);
   // Use the enhanced hash computation for better distribution
   const size_t stripeIdx = computeStrideAwareHash(dimensions, originalShape);
-  SHARED_LOCK_TYPE<MUTEX_TYPE> lock(_mutexes[stripeIdx]);
+  std::unique_lock<MUTEX_TYPE> lock(_mutexes[stripeIdx]);
 
   // Check if a compatible TadPack already exists
-  TadPack* existing = enhancedSearch(dimensions, originalShape, stripeIdx);
-  if (existing) {
-    return existing;
+  auto node = searchNode(dimensions, originalShape, stripeIdx);
+  if (node != nullptr && node->pack() != nullptr) {
+    _bookkeeping.hit();
+    return node->pack();
   }
 
   // No compatible TadPack found, create a new one
@@ -212,6 +181,17 @@ TadPack* DirectTadTrie::insert(std::vector<LongType>& dimensions, LongType* orig
     }
   }
 
+  // Leaf for this particular source shape: first free or matching slot starting at shape hash
+  const int leafLevel = dimensions.size() + 1;
+  auto key = static_cast<LongType>(calculateShapeHash(originalShape));
+  while (true) {
+    auto leaf = current->findOrCreateChild(key++, leafLevel, false, rank);
+    if (leaf->pack() == nullptr || leaf->matchesOriginalShape(originalShape)) {
+      current = leaf;
+      break;
+    }
+  }
+
   // Create the TadPack only if it doesn't exist yet
   if (!current->pack()) {
     try {
@@ -228,6 +208,8 @@ TadPack* DirectTadTrie::insert(std::vector<LongType>& dimensions, LongType* orig
 
       // Store the TadPack in the node (setPack handles synchronization)
       current->setPack(newPack);
+      current->storeOriginalShape(originalShape);
+      _bookkeeping.miss(packBytes(current->pack()));
 
     } catch (const std::exception& e) {
       std::string msg = "TAD creation failed: ";
@@ -242,17 +224,7 @@ TadPack* DirectTadTrie::insert(std::vector<LongType>& dimensions, LongType* orig
 
 const TadTrieNode* DirectTadTrie::findChild(const TadTrieNode* node, LongType value, int level, bool isDimension, int shapeRank) const {
   if (!node) return nullptr;
-
-  for (const auto& child : node->children()) {
-    if (child->value() == value &&
-        child->level() == level &&
-        child->isDimension() == isDimension &&
-        child->shapeRank() == shapeRank) {
-      return child.get();
-    }
-  }
-
-  return nullptr;
+  return node->findChild(value, level, isDimension, shapeRank);
 }
 
 }  // namespace sd
\ No newline at end of file
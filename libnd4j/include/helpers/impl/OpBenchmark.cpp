@@ -0,0 +1,135 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+#include <helpers/OpBenchmark.h>
+
+namespace sd {
+
+OpBenchmark::OpBenchmark(std::string name, NDArray *x, NDArray *y, NDArray *z) {
+  _testName = name;
+  _x = x;
+  _y = y;
+  _z = z;
+}
+
+OpBenchmark::OpBenchmark(std::string name, NDArray *x, NDArray *z) {
+  _testName = name;
+  _x = x;
+  _z = z;
+}
+
+OpBenchmark::OpBenchmark(std::string name, NDArray *x, NDArray *z, std::initializer_list<LongType> *axis) {
+  _testName = name;
+  _x = x;
+  _z = z;
+  if (axis != nullptr) _axis = std::vector<LongType>(*axis);
+}
+
+OpBenchmark::OpBenchmark(std::string name, NDArray *x, NDArray *z, std::vector<LongType> axis) {
+  _testName = name;
+  _x = x;
+  _z = z;
+  _axis = axis;
+}
+
+OpBenchmark::OpBenchmark(std::string name, NDArray *x, NDArray *y, NDArray *z, std::initializer_list<LongType> *axis) {
+  _testName = name;
+  _x = x;
+  _y = y;
+  _z = z;
+  if (axis != nullptr) _axis = std::vector<LongType>(*axis);
+}
+
+OpBenchmark::OpBenchmark(std::string name, NDArray *x, NDArray *y, NDArray *z, std::vector<LongType> *axis) {
+  _testName = name;
+  _x = x;
+  _y = y;
+  _z = z;
+  if (axis != nullptr) _axis = *axis;
+}
+
+void OpBenchmark::setOpNum(int opNum) { _opNum = opNum; }
+
+void OpBenchmark::setTestName(std::string name) { _testName = name; }
+
+void OpBenchmark::setX(NDArray *array) { _x = array; }
+
+void OpBenchmark::setY(NDArray *array) { _y = array; }
+
+void OpBenchmark::setZ(NDArray *array) { _z = array; }
+
+void OpBenchmark::setAxis(std::vector<LongType> axis) { _axis = axis; }
+
+void OpBenchmark::setAxis(std::initializer_list<LongType> axis) { _axis = axis; }
+
+NDArray &OpBenchmark::x() { return *_x; }
+
+int OpBenchmark::opNum() { return _opNum; }
+
+std::string OpBenchmark::testName() { return _testName; }
+
+std::vector<LongType> OpBenchmark::getAxis() { return _axis; }
+
+std::string OpBenchmark::extra() { return "N/A"; }
+
+std::string OpBenchmark::dataType() {
+  if (_x == nullptr) return "N/A";
+  return DataTypeUtils::asString(_x->dataType());
+}
+
+std::string OpBenchmark::axis() {
+  if (_axis.empty()) return "N/A";
+  return ShapeUtils::shapeAsString(_axis);
+}
+
+std::string OpBenchmark::orders() {
+  std::string result;
+  for (auto array : {_x, _y, _z}) {
+    if (array == nullptr) continue;
+    if (!result.empty()) result += "/";
+    result += array->ordering();
+  }
+
+  return result.empty() ? "N/A" : result;
+}
+
+std::string OpBenchmark::strides() {
+  std::string result;
+  for (auto array : {_x, _y, _z}) {
+    if (array == nullptr) continue;
+    if (!result.empty()) result += "/";
+    result += ShapeUtils::strideAsString(array);
+  }
+
+  return result.empty() ? "N/A" : result;
+}
+
+std::string OpBenchmark::shape() {
+  if (_x == nullptr) return "N/A";
+  return ShapeUtils::shapeAsString(_x);
+}
+
+std::string OpBenchmark::inplace() {
+  if (_x == nullptr || _z == nullptr) return "N/A";
+  return _x == _z ? "true" : "false";
+}
+
+}  // namespace sd
@@ -760,6 +760,26 @@ SD_LIB_EXPORT SD_INLINE SD_HOST_DEVICE bool strideDescendingCAscendingF( sd::Lon
   }
 }
 
+/**
+ * Returns true when the array occupies exactly [0, length) of its buffer, i.e. it has the default strides
+ * of its order (unit dimensions aside). Element-wise loops over arrays that are dense and share shape and
+ * strides can then walk all buffers linearly, whatever the order is.
+ */
+SD_LIB_EXPORT SD_INLINE SD_HOST_DEVICE bool isDense(const sd::LongType *shapeInfo) {
+  const sd::LongType rank = shape::rank(shapeInfo);
+  const sd::LongType *shapeOf = shape::shapeOf(shapeInfo);
+  const sd::LongType *strides = shape::stride(shapeInfo);
+  const bool cOrder = shape::order(shapeInfo) == 'c';
+
+  sd::LongType expected = 1;
+  for (sd::LongType e = 0; e < rank; e++) {
+    const sd::LongType i = cOrder ? rank - 1 - e : e;
+    if (shapeOf[i] != 1 && strides[i] != expected) return false;
+    expected *= shapeOf[i];
+  }
+  return true;
+}
+
 SD_LIB_EXPORT SD_INLINE SD_HOST int outerArrayOffsets(sd::LongType *maxOffsets, const sd::LongType minIdx,
                                                       const sd::LongType *maxShapeInfo, const sd::LongType *minShapeInfo,
                                                       sd::LongType *memBuff, const sd::LongType *dimsToExclude) {
@@ -377,6 +377,14 @@ SD_LIB_EXPORT float getRandomGeneratorNextFloat(OpaqueRandomGenerator ptr) ;
 SD_LIB_EXPORT double getRandomGeneratorNextDouble(OpaqueRandomGenerator ptr) ;
 SD_LIB_EXPORT void deleteRandomGenerator(OpaqueRandomGenerator ptr) ;
 SD_LIB_EXPORT sd::LongType getCachedMemory(int deviceId) ;
+SD_LIB_EXPORT sd::LongType getShapeCacheHits() ;
+SD_LIB_EXPORT sd::LongType getShapeCacheMisses() ;
+SD_LIB_EXPORT sd::LongType getShapeCacheEntries() ;
+SD_LIB_EXPORT sd::LongType getShapeCacheBytes() ;
+SD_LIB_EXPORT sd::LongType getTadCacheHits() ;
+SD_LIB_EXPORT sd::LongType getTadCacheMisses() ;
+SD_LIB_EXPORT sd::LongType getTadCacheEntries() ;
+SD_LIB_EXPORT sd::LongType getTadCacheBytes() ;
 SD_LIB_EXPORT sd::Pointer lcScalarPointer(OpaqueLaunchContext lc) ;
 SD_LIB_EXPORT sd::Pointer lcReductionPointer(OpaqueLaunchContext lc) ;
 SD_LIB_EXPORT sd::Pointer lcAllocationPointer(OpaqueLaunchContext lc) ;
@@ -450,6 +458,7 @@ SD_LIB_EXPORT  sd::Pointer dataPointForNumpyHeader(sd::Pointer npyArray);
 SD_LIB_EXPORT  sd::Pointer dataPointForNumpyStruct(sd::Pointer npyArrayStruct);
 SD_LIB_EXPORT  sd::Pointer dataPointForNumpy(sd::Pointer npyArray);
 SD_LIB_EXPORT  sd::Pointer numpyFromFile(std::string path);
+SD_LIB_EXPORT  OpaqueNDArray numpyMmapFromFile(std::string path);
 SD_LIB_EXPORT  void *mapFromNpzFile(std::string path);
 SD_LIB_EXPORT  int getNumNpyArraysInMap(void *map);
 SD_LIB_EXPORT  const char *getNpyArrayNameFromMap(void *map, int index, char *nameBuffer);
@@ -117,6 +117,53 @@ Environment::Environment() {
    _allowHelpers = false;
  }
 
+ /**
+  * If this env var is defined - thread pool and workspaces will be NUMA-aware
+  */
+ const char *numa_aware = std::getenv("SD_NUMA_AWARE");
+ if (numa_aware != nullptr) {
+   _numaAware = true;
+ }
+
+ /**
+  * If this env var is defined - parallel loops will use work-stealing scheduler
+  */
+ const char *work_stealing = std::getenv("SD_WORK_STEALING");
+ if (work_stealing != nullptr) {
+   _workStealing = true;
+ }
+
+ /**
+  * If this env var is defined - DeclarableOp::execute reuses cached execution plans
+  */
+ const char *execution_plans = std::getenv("SD_EXECUTION_PLANS");
+ if (execution_plans != nullptr) {
+   _executionPlans = true;
+ }
+
+ /**
+  * This var caps the instruction set used by runtime-dispatched hot loops
+  */
+ const char *max_isa = std::getenv("SD_MAX_ISA");
+ if (max_isa != nullptr) {
+   std::string isa(max_isa);
+   if (isa == "generic" || isa == "GENERIC") {
+     _maxIsaLevel = 1;
+   } else if (isa == "avx2" || isa == "AVX2") {
+     _maxIsaLevel = 2;
+   } else if (isa == "avx512" || isa == "AVX512") {
+     _maxIsaLevel = 3;
+   } else {
+     try {
+       _maxIsaLevel = std::stoi(isa);
+     } catch (std::invalid_argument &e) {
+       // just do nothing
+     } catch (std::out_of_range &e) {
+       // still do nothing
+     }
+   }
+ }
+
  /**
   * This var defines max amount of host memory library can allocate
   */
@@ -958,6 +1005,22 @@ void Environment::setCudaDeviceSchedule(int schedule) {
 
  void Environment::allowHelpers(bool reallyAllow) { _allowHelpers.store(reallyAllow); }
 
+ bool Environment::isNumaAware() { return _numaAware.load(); }
+
+ void Environment::setNumaAware(bool reallyAware) { _numaAware.store(reallyAware); }
+
+ bool Environment::isWorkStealing() { return _workStealing.load(); }
+
+ void Environment::setWorkStealing(bool reallyUse) { _workStealing.store(reallyUse); }
+
+ bool Environment::isExecutionPlans() { return _executionPlans.load(); }
+
+ void Environment::setExecutionPlans(bool reallyUse) { _executionPlans.store(reallyUse); }
+
+ int Environment::maxIsaLevel() { return _maxIsaLevel.load(); }
+
+ void Environment::setMaxIsaLevel(int level) { _maxIsaLevel.store(level); }
+
  void Environment::setGroupLimit(int group, LongType numBytes) {
    memory::MemoryCounter::getInstance().setGroupLimit((memory::MemoryType)group, numBytes);
  }
@@ -1371,6 +1371,23 @@ sd::Pointer numpyFromFile(std::string path) {
   return reinterpret_cast<sd::Pointer>(numpyBuffer);
 }
 
+/**
+ * Map a numpy array file into memory
+ * and wrap it into NDArray without copying.
+ * Mapping is released together with array's DataBuffer
+ * @param path
+ * @return
+ */
+OpaqueNDArray numpyMmapFromFile(std::string path) {
+  try {
+    return sd::NDArrayFactory::mmapNpyFile(path.c_str());
+  } catch (std::exception &e) {
+    sd::LaunchContext::defaultContext()->errorReference()->setErrorCode(1);
+    sd::LaunchContext::defaultContext()->errorReference()->setErrorMessage(e.what());
+    return nullptr;
+  }
+}
+
 ////// NPZ //////
 
 void* mapFromNpzFile(std::string path) {
@@ -1560,6 +1577,22 @@ void ctxSetExecutionMode(OpaqueContext *ptr, int execMode) {
 
 sd::LongType getCachedMemory(int deviceId) { return sd::ConstantHelper::getInstance().getCachedAmount(deviceId); }
 
+sd::LongType getShapeCacheHits() { return sd::ConstantShapeHelper::getInstance().cache().hits(); }
+
+sd::LongType getShapeCacheMisses() { return sd::ConstantShapeHelper::getInstance().cache().misses(); }
+
+sd::LongType getShapeCacheEntries() { return sd::ConstantShapeHelper::getInstance().cache().entries(); }
+
+sd::LongType getShapeCacheBytes() { return sd::ConstantShapeHelper::getInstance().cache().cachedBytes(); }
+
+sd::LongType getTadCacheHits() { return sd::ConstantTadHelper::getInstance().cache().hits(); }
+
+sd::LongType getTadCacheMisses() { return sd::ConstantTadHelper::getInstance().cache().misses(); }
+
+sd::LongType getTadCacheEntries() { return sd::ConstantTadHelper::getInstance().cache().entries(); }
+
+sd::LongType getTadCacheBytes() { return sd::ConstantTadHelper::getInstance().cache().cachedBytes(); }
+
 
 void ctxShapeFunctionOverride(OpaqueContext *ptr, bool reallyOverride) {
   ptr->setShapeFunctionOverride(reallyOverride);
@@ -230,13 +230,18 @@ char *cnpy::loadFile(const char *path) {
   long length;
   FILE *f = fopen(path, "rb");  // was "rb"
 
-  if (f) {
-    fseek(f, 0, SEEK_END);
-    length = ftell(f);
-    fseek(f, 0, SEEK_SET);
-    buffer = (char *)malloc((length + 1) * sizeof(char));
-
-    fclose(f);
+  if (!f) THROW_EXCEPTION((std::string("loadFile: unable to open file ") + path).c_str());
+
+  fseek(f, 0, SEEK_END);
+  length = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  buffer = (char *)malloc((length + 1) * sizeof(char));
+
+  size_t nread = fread(buffer, sizeof(char), length, f);
+  fclose(f);
+  if (nread != static_cast<size_t>(length)) {
+    free(buffer);
+    THROW_EXCEPTION((std::string("loadFile: failed to read file ") + path).c_str());
   }
 
   buffer[length] = '\0';
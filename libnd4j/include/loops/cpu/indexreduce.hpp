@@ -84,7 +84,9 @@ sd::LongType IndexReduce<X, Y>::execScalar(const void *vx, const sd::LongType *x
    }
  };
 
- maxThreads = samediff::Threads::parallel_for(func, 0, len, 1, maxThreads);
+ // ties are resolved by order of merging, so each block fills its own slot and slots are merged in order
+ maxThreads = samediff::Threads::parallel_blocks(func, 0, len,
+                                                 samediff::ThreadsHelper::numberOfThreads(maxThreads, len));
 
  for (int e = 0; e < maxThreads; e++) startingIndex = OpType::update(startingIndex, intermediatery[e], extraParams);
 
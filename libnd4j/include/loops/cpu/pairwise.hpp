@@ -20,6 +20,7 @@
 // Created by remote on 2018-09-20.
 //
 #include <execution/Threads.h>
+#include <helpers/CpuIsa.h>
 #include <helpers/LoopKind.h>
 #include <helpers/OmpLaunchHelper.h>
 #include <helpers/shape.h>
@@ -64,10 +65,9 @@ SD_INLINE void PairWiseTransform<X, Y, Z>::exec(const void *vx, sd::LongType xEw
 
 
   if (xEws == 1 && yEws == 1 && zEws == 1) {
-    for (sd::LongType i = start; i < stop; i++) {
-      z[i] = OpType::op(x[i], y[i], extraParams);
-    }
-
+    sd::CpuIsa::dispatch([&]() {
+      for (sd::LongType i = start; i < stop; i++) z[i] = OpType::op(x[i], y[i], extraParams);
+    });
   } else {
     for (sd::LongType i = start; i < stop; i++) z[i * zEws] = OpType::op(x[i * xEws], y[i * yEws], extraParams);
   }
@@ -111,6 +111,16 @@ SD_INLINE void PairWiseTransform<X, Y, Z>::exec(const void *vx,
   sd::LongType *yStride = shape::stride(yShapeInfo);
   sd::LongType *zStride = shape::stride(zShapeInfo);
   bool allSameOrder = shape::order(xShapeInfo) == shape::order(yShapeInfo) && shape::order(xShapeInfo) == shape::order(zShapeInfo);
+
+  // dense arrays sharing shape and strides map linear index i to offset i in all three buffers
+  if (shape::haveSameShapeAndStrides(xShapeInfo, yShapeInfo) && shape::haveSameShapeAndStrides(xShapeInfo, zShapeInfo) &&
+      shape::isDense(xShapeInfo)) {
+    sd::CpuIsa::dispatch([&]() {
+      for (sd::LongType i = start; i < stop; i++) z[i] = OpType::op(x[i], y[i], extraParams);
+    });
+    return;
+  }
+
   if (shape::haveSameShapeAndStrides(xShapeInfo, yShapeInfo)
       && shape::haveSameShapeAndStrides(xShapeInfo, zShapeInfo)
       && !shape::isViewConst(xShapeInfo)
@@ -90,9 +90,12 @@ void SD_HOST ReduceFloatFunction<X, Z>::execScalar(const void *vx, const sd::Lon
     z[0] = OpType::postProcess(intermediate[0], length, extraParams);
   } else {
     auto func = PRAGMA_THREADS_FOR {
-      for (auto i = start; i < stop; i++) {
-        intermediate[thread_id] = OpType::update(intermediate[thread_id], OpType::op(x[i], extraParams), extraParams);
-      }
+      // accumulate into a local, so the ISA-specific clone of the loop keeps it in registers
+      auto acc = intermediate[thread_id];
+      sd::CpuIsa::dispatch([&]() {
+        for (auto i = start; i < stop; i++) acc = OpType::update(acc, OpType::op(x[i], extraParams), extraParams);
+      });
+      intermediate[thread_id] = acc;
     };
     maxThreads = samediff::Threads::parallel_for(func, 0, length, 1, maxThreads);
     PRAGMA_OMP_SIMD
@@ -166,8 +169,12 @@ Z SD_HOST ReduceFloatFunction<X, Z>::execScalar(const void *vx, sd::LongType xEw
 
   auto func = PRAGMA_THREADS_FOR {
     if (xEws == 1) {
-      for (auto i = start; i < stop; i++)
-        intermediate[thread_id] = OpType::update(intermediate[thread_id], OpType::op(x[i], extraParams), extraParams);
+      // accumulate into a local, so the ISA-specific clone of the loop keeps it in registers
+      auto acc = intermediate[thread_id];
+      sd::CpuIsa::dispatch([&]() {
+        for (auto i = start; i < stop; i++) acc = OpType::update(acc, OpType::op(x[i], extraParams), extraParams);
+      });
+      intermediate[thread_id] = acc;
     } else {
       for (auto i = start; i < stop; i++)
         intermediate[thread_id] =
@@ -154,8 +154,12 @@ Z SD_HOST ReduceLongFunction<X, Z>::execScalar(const void *vx, sd::LongType xEws
 
   auto func = PRAGMA_THREADS_FOR {
     if (xEws == 1) {
-      for (auto i = start; i < stop; i++)
-        intermediate[thread_id] = OpType::update(intermediate[thread_id], OpType::op(x[i], extraParams), extraParams);
+      // accumulate into a local, so the ISA-specific clone of the loop keeps it in registers
+      auto acc = intermediate[thread_id];
+      sd::CpuIsa::dispatch([&]() {
+        for (auto i = start; i < stop; i++) acc = OpType::update(acc, OpType::op(x[i], extraParams), extraParams);
+      });
+      intermediate[thread_id] = acc;
     } else {
       for (auto i = start; i < stop; i++)
         intermediate[thread_id] =
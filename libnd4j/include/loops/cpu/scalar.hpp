@@ -20,6 +20,7 @@
 // Created by raver119 on 08.10.2017.
 //
 #include <execution/Threads.h>
+#include <helpers/CpuIsa.h>
 #include <helpers/LoopKind.h>
 #include <system/op_boilerplate.h>
 #include <types/types.h>
@@ -61,6 +62,18 @@ void ScalarTransform<X, Y, Z>::transform(const void *vx, const sd::LongType *xSh
   sd::LongType *zTadStride = shape::stride(zTadShapeInfo);
 
   const int tadLength = shape::tadLength(xShapeInfo, dimension, dimensionLength);
+
+  if (shape::haveSameShapeAndStrides(xTadShapeInfo, zTadShapeInfo) && shape::isDense(xTadShapeInfo)) {
+    sd::CpuIsa::dispatch([&]() {
+      for (auto r = start; r < stop; r++) {
+        auto oZ = z + zTadOffsets[r];
+        auto oX = x + xTadOffsets[r];
+        for (int f = 0; f < tadLength; f++) oZ[f] = OpType::op(oX[f], scalars[r], extraParams);
+      }
+    });
+    return;
+  }
+
   for (auto r = start; r < stop; r++) {
     auto oZ = z + zTadOffsets[r];
     auto oX = x + xTadOffsets[r];
@@ -120,6 +133,14 @@ void ScalarTransform<X, Y, Z>::transform(const void *vx, const sd::LongType *xSh
   sd::LongType *xStride = shape::stride(xShapeInfo);
   sd::LongType *zStride = shape::stride(zShapeInfo);
 
+  // dense arrays sharing shape and strides map linear index i to offset i in both buffers
+  if (shape::haveSameShapeAndStrides(xShapeInfo, zShapeInfo) && shape::isDense(xShapeInfo)) {
+    sd::CpuIsa::dispatch([&]() {
+      for (auto i = start; i < stop; i++) z[i] = OpType::op(x[i], scalar, extraParams);
+    });
+    return;
+  }
+
   PRAGMA_OMP_SIMD
   for (auto i = start; i < stop; i++) {
     sd::LongType coords[SD_MAX_RANK];
@@ -20,11 +20,16 @@
 // Created by raver on 6/12/2018.
 //
 #include <execution/Threads.h>
+#include <helpers/CpuIsa.h>
 #include <helpers/OmpLaunchHelper.h>
 #include <loops/type_conversions.h>
 #include <system/op_boilerplate.h>
 #include <types/types.h>
 
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
 namespace sd {
 
 template <typename T>
@@ -88,6 +93,140 @@ SD_HOST void TypeCast::convertToQuantized(Pointer *extras, void *dx, LongType N,
   samediff::Threads::parallel_for(func, 0, N);
 }
 
+// elements per block of the threshold encoders; blocks are the unit of parallelism and of compressed records
+static constexpr LongType kThresholdBlock = 4096;
+
+static SD_INLINE int varintLength(uint64_t v) {
+  int len = 1;
+  while (v >= 0x80) {
+    v >>= 7;
+    len++;
+  }
+  return len;
+}
+
+static SD_INLINE uint8_t *writeVarint(uint8_t *p, uint64_t v) {
+  while (v >= 0x80) {
+    *p++ = static_cast<uint8_t>(v | 0x80);
+    v >>= 7;
+  }
+  *p++ = static_cast<uint8_t>(v);
+  return p;
+}
+
+static SD_INLINE const uint8_t *readVarint(const uint8_t *p, uint64_t &v) {
+  v = 0;
+  int shift = 0;
+  while (*p & 0x80) {
+    v |= static_cast<uint64_t>(*p++ & 0x7f) << shift;
+    shift += 7;
+  }
+  v |= static_cast<uint64_t>(*p++) << shift;
+  return p;
+}
+
+// size of the varint stream holding the first `quota` hits of [from, to)
+template <typename T>
+static LongType thresholdSparseBytes(const T *x, LongType from, LongType to, LongType quota, T tt, T mtt) {
+  LongType bytes = 0;
+  LongType prev = -1;
+  for (LongType e = from; e < to && quota > 0; e++) {
+    if (x[e] >= tt || x[e] <= mtt) {
+      bytes += varintLength(static_cast<uint64_t>(e - from - prev) << 1);
+      prev = e - from;
+      quota--;
+    }
+  }
+  return bytes;
+}
+
+// first pass: hits per block (and optionally their varint stream size), every thread owns whole blocks
+template <typename T>
+static void thresholdCountBlocks(const T *x, LongType N, T tt, T mtt, std::vector<LongType> &counts,
+                                 std::vector<LongType> *sparseBytes) {
+  auto func = PRAGMA_THREADS_FOR {
+    for (auto b = start; b < stop; b++) {
+      auto from = b * kThresholdBlock;
+      auto to = std::min<LongType>(from + kThresholdBlock, N);
+      LongType cnt = 0;
+      for (auto e = from; e < to; e++)
+        if (x[e] >= tt || x[e] <= mtt) cnt++;
+
+      counts[b] = cnt;
+      if (sparseBytes != nullptr) (*sparseBytes)[b] = thresholdSparseBytes(x, from, to, cnt, tt, mtt);
+    }
+  };
+
+  samediff::Threads::parallel_for(func, 0, static_cast<LongType>(counts.size()));
+}
+
+// exclusive prefix sum over block counts, clamping counts so only the first `capacity` hits get encoded
+static LongType thresholdPrefixSum(std::vector<LongType> &counts, std::vector<LongType> &offsets, LongType capacity) {
+  LongType total = 0;
+  for (size_t b = 0; b < counts.size(); b++) {
+    offsets[b] = total;
+    counts[b] = std::min<LongType>(counts[b], std::max<LongType>(capacity - total, 0));
+    total += counts[b];
+  }
+  return total;
+}
+
+// second pass for the plain index formats: every block writes its hits at its own offset, no atomics needed
+template <typename T, typename I>
+static void thresholdScatter(T *x, LongType N, T tt, T mtt, const std::vector<LongType> &counts,
+                             const std::vector<LongType> &offsets, I *z) {
+  auto func = PRAGMA_THREADS_FOR {
+    for (auto b = start; b < stop; b++) {
+      auto quota = counts[b];
+      auto idx = offsets[b];
+      auto to = std::min<LongType>((b + 1) * kThresholdBlock, N);
+      for (auto e = b * kThresholdBlock; e < to && quota > 0; e++) {
+        if (x[e] >= tt) {
+          z[idx++] = static_cast<I>(e + 1);
+          x[e] -= tt;
+          quota--;
+        } else if (x[e] <= mtt) {
+          z[idx++] = static_cast<I>(-e - 1);
+          x[e] += tt;
+          quota--;
+        }
+      }
+    }
+  };
+
+  samediff::Threads::parallel_for(func, 0, static_cast<LongType>(counts.size()));
+}
+
+// writes the payload of one compressed record, either a 2-bit code per element or (delta << 1 | sign) varints
+template <typename T>
+static void thresholdEncodeRecord(T *x, LongType from, LongType to, LongType quota, T tt, T mtt, bool dense,
+                                  uint8_t *p) {
+  if (dense) memset(p, 0, (to - from + 3) / 4);
+
+  LongType prev = -1;
+  for (LongType e = from; e < to && quota > 0; e++) {
+    uint64_t sign;
+    if (x[e] >= tt) {
+      sign = 0;
+      x[e] -= tt;
+    } else if (x[e] <= mtt) {
+      sign = 1;
+      x[e] += tt;
+    } else {
+      continue;
+    }
+
+    auto k = e - from;
+    if (dense) {
+      p[k >> 2] |= static_cast<uint8_t>((1 + sign) << ((k & 3) * 2));
+    } else {
+      p = writeVarint(p, (static_cast<uint64_t>(k - prev) << 1) | sign);
+      prev = k;
+    }
+    quota--;
+  }
+}
+
 template <typename T>
 void TypeCast::convertToThreshold(Pointer *extras, void *dx, LongType N, void *dz) {
   // we suppose that first 4 bytes are integer, second 4 bytes are float
@@ -101,67 +240,179 @@ void TypeCast::convertToThreshold(Pointer *extras, void *dx, LongType N, void *d
   fb.i_ = z[2];
   float threshold = fb.f_;
 
-  // TODO: int limit is sad thing here, 2B elements limitation
-  auto l = static_cast<int>(N);
-  z[1] = l;
+  // int indices are part of this format, use convertToThreshold64 for arrays with more than 2B elements
+  if (N > DataTypeUtils::max<int>())
+    THROW_EXCEPTION("convertToThreshold: array is too long for int indices, use convertToThreshold64 instead");
 
-#ifdef _OPENMP
-  int threads = OmpLaunchHelper::betterThreads(N);
-  auto span = OmpLaunchHelper::betterSpan(N, threads);
-#else
-  int threads = 1;
-  auto span = N;
-#endif
+  z[1] = static_cast<int>(N);
 
   T tt = static_cast<T>(threshold);
   T mtt = -tt;
 
-  // we use 3 as offset, since first 12 bytes are occupied with header
-  int flimit = limit + 4;
-  volatile int cnt = 4;
-  volatile bool flag = false;
-  PRAGMA_OMP_PARALLEL_THREADS(threads) {
-    int tid = omp_get_thread_num();
-    int start = span * tid;
-    int stop = span * (tid + 1);
-    if (stop > l) stop = l;
-
-    for (int e = start; e < stop; e++) {
-      bool flag_load;
-      PRAGMA_OMP_ATOMIC_ARGS(read)
-      flag_load = flag;
-      if (flag_load) break;
-
-      T cUpd = x[e];
-      if (cUpd >= tt) {
-        int idx;
-        PRAGMA_OMP_ATOMIC_ARGS(capture)
-        idx = cnt++;
-
-        if (idx >= flimit) {
-          PRAGMA_OMP_ATOMIC_ARGS(write)
-          flag = true;
-          break;
-        }
+  // count per block, prefix sum and scatter, so the first `limit` hits are encoded in index order
+  auto numBlocks = (N + kThresholdBlock - 1) / kThresholdBlock;
+  std::vector<LongType> counts(numBlocks), offsets(numBlocks);
+  thresholdCountBlocks(x, N, tt, mtt, counts, nullptr);
+  thresholdPrefixSum(counts, offsets, limit);
 
-        z[idx] = e + 1;
-        x[e] -= tt;
-      } else if (cUpd <= mtt) {
-        int idx;
-        PRAGMA_OMP_ATOMIC_ARGS(capture)
-        idx = cnt++;
-
-        if (idx >= flimit) {
-          PRAGMA_OMP_ATOMIC_ARGS(write)
-          flag = true;
-          break;
-        }
+  // we use 4 as offset, since first 16 bytes are occupied with header
+  thresholdScatter(x, N, tt, mtt, counts, offsets, z + 4);
+}
+
+LongType TypeCast::estimateThreshold64Size(LongType N, LongType capacity, int compression) {
+  auto numBlocks = (N + kThresholdBlock - 1) / kThresholdBlock;
+  capacity = std::min<LongType>(std::max<LongType>(capacity, 0), N);
+
+  if (compression == THRESHOLD_INDICES_RAW) return sizeof(ThresholdHeader) + capacity * sizeof(LongType);
+
+  // one record per non-empty block, hybrid records are never larger than the varint ones
+  auto maxElement = varintLength(static_cast<uint64_t>(kThresholdBlock) << 1 | 1);
+  auto maxRecordHeader = varintLength(static_cast<uint64_t>(numBlocks)) + maxElement;
+  return sizeof(ThresholdHeader) + std::min<LongType>(capacity, numBlocks) * maxRecordHeader + capacity * maxElement;
+}
+
+template <typename T>
+void TypeCast::convertToThreshold64(Pointer *extras, void *dx, LongType N, void *dz) {
+  auto x = reinterpret_cast<T *>(dx);
+  auto header = reinterpret_cast<ThresholdHeader *>(dz);
+  auto payload = reinterpret_cast<uint8_t *>(dz) + sizeof(ThresholdHeader);
+
+  auto compression = header->compression;
+  if (compression != THRESHOLD_INDICES_RAW && compression != THRESHOLD_INDICES_VARINT &&
+      compression != THRESHOLD_INDICES_HYBRID)
+    THROW_EXCEPTION("convertToThreshold64: unknown index compression");
+
+  T tt = static_cast<T>(header->threshold);
+  T mtt = -tt;
+  bool compressed = compression != THRESHOLD_INDICES_RAW;
+
+  auto numBlocks = (N + kThresholdBlock - 1) / kThresholdBlock;
+  std::vector<LongType> counts(numBlocks), offsets(numBlocks);
+  std::vector<LongType> sparseBytes(compressed ? numBlocks : 0);
+
+  thresholdCountBlocks(x, N, tt, mtt, counts, compressed ? &sparseBytes : nullptr);
+
+  // the varint stream sizes were measured for all hits, so the block cut by the capacity has to be measured again
+  std::vector<LongType> full;
+  if (compressed) full = counts;
+
+  header->length = N;
+  header->encoded = thresholdPrefixSum(counts, offsets, header->capacity);
+
+  if (!compressed) {
+    thresholdScatter(x, N, tt, mtt, counts, offsets, reinterpret_cast<LongType *>(payload));
+    header->payloadBytes = header->encoded * static_cast<LongType>(sizeof(LongType));
+    return;
+  }
+
+  // record sizes are known now, so byte offsets come from one more prefix sum over them
+  std::vector<int8_t> dense(numBlocks, 0);
+  LongType position = 0;
+  for (LongType b = 0; b < numBlocks; b++) {
+    offsets[b] = position;
+    auto quota = counts[b];
+    if (quota == 0) continue;
+
+    auto from = b * kThresholdBlock;
+    auto to = std::min<LongType>(from + kThresholdBlock, N);
+    auto sparse = quota < full[b] ? thresholdSparseBytes(x, from, to, quota, tt, mtt) : sparseBytes[b];
+    auto bitmap = (to - from + 3) / 4;
+    dense[b] = compression == THRESHOLD_INDICES_HYBRID && bitmap < sparse;
+
+    position += varintLength(static_cast<uint64_t>(b)) + varintLength(static_cast<uint64_t>(quota) << 1) +
+                (dense[b] ? bitmap : sparse);
+  }
+  header->payloadBytes = position;
+
+  auto func = PRAGMA_THREADS_FOR {
+    for (auto b = start; b < stop; b++) {
+      auto quota = counts[b];
+      if (quota == 0) continue;
+
+      auto from = b * kThresholdBlock;
+      auto to = std::min<LongType>(from + kThresholdBlock, N);
+      auto p = writeVarint(payload + offsets[b], static_cast<uint64_t>(b));
+      p = writeVarint(p, (static_cast<uint64_t>(quota) << 1) | static_cast<uint64_t>(dense[b]));
+      thresholdEncodeRecord(x, from, to, quota, tt, mtt, dense[b] != 0, p);
+    }
+  };
 
-        z[idx] = -e - 1;
-        x[e] += tt;
+  samediff::Threads::parallel_for(func, 0, numBlocks);
+}
+
+template <typename T>
+void TypeCast::convertFromThreshold64(Pointer *extras, const void *dx, LongType N, void *dz) {
+  auto header = reinterpret_cast<const ThresholdHeader *>(dx);
+  auto payload = reinterpret_cast<const uint8_t *>(dx) + sizeof(ThresholdHeader);
+  auto z = reinterpret_cast<T *>(dz);
+
+  if (header->length > N) THROW_EXCEPTION("convertFromThreshold64: encoded array is longer than the target");
+
+  T tt = static_cast<T>(header->threshold);
+  T mtt = -tt;
+
+  if (header->compression == THRESHOLD_INDICES_RAW) {
+    auto x = reinterpret_cast<const LongType *>(payload);
+    auto func = PRAGMA_THREADS_FOR {
+      for (auto e = start; e < stop; e++) {
+        auto el = x[e];
+        z[(el > 0 ? el : -el) - 1] += el > 0 ? tt : mtt;
       }
+    };
+
+    samediff::Threads::parallel_for(func, 0, header->encoded);
+    return;
+  }
+
+  if (header->compression != THRESHOLD_INDICES_VARINT && header->compression != THRESHOLD_INDICES_HYBRID)
+    THROW_EXCEPTION("convertFromThreshold64: unknown index compression");
+
+  // records are variable-sized, so locate them first; each one targets its own block and decodes independently
+  std::vector<const uint8_t *> records;
+  auto p = payload;
+  auto end = payload + header->payloadBytes;
+  while (p < end) {
+    records.push_back(p);
+
+    uint64_t b, meta;
+    p = readVarint(readVarint(p, b), meta);
+    if (meta & 1) {
+      auto from = static_cast<LongType>(b) * kThresholdBlock;
+      p += (std::min<LongType>(from + kThresholdBlock, header->length) - from + 3) / 4;
+    } else {
+      for (uint64_t i = 0; i < (meta >> 1); i++)
+        while (*p++ & 0x80);
     }
   }
+
+  auto func = PRAGMA_THREADS_FOR {
+    for (auto r = start; r < stop; r++) {
+      uint64_t b, meta;
+      auto q = readVarint(readVarint(records[r], b), meta);
+      auto from = static_cast<LongType>(b) * kThresholdBlock;
+
+      if (meta & 1) {
+        auto len = std::min<LongType>(from + kThresholdBlock, header->length) - from;
+        for (LongType k = 0; k < len; k++) {
+          auto code = (q[k >> 2] >> ((k & 3) * 2)) & 3;
+          if (code == 1)
+            z[from + k] += tt;
+          else if (code == 2)
+            z[from + k] += mtt;
+        }
+      } else {
+        LongType k = -1;
+        for (uint64_t i = 0; i < (meta >> 1); i++) {
+          uint64_t v;
+          q = readVarint(q, v);
+          k += static_cast<LongType>(v >> 1);
+          z[from + k] += (v & 1) ? mtt : tt;
+        }
+      }
+    }
+  };
+
+  samediff::Threads::parallel_for(func, 0, static_cast<LongType>(records.size()));
 }
 
 template <typename T>
@@ -201,10 +452,11 @@ void TypeCast::convertGeneric(Pointer *extras, void *dx, LongType N, void *dz) {
   auto x = reinterpret_cast<S *>(dx);
   auto z = reinterpret_cast<T *>(dz);
 
+  // half-precision conversions are bit twiddling without F16C, which the AVX2/AVX-512 clones vectorize
   auto func = PRAGMA_THREADS_FOR {
-    for (auto i = start; i < stop; i++) {
-      z[i] = static_cast<T>(static_cast<float>(x[i]));
-    }
+    CpuIsa::dispatch([&]() {
+      for (auto i = start; i < stop; i++) z[i] = static_cast<T>(static_cast<float>(x[i]));
+    });
   };
   samediff::Threads::parallel_for(func, 0, N);
 };
@@ -219,6 +471,16 @@ template void TypeCast::convertToThreshold<float>(Pointer *extras, void *dx, Lon
 template void TypeCast::convertToThreshold<float16>(Pointer *extras, void *dx, LongType N, void *dz);
 template void TypeCast::convertToThreshold<bfloat16>(Pointer *extras, void *dx, LongType N, void *dz);
 
+template void TypeCast::convertFromThreshold64<double>(Pointer *extras, const void *dx, LongType N, void *dz);
+template void TypeCast::convertFromThreshold64<float>(Pointer *extras, const void *dx, LongType N, void *dz);
+template void TypeCast::convertFromThreshold64<float16>(Pointer *extras, const void *dx, LongType N, void *dz);
+template void TypeCast::convertFromThreshold64<bfloat16>(Pointer *extras, const void *dx, LongType N, void *dz);
+
+template void TypeCast::convertToThreshold64<double>(Pointer *extras, void *dx, LongType N, void *dz);
+template void TypeCast::convertToThreshold64<float>(Pointer *extras, void *dx, LongType N, void *dz);
+template void TypeCast::convertToThreshold64<float16>(Pointer *extras, void *dx, LongType N, void *dz);
+template void TypeCast::convertToThreshold64<bfloat16>(Pointer *extras, void *dx, LongType N, void *dz);
+
 template void TypeCast::convertFromQuantized<double>(Pointer *extras, void *dx, LongType N, void *dz);
 template void TypeCast::convertFromQuantized<float>(Pointer *extras, void *dx, LongType N, void *dz);
 template void TypeCast::convertFromQuantized<float16>(Pointer *extras, void *dx, LongType N, void *dz);
@@ -46,6 +46,26 @@ typedef union {
   int i_;
 } FloatBits;
 
+// layouts of the index stream produced by TypeCast::convertToThreshold64
+enum ThresholdIndexCompression : int {
+  // signed 64-bit indices, idx + 1 for positive updates and -(idx + 1) for negative ones
+  THRESHOLD_INDICES_RAW = 0,
+  // per-block records of varint-encoded (delta << 1 | sign) pairs
+  THRESHOLD_INDICES_VARINT = 1,
+  // per-block records that pick the smaller of the varint stream and a 2-bit-per-element bitmap
+  THRESHOLD_INDICES_HYBRID = 2,
+};
+
+// header of the 64-bit threshold encoding, the index stream follows it directly
+typedef struct {
+  LongType capacity;      // in: max number of elements to encode
+  LongType length;        // out: length of the encoded array
+  LongType encoded;       // out: number of elements actually encoded
+  LongType payloadBytes;  // out: size of the index stream in bytes
+  float threshold;        // in
+  int compression;        // in: one of ThresholdIndexCompression
+} ThresholdHeader;
+
 class SD_LIB_HIDDEN TypeCast {
  public:
   template <typename S, typename T>
@@ -57,6 +77,20 @@ class SD_LIB_HIDDEN TypeCast {
   template <typename T>
   static SD_HOST void convertFromThreshold(Pointer *extras, const void *dx, LongType N, void *dz);
 
+  /**
+   * Threshold encoding without the 2B elements limit of convertToThreshold: dz starts with a ThresholdHeader
+   * that has capacity, threshold and compression filled in by the caller, and must hold at least
+   * estimateThreshold64Size(N, capacity, compression) bytes. Only the first `capacity` elements above
+   * threshold (in index order) are encoded and subtracted from dx, so the output is deterministic.
+   */
+  template <typename T>
+  static SD_HOST void convertToThreshold64(Pointer *extras, void *dx, LongType N, void *dz);
+
+  template <typename T>
+  static SD_HOST void convertFromThreshold64(Pointer *extras, const void *dx, LongType N, void *dz);
+
+  static SD_HOST LongType estimateThreshold64Size(LongType N, LongType capacity, int compression);
+
   SD_INLINE static SD_HOST LongType estimateQuantizedSize(LongType rawSize) {
     if (rawSize <= 0) THROW_EXCEPTION("Input size for quantization can't be <= 0");
 
@@ -0,0 +1,91 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Size-classed pool of host memory blocks, used to recycle Workspace spills across cycles
+//
+
+#ifndef SD_SPILLPOOL_H
+#define SD_SPILLPOOL_H
+
+#include <system/common.h>
+
+#include <mutex>
+#include <vector>
+
+namespace sd {
+namespace memory {
+/**
+ * This class keeps released host blocks in per-size-class free lists, so repeated allocations of similar size
+ * are served without going to the system allocator.
+ * Size classes are 4 per power of two, starting at 64 bytes, so rounding wastes at most 25% of the block.
+ */
+class SD_LIB_EXPORT SpillPool {
+ private:
+  std::mutex _locker;
+
+  // free blocks, one list per size class
+  std::vector<std::vector<void*>> _free;
+
+  // total capacity of blocks currently held in free lists
+  LongType _pooledBytes = 0L;
+
+  // maximal number of bytes kept in free lists, 0 disables pooling
+  LongType _limit = 0L;
+
+  static void* allocateBlock(LongType capacity);
+  static void releaseBlock(void* ptr);
+
+ public:
+  explicit SpillPool(LongType limit = 0L);
+  ~SpillPool();
+
+  /**
+   * This method returns size class index for a given number of bytes
+   */
+  static int sizeClass(LongType numBytes);
+
+  /**
+   * This method returns capacity of blocks within given size class
+   */
+  static LongType classCapacity(int sizeClass);
+
+  /**
+   * This method returns block of at least numBytes. Actual block capacity is stored into capacity,
+   * and has to be passed back into release()
+   */
+  void* allocate(LongType numBytes, LongType& capacity);
+
+  /**
+   * This method returns block into the pool, or frees it if pool is full or disabled
+   */
+  void release(void* ptr, LongType capacity);
+
+  /**
+   * This method frees all pooled blocks
+   */
+  void purge();
+
+  void setLimit(LongType numBytes);
+  LongType limit();
+  LongType pooledBytes();
+};
+}  // namespace memory
+}  // namespace sd
+
+#endif  // SD_SPILLPOOL_H
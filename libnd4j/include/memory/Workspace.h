@@ -28,6 +28,7 @@
 
 #include <memory/ExternalWorkspace.h>
 #include <memory/MemoryType.h>
+#include <memory/SpillPool.h>
 #include <system/common.h>
 #include <types/float16.h>
 
@@ -38,6 +39,38 @@
 namespace sd {
 namespace memory {
 
+/*
+ * Per-thread sub-arena: a chunk carved out of the workspace buffer on first use within a cycle,
+ * so threads that allocate temporaries concurrently bump their own offset instead of a shared one
+ */
+struct WorkspaceArena {
+  std::atomic<char*> _base{nullptr};
+  std::atomic<LongType> _offset{0L};
+};
+
+/*
+ * Controls how workspace buffer follows the demand of its cycles. Defaults match legacy behavior:
+ * buffer grows to exactly what the last cycle needed, never shrinks, is zero-filled, and spills aren't pooled.
+ */
+struct WorkspaceGrowthPolicy {
+  // buffer is grown to the cycle high-water mark multiplied by this factor, leaving headroom for varying cycles
+  double growthFactor = 1.0;
+
+  // buffer never grows beyond this number of bytes, cycles that need more keep spilling. 0 means no limit
+  LongType maxSize = 0L;
+
+  // buffer shrinks to the high-water mark of recent cycles only after this many consecutive cycles
+  // stayed below shrinkThreshold of its size. 0 disables shrinking
+  int shrinkAfterCycles = 0;
+  double shrinkThreshold = 0.5;
+
+  // if false, newly allocated buffers aren't memset to zero
+  bool zeroFill = true;
+
+  // spills released at scopeIn() are kept in size-classed pool, up to this number of bytes. 0 disables pooling
+  LongType spillPoolLimit = 0L;
+};
+
 class SD_LIB_EXPORT Workspace {
  protected:
   char* _ptrHost = nullptr;
@@ -55,7 +88,6 @@ class SD_LIB_EXPORT Workspace {
   LongType _currentSize = 0L;
   LongType _currentSizeSecondary = 0L;
 
-  std::mutex _mutexAllocation;
   std::mutex _mutexSpills;
 
   bool _externalized = false;
@@ -63,15 +95,37 @@ class SD_LIB_EXPORT Workspace {
   std::vector<void*> _spills;
   std::vector<void*> _spillsSecondary;
 
+  // capacities of pooled blocks backing _spills
+  std::vector<LongType> _spillsCapacities;
+  SpillPool _spillPool;
+
+  WorkspaceGrowthPolicy _policy;
+  LongType _windowHighWaterMark = 0L;
+  int _cyclesBelowThreshold = 0;
+
   std::atomic<LongType> _spillsSize;
   std::atomic<LongType> _cycleAllocations;
 
   std::atomic<LongType> _spillsSizeSecondary;
   std::atomic<LongType> _cycleAllocationsSecondary;
 
+  WorkspaceArena* _arenas = nullptr;
+  int _numArenas = 0;
+  LongType _arenaSize = 0L;
+
   void init(LongType primaryBytes, LongType secondaryBytes = 0L);
+  void resize(LongType primaryBytes);
+  void applyGrowthPolicy(LongType cycleBytes);
   void freeSpills();
 
+  // lock-free bump of the shared offset, returns nullptr if the buffer can't fit numBytes
+  void* allocateFromBuffer(LongType numBytes);
+  // bump allocation within the calling thread's sub-arena, returns nullptr if arena can't serve request
+  void* allocateFromArena(LongType numBytes);
+  // out-of-buffer allocation, tracked until the next scopeIn()
+  void* allocateSpill(LongType numBytes);
+  void resetArenas();
+
  public:
   explicit Workspace(ExternalWorkspace* external);
   Workspace(LongType initialSize = 0L, LongType secondaryBytes = 0L);
@@ -92,6 +146,28 @@ class SD_LIB_EXPORT Workspace {
   void expandBy(LongType primaryBytes, LongType secondaryBytes = 0L);
   void expandTo(LongType primaryBytes, LongType secondaryBytes = 0L);
 
+  /*
+   * This method enables per-thread sub-arenas: each allocating thread is mapped onto one of numArenas
+   * chunks of arenaBytes, carved out of the workspace buffer on first use within a cycle.
+   * Allocations bigger than arenaBytes, or allocations made once the arena is exhausted, go to the shared buffer.
+   * Passing 0 disables arenas. Must not be called while allocations are in flight.
+   */
+  void setThreadArenas(int numArenas, LongType arenaBytes);
+  int getNumberOfThreadArenas();
+  LongType getThreadArenaSize();
+
+  /*
+   * This method sets policy applied to the buffer at scopeIn(). Growth policy and spill pooling
+   * are applied to host memory on CPU backend only
+   */
+  void setGrowthPolicy(const WorkspaceGrowthPolicy& policy);
+  WorkspaceGrowthPolicy growthPolicy();
+
+  /*
+   * This method returns number of bytes held in spill pool between cycles
+   */
+  LongType getPooledSpillsSize();
+
   //            bool resizeSupported();
 
   void* allocateBytes(LongType numBytes);
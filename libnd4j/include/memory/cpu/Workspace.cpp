@@ -24,6 +24,7 @@
 
 #include "../Workspace.h"
 
+#include <execution/NumaTopology.h>
 #include <helpers/logger.h>
 #include <math/templatemath.h>
 #include <stdio.h>
@@ -32,6 +33,8 @@
 
 #include <atomic>
 #include <cstring>
+#include <functional>
+#include <thread>
 
 namespace sd {
 namespace memory {
@@ -73,19 +76,94 @@ Workspace::Workspace(sd::LongType initialSize, sd::LongType secondaryBytes) {
 }
 
 void Workspace::init(sd::LongType bytes, sd::LongType secondaryBytes) {
-  if (this->_currentSize < bytes) {
-    if (this->_allocatedHost && !_externalized) free((void *)this->_ptrHost);
+  if (this->_currentSize < bytes) resize(bytes);
+}
+
+void Workspace::resize(sd::LongType bytes) {
+  if (this->_allocatedHost && !_externalized) free((void *)this->_ptrHost);
+
+  // whatever buffer we get from now on is owned by this workspace
+  _externalized = false;
 
+  if (bytes < 1) {
+    this->_ptrHost = nullptr;
+    this->_currentSize = 0;
+    this->_allocatedHost = false;
+    return;
+  }
+
+  // buffer pages go to the node of thread that owns this workspace, before anything touches them. Buffer is page
+  // aligned then, so binding doesn't touch pages shared with other allocations
+  if (sd::Environment::getInstance().isNumaAware()) {
+    auto &topology = samediff::NumaTopology::getInstance();
+    this->_ptrHost = (char *)topology.allocateOnNode(bytes, topology.currentNode());
+  } else {
     this->_ptrHost = (char *)malloc(bytes);
+  }
 
-    CHECK_ALLOC(this->_ptrHost, "Failed to allocate new workspace", bytes);
+  CHECK_ALLOC(this->_ptrHost, "Failed to allocate new workspace", bytes);
 
-    memset(this->_ptrHost, 0, bytes);
-    this->_currentSize = bytes;
-    this->_allocatedHost = true;
+  if (_policy.zeroFill) memset(this->_ptrHost, 0, bytes);
+
+  this->_currentSize = bytes;
+  this->_allocatedHost = true;
+}
+
+void Workspace::applyGrowthPolicy(sd::LongType cycleBytes) {
+  auto target = [&](sd::LongType bytes) -> sd::LongType {
+    auto result = static_cast<sd::LongType>(static_cast<double>(bytes) * _policy.growthFactor);
+    return _policy.maxSize > 0 ? sd::math::sd_min<sd::LongType>(result, _policy.maxSize) : result;
+  };
+
+  if (cycleBytes > _currentSize) {
+    auto bytes = target(cycleBytes);
+    if (bytes > _currentSize) resize(bytes);
+
+    _cyclesBelowThreshold = 0;
+    _windowHighWaterMark = 0;
+    return;
+  }
+
+  if (_policy.shrinkAfterCycles < 1) return;
+
+  if (static_cast<double>(cycleBytes) >= static_cast<double>(_currentSize) * _policy.shrinkThreshold) {
+    _cyclesBelowThreshold = 0;
+    _windowHighWaterMark = 0;
+    return;
+  }
+
+  _windowHighWaterMark = sd::math::sd_max<sd::LongType>(_windowHighWaterMark, cycleBytes);
+  if (++_cyclesBelowThreshold < _policy.shrinkAfterCycles) return;
+
+  auto bytes = target(_windowHighWaterMark);
+  if (bytes < _currentSize) {
+    resize(bytes);
+    _spillPool.purge();
   }
+
+  _cyclesBelowThreshold = 0;
+  _windowHighWaterMark = 0;
+}
+
+void Workspace::setGrowthPolicy(const WorkspaceGrowthPolicy &policy) {
+  if (policy.growthFactor < 1.0) THROW_EXCEPTION("Workspace growth factor can't be less than 1.0");
+
+  if (policy.shrinkThreshold <= 0.0 || policy.shrinkThreshold > 1.0)
+    THROW_EXCEPTION("Workspace shrink threshold should be within (0, 1] range");
+
+  if (policy.maxSize < 0 || policy.spillPoolLimit < 0 || policy.shrinkAfterCycles < 0)
+    THROW_EXCEPTION("Workspace growth policy limits can't be negative");
+
+  _policy = policy;
+  _cyclesBelowThreshold = 0;
+  _windowHighWaterMark = 0;
+  _spillPool.setLimit(policy.spillPoolLimit);
 }
 
+WorkspaceGrowthPolicy Workspace::growthPolicy() { return _policy; }
+
+sd::LongType Workspace::getPooledSpillsSize() { return _spillPool.pooledBytes(); }
+
 void Workspace::expandBy(sd::LongType numBytes, sd::LongType secondaryBytes) {
   this->init(_currentSize + numBytes, _currentSizeSecondary + secondaryBytes);
 }
@@ -95,17 +173,21 @@ void Workspace::expandTo(sd::LongType numBytes, sd::LongType secondaryBytes) { t
 void Workspace::freeSpills() {
   _spillsSize = 0;
 
+  std::lock_guard<std::mutex> lock(_mutexSpills);
   if (_spills.size() < 1) return;
 
-  for (auto v : _spills) free(v);
+  for (size_t e = 0; e < _spills.size(); e++) _spillPool.release(_spills[e], _spillsCapacities[e]);
 
   _spills.clear();
+  _spillsCapacities.clear();
 }
 
 Workspace::~Workspace() {
   if (this->_allocatedHost && !_externalized) free((void *)this->_ptrHost);
 
   freeSpills();
+
+  delete[] _arenas;
 }
 
 sd::LongType Workspace::getUsedSize() { return getCurrentOffset(); }
@@ -114,56 +196,112 @@ sd::LongType Workspace::getCurrentSize() { return _currentSize; }
 
 sd::LongType Workspace::getCurrentOffset() { return _offset.load(); }
 
+void *Workspace::allocateFromBuffer(sd::LongType numBytes) {
+  // _currentSize and _ptrHost only change within scopeIn(), so plain CAS over offset is enough here
+  auto current = _offset.load(std::memory_order_relaxed);
+  do {
+    if (current + numBytes > _currentSize) return nullptr;
+  } while (!_offset.compare_exchange_weak(current, current + numBytes, std::memory_order_relaxed));
+
+  return (void *)(_ptrHost + current);
+}
+
+void *Workspace::allocateFromArena(sd::LongType numBytes) {
+  if (numBytes > _arenaSize) return nullptr;
+
+  auto &arena = _arenas[std::hash<std::thread::id>{}(std::this_thread::get_id()) % _numArenas];
+
+  auto base = arena._base.load(std::memory_order_acquire);
+  if (base == nullptr) {
+    auto chunk = (char *)allocateFromBuffer(_arenaSize);
+    if (chunk == nullptr) return nullptr;
+
+    // if some other thread mapped onto the same arena won the race - its chunk is used, ours stays unused till scopeOut
+    if (arena._base.compare_exchange_strong(base, chunk, std::memory_order_acq_rel)) base = chunk;
+  }
+
+  auto current = arena._offset.load(std::memory_order_relaxed);
+  do {
+    if (current + numBytes > _arenaSize) return nullptr;
+  } while (!arena._offset.compare_exchange_weak(current, current + numBytes, std::memory_order_relaxed));
+
+  return (void *)(base + current);
+}
+
+void *Workspace::allocateSpill(sd::LongType numBytes) {
+  sd_debug("Allocating %lld bytes in spills\n", numBytes);
+
+  sd::LongType capacity = 0;
+  auto p = _spillPool.allocate(numBytes, capacity);
+
+  {
+    std::lock_guard<std::mutex> lock(_mutexSpills);
+    _spills.push_back(p);
+    _spillsCapacities.push_back(capacity);
+  }
+
+  _spillsSize += numBytes;
+
+  return p;
+}
+
 void *Workspace::allocateBytes(sd::LongType numBytes) {
   if (numBytes < 1) throw allocation_exception::build("Number of bytes for allocation should be positive", numBytes);
 
-  // numBytes += 32;
-  void *result = nullptr;
   this->_cycleAllocations += numBytes;
-  this->_mutexAllocation.lock();
-
-  if (_offset.load() + numBytes > _currentSize) {
-    sd_debug("Allocating %lld bytes in spills\n", numBytes);
-    this->_mutexAllocation.unlock();
-#if defined(SD_ALIGNED_ALLOC)
-    void *p = aligned_alloc(SD_DESIRED_ALIGNMENT, (numBytes + SD_DESIRED_ALIGNMENT - 1) & (-SD_DESIRED_ALIGNMENT));
-#else
-    void *p = malloc(numBytes);
-#endif
-    CHECK_ALLOC(p, "Failed to allocate new workspace", numBytes);
-
-    _mutexSpills.lock();
-    _spills.push_back(p);
-    _mutexSpills.unlock();
-
-    _spillsSize += numBytes;
 
-    return p;
-  }
+  void *result = _numArenas > 0 ? allocateFromArena(numBytes) : nullptr;
+  if (result == nullptr) result = allocateFromBuffer(numBytes);
 
-  result = (void *)(_ptrHost + _offset.load());
-  _offset += numBytes;
-  // memset(result, 0, (int) numBytes);
+  if (result == nullptr) return allocateSpill(numBytes);
 
   sd_debug("Allocating %lld bytes from workspace; Current PTR: %p; Current offset: %lld\n", numBytes, result,
            _offset.load());
 
-  this->_mutexAllocation.unlock();
-
   return result;
 }
 
+void Workspace::resetArenas() {
+  for (int e = 0; e < _numArenas; e++) {
+    _arenas[e]._base = nullptr;
+    _arenas[e]._offset = 0;
+  }
+}
+
+void Workspace::setThreadArenas(int numArenas, sd::LongType arenaBytes) {
+  if (numArenas < 0 || (numArenas > 0 && arenaBytes < 1))
+    THROW_EXCEPTION("Number of thread arenas should be non-negative, and arena size should be positive");
+
+  delete[] _arenas;
+  _arenas = nullptr;
+  _numArenas = 0;
+  _arenaSize = 0;
+
+  if (numArenas == 0) return;
+
+  _arenas = new WorkspaceArena[numArenas];
+  _numArenas = numArenas;
+  _arenaSize = arenaBytes;
+}
+
+int Workspace::getNumberOfThreadArenas() { return _numArenas; }
+
+sd::LongType Workspace::getThreadArenaSize() { return _arenaSize; }
+
 sd::LongType Workspace::getAllocatedSize() { return getCurrentSize() + getSpilledSize(); }
 
 void Workspace::scopeIn() {
   freeSpills();
-  init(_cycleAllocations.load());
+  // arenas are carved out of the same buffer, so their footprint has to fit there as well
+  auto cycleBytes = _cycleAllocations.load() + _numArenas * _arenaSize;
   _cycleAllocations = 0;
+  applyGrowthPolicy(cycleBytes);
 }
 
 void Workspace::scopeOut() {
   _offset = 0;
   _offsetSecondary = 0;
+  resetArenas();
 }
 
 sd::LongType Workspace::getSpilledSize() { return _spillsSize.load(); }
@@ -186,7 +324,10 @@ sd::LongType Workspace::getUsedSecondarySize() { return 0L; }
 
 Workspace *Workspace::clone() {
   // for clone we take whatever is higher: current allocated size, or allocated size of current loop
-  return new Workspace(sd::math::sd_max<sd::LongType>(this->getCurrentSize(), this->_cycleAllocations.load()));
+  auto result = new Workspace(sd::math::sd_max<sd::LongType>(this->getCurrentSize(), this->_cycleAllocations.load()));
+  result->setThreadArenas(_numArenas, _arenaSize);
+  result->setGrowthPolicy(_policy);
+  return result;
 }
 }  // namespace memory
 }  // namespace sd
@@ -32,6 +32,8 @@
 
 #include <atomic>
 #include <cstring>
+#include <functional>
+#include <thread>
 
 #include "../Workspace.h"
 
@@ -135,6 +137,8 @@ Workspace::~Workspace() {
   if (this->_allocatedDevice && !_externalized) cudaFree((void *)this->_ptrDevice);
 
   freeSpills();
+
+  delete[] _arenas;
 }
 
 LongType Workspace::getUsedSize() { return getCurrentOffset(); }
@@ -149,11 +153,96 @@ LongType Workspace::getAllocatedSize() { return getCurrentSize() + getSpilledSiz
 
 void Workspace::scopeIn() {
   freeSpills();
-  init(_cycleAllocations.load());
+  // arenas are carved out of the same buffer, so their footprint has to fit there as well
+  init(_cycleAllocations.load() + _numArenas * _arenaSize);
   _cycleAllocations = 0;
 }
 
-void Workspace::scopeOut() { _offset = 0; }
+void Workspace::scopeOut() {
+  _offset = 0;
+  resetArenas();
+}
+
+void *Workspace::allocateFromBuffer(LongType numBytes) {
+  // _currentSize and _ptrDevice only change within scopeIn(), so plain CAS over offset is enough here
+  auto current = _offset.load(std::memory_order_relaxed);
+  do {
+    if (current + numBytes > _currentSize) return nullptr;
+  } while (!_offset.compare_exchange_weak(current, current + numBytes, std::memory_order_relaxed));
+
+  return (void *)(_ptrDevice + current);
+}
+
+void *Workspace::allocateFromArena(LongType numBytes) {
+  if (numBytes > _arenaSize) return nullptr;
+
+  auto &arena = _arenas[std::hash<std::thread::id>{}(std::this_thread::get_id()) % _numArenas];
+
+  auto base = arena._base.load(std::memory_order_acquire);
+  if (base == nullptr) {
+    auto chunk = (char *)allocateFromBuffer(_arenaSize);
+    if (chunk == nullptr) return nullptr;
+
+    if (arena._base.compare_exchange_strong(base, chunk, std::memory_order_acq_rel)) base = chunk;
+  }
+
+  auto current = arena._offset.load(std::memory_order_relaxed);
+  do {
+    if (current + numBytes > _arenaSize) return nullptr;
+  } while (!arena._offset.compare_exchange_weak(current, current + numBytes, std::memory_order_relaxed));
+
+  return (void *)(base + current);
+}
+
+void *Workspace::allocateSpill(LongType numBytes) {
+  sd_debug("Allocating %lld [DEVICE] bytes in spills\n", numBytes);
+
+  Pointer p;
+  auto res = cudaMalloc(reinterpret_cast<void **>(&p), numBytes);
+  if (res != 0) throw cuda_exception::build("Can't allocate [DEVICE] memory", res);
+
+  {
+    std::lock_guard<std::mutex> lock(_mutexSpills);
+    _spills.push_back(p);
+  }
+
+  _spillsSize += numBytes;
+
+  return p;
+}
+
+void Workspace::resetArenas() {
+  for (int e = 0; e < _numArenas; e++) {
+    _arenas[e]._base = nullptr;
+    _arenas[e]._offset = 0;
+  }
+}
+
+void Workspace::setThreadArenas(int numArenas, LongType arenaBytes) {
+  if (numArenas < 0 || (numArenas > 0 && arenaBytes < 1))
+    THROW_EXCEPTION("Number of thread arenas should be non-negative, and arena size should be positive");
+
+  delete[] _arenas;
+  _arenas = nullptr;
+  _numArenas = 0;
+  _arenaSize = 0;
+
+  if (numArenas == 0) return;
+
+  _arenas = new WorkspaceArena[numArenas];
+  _numArenas = numArenas;
+  _arenaSize = arenaBytes;
+}
+
+int Workspace::getNumberOfThreadArenas() { return _numArenas; }
+
+void Workspace::setGrowthPolicy(const WorkspaceGrowthPolicy &policy) { _policy = policy; }
+
+WorkspaceGrowthPolicy Workspace::growthPolicy() { return _policy; }
+
+LongType Workspace::getPooledSpillsSize() { return _spillPool.pooledBytes(); }
+
+LongType Workspace::getThreadArenaSize() { return _arenaSize; }
 
 LongType Workspace::getSpilledSize() { return _spillsSize.load(); }
 
@@ -163,36 +252,32 @@ void *Workspace::allocateBytes(MemoryType type, LongType numBytes) {
       if (numBytes < 1)
         throw allocation_exception::build("Number of [HOST] bytes for allocation should be positive", numBytes);
 
-      // numBytes += 32;
-      void *result = nullptr;
       this->_cycleAllocationsSecondary += numBytes;
-      this->_mutexAllocation.lock();
 
-      if (_offsetSecondary.load() + numBytes > _currentSizeSecondary) {
-        sd_debug("Allocating %lld [HOST] bytes in spills\n", numBytes);
-        this->_mutexAllocation.unlock();
+      auto current = _offsetSecondary.load(std::memory_order_relaxed);
+      do {
+        if (current + numBytes > _currentSizeSecondary) {
+          sd_debug("Allocating %lld [HOST] bytes in spills\n", numBytes);
 
-        Pointer p;
-        auto res = cudaHostAlloc(reinterpret_cast<void **>(&p), numBytes, cudaHostAllocDefault);
-        if (res != 0) throw cuda_exception::build("Can't allocate [HOST] memory", res);
+          Pointer p;
+          auto res = cudaHostAlloc(reinterpret_cast<void **>(&p), numBytes, cudaHostAllocDefault);
+          if (res != 0) throw cuda_exception::build("Can't allocate [HOST] memory", res);
 
-        _mutexSpills.lock();
-        _spillsSecondary.push_back(p);
-        _mutexSpills.unlock();
+          {
+            std::lock_guard<std::mutex> lock(_mutexSpills);
+            _spillsSecondary.push_back(p);
+          }
 
-        _spillsSizeSecondary += numBytes;
+          _spillsSizeSecondary += numBytes;
 
-        return p;
-      }
+          return p;
+        }
+      } while (!_offsetSecondary.compare_exchange_weak(current, current + numBytes, std::memory_order_relaxed));
 
-      result = (void *)(_ptrHost + _offsetSecondary.load());
-      _offsetSecondary += numBytes;
-      // memset(result, 0, (int) numBytes);
+      auto result = (void *)(_ptrHost + current);
 
       sd_debug("Allocating %lld bytes from [HOST] workspace; Current PTR: %p; Current offset: %lld\n", numBytes, result,
-               _offset.load());
-
-      this->_mutexAllocation.unlock();
+               _offsetSecondary.load());
 
       return result;
     } break;
@@ -200,37 +285,16 @@ void *Workspace::allocateBytes(MemoryType type, LongType numBytes) {
       if (numBytes < 1)
         throw allocation_exception::build("Number of [DEVICE] bytes for allocation should be positive", numBytes);
 
-      // numBytes += 32;
-      void *result = nullptr;
       this->_cycleAllocations += numBytes;
-      this->_mutexAllocation.lock();
-
-      if (_offset.load() + numBytes > _currentSize) {
-        sd_debug("Allocating %lld [DEVICE] bytes in spills\n", numBytes);
-        this->_mutexAllocation.unlock();
 
-        Pointer p;
-        auto res = cudaMalloc(reinterpret_cast<void **>(&p), numBytes);
-        if (res != 0) throw cuda_exception::build("Can't allocate [DEVICE] memory", res);
+      void *result = _numArenas > 0 ? allocateFromArena(numBytes) : nullptr;
+      if (result == nullptr) result = allocateFromBuffer(numBytes);
 
-        _mutexSpills.lock();
-        _spills.push_back(p);
-        _mutexSpills.unlock();
-
-        _spillsSize += numBytes;
-
-        return p;
-      }
-
-      result = (void *)(_ptrDevice + _offset.load());
-      _offset += numBytes;
-      // memset(result, 0, (int) numBytes);
+      if (result == nullptr) return allocateSpill(numBytes);
 
       sd_debug("Allocating %lld bytes from [DEVICE] workspace; Current PTR: %p; Current offset: %lld\n", numBytes,
                result, _offset.load());
 
-      this->_mutexAllocation.unlock();
-
       return result;
     } break;
     default:
@@ -240,7 +304,9 @@ void *Workspace::allocateBytes(MemoryType type, LongType numBytes) {
 
 Workspace *Workspace::clone() {
   // for clone we take whatever is higher: current allocated size, or allocated size of current loop
-  return new Workspace(sd::math::sd_max<LongType>(this->getCurrentSize(), this->_cycleAllocations.load()));
+  auto result = new Workspace(sd::math::sd_max<LongType>(this->getCurrentSize(), this->_cycleAllocations.load()));
+  result->setThreadArenas(_numArenas, _arenaSize);
+  return result;
 }
 
 LongType Workspace::getAllocatedSecondarySize() { return getCurrentSecondarySize() + getSpilledSecondarySize(); }
@@ -0,0 +1,135 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Size-classed pool of host memory blocks
+//
+#include "../SpillPool.h"
+
+#include <system/op_boilerplate.h>
+
+#include <stdlib.h>
+
+namespace sd {
+namespace memory {
+
+// 64 bytes is the smallest class, then 4 classes per power of two up to 2^63
+static const int SD_SPILL_POOL_CLASSES = 1 + (63 - 6) * 4;
+
+SpillPool::SpillPool(LongType limit) : _free(SD_SPILL_POOL_CLASSES), _limit(limit) {}
+
+SpillPool::~SpillPool() { purge(); }
+
+int SpillPool::sizeClass(LongType numBytes) {
+  if (numBytes <= 64) return 0;
+
+  // numBytes lies within (2^k, 2^(k+1)], which is split into 4 equal steps
+  auto k = 63 - __builtin_clzll(static_cast<unsigned long long>(numBytes - 1));
+  auto lower = 1LL << k;
+  auto step = lower >> 2;
+  auto s = (numBytes - lower + step - 1) / step;
+
+  return 1 + (k - 6) * 4 + static_cast<int>(s - 1);
+}
+
+LongType SpillPool::classCapacity(int sizeClass) {
+  if (sizeClass == 0) return 64;
+
+  auto k = 6 + (sizeClass - 1) / 4;
+  auto s = (sizeClass - 1) % 4 + 1;
+  return static_cast<LongType>(4 + s) << (k - 2);
+}
+
+void *SpillPool::allocateBlock(LongType capacity) {
+#if defined(SD_ALIGNED_ALLOC)
+  void *p = aligned_alloc(SD_DESIRED_ALIGNMENT, (capacity + SD_DESIRED_ALIGNMENT - 1) & (-SD_DESIRED_ALIGNMENT));
+#else
+  void *p = malloc(capacity);
+#endif
+  CHECK_ALLOC(p, "Failed to allocate spill block", capacity);
+  return p;
+}
+
+void SpillPool::releaseBlock(void *ptr) { free(ptr); }
+
+void *SpillPool::allocate(LongType numBytes, LongType &capacity) {
+  auto cls = sizeClass(numBytes);
+  capacity = classCapacity(cls);
+
+  {
+    std::lock_guard<std::mutex> lock(_locker);
+    auto &list = _free[cls];
+    if (!list.empty()) {
+      auto p = list.back();
+      list.pop_back();
+      _pooledBytes -= capacity;
+      return p;
+    }
+  }
+
+  return allocateBlock(capacity);
+}
+
+void SpillPool::release(void *ptr, LongType capacity) {
+  if (ptr == nullptr) return;
+
+  {
+    std::lock_guard<std::mutex> lock(_locker);
+    if (_pooledBytes + capacity <= _limit) {
+      _free[sizeClass(capacity)].push_back(ptr);
+      _pooledBytes += capacity;
+      return;
+    }
+  }
+
+  releaseBlock(ptr);
+}
+
+void SpillPool::purge() {
+  std::lock_guard<std::mutex> lock(_locker);
+  for (auto &list : _free) {
+    for (auto p : list) releaseBlock(p);
+
+    list.clear();
+  }
+
+  _pooledBytes = 0;
+}
+
+void SpillPool::setLimit(LongType numBytes) {
+  {
+    std::lock_guard<std::mutex> lock(_locker);
+    _limit = numBytes;
+    if (_pooledBytes <= _limit) return;
+  }
+
+  // new limit is lower than what we hold, so we just drop everything and let it refill
+  purge();
+}
+
+LongType SpillPool::limit() {
+  std::lock_guard<std::mutex> lock(_locker);
+  return _limit;
+}
+
+LongType SpillPool::pooledBytes() {
+  std::lock_guard<std::mutex> lock(_locker);
+  return _pooledBytes;
+}
+}  // namespace memory
+}  // namespace sd
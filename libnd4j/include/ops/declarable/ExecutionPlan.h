@@ -0,0 +1,109 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Execution plans for DeclarableOp::execute(Context*). A plan holds what execute() learns about a call before the
+// op itself runs: inputs and arguments passed validation, shapes of outputs and which platform helper (if any) is
+// used. Plans are keyed by call signature: op hash, engine, shape infos (so data types too) of all inputs and of
+// outputs provided by caller, and all I/T/B/D/S arguments.
+//
+// Output shapes are kept only if shape function didn't request any input array, that is they depend on input shapes
+// and arguments alone. Ops like unique or reshape with shape given as input still reuse validation and helper
+// selection, but their shape function runs every time.
+//
+
+#ifndef LIBND4J_EXECUTIONPLAN_H
+#define LIBND4J_EXECUTIONPLAN_H
+
+#include <graph/Context.h>
+#include <helpers/generic/StripedLocks.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace sd {
+namespace ops {
+namespace platforms {
+class PlatformHelper;
+}
+
+// once cache holds this many plans it is cleared and starts over
+static constexpr LongType EXECUTION_PLAN_CACHE_LIMIT = 1 << 14;
+
+class SD_LIB_EXPORT ExecutionPlan {
+ public:
+  // value prepareOutputs() returned
+  int numOutputs = 0;
+
+  // shape infos of outputs, empty if they have to be evaluated by shape function on every call
+  std::vector<std::vector<LongType>> outputShapes;
+
+  // helper to invoke instead of validateAndExecute(), nullptr if there's none usable
+  platforms::PlatformHelper* helper = nullptr;
+
+  bool hasOutputShapes() const { return !outputShapes.empty(); }
+
+  /**
+   * This method allocates outputs missing in fast path of given context, as prepareOutputs() would do
+   */
+  void allocateOutputs(graph::Context& block) const;
+};
+
+class SD_LIB_EXPORT ExecutionPlanCache {
+ private:
+  struct SignatureHash {
+    size_t operator()(const std::vector<LongType>& signature) const;
+  };
+
+  // lookups on the hot path only share the lock, store() and clear() take it exclusively
+  MUTEX_TYPE _lock;
+  std::unordered_map<std::vector<LongType>, std::shared_ptr<const ExecutionPlan>, SignatureHash> _plans;
+
+  std::atomic<LongType> _hits{0};
+  std::atomic<LongType> _misses{0};
+
+  ExecutionPlanCache() = default;
+
+ public:
+  static ExecutionPlanCache& getInstance();
+
+  /**
+   * This method builds signature of op call in given fast path context, returns false if call can't be planned
+   */
+  static bool buildSignature(LongType opHash, graph::Context& block, std::vector<LongType>& signature);
+
+  /**
+   * This method returns plan for given signature, or nullptr if there's none yet
+   */
+  std::shared_ptr<const ExecutionPlan> lookup(const std::vector<LongType>& signature);
+
+  void store(const std::vector<LongType>& signature, std::shared_ptr<const ExecutionPlan> plan);
+
+  void clear();
+
+  LongType hits();
+  LongType misses();
+  LongType size();
+};
+}  // namespace ops
+}  // namespace sd
+
+#endif  // LIBND4J_EXECUTIONPLAN_H
@@ -29,11 +29,10 @@
 namespace sd {
 namespace ops {
 
-CUSTOM_OP_IMPL(percentile, 1, 1, false, 1, -2) {
+CUSTOM_OP_IMPL(percentile, 1, 1, false, -1, -2) {
   auto input = INPUT_VARIABLE(0);    // tensor with rank > 0
   auto output = OUTPUT_VARIABLE(0);  // [bS, oD, oH, oW, iC] (NDHWC) or [bS, iC, oD, oH, oW] (NCDHW)
 
-  const auto q = T_ARG(0);  // percentile
   const int interpolation = block.getTArguments()->size() > 1 ? T_ARG(1) : 2.;  // 0-"lower", 1-"higher", 2-"nearest"(default)
   const int keepDims = block.getTArguments()->size() > 2 ? T_ARG(2) : 0.;  // false is default
 
@@ -42,8 +41,21 @@ CUSTOM_OP_IMPL(percentile, 1, 1, false, 1, -2) {
 
   REQUIRE_TRUE(inputArrRank > 0, 0, "PERCENTILE OP: rank of input array must be positive (>0), but got %i instead !",
                inputArrRank);
-  REQUIRE_TRUE(0.f <= q && q <= 100.f, 0,
-               "PERCENTILE OP: percentile parameter must be within [0, 100] range, but got %f instead !", q);
+
+  // optional second input holds several percentiles, all of them are computed from one pass over every sub-array
+  std::vector<float> quantiles;
+  if (block.width() > 1) {
+    auto qArr = INPUT_VARIABLE(1);
+    for (LongType i = 0; i < qArr->lengthOf(); ++i) quantiles.push_back(qArr->e<float>(i));
+  } else {
+    REQUIRE_TRUE(block.getTArguments()->size() > 0, 0,
+                 "PERCENTILE OP: percentile must be given either as float argument or as second input !");
+    quantiles.push_back(T_ARG(0));
+  }
+
+  for (const auto quantile : quantiles)
+    REQUIRE_TRUE(0.f <= quantile && quantile <= 100.f, 0,
+                 "PERCENTILE OP: percentile parameter must be within [0, 100] range, but got %f instead !", quantile);
   REQUIRE_TRUE(interpolation == 0 || interpolation == 1 || interpolation == 2, 0,
                "PERCENTILE OP: the correct values for interpolation parameter are 0, 1, 2, but got %i instead !",
                interpolation);
@@ -61,7 +73,7 @@ CUSTOM_OP_IMPL(percentile, 1, 1, false, 1, -2) {
   }
 
   std::vector<LongType> axises = *block.getIArguments();
-  helpers::percentile(block.launchContext(), *input, *output, axises, q, interpolation);
+  helpers::percentile(block.launchContext(), *input, *output, axises, quantiles, interpolation);
 
   return Status::OK;
 }
@@ -69,6 +81,7 @@ CUSTOM_OP_IMPL(percentile, 1, 1, false, 1, -2) {
 DECLARE_TYPES(percentile) {
   getOpDescriptor()
       ->setAllowedInputTypes(0, ANY)
+      ->setAllowedInputTypes(1, {ALL_FLOATS, ALL_INTS})
       ->setAllowedOutputTypes(0, INHERIT)
       ->setSameMode(true);
 }
@@ -99,6 +112,15 @@ DECLARE_SHAPE_FN(percentile) {
   auto outputShapeInfo = ShapeUtils::evalReduceShapeInfo(shape::order(inputShapeInfo), &axises, inputShapeInfo, keepDims,
                                                          false, block.getWorkspace());
 
+  // vector of percentiles adds leading dimension of the same length
+  if (block.width() > 1 && shape::rank(inputShape->at(1)) > 0) {
+    std::vector<LongType> outputShape = {shape::length(inputShape->at(1))};
+    for (int i = 0; i < shape::rank(outputShapeInfo); ++i) outputShape.push_back(shape::shapeOf(outputShapeInfo)[i]);
+
+    return SHAPELIST(ConstantShapeHelper::getInstance().createShapeInfo(ArrayOptions::dataType(inputShapeInfo), 'c',
+                                                                        outputShape));
+  }
+
   return SHAPELIST(outputShapeInfo);
 }
 
@@ -0,0 +1,144 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Tiled scaled dot product attention with online softmax
+//
+
+#include <system/op_boilerplate.h>
+#if NOT_EXCLUDED(OP_fused_dot_product_attention)
+
+#include <ops/declarable/CustomOperations.h>
+#include <ops/declarable/helpers/attention.h>
+
+namespace sd {
+namespace ops {
+
+static void validateFusedAttention(NDArray* queries, NDArray* keys, NDArray* values, NDArray* qMask,
+                                   NDArray* vMask) {
+  REQUIRE_TRUE(queries->isR() && keys->dataType() == queries->dataType() && values->dataType() == queries->dataType(),
+               0, "FUSED_DOT_PRODUCT_ATTENTION op: queries, keys and values must have the same floating point type !");
+  const int rank = queries->rankOf();
+  REQUIRE_TRUE(rank >= 2 && keys->rankOf() == rank && values->rankOf() == rank, 0,
+               "FUSED_DOT_PRODUCT_ATTENTION op: queries, keys and values must have the same rank >= 2, but got %i, %i "
+               "and %i !",
+               rank, keys->rankOf(), values->rankOf());
+  for (int e = 0; e < rank - 2; e++)
+    REQUIRE_TRUE(keys->sizeAt(e) == queries->sizeAt(e) && values->sizeAt(e) == queries->sizeAt(e), 0,
+                 "FUSED_DOT_PRODUCT_ATTENTION op: leading dimensions of queries, keys and values must match !");
+  REQUIRE_TRUE(keys->sizeAt(-1) == queries->sizeAt(-1), 0,
+               "FUSED_DOT_PRODUCT_ATTENTION op: queries and keys must have the same feature size, but got %i and %i !",
+               queries->sizeAt(-1), keys->sizeAt(-1));
+  REQUIRE_TRUE(keys->sizeAt(-2) == values->sizeAt(-2), 0,
+               "FUSED_DOT_PRODUCT_ATTENTION op: keys and values must have the same number of timesteps, but got %i "
+               "and %i !",
+               keys->sizeAt(-2), values->sizeAt(-2));
+
+  const LongType groups = queries->lengthOf() / (queries->sizeAt(-2) * queries->sizeAt(-1));
+  const auto validMask = [groups](NDArray* mask, const LongType length) -> bool {
+    if (mask == nullptr || mask->isEmpty()) return true;
+    if (mask->lengthOf() % length != 0) return false;
+    const LongType rows = mask->lengthOf() / length;
+    return rows > 0 && groups % rows == 0;
+  };
+  REQUIRE_TRUE(validMask(qMask, queries->sizeAt(-2)), 0,
+               "FUSED_DOT_PRODUCT_ATTENTION op: queries mask must have shape [batchSize, Tq] !");
+  REQUIRE_TRUE(validMask(vMask, keys->sizeAt(-2)), 0,
+               "FUSED_DOT_PRODUCT_ATTENTION op: values mask must have shape [batchSize, Tv] !");
+}
+
+CUSTOM_OP_IMPL(fused_dot_product_attention, -2, 2, false, -2, 0) {
+  auto queries = INPUT_VARIABLE(0);
+  auto values = INPUT_VARIABLE(1);
+  auto keys = block.width() > 2 ? INPUT_VARIABLE(2) : values;
+  auto qMask = block.width() > 3 ? INPUT_VARIABLE(3) : nullptr;
+  auto vMask = block.width() > 4 ? INPUT_VARIABLE(4) : nullptr;
+
+  auto output = OUTPUT_VARIABLE(0);
+  auto logSumExp = OUTPUT_VARIABLE(1);
+
+  auto scale = block.numT() > 0 ? T_ARG(0) : 1.0;
+  auto useCausalMask = block.numB() > 0 ? B_ARG(0) : false;
+
+  validateFusedAttention(queries, keys, values, qMask, vMask);
+
+  helpers::fusedDotProductAttention(block.launchContext(), queries, keys, values, qMask, vMask, scale, useCausalMask,
+                                    output, logSumExp);
+
+  return sd::Status::OK;
+}
+
+DECLARE_TYPES(fused_dot_product_attention) {
+  getOpDescriptor()->setAllowedInputTypes({ALL_FLOATS, ALL_INTS, BOOL})->setAllowedOutputTypes({ALL_FLOATS});
+}
+
+DECLARE_SHAPE_FN(fused_dot_product_attention) {
+  auto queries = INPUT_VARIABLE(0);
+  auto values = INPUT_VARIABLE(1);
+
+  std::vector<LongType> outShape = queries->getShapeAsVector();
+  outShape.back() = values->sizeAt(-1);
+  std::vector<LongType> lseShape(outShape.begin(), outShape.end() - 1);
+
+  auto outShapeInfo =
+      ConstantShapeHelper::getInstance().bufferForShapeInfo(queries->dataType(), 'c', outShape)->primary();
+  auto lseShapeInfo =
+      ConstantShapeHelper::getInstance().bufferForShapeInfo(queries->dataType(), 'c', lseShape)->primary();
+
+  return SHAPELIST(outShapeInfo, lseShapeInfo);
+}
+
+CUSTOM_OP_IMPL(fused_dot_product_attention_bp, -2, 3, false, -2, 0) {
+  auto queries = INPUT_VARIABLE(0);
+  auto values = INPUT_VARIABLE(1);
+  auto keys = INPUT_VARIABLE(2);
+  auto output = INPUT_VARIABLE(3);
+  auto logSumExp = INPUT_VARIABLE(4);
+  auto eps = INPUT_VARIABLE(5);
+  auto qMask = block.width() > 6 ? INPUT_VARIABLE(6) : nullptr;
+  auto vMask = block.width() > 7 ? INPUT_VARIABLE(7) : nullptr;
+
+  auto dLdq = OUTPUT_VARIABLE(0);
+  auto dLdv = OUTPUT_VARIABLE(1);
+  auto dLdk = OUTPUT_VARIABLE(2);
+
+  auto scale = block.numT() > 0 ? T_ARG(0) : 1.0;
+  auto useCausalMask = block.numB() > 0 ? B_ARG(0) : false;
+
+  validateFusedAttention(queries, keys, values, qMask, vMask);
+  REQUIRE_TRUE(eps->isSameShape(output), 0,
+               "FUSED_DOT_PRODUCT_ATTENTION_BP op: gradient and output of forward pass must have the same shape !");
+
+  helpers::fusedDotProductAttentionBp(block.launchContext(), queries, keys, values, qMask, vMask, scale,
+                                      useCausalMask, output, logSumExp, eps, dLdq, dLdk, dLdv);
+
+  return sd::Status::OK;
+}
+
+DECLARE_TYPES(fused_dot_product_attention_bp) {
+  getOpDescriptor()->setAllowedInputTypes({ALL_FLOATS, ALL_INTS, BOOL})->setAllowedOutputTypes({ALL_FLOATS});
+}
+
+DECLARE_SHAPE_FN(fused_dot_product_attention_bp) {
+  return SHAPELIST(CONSTANT(inputShape->at(0)), CONSTANT(inputShape->at(1)), CONSTANT(inputShape->at(2)));
+}
+
+}  // namespace ops
+}  // namespace sd
+
+#endif
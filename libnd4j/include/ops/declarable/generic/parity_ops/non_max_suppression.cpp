@@ -52,6 +52,13 @@ CUSTOM_OP_IMPL(non_max_suppression, 2, 1, false, 0, 0) {
   } else if (block.getTArguments()->size() > 1) {
     scoreThreshold = T_ARG(1);
   }
+
+  double softNmsSigma = 0.;
+  if (block.width() > 5) {
+    softNmsSigma = INPUT_VARIABLE(5)->e<double>(0);
+  } else if (block.getTArguments()->size() > 2) {
+    softNmsSigma = T_ARG(2);
+  }
   if (boxes->isEmpty() || scales->isEmpty()) return Status::OK;
 
   if (output->isEmpty()) return Status::OK;
@@ -75,8 +82,12 @@ CUSTOM_OP_IMPL(non_max_suppression, 2, 1, false, 0, 0) {
                "image.non_max_suppression: Boxes and scores inputs should have the same data type, but %s and %s "
                "were given.",
                DataTypeUtils::asString(boxes->dataType()).c_str(), DataTypeUtils::asString(scales->dataType()).c_str());
+  REQUIRE_TRUE(softNmsSigma >= 0., 0,
+               "image.non_max_suppression: The soft NMS sigma should be non-negative, but %lf is given.",
+               softNmsSigma);
+
   helpers::nonMaxSuppression(block.launchContext(), boxes, scales, maxOutputSize, overlayThreshold, scoreThreshold,
-                             output);
+                             output, softNmsSigma);
   return Status::OK;
 }
 
@@ -151,6 +162,13 @@ CUSTOM_OP_IMPL(non_max_suppression_v3, 2, 1, false, 0, 0) {
   } else if (block.getTArguments()->size() > 1) {
     scoreThreshold = T_ARG(1);
   }
+
+  double softNmsSigma = 0.;
+  if (block.width() > 5) {
+    softNmsSigma = INPUT_VARIABLE(5)->e<double>(0);
+  } else if (block.getTArguments()->size() > 2) {
+    softNmsSigma = T_ARG(2);
+  }
   if (boxes->isEmpty() || scales->isEmpty()) return Status::OK;
   if (output->isEmpty()) return Status::OK;
 
@@ -172,8 +190,12 @@ CUSTOM_OP_IMPL(non_max_suppression_v3, 2, 1, false, 0, 0) {
                "were given.",
                DataTypeUtils::asString(boxes->dataType()).c_str(), DataTypeUtils::asString(scales->dataType()).c_str());
 
+  REQUIRE_TRUE(softNmsSigma >= 0., 0,
+               "image.non_max_suppression_v3: The soft NMS sigma should be non-negative, but %lf is given.",
+               softNmsSigma);
+
   helpers::nonMaxSuppressionV3(block.launchContext(), boxes, scales, maxOutputSize, overlayThreshold, scoreThreshold,
-                               output);
+                               output, softNmsSigma);
   return Status::OK;
 }
 
@@ -210,10 +232,17 @@ DECLARE_SHAPE_FN(non_max_suppression_v3) {
     scoreThreshold = T_ARG(1);
   }
 
+  double softNmsSigma = 0.;
+  if (block.width() > 5) {
+    softNmsSigma = INPUT_VARIABLE(5)->e<double>(0);
+  } else if (block.getTArguments()->size() > 2) {
+    softNmsSigma = T_ARG(2);
+  }
+
   auto len = maxOutputSize;
   if (len > 0)
     len = helpers::nonMaxSuppressionV3(block.launchContext(), boxes, scales, maxOutputSize, overlayThreshold,
-                                       scoreThreshold, nullptr);
+                                       scoreThreshold, nullptr, softNmsSigma);
 
   if(len == 0) {
     std::vector<LongType> shape = {0};
@@ -53,10 +53,13 @@ CUSTOM_OP_IMPL(non_max_suppression_overlaps, 2, 1, false, 0, 0) {
   double scoreThreshold = -DataTypeUtils::infOrMax<double>();
   if (block.getTArguments()->size() > 0) overlapThreshold = T_ARG(0);
   if (block.getTArguments()->size() > 1) scoreThreshold = T_ARG(1);
+  double softNmsSigma = block.getTArguments()->size() > 2 ? T_ARG(2) : 0.;
+  REQUIRE_TRUE(softNmsSigma >= 0., 0,
+               "image.non_max_suppression_overlaps: The soft NMS sigma should be non-negative, but %lf is given.",
+               softNmsSigma);
 
-  // TODO: refactor helpers to multithreaded facility
   helpers::nonMaxSuppressionGeneric(block.launchContext(), boxes, scales, maxOutputSize, overlapThreshold,
-                                    scoreThreshold, output);
+                                    scoreThreshold, output, softNmsSigma);
   return Status::OK;
 }
 
@@ -76,7 +79,8 @@ DECLARE_SHAPE_FN(non_max_suppression_overlaps) {
 
   LongType boxSize =
       helpers::nonMaxSuppressionGeneric(block.launchContext(), INPUT_VARIABLE(0), INPUT_VARIABLE(1), maxOutputSize,
-                                        overlapThreshold, scoreThreshold, nullptr);
+                                        overlapThreshold, scoreThreshold, nullptr,
+                                        block.getTArguments()->size() > 2 ? T_ARG(2) : 0.);
   if (boxSize < maxOutputSize) {
     maxOutputSize = boxSize;
   }
@@ -331,9 +331,12 @@ DECLARE_BROADCASTABLE_OP(boolean_xor, 0, 0);
  * This operation performs calculation of percentile of input array along given axises
  *
  * Input - tensor with rank N > 0
+ * Optional input - vector of percentiles in range [0,100], all of them are computed at once and stacked along new
+ * leading dimension of output
  * Output - tensor with rank (N - length(axis)) or scalar if number of Integer arguments is zero
  * Float arguments:
- *   0: percentile (scalar) in range [0,100] (inclusively)
+ *   0: percentile (scalar) in range [0,100] (inclusively), ignored if vector of percentiles is given as input, then
+ *      it may be omitted as well, unless interpolation or keepDims follow and it is needed as placeholder
  *   1: interpolation (optional), possible values are 0-"lower", 1-"higher", 2-"nearest"(default)
  *   2: keepDims (optional), if it is non zero, then unities are kept in reduced resulting shape of output array,
  * default is 0 Integer arguments - axis - the sequence of axises to calculate percentile along, if sequence is empty
@@ -341,7 +344,7 @@ DECLARE_BROADCASTABLE_OP(boolean_xor, 0, 0);
  *
  */
 #if NOT_EXCLUDED(OP_percentile)
-DECLARE_CUSTOM_OP(percentile, 1, 1, false, 1, -2);
+DECLARE_CUSTOM_OP(percentile, 1, 1, false, -1, -2);
 #endif
 
 /**
@@ -253,6 +253,33 @@ DECLARE_CUSTOM_OP(dot_product_attention_v2, -2, -1, false, -2, 2);
 DECLARE_CUSTOM_OP(dot_product_attention_v2_bp, -2, -3, false, -2, 1);
 #endif
 
+/**
+ * Scaled dot product attention computed in tiles with online softmax, the [Tq, Tv] score matrix and masks are never
+ * materialized, so memory use is linear in sequence length
+ * out = softmax(scale * q * k^T) * v
+ *
+ * Expected arguments:
+ * q: queries of shape [..., Tq, D], e.g. [batchSize, Tq, D] or [batchSize, numHeads, Tq, D]
+ * v: values of shape [..., Tv, Dv]
+ * k: keys of shape [..., Tv, D]
+ * qMask: OPTIONAL; [batchSize, Tq], masked queries produce zero output
+ * vMask: OPTIONAL; [batchSize, Tv], masked keys are not attended to
+ *
+ * float input arguments:
+ * 0: scale, 1.0 by default
+ *
+ * boolean input arguments:
+ * 0: useCausalMask, query i attends to keys 0..i only
+ *
+ * Output Arrays:
+ * 0: attention result of shape [..., Tq, Dv]
+ * 1: log of softmax denominator of shape [..., Tq], input of fused_dot_product_attention_bp
+ */
+#if NOT_EXCLUDED(OP_fused_dot_product_attention)
+DECLARE_CUSTOM_OP(fused_dot_product_attention, -2, 2, false, -2, 0);
+DECLARE_CUSTOM_OP(fused_dot_product_attention_bp, -2, 3, false, -2, 0);
+#endif
+
 
 /**
  * This performs multi-headed dot product attention on the given timeseries input
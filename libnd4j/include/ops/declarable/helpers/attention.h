@@ -0,0 +1,60 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Fused scaled dot product attention, score matrix is never materialized
+//
+
+#ifndef LIBND4J_HELPERS_ATTENTION_H
+#define LIBND4J_HELPERS_ATTENTION_H
+#include <array/NDArray.h>
+#include <system/op_boilerplate.h>
+
+namespace sd {
+namespace ops {
+namespace helpers {
+
+/**
+ * softmax(scale * Q * K^T) * V computed over tiles of queries and keys with online softmax
+ *
+ * @param queries   [..., Tq, D]
+ * @param keys      [..., Tv, D]
+ * @param values    [..., Tv, Dv]
+ * @param qMask     optional [B, Tq], masked queries get zero output
+ * @param vMask     optional [B, Tv], masked keys are not attended to
+ * @param causal    query i only attends to keys 0..i
+ * @param output    [..., Tq, Dv]
+ * @param logSumExp [..., Tq], log of softmax denominator per query (including max shift), -inf for queries without
+ *                  any visible key; this is all backward pass needs besides inputs and output
+ */
+SD_LIB_HIDDEN void fusedDotProductAttention(LaunchContext* context, NDArray* queries, NDArray* keys,
+                                            NDArray* values, NDArray* qMask, NDArray* vMask, double scale,
+                                            bool causal, NDArray* output, NDArray* logSumExp);
+
+/**
+ * gradients of fusedDotProductAttention, attention probabilities are recomputed tile by tile from logSumExp
+ */
+SD_LIB_HIDDEN void fusedDotProductAttentionBp(LaunchContext* context, NDArray* queries, NDArray* keys,
+                                              NDArray* values, NDArray* qMask, NDArray* vMask, double scale,
+                                              bool causal, NDArray* output, NDArray* logSumExp, NDArray* eps,
+                                              NDArray* dLdq, NDArray* dLdk, NDArray* dLdv);
+
+}  // namespace helpers
+}  // namespace ops
+}  // namespace sd
+#endif
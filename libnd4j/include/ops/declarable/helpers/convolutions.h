@@ -488,6 +488,20 @@ class SD_LIB_HIDDEN ConvolutionUtils {
                        const LongType sH, const LongType sW, LongType pH, LongType pW, const LongType dH, const LongType dW, const int paddingMode,
                        const int isNCHW, const int wFormat);
 
+  // Winograd F(2x2,3x3) / F(4x4,3x3) is used for 3x3 stride-1 undilated float/double convolutions with enough channels,
+  // unless platform helpers are forbidden or oneDNN takes over convolutions
+  static bool useWinograd2d(NDArray* input, NDArray* weights, NDArray* output, const LongType kH, const LongType kW,
+                            const LongType sH, const LongType sW, const LongType dH, const LongType dW,
+                            const int wFormat);
+
+  // paddings are used as given, like im2col path does
+  static void conv2dWinograd(NDArray* input, NDArray* weights, NDArray* bias, NDArray* output, LongType pH,
+                             LongType pW, const int isNCHW, const int wFormat);
+
+  // gradI only, gradW and gradB stay with im2col
+  static void conv2dBPWinograd(NDArray* weights, NDArray* gradO, NDArray* gradI, LongType pH, LongType pW,
+                               const int isNCHW, const int wFormat);
+
   static void depthwiseConv2d(sd::graph::Context& block, NDArray* input, NDArray* weights,
                               NDArray* bias, NDArray* output, const LongType kH, const LongType kW, const LongType sH,
                               const LongType sW, LongType pH, LongType pW, const LongType dH, const LongType dW, const int paddingMode,
@@ -21,16 +21,152 @@
 //
 #include <array/NDArrayFactory.h>
 #include <execution/Threads.h>
+#include <helpers/BlasHelper.h>
 #include <helpers/MmulHelper.h>
 #include <ops/declarable/helpers/addBias.h>
 #include <ops/declarable/helpers/convolutions.h>
 #include <ops/declarable/helpers/im2col.h>
+#include <ops/gemm.h>
+
+#include <algorithm>
+#include <climits>
+#include <type_traits>
 
 #if NOT_EXCLUDED(OP_col2im) && NOT_EXCLUDED(OP_im2col)
 
 namespace sd {
 namespace ops {
 
+// upper bound for one block of NHWC im2col rows, so the columns never exist for the whole batch at once
+static constexpr LongType NHWC_COL_BLOCK_BYTES = 8 * 1024 * 1024;
+
+//////////////////////////////////////////////////////////////////////////
+// row-major C[M x N] = A[M x K] * B[K x N] + beta * C, going to vendor BLAS the same way MmulHelper does
+template <typename T>
+static void nhwcGemm(const LongType M, const LongType N, const LongType K, const T* A, const LongType lda,
+                     const T* B, const LongType ldb, const double beta, T* C, const LongType ldc) {
+  const bool fitsInt = M <= INT_MAX && N <= INT_MAX && K <= INT_MAX && lda <= INT_MAX && ldb <= INT_MAX;
+  if (fitsInt && Environment::getInstance().isEnableBlas()) {
+    if constexpr (std::is_same<T, float>::value) {
+      if (BlasHelper::getInstance().hasGEMM(DataType::FLOAT32)) {
+        BlasHelper::getInstance().sgemm()(CblasRowMajor, CblasNoTrans, CblasNoTrans, M, N, K, 1.f,
+                                          const_cast<float*>(A), lda, const_cast<float*>(B), ldb,
+                                          static_cast<float>(beta), C, ldc);
+        return;
+      }
+    } else if constexpr (std::is_same<T, double>::value) {
+      if (BlasHelper::getInstance().hasGEMM(DataType::DOUBLE)) {
+        BlasHelper::getInstance().dgemm()(CblasRowMajor, CblasNoTrans, CblasNoTrans, M, N, K, 1.0,
+                                          const_cast<double*>(A), lda, const_cast<double*>(B), ldb, beta, C, ldc);
+        return;
+      }
+    }
+  }
+
+  blas::GEMM<T, T, T>::op(M, N, K, 1.0, A, lda, 1, B, ldb, 1, beta, C, ldc, 1);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// conv2d on NHWC arrays as they are: output pixels are GEMM rows and (kh, kw, ic) are GEMM columns, so the input,
+// the weights and the output are used without permuted copies. Returns false if arrays don't fit this path
+template <typename T>
+static bool conv2dNhwc_(NDArray* input, NDArray* weights, NDArray* bias, NDArray* output, const LongType kH,
+                        const LongType kW, const LongType sH, const LongType sW, LongType pH, LongType pW,
+                        const LongType dH, const LongType dW, const int wFormat) {
+  // input   [bS, iH, iW, iC]
+  // weights [kH, kW, iC, oC], [oC, iC, kH, kW], [oC, kH, kW, iC]
+  // output  [bS, oH, oW, oC]
+  if (input->ordering() != 'c' || !shape::isDense(input->shapeInfo()) || output->ordering() != 'c' ||
+      !shape::isDense(output->shapeInfo()) || input->dataType() != output->dataType() ||
+      weights->dataType() != output->dataType() || (bias != nullptr && bias->dataType() != output->dataType()))
+    return false;
+
+  const LongType bS = input->sizeAt(0);
+  const LongType iH = input->sizeAt(1);
+  const LongType iW = input->sizeAt(2);
+  const LongType iC = ConvolutionUtils::inChannels(weights->shapeInfo(), wFormat);
+  const LongType oC = ConvolutionUtils::outChannels(weights->shapeInfo(), wFormat);
+  const LongType oH = output->sizeAt(1);
+  const LongType oW = output->sizeAt(2);
+  const LongType M = bS * oH * oW;
+  const LongType K = kH * kW * iC;
+
+  // paddings are used as given, padding mode only affects output size, same as in im2col path below
+
+  // weights as [K, oC] with rows in (kh, kw, ic) order, a view if they are already laid out like that
+  NDArray wCopy;
+  const T* w = weights->bufferAsT<T>();
+  if (wFormat != 0 || weights->ordering() != 'c' || !shape::isDense(weights->shapeInfo())) {
+    std::vector<LongType> perm = wFormat == 1 ? std::vector<LongType>({2, 3, 1, 0})
+                                 : wFormat == 2 ? std::vector<LongType>({1, 2, 3, 0})
+                                                : std::vector<LongType>({0, 1, 2, 3});
+    NDArray& permuted = weights->permute(perm, false, false);
+    wCopy = permuted.dup('c');
+    delete &permuted;
+    w = wCopy.bufferAsT<T>();
+  }
+
+  const T* x = input->bufferAsT<T>();
+  T* z = output->bufferAsT<T>();
+
+  // output starts from bias, GEMMs accumulate on top of it
+  const T* b = bias != nullptr ? bias->bufferAsT<T>() : nullptr;
+  auto initOutput = PRAGMA_THREADS_FOR {
+    for (auto r = start; r < stop; r++) {
+      T* zRow = z + r * oC;
+      if (b != nullptr)
+        std::copy(b, b + oC, zRow);
+      else
+        std::fill(zRow, zRow + oC, static_cast<T>(0));
+    }
+  };
+  samediff::Threads::parallel_for(initOutput, 0, M);
+
+  // 1x1 kernel over every pixel: NHWC input already is the [bS*iH*iW, iC] GEMM operand
+  if (kH == 1 && kW == 1 && sH == 1 && sW == 1 && pH == 0 && pW == 0 && oH == iH && oW == iW) {
+    nhwcGemm<T>(M, oC, K, x, iC, w, oC, 1.0, z, oC);
+    return true;
+  }
+
+  // otherwise im2col is done block by block straight into a row-major [rows, K] panel the GEMM consumes in place,
+  // and every block of results lands in its final place in the output
+  const LongType blockRows =
+      std::max<LongType>(1, std::min<LongType>(M, NHWC_COL_BLOCK_BYTES / static_cast<LongType>(sizeof(T) * K)));
+  std::vector<T> col(blockRows * K);
+
+  for (LongType r0 = 0; r0 < M; r0 += blockRows) {
+    const LongType rows = std::min<LongType>(blockRows, M - r0);
+
+    auto fillColumns = PRAGMA_THREADS_FOR {
+      for (auto r = start; r < stop; r++) {
+        const LongType pixel = r0 + r;
+        const LongType bIdx = pixel / (oH * oW);
+        const LongType oh = (pixel / oW) % oH;
+        const LongType ow = pixel % oW;
+        T* dst = col.data() + r * K;
+
+        for (LongType kh = 0; kh < kH; kh++) {
+          const LongType ih = oh * sH - pH + kh * dH;
+          for (LongType kw = 0; kw < kW; kw++, dst += iC) {
+            const LongType iw = ow * sW - pW + kw * dW;
+            if (ih < 0 || ih >= iH || iw < 0 || iw >= iW) {
+              std::fill(dst, dst + iC, static_cast<T>(0));
+            } else {
+              const T* src = x + ((bIdx * iH + ih) * iW + iw) * iC;
+              std::copy(src, src + iC, dst);
+            }
+          }
+        }
+      }
+    };
+    samediff::Threads::parallel_for(fillColumns, 0, rows);
+
+    nhwcGemm<T>(rows, oC, K, col.data(), K, w, oC, 1.0, z + r0 * oC, oC);
+  }
+
+  return true;
+}
+
 //////////////////////////////////////////////////////////////////////////
 template <typename X, typename Y>
 static void conv2d_(sd::graph::Context& block, NDArray* input, NDArray* weights, NDArray* bias,
@@ -42,6 +178,15 @@ static void conv2d_(sd::graph::Context& block, NDArray* input, NDArray* weights,
   // bias    [oC]
   // output  [bS, oH, oW, oC] (NHWC) or [bS, oC, oH, oW] (NCHW)
 
+  if (ConvolutionUtils::useWinograd2d(input, weights, output, kH, kW, sH, sW, dH, dW, wFormat) &&
+      (bias == nullptr || bias->dataType() == output->dataType())) {
+    ConvolutionUtils::conv2dWinograd(input, weights, bias, output, pH, pW, isNCHW, wFormat);
+    return;
+  }
+
+  if (!isNCHW && conv2dNhwc_<X>(input, weights, bias, output, kH, kW, sH, sW, pH, pW, dH, dW, wFormat))
+    return;
+
   LongType bS = input->sizeAt(0);
   LongType iC = ConvolutionUtils::inChannels(weights->shapeInfo(), wFormat);
   LongType oC = ConvolutionUtils::outChannels(weights->shapeInfo(), wFormat);
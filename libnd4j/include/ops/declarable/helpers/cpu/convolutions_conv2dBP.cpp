@@ -110,39 +110,43 @@ static void conv2dBP_(sd::graph::Context& block, NDArray* input, NDArray* weight
   }
 
   // Calculate gradI
-  NDArray weights2d;
-  if (wFormat == 0) {
-    std::vector<sd::LongType> perm = {3,2,1,0};
-    std::vector<sd::LongType> wShape = {iC * kH * kW,oC};
-    weights2d = weights->permute(perm, false, false).reshape('f', wShape);
-  } else if (wFormat == 1) {
-    std::vector<sd::LongType> wShape2 = {iC * kH * kW,oC};
-    weights2d = weights->reshape('f', wShape2);
+  if (ConvolutionUtils::useWinograd2d(gradO, weights, gradI, kH, kW, sH, sW, dH, dW, wFormat)) {
+    ConvolutionUtils::conv2dBPWinograd(weights, gradO, gradI, pH, pW, isNCHW, wFormat);
   } else {
-    std::vector<sd::LongType> wPermute = {0,2,3,1};
-    std::vector<sd::LongType> weights2dShape = {iC * kH * kW,oC};
-    weights2d = weights->permute(wPermute, false, false).reshape('f', weights2dShape);
-  }
+    NDArray weights2d;
+    if (wFormat == 0) {
+      std::vector<sd::LongType> perm = {3,2,1,0};
+      std::vector<sd::LongType> wShape = {iC * kH * kW,oC};
+      weights2d = weights->permute(perm, false, false).reshape('f', wShape);
+    } else if (wFormat == 1) {
+      std::vector<sd::LongType> wShape2 = {iC * kH * kW,oC};
+      weights2d = weights->reshape('f', wShape2);
+    } else {
+      std::vector<sd::LongType> wPermute = {0,2,3,1};
+      std::vector<sd::LongType> weights2dShape = {iC * kH * kW,oC};
+      weights2d = weights->permute(wPermute, false, false).reshape('f', weights2dShape);
+    }
 
-  std::vector<sd::LongType> columns2dShape = {iC * kH * kW, bS * oH * oW};
-  NDArray columns2d('c', columns2dShape, columns->dataType(), columns->getContext());
+    std::vector<sd::LongType> columns2dShape = {iC * kH * kW, bS * oH * oW};
+    NDArray columns2d('c', columns2dShape, columns->dataType(), columns->getContext());
 
 
-  MmulHelper::matmul(&weights2d, &gradO2d, &columns2d, false, false, 1.0, 0.0);
-  //Calculate epsilonNext by doing im2col reduction.
-  //Current col2im implementation expects input with order: [miniBatch,channels,kH,kW,outH,outW]
-  //currently have [kH,kW,inDepth,outW,outH,miniBatch] -> permute first
-  auto eps6d = columns2d.newShapeNoCopy({kH, kW,iC, oW, oH, bS }, 'f');
-  std::vector<sd::LongType> epsPermute = {5,2,1,0,4,3};
-  auto permuted = eps6d->permute(epsPermute, false, false);
+    MmulHelper::matmul(&weights2d, &gradO2d, &columns2d, false, false, 1.0, 0.0);
+    //Calculate epsilonNext by doing im2col reduction.
+    //Current col2im implementation expects input with order: [miniBatch,channels,kH,kW,outH,outW]
+    //currently have [kH,kW,inDepth,outW,outH,miniBatch] -> permute first
+    auto eps6d = columns2d.newShapeNoCopy({kH, kW,iC, oW, oH, bS }, 'f');
+    std::vector<sd::LongType> epsPermute = {5,2,1,0,4,3};
+    auto permuted = eps6d->permute(epsPermute, false, false);
 
-  // Perform col2im
-  auto ctx = block.launchContext();
-  helpers::col2im(*ctx, &permuted, gradIPermuted, sH, sW, pH, pW, iH, iW, dH, dW);
-  // Handle NHWC format if necessary
-  if (!isNCHW) {
-    std::vector<sd::LongType> perm = {0,2,3,1};
-    gradI->assign(&gradIPermuted->permute(perm, false, false));  // [bS, iC, iH, iW] -> [bS, iH, iW, iC]
+    // Perform col2im
+    auto ctx = block.launchContext();
+    helpers::col2im(*ctx, &permuted, gradIPermuted, sH, sW, pH, pW, iH, iW, dH, dW);
+    // Handle NHWC format if necessary
+    if (!isNCHW) {
+      std::vector<sd::LongType> perm = {0,2,3,1};
+      gradI->assign(&gradIPermuted->permute(perm, false, false));  // [bS, iC, iH, iW] -> [bS, iH, iW, iC]
+    }
   }
 
   // Clean up
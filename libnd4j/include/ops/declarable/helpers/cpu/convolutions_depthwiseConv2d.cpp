@@ -26,10 +26,99 @@
 #include <ops/declarable/helpers/col2im.h>
 #include <ops/declarable/helpers/convolutions.h>
 #include <ops/declarable/helpers/im2col.h>
+
+#include <algorithm>
 #if NOT_EXCLUDED(OP_col2im) && NOT_EXCLUDED(OP_im2col)
 namespace sd {
 namespace ops {
 
+// larger kernels amortize im2col + tensorDot better than the direct loop below
+static constexpr LongType NHWC_DIRECT_MAX_KERNEL = 49;
+
+//////////////////////////////////////////////////////////////////////////
+// direct depthwise convolution over NHWC arrays as they are, no permuted input copy and no columns array
+// returns false if arrays don't fit this path
+template <typename T>
+static bool depthwiseConv2dNhwc_(NDArray* input, NDArray* weights, NDArray* bias, NDArray* output,
+                                 const LongType kH, const LongType kW, const LongType sH, const LongType sW, LongType pH,
+                                 LongType pW, const LongType dH, const LongType dW, const int paddingMode,
+                                 const int wFormat) {
+  // input   [bS, iH, iW, iC]
+  // weights [kH, kW, iC, mC], [mC, iC, kH, kW], [mC, kH, kW, iC]
+  // output  [bS, oH, oW, iC*mC]
+  if (kH * kW > NHWC_DIRECT_MAX_KERNEL || input->ordering() != 'c' || !shape::isDense(input->shapeInfo()) ||
+      output->ordering() != 'c' || !shape::isDense(output->shapeInfo()) || input->dataType() != output->dataType() ||
+      weights->dataType() != output->dataType() || (bias != nullptr && bias->dataType() != output->dataType()))
+    return false;
+
+  const LongType bS = input->sizeAt(0);
+  const LongType iH = input->sizeAt(1);
+  const LongType iW = input->sizeAt(2);
+  const LongType iC = input->sizeAt(3);
+  const LongType oH = output->sizeAt(1);
+  const LongType oW = output->sizeAt(2);
+  const LongType oC = output->sizeAt(3);
+  const LongType mC = oC / iC;
+
+  if (paddingMode == 1)  // SAME
+    ConvolutionUtils::calcPadding2D(pH, pW, oH, oW, iH, iW, kH, kW, sH, sW, dH, dW);
+
+  // weights as [kH, kW, iC, mC], so each kernel tap is one contiguous oC-long row matching the output pixel layout
+  NDArray wCopy;
+  const T* w = weights->bufferAsT<T>();
+  if (wFormat != 0 || weights->ordering() != 'c' || !shape::isDense(weights->shapeInfo())) {
+    std::vector<LongType> perm = wFormat == 1 ? std::vector<LongType>({2, 3, 1, 0})
+                                 : wFormat == 2 ? std::vector<LongType>({1, 2, 3, 0})
+                                                : std::vector<LongType>({0, 1, 2, 3});
+    NDArray& permuted = weights->permute(perm, false, false);
+    wCopy = permuted.dup('c');
+    delete &permuted;
+    w = wCopy.bufferAsT<T>();
+  }
+
+  const T* x = input->bufferAsT<T>();
+  const T* b = bias != nullptr ? bias->bufferAsT<T>() : nullptr;
+  T* z = output->bufferAsT<T>();
+
+  auto func = PRAGMA_THREADS_FOR {
+    for (auto pixel = start; pixel < stop; pixel++) {
+      const LongType bIdx = pixel / (oH * oW);
+      const LongType oh = (pixel / oW) % oH;
+      const LongType ow = pixel % oW;
+      T* zPix = z + pixel * oC;
+
+      if (b != nullptr)
+        std::copy(b, b + oC, zPix);
+      else
+        std::fill(zPix, zPix + oC, static_cast<T>(0));
+
+      for (LongType kh = 0; kh < kH; kh++) {
+        const LongType ih = oh * sH - pH + kh * dH;
+        if (ih < 0 || ih >= iH) continue;
+
+        for (LongType kw = 0; kw < kW; kw++) {
+          const LongType iw = ow * sW - pW + kw * dW;
+          if (iw < 0 || iw >= iW) continue;
+
+          const T* xPix = x + ((bIdx * iH + ih) * iW + iw) * iC;
+          const T* wTap = w + (kh * kW + kw) * oC;
+
+          if (mC == 1) {
+            for (LongType ic = 0; ic < iC; ic++) zPix[ic] += xPix[ic] * wTap[ic];
+          } else {
+            for (LongType ic = 0; ic < iC; ic++)
+              for (LongType m = 0; m < mC; m++) zPix[ic * mC + m] += xPix[ic] * wTap[ic * mC + m];
+          }
+        }
+      }
+    }
+  };
+
+  samediff::Threads::parallel_for(func, 0, bS * oH * oW);
+
+  return true;
+}
+
 //////////////////////////////////////////////////////////////////////////
 template <typename X, typename Y>
 static void depthwiseConv2d_(sd::graph::Context& block, NDArray* input, NDArray* weights,
@@ -52,6 +141,10 @@ static void depthwiseConv2d_(sd::graph::Context& block, NDArray* input, NDArray*
   // paddingMode  0-VALID, 1-SAME
   // isNCHW       0-NCHW,  1-NHWC
 
+  if (!isNCHW &&
+      depthwiseConv2dNhwc_<X>(input, weights, bias, output, kH, kW, sH, sW, pH, pW, dH, dW, paddingMode, wFormat))
+    return;
+
   LongType bS, iC, iH, iW, mC, oC, oH, oW;  // batch size, input channels, input height/width, channels multiplier(oC =
   // iC*mC), output channels, output height/width
   LongType indIOioC, indIiH, indWmC, indWiC, indWkH, indOoH;  // corresponding indexes
@@ -0,0 +1,339 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Winograd F(2x2,3x3) and F(4x4,3x3) convolution for 3x3 stride-1 kernels
+//
+#include <execution/Threads.h>
+#include <helpers/BlasHelper.h>
+#include <ops/declarable/helpers/convolutions.h>
+#include <ops/gemm.h>
+
+#include <algorithm>
+#include <climits>
+#include <type_traits>
+#if NOT_EXCLUDED(OP_col2im) && NOT_EXCLUDED(OP_im2col)
+
+namespace sd {
+namespace ops {
+
+// below this many input/output channels transforms cost more than the multiplications they save
+static constexpr LongType WINOGRAD_MIN_CHANNELS = 8;
+
+// upper bound for transformed tiles (input and product) kept at once
+static constexpr LongType WINOGRAD_BLOCK_BYTES = 4 * 1024 * 1024;
+
+//////////////////////////////////////////////////////////////////////////
+// transform matrices of F(m x m, 3 x 3), tiles are alpha = m + 2 wide
+template <int M>
+struct WinogradTransform;
+
+template <>
+struct WinogradTransform<2> {
+  static constexpr int alpha = 4;
+  static constexpr double BT[4][4] = {{1, 0, -1, 0}, {0, 1, 1, 0}, {0, -1, 1, 0}, {0, 1, 0, -1}};
+  static constexpr double G[4][3] = {{1, 0, 0}, {0.5, 0.5, 0.5}, {0.5, -0.5, 0.5}, {0, 0, 1}};
+  static constexpr double AT[2][4] = {{1, 1, 1, 0}, {0, 1, -1, -1}};
+};
+
+template <>
+struct WinogradTransform<4> {
+  static constexpr int alpha = 6;
+  static constexpr double BT[6][6] = {{4, 0, -5, 0, 1, 0},  {0, -4, -4, 1, 1, 0}, {0, 4, -4, -1, 1, 0},
+                                      {0, -2, -1, 2, 1, 0}, {0, 2, -1, -2, 1, 0}, {0, 4, 0, -5, 0, 1}};
+  static constexpr double G[6][3] = {{1. / 4, 0, 0},           {-1. / 6, -1. / 6, -1. / 6}, {-1. / 6, 1. / 6, -1. / 6},
+                                     {1. / 24, 1. / 12, 1. / 6}, {1. / 24, -1. / 12, 1. / 6}, {0, 0, 1}};
+  static constexpr double AT[4][6] = {{1, 1, 1, 1, 1, 0}, {0, 1, -1, 2, -2, 0}, {0, 1, 1, 4, 4, 0}, {0, 1, -1, 8, -8, 1}};
+};
+
+// element strides of a 4d activation array, independent of its NCHW/NHWC layout
+struct ActivationStrides {
+  LongType b, c, h, w;
+};
+
+static ActivationStrides activationStrides(NDArray* arr, const int isNCHW) {
+  const auto s = arr->stridesOf();
+  return isNCHW ? ActivationStrides{s[0], s[1], s[2], s[3]} : ActivationStrides{s[0], s[3], s[1], s[2]};
+}
+
+// element strides of 3x3 weights as (kh, kw, in channel, out channel), plus offset of element (0, 0, 0, 0)
+struct KernelStrides {
+  LongType kh, kw, in, out, offset;
+};
+
+static KernelStrides kernelStrides(NDArray* weights, const int wFormat) {
+  const auto s = weights->stridesOf();
+  if (wFormat == 1)  // [oC, iC, kH, kW]
+    return {s[2], s[3], s[1], s[0], 0};
+  if (wFormat == 2)  // [oC, kH, kW, iC]
+    return {s[1], s[2], s[3], s[0], 0};
+  return {s[0], s[1], s[2], s[3], 0};  // [kH, kW, iC, oC]
+}
+
+//////////////////////////////////////////////////////////////////////////
+// U[xi][in][out] = (G g G^T)[xi] for every pair of channels
+template <typename T, int M>
+static void winogradKernels(const T* w, const KernelStrides& ws, const LongType cIn, const LongType cOut, T* u) {
+  using WT = WinogradTransform<M>;
+  constexpr int A = WT::alpha;
+
+  auto func = PRAGMA_THREADS_FOR {
+    for (auto e = start; e < stop; e++) {
+      const LongType in = e / cOut;
+      const LongType out = e % cOut;
+      const T* g = w + ws.offset + in * ws.in + out * ws.out;
+
+      double tmp[A][3];
+      for (int i = 0; i < A; i++)
+        for (int j = 0; j < 3; j++)
+          tmp[i][j] = WT::G[i][0] * g[j * ws.kw] + WT::G[i][1] * g[ws.kh + j * ws.kw] +
+                      WT::G[i][2] * g[2 * ws.kh + j * ws.kw];
+
+      for (int i = 0; i < A; i++)
+        for (int j = 0; j < A; j++)
+          u[((i * A + j) * cIn + in) * cOut + out] =
+              static_cast<T>(tmp[i][0] * WT::G[j][0] + tmp[i][1] * WT::G[j][1] + tmp[i][2] * WT::G[j][2]);
+    }
+  };
+
+  samediff::Threads::parallel_for(func, 0, cIn * cOut);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// alpha^2 independent row-major products C[xi] = A[xi] * B[xi], one per transformed tile element
+template <typename T>
+static void winogradGemms(const int count, const LongType rows, const LongType cols, const LongType depth, const T* a,
+                          const T* b, T* c) {
+  const bool useBlas = rows <= INT_MAX && cols <= INT_MAX && depth <= INT_MAX &&
+                       Environment::getInstance().isEnableBlas() &&
+                       BlasHelper::getInstance().hasGEMM(std::is_same<T, float>::value ? DataType::FLOAT32
+                                                                                       : DataType::DOUBLE);
+
+  for (int xi = 0; xi < count; xi++) {
+    const T* aX = a + xi * rows * depth;
+    const T* bX = b + xi * depth * cols;
+    T* cX = c + xi * rows * cols;
+
+    if (useBlas) {
+      if constexpr (std::is_same<T, float>::value)
+        BlasHelper::getInstance().sgemm()(CblasRowMajor, CblasNoTrans, CblasNoTrans, rows, cols, depth, 1.f,
+                                          const_cast<T*>(aX), depth, const_cast<T*>(bX), cols, 0.f, cX, cols);
+      else
+        BlasHelper::getInstance().dgemm()(CblasRowMajor, CblasNoTrans, CblasNoTrans, rows, cols, depth, 1.0,
+                                          const_cast<T*>(aX), depth, const_cast<T*>(bX), cols, 0.0, cX, cols);
+    } else {
+      blas::GEMM<T, T, T>::op(rows, cols, depth, 1.0, aX, depth, 1, bX, cols, 1, 0.0, cX, cols, 1);
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 3x3 stride-1 correlation of x [bS, cIn, xH, xW] into z [bS, cOut, zH, zW] (any layout, see strides), where
+// z(h, w) is computed from x(h - pH .. h - pH + 2, w - pW .. w - pW + 2) and x is zero outside of its bounds
+template <typename T, int M>
+static void winogradConv2d_(const T* x, const ActivationStrides& xs, const LongType bS, const LongType cIn,
+                            const LongType xH, const LongType xW, const T* w, const KernelStrides& ws, const T* bias,
+                            T* z, const ActivationStrides& zs, const LongType cOut, const LongType zH, const LongType zW,
+                            const LongType pH, const LongType pW) {
+  using WT = WinogradTransform<M>;
+  constexpr int A = WT::alpha;
+  constexpr int A2 = A * A;
+
+  std::vector<T> u(A2 * cIn * cOut);
+  winogradKernels<T, M>(w, ws, cIn, cOut, u.data());
+
+  const LongType tH = (zH + M - 1) / M;
+  const LongType tW = (zW + M - 1) / M;
+  const LongType numTiles = bS * tH * tW;
+  const LongType blockTiles = std::max<LongType>(
+      1, std::min<LongType>(numTiles, WINOGRAD_BLOCK_BYTES / static_cast<LongType>(A2 * (cIn + cOut) * sizeof(T))));
+
+  std::vector<T> v(A2 * blockTiles * cIn);
+  std::vector<T> m(A2 * blockTiles * cOut);
+
+  for (LongType t0 = 0; t0 < numTiles; t0 += blockTiles) {
+    const LongType nT = std::min<LongType>(blockTiles, numTiles - t0);
+
+    // V[xi][tile][in] = (B^T d B)[xi]
+    auto inputTransform = PRAGMA_THREADS_FOR {
+      for (auto t = start; t < stop; t++) {
+        const LongType tile = t0 + t;
+        const LongType b = tile / (tH * tW);
+        const LongType h0 = ((tile / tW) % tH) * M - pH;
+        const LongType w0 = (tile % tW) * M - pW;
+
+        for (LongType in = 0; in < cIn; in++) {
+          const T* xC = x + b * xs.b + in * xs.c;
+
+          double d[A][A];
+          for (int i = 0; i < A; i++) {
+            const LongType h = h0 + i;
+            for (int j = 0; j < A; j++) {
+              const LongType ww = w0 + j;
+              d[i][j] = (h < 0 || h >= xH || ww < 0 || ww >= xW) ? 0. : static_cast<double>(xC[h * xs.h + ww * xs.w]);
+            }
+          }
+
+          double tmp[A][A];
+          for (int i = 0; i < A; i++)
+            for (int j = 0; j < A; j++) {
+              double sum = 0.;
+              for (int k = 0; k < A; k++) sum += WT::BT[i][k] * d[k][j];
+              tmp[i][j] = sum;
+            }
+
+          for (int i = 0; i < A; i++)
+            for (int j = 0; j < A; j++) {
+              double sum = 0.;
+              for (int k = 0; k < A; k++) sum += tmp[i][k] * WT::BT[j][k];
+              v[((i * A + j) * nT + t) * cIn + in] = static_cast<T>(sum);
+            }
+        }
+      }
+    };
+    samediff::Threads::parallel_for(inputTransform, 0, nT);
+
+    // M[xi] = V[xi] * U[xi], this is where the multiplications are saved
+    winogradGemms<T>(A2, nT, cOut, cIn, v.data(), u.data(), m.data());
+
+    // z = A^T M A + bias
+    auto outputTransform = PRAGMA_THREADS_FOR {
+      for (auto t = start; t < stop; t++) {
+        const LongType tile = t0 + t;
+        const LongType b = tile / (tH * tW);
+        const LongType h0 = ((tile / tW) % tH) * M;
+        const LongType w0 = (tile % tW) * M;
+
+        for (LongType out = 0; out < cOut; out++) {
+          double tmp[M][A];
+          for (int i = 0; i < M; i++)
+            for (int j = 0; j < A; j++) {
+              double sum = 0.;
+              for (int k = 0; k < A; k++) sum += WT::AT[i][k] * static_cast<double>(m[((k * A + j) * nT + t) * cOut + out]);
+              tmp[i][j] = sum;
+            }
+
+          const double shift = bias != nullptr ? static_cast<double>(bias[out]) : 0.;
+          T* zC = z + b * zs.b + out * zs.c;
+          for (int i = 0; i < M && h0 + i < zH; i++)
+            for (int j = 0; j < M && w0 + j < zW; j++) {
+              double sum = shift;
+              for (int k = 0; k < A; k++) sum += tmp[i][k] * WT::AT[j][k];
+              zC[(h0 + i) * zs.h + (w0 + j) * zs.w] = static_cast<T>(sum);
+            }
+        }
+      }
+    };
+    samediff::Threads::parallel_for(outputTransform, 0, nT);
+  }
+}
+
+template <typename T>
+static void winogradConv2d(const T* x, const ActivationStrides& xs, const LongType bS, const LongType cIn,
+                           const LongType xH, const LongType xW, const T* w, const KernelStrides& ws, const T* bias, T* z,
+                           const ActivationStrides& zs, const LongType cOut, const LongType zH, const LongType zW,
+                           const LongType pH, const LongType pW) {
+  // bigger tiles save more multiplications, but only pay off when the output isn't mostly tile padding
+  if (zH >= 8 && zW >= 8)
+    winogradConv2d_<T, 4>(x, xs, bS, cIn, xH, xW, w, ws, bias, z, zs, cOut, zH, zW, pH, pW);
+  else
+    winogradConv2d_<T, 2>(x, xs, bS, cIn, xH, xW, w, ws, bias, z, zs, cOut, zH, zW, pH, pW);
+}
+
+//////////////////////////////////////////////////////////////////////////
+bool ConvolutionUtils::useWinograd2d(NDArray* input, NDArray* weights, NDArray* output, const LongType kH,
+                                     const LongType kW, const LongType sH, const LongType sW, const LongType dH,
+                                     const LongType dW, const int wFormat) {
+  if (kH != 3 || kW != 3 || sH != 1 || sW != 1 || dH != 1 || dW != 1) return false;
+
+  if (!Environment::getInstance().helpersAllowed()) return false;
+#if defined(HAVE_ONEDNN)
+  if (Environment::getInstance().isUseONEDNN()) return false;
+#endif
+
+  const auto dtype = input->dataType();
+  if ((dtype != DataType::FLOAT32 && dtype != DataType::DOUBLE) || weights->dataType() != dtype ||
+      output->dataType() != dtype)
+    return false;
+
+  return inChannels(weights->shapeInfo(), wFormat) >= WINOGRAD_MIN_CHANNELS &&
+         outChannels(weights->shapeInfo(), wFormat) >= WINOGRAD_MIN_CHANNELS;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void ConvolutionUtils::conv2dWinograd(NDArray* input, NDArray* weights, NDArray* bias, NDArray* output,
+                                      LongType pH, LongType pW, const int isNCHW, const int wFormat) {
+  // input   [bS, iH, iW, iC] (NHWC) or [bS, iC, iH, iW] (NCHW)
+  // weights [3, 3, iC, oC], [oC, iC, 3, 3], [oC, 3, 3, iC]
+  // bias    [oC]
+  // output  [bS, oH, oW, oC] (NHWC) or [bS, oC, oH, oW] (NCHW)
+  const LongType bS = input->sizeAt(0);
+  const LongType iC = inChannels(weights->shapeInfo(), wFormat);
+  const LongType oC = outChannels(weights->shapeInfo(), wFormat);
+  const LongType iH = input->sizeAt(isNCHW ? 2 : 1);
+  const LongType iW = input->sizeAt(isNCHW ? 3 : 2);
+  const LongType oH = output->sizeAt(isNCHW ? 2 : 1);
+  const LongType oW = output->sizeAt(isNCHW ? 3 : 2);
+
+  const auto xs = activationStrides(input, isNCHW);
+  const auto zs = activationStrides(output, isNCHW);
+  const auto ws = kernelStrides(weights, wFormat);
+
+  if (input->dataType() == DataType::FLOAT32)
+    winogradConv2d<float>(input->bufferAsT<float>(), xs, bS, iC, iH, iW, weights->bufferAsT<float>(), ws,
+                          bias != nullptr ? bias->bufferAsT<float>() : nullptr, output->bufferAsT<float>(), zs, oC, oH,
+                          oW, pH, pW);
+  else
+    winogradConv2d<double>(input->bufferAsT<double>(), xs, bS, iC, iH, iW, weights->bufferAsT<double>(), ws,
+                           bias != nullptr ? bias->bufferAsT<double>() : nullptr, output->bufferAsT<double>(), zs, oC,
+                           oH, oW, pH, pW);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void ConvolutionUtils::conv2dBPWinograd(NDArray* weights, NDArray* gradO, NDArray* gradI, LongType pH, LongType pW,
+                                        const int isNCHW, const int wFormat) {
+  // weights [3, 3, iC, oC], [oC, iC, 3, 3], [oC, 3, 3, iC]
+  // gradO   [bS, oH, oW, oC] (NHWC) or [bS, oC, oH, oW] (NCHW)
+  // gradI   [bS, iH, iW, iC] (NHWC) or [bS, iC, iH, iW] (NCHW)
+  const LongType bS = gradO->sizeAt(0);
+  const LongType iC = inChannels(weights->shapeInfo(), wFormat);
+  const LongType oC = outChannels(weights->shapeInfo(), wFormat);
+  const LongType iH = gradI->sizeAt(isNCHW ? 2 : 1);
+  const LongType iW = gradI->sizeAt(isNCHW ? 3 : 2);
+  const LongType oH = gradO->sizeAt(isNCHW ? 2 : 1);
+  const LongType oW = gradO->sizeAt(isNCHW ? 3 : 2);
+
+  // gradI(h, w) = sum over kh, kw of gradO(h + pH - kh, w + pW - kw) * weights(kh, kw), that is 3x3 stride-1
+  // correlation of gradO with the kernel flipped in space and with channels swapped, padded by 2 - pH, 2 - pW
+  const auto ws = kernelStrides(weights, wFormat);
+  const KernelStrides flipped = {-ws.kh, -ws.kw, ws.out, ws.in, 2 * ws.kh + 2 * ws.kw};
+
+  const auto xs = activationStrides(gradO, isNCHW);
+  const auto zs = activationStrides(gradI, isNCHW);
+
+  if (gradO->dataType() == DataType::FLOAT32)
+    winogradConv2d<float>(gradO->bufferAsT<float>(), xs, bS, oC, oH, oW, weights->bufferAsT<float>(), flipped, nullptr,
+                          gradI->bufferAsT<float>(), zs, iC, iH, iW, 2 - pH, 2 - pW);
+  else
+    winogradConv2d<double>(gradO->bufferAsT<double>(), xs, bS, oC, oH, oW, weights->bufferAsT<double>(), flipped,
+                           nullptr, gradI->bufferAsT<double>(), zs, iC, iH, iW, 2 - pH, 2 - pW);
+}
+
+}  // namespace ops
+}  // namespace sd
+#endif
@@ -19,55 +19,26 @@
 //
 // @author raver119@gmail.com
 //
+#include <helpers/HistogramEngine.h>
 #include <ops/declarable/helpers/histogram.h>
 #if NOT_EXCLUDED(OP_histogram)
 namespace sd {
 namespace ops {
 namespace helpers {
 template <typename X, typename Z>
-static void histogram_(void const *xBuffer, sd::LongType const *xShapeInfo, void *zBuffer,
-                       sd::LongType const *zShapeInfo, sd::LongType numBins, double min_val, double max_val) {
-  auto dx = reinterpret_cast<X const *>(xBuffer);
-  auto result = reinterpret_cast<Z *>(zBuffer);
+static void histogram_(NDArray &input, NDArray &output, double min_val, double max_val) {
+  const sd::LongType numBins = output.lengthOf();
+  const sd::histogram::FixedWidthBins binOf{min_val, (max_val - min_val) / numBins, numBins};
 
-  int length = shape::length(xShapeInfo);
-
-  X binSize = (max_val - min_val) / (numBins);
-
-  // FIXME: this op should be parallelized
-  {
-    int *bins = new int[numBins];
-    std::memset(bins, 0, sizeof(int) * numBins);
-
-    PRAGMA_OMP_SIMD
-    for (int x = 0; x < length; x++) {
-      int idx = (int)((dx[x] - min_val) / binSize);
-      if (idx < 0)
-        idx = 0;
-      else if (idx >= numBins)
-        idx = numBins - 1;
-
-      bins[idx]++;
-    }
-
-    PRAGMA_OMP_SIMD
-    for (sd::LongType x = 0; x < numBins; x++) {
-      result[x] += bins[x];
-    }
-
-    delete[] bins;
-  }
+  sd::histogram::histogram<X, Z>(input, output, binOf);
 }
 
 void histogramHelper(sd::LaunchContext *context, NDArray &input, NDArray &output) {
-  sd::LongType numBins = output.lengthOf();
   double min_val = input.reduceNumber(reduce::SameOps::Min).e<double>(0);
   double max_val = input.reduceNumber(reduce::SameOps::Max).e<double>(0);
 
-  BUILD_DOUBLE_SELECTOR(
-      input.dataType(), output.dataType(), histogram_,
-      (input.buffer(), input.shapeInfo(), output.buffer(), output.shapeInfo(), numBins, min_val, max_val),
-      SD_COMMON_TYPES, SD_INDEXING_TYPES);
+  BUILD_DOUBLE_SELECTOR(input.dataType(), output.dataType(), histogram_, (input, output, min_val, max_val),
+                        SD_COMMON_TYPES, SD_INDEXING_TYPES);
 }
 }  // namespace helpers
 }  // namespace ops
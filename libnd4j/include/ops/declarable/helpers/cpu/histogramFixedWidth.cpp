@@ -19,48 +19,45 @@
 //
 // @author Yurii Shyrma (iuriish@yahoo.com), created on 31.08.2018
 //
+#include <helpers/HistogramEngine.h>
 #include <ops/declarable/helpers/histogramFixedWidth.h>
 #if NOT_EXCLUDED(OP_histogram_fixed_width)
 namespace sd {
 namespace ops {
 namespace helpers {
 
-template <typename T>
+template <typename X, typename Z>
 void histogramFixedWidth_(NDArray& input, NDArray& range, NDArray& output) {
-  const int nbins = output.lengthOf();
+  const sd::LongType nbins = output.lengthOf();
 
   // firstly initialize output with zeros
   output.nullify();
 
-  const T leftEdge = range.e<double>(0);
-  const T rightEdge = range.e<double>(1);
+  const double leftEdge = range.e<double>(0);
+  const double rightEdge = range.e<double>(1);
 
-  const T binWidth = (rightEdge - leftEdge) / nbins;
-  const T secondEdge = leftEdge + binWidth;
-  const T lastButOneEdge = rightEdge - binWidth;
+  const double binWidth = (rightEdge - leftEdge) / nbins;
+  const double secondEdge = leftEdge + binWidth;
+  const double lastButOneEdge = rightEdge - binWidth;
 
-  sd::LongType inputLength = input.lengthOf();
+  // outer bins are decided by edges, so rounding in (value - leftEdge) / binWidth can't move values across them
+  const sd::histogram::FixedWidthBins inner{leftEdge, binWidth, nbins};
+  auto binOf = [=](X value) -> sd::LongType {
+    const auto v = static_cast<double>(value);
+    if (v < secondEdge) return 0;
+    if (v >= lastButOneEdge) return nbins - 1;
+    return inner(value);
+  };
 
-  // FIXME: make this one parallel without CRITICAL section
-  for (sd::LongType i = 0; i < inputLength; ++i) {
-    const T value = input.e<T>(i);
-
-    if (value < secondEdge) {
-      output.p<sd::LongType>(0, output.e<sd::LongType>(0) + 1);
-    } else if (value >= lastButOneEdge) {
-      output.p<sd::LongType>(nbins - 1, output.e<sd::LongType>(nbins - 1) + 1);
-    } else {
-      sd::LongType currInd = static_cast<sd::LongType>((value - leftEdge) / binWidth);
-      output.p<sd::LongType>(currInd, output.e<sd::LongType>(currInd) + 1);
-    }
-  }
+  sd::histogram::histogram<X, Z>(input, output, binOf);
 }
 
 void histogramFixedWidth(sd::LaunchContext* context, NDArray& input, NDArray& range, NDArray& output) {
-  BUILD_SINGLE_SELECTOR(input.dataType(), histogramFixedWidth_, (input, range, output), SD_COMMON_TYPES);
+  BUILD_DOUBLE_SELECTOR(input.dataType(), output.dataType(), histogramFixedWidth_, (input, range, output),
+                        SD_COMMON_TYPES, SD_INDEXING_TYPES);
 }
-BUILD_SINGLE_TEMPLATE(template void histogramFixedWidth_, (NDArray& input, NDArray& range, NDArray& output),
-                      SD_COMMON_TYPES);
+BUILD_DOUBLE_TEMPLATE(template void histogramFixedWidth_, (NDArray& input, NDArray& range, NDArray& output),
+                      SD_COMMON_TYPES, SD_INDEXING_TYPES);
 
 }  // namespace helpers
 }  // namespace ops
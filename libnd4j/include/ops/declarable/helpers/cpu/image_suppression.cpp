@@ -15,14 +15,15 @@
  *
  * SPDX-License-Identifier: Apache-2.0
  ******************************************************************************/
-
 //
 //  @author sgazeos@gmail.com
 //
 #include <array/NDArrayFactory.h>
+#include <execution/Threads.h>
 #include <ops/declarable/helpers/image_suppression.h>
 
 #include <algorithm>
+#include <cmath>
 #include <numeric>
 #include <queue>
 
@@ -30,237 +31,424 @@ namespace sd {
 namespace ops {
 namespace helpers {
 
+// candidates are screened in parallel against boxes selected before their block, then the block is resolved in order
+static constexpr sd::LongType NMS_BLOCK = 256;
+// below this number of box comparisons per block screening is done by the calling thread
+static constexpr sd::LongType NMS_MIN_PARALLEL_WORK = 1 << 15;
+// spatial grid over selected boxes is used from this number of candidates on
+static constexpr sd::LongType NMS_GRID_MIN_CANDIDATES = 1024;
+// selected boxes covering more grid cells than this are checked by every candidate instead
+static constexpr sd::LongType NMS_GRID_MAX_SPAN = 16;
+// similarities to selected boxes are computed for this many boxes at once
+static constexpr int NMS_SIMILARITY_BLOCK = 64;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// true if any selected box with ordinal in [from, to) suppresses box i
+template <typename T, typename Similarity, typename Suppresses>
+static bool anySuppresses(const Similarity& similarity, const sd::LongType i, sd::LongType from, const sd::LongType to,
+                          const Suppresses& suppresses) {
+  T sim[NMS_SIMILARITY_BLOCK];
+  for (; from < to; from += NMS_SIMILARITY_BLOCK) {
+    const int count = static_cast<int>(sd::math::sd_min<sd::LongType>(NMS_SIMILARITY_BLOCK, to - from));
+    similarity.toSelected(i, from, count, sim);
+    for (int k = 0; k < count; k++)
+      if (suppresses(sim[k])) return true;
+  }
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Intersection over union of boxes [y1, x1, y2, x2] with corners in any order, boxes with non-positive area have
+// zero similarity to anything. Selected boxes are kept as separate coordinate arrays, so similarity of one box to
+// many selected ones is a vector loop. Optional uniform grid limits candidates to selected boxes in the same cells.
 template <typename T>
-static void nonMaxSuppressionV2_(NDArray* boxes, NDArray* scales, int maxSize, double overlapThreshold,
-                                 double scoreThreshold, NDArray* output) {
-  std::vector<int> indices(scales->lengthOf());
-  std::iota(indices.begin(), indices.end(), 0);
-  auto actualIndicesCount = indices.size();
-  for (auto e = 0; e < scales->lengthOf(); e++) {
-    if (scales->e<float>(e) < (float)scoreThreshold) {
-      indices[e] = -1;
-      actualIndicesCount--;
+class IouSimilarity {
+ private:
+  std::vector<T> _yMin, _xMin, _yMax, _xMax, _area;
+  std::vector<T> _sYMin, _sXMin, _sYMax, _sXMax, _sArea;
+
+  sd::LongType _gridSize = 0;
+  double _yLo = 0., _xLo = 0., _cellH = 1., _cellW = 1.;
+  std::vector<std::vector<sd::LongType>> _cells;
+  std::vector<sd::LongType> _wide;
+
+  SD_INLINE sd::LongType cellOf(const T value, const double lo, const double cell) const {
+    double c = (static_cast<double>(value) - lo) / cell;
+    c = !(c > 0.) ? 0. : (c >= static_cast<double>(_gridSize) ? static_cast<double>(_gridSize - 1) : c);
+    return static_cast<sd::LongType>(c);
+  }
+
+  SD_INLINE T overlap(const sd::LongType i, const sd::LongType s) const {
+    const T zero = static_cast<T>(0.f);
+    const T intersectionY = sd::math::sd_min(_yMax[i], _sYMax[s]) - sd::math::sd_max(_yMin[i], _sYMin[s]);
+    const T intersectionX = sd::math::sd_min(_xMax[i], _sXMax[s]) - sd::math::sd_max(_xMin[i], _sXMin[s]);
+    const T intersectionArea = sd::math::sd_max(intersectionY, zero) * sd::math::sd_max(intersectionX, zero);
+    return _area[i] <= zero || _sArea[s] <= zero ? zero
+                                                 : intersectionArea / (_area[i] + _sArea[s] - intersectionArea);
+  }
+
+ public:
+  explicit IouSimilarity(NDArray* boxes) {
+    const sd::LongType numBoxes = boxes->sizeAt(0);
+    _yMin.resize(numBoxes);
+    _xMin.resize(numBoxes);
+    _yMax.resize(numBoxes);
+    _xMax.resize(numBoxes);
+    _area.resize(numBoxes);
+
+    auto load = PRAGMA_THREADS_FOR {
+      for (auto i = start; i < stop; i++) {
+        _yMin[i] = sd::math::sd_min(boxes->t<T>(i, 0), boxes->t<T>(i, 2));
+        _xMin[i] = sd::math::sd_min(boxes->t<T>(i, 1), boxes->t<T>(i, 3));
+        _yMax[i] = sd::math::sd_max(boxes->t<T>(i, 0), boxes->t<T>(i, 2));
+        _xMax[i] = sd::math::sd_max(boxes->t<T>(i, 1), boxes->t<T>(i, 3));
+        _area[i] = (_yMax[i] - _yMin[i]) * (_xMax[i] - _xMin[i]);
+      }
+    };
+
+    samediff::Threads::parallel_for(load, 0, numBoxes);
+  }
+
+  /**
+   * Spreads future selections over a grid covering all candidates. Only valid when suppression needs a positive
+   * intersection, i.e. zero similarity never suppresses.
+   */
+  void useGrid(const std::vector<sd::LongType>& candidates) {
+    double yHi, xHi;
+    _yLo = _xLo = DataTypeUtils::infOrMax<double>();
+    yHi = xHi = -DataTypeUtils::infOrMax<double>();
+    for (auto i : candidates) {
+      _yLo = sd::math::sd_min<double>(_yLo, static_cast<double>(_yMin[i]));
+      _xLo = sd::math::sd_min<double>(_xLo, static_cast<double>(_xMin[i]));
+      yHi = sd::math::sd_max<double>(yHi, static_cast<double>(_yMax[i]));
+      xHi = sd::math::sd_max<double>(xHi, static_cast<double>(_xMax[i]));
     }
+    if (!(yHi > _yLo) || !(xHi > _xLo) || std::isinf(yHi - _yLo) || std::isinf(xHi - _xLo)) return;
+
+    // about 4 candidates per cell
+    _gridSize = sd::math::sd_max<sd::LongType>(
+        1, sd::math::sd_min<sd::LongType>(64, static_cast<sd::LongType>(std::sqrt(candidates.size() / 4.))));
+    _cellH = (yHi - _yLo) / _gridSize;
+    _cellW = (xHi - _xLo) / _gridSize;
+    _cells.assign(_gridSize * _gridSize, std::vector<sd::LongType>());
   }
-  std::sort(indices.begin(), indices.end(),
-            [scales](int i, int j) { return i >= 0 && j >= 0 ? scales->e<T>(i) > scales->e<T>(j) : (i > j); });
-
-  //        std::vector<int> selected(output->lengthOf());
-  std::vector<int> selectedIndices(output->lengthOf(), 0);
-  auto needToSuppressWithThreshold = [](NDArray& boxes, int previousIndex, int nextIndex, T threshold) -> bool {
-    if (previousIndex < 0 || nextIndex < 0) return true;
-    T minYPrev = sd::math::sd_min(boxes.t<T>(previousIndex, 0), boxes.t<T>(previousIndex, 2));
-    T minXPrev = sd::math::sd_min(boxes.t<T>(previousIndex, 1), boxes.t<T>(previousIndex, 3));
-    T maxYPrev = sd::math::sd_max(boxes.t<T>(previousIndex, 0), boxes.t<T>(previousIndex, 2));
-    T maxXPrev = sd::math::sd_max(boxes.t<T>(previousIndex, 1), boxes.t<T>(previousIndex, 3));
-    T minYNext = sd::math::sd_min(boxes.t<T>(nextIndex, 0), boxes.t<T>(nextIndex, 2));
-    T minXNext = sd::math::sd_min(boxes.t<T>(nextIndex, 1), boxes.t<T>(nextIndex, 3));
-    T maxYNext = sd::math::sd_max(boxes.t<T>(nextIndex, 0), boxes.t<T>(nextIndex, 2));
-    T maxXNext = sd::math::sd_max(boxes.t<T>(nextIndex, 1), boxes.t<T>(nextIndex, 3));
-    T areaPrev = (maxYPrev - minYPrev) * (maxXPrev - minXPrev);
-    T areaNext = (maxYNext - minYNext) * (maxXNext - minXNext);
-
-    if (areaNext <= T(0.f) || areaPrev <= T(0.f)) return false;
-
-    T minIntersectionY = sd::math::sd_max(minYPrev, minYNext);
-    T minIntersectionX = sd::math::sd_max(minXPrev, minXNext);
-    T maxIntersectionY = sd::math::sd_min(maxYPrev, maxYNext);
-    T maxIntersectionX = sd::math::sd_min(maxXPrev, maxXNext);
-    T intersectionArea = sd::math::sd_max(T(maxIntersectionY - minIntersectionY), T(0.0f)) *
-                         sd::math::sd_max(T(maxIntersectionX - minIntersectionX), T(0.0f));
-    T intersectionValue = intersectionArea / (areaPrev + areaNext - intersectionArea);
-    return intersectionValue > threshold;
-  };
-  //        int numSelected = 0;
-  int numBoxes = actualIndicesCount;  // boxes->sizeAt(0);
-  int numSelected = 0;
-
-  for (int i = 0; i < numBoxes; ++i) {
-    bool shouldSelect = numSelected < output->lengthOf();
-
-    // FIXME: add parallelism here
-    for (int j = numSelected - 1; j >= 0; --j) {
-      if (shouldSelect)
-        if (needToSuppressWithThreshold(*boxes, indices[i], indices[selectedIndices[j]], T(overlapThreshold))) {
-          shouldSelect = false;
-        }
+
+  SD_INLINE T operator()(const sd::LongType i, const sd::LongType j) const {
+    const T zero = static_cast<T>(0.f);
+    if (_area[i] <= zero || _area[j] <= zero) return zero;
+
+    const T intersectionY = sd::math::sd_min(_yMax[i], _yMax[j]) - sd::math::sd_max(_yMin[i], _yMin[j]);
+    const T intersectionX = sd::math::sd_min(_xMax[i], _xMax[j]) - sd::math::sd_max(_xMin[i], _xMin[j]);
+    const T intersectionArea = sd::math::sd_max(intersectionY, zero) * sd::math::sd_max(intersectionX, zero);
+    return intersectionArea / (_area[i] + _area[j] - intersectionArea);
+  }
+
+  void toSelected(const sd::LongType i, const sd::LongType from, const int count, T* sim) const {
+    const T zero = static_cast<T>(0.f);
+    const T yMin = _yMin[i], xMin = _xMin[i], yMax = _yMax[i], xMax = _xMax[i], area = _area[i];
+    const T* sYMin = _sYMin.data() + from;
+    const T* sXMin = _sXMin.data() + from;
+    const T* sYMax = _sYMax.data() + from;
+    const T* sXMax = _sXMax.data() + from;
+    const T* sArea = _sArea.data() + from;
+
+    PRAGMA_OMP_SIMD
+    for (int k = 0; k < count; k++) {
+      const T intersectionY = sd::math::sd_min(yMax, sYMax[k]) - sd::math::sd_max(yMin, sYMin[k]);
+      const T intersectionX = sd::math::sd_min(xMax, sXMax[k]) - sd::math::sd_max(xMin, sXMin[k]);
+      const T intersectionArea = sd::math::sd_max(intersectionY, zero) * sd::math::sd_max(intersectionX, zero);
+      const T unionArea = area + sArea[k] - intersectionArea;
+      sim[k] = area <= zero || sArea[k] <= zero ? zero : intersectionArea / unionArea;
     }
-    if (shouldSelect) {
-      output->p(numSelected, indices[i]);
-      selectedIndices[numSelected++] = i;
+  }
+
+  void select(const sd::LongType i) {
+    const sd::LongType ordinal = _sArea.size();
+    _sYMin.push_back(_yMin[i]);
+    _sXMin.push_back(_xMin[i]);
+    _sYMax.push_back(_yMax[i]);
+    _sXMax.push_back(_xMax[i]);
+    _sArea.push_back(_area[i]);
+    if (_gridSize == 0) return;
+
+    const sd::LongType y0 = cellOf(_yMin[i], _yLo, _cellH), y1 = cellOf(_yMax[i], _yLo, _cellH);
+    const sd::LongType x0 = cellOf(_xMin[i], _xLo, _cellW), x1 = cellOf(_xMax[i], _xLo, _cellW);
+    if ((y1 - y0 + 1) * (x1 - x0 + 1) > NMS_GRID_MAX_SPAN) {
+      _wide.push_back(ordinal);
+      return;
     }
+    for (sd::LongType y = y0; y <= y1; y++)
+      for (sd::LongType x = x0; x <= x1; x++) _cells[y * _gridSize + x].push_back(ordinal);
   }
-}
+
+  // true if any of first `to` selected boxes suppresses box i
+  template <typename Suppresses>
+  bool screen(const sd::LongType i, const sd::LongType to, const Suppresses& suppresses) const {
+    if (_gridSize == 0) return anySuppresses<T>(*this, i, 0, to, suppresses);
+
+    for (auto s : _wide)
+      if (s < to && suppresses(overlap(i, s))) return true;
+
+    // two boxes with a common point share at least one cell, so no other selected box can overlap box i
+    const sd::LongType y0 = cellOf(_yMin[i], _yLo, _cellH), y1 = cellOf(_yMax[i], _yLo, _cellH);
+    const sd::LongType x0 = cellOf(_xMin[i], _xLo, _cellW), x1 = cellOf(_xMax[i], _xLo, _cellW);
+    for (sd::LongType y = y0; y <= y1; y++)
+      for (sd::LongType x = x0; x <= x1; x++)
+        for (auto s : _cells[y * _gridSize + x])
+          if (s < to && suppresses(overlap(i, s))) return true;
+
+    return false;
+  }
+};
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-// Return intersection-over-union overlap between boxes i and j
+// Precomputed similarities, overlaps[i, j] is similarity of box i to box j
 template <typename T>
-static inline T similirityV3_(NDArray& boxes, sd::LongType i, sd::LongType j) {
-  const T zero = static_cast<T>(0.f);
-  const T yminI = math::sd_min(boxes.t<T>(i, 0), boxes.t<T>(i, 2));
-  const T xminI = math::sd_min(boxes.t<T>(i, 1), boxes.t<T>(i, 3));
-  const T ymaxI = math::sd_max(boxes.t<T>(i, 0), boxes.t<T>(i, 2));
-  const T xmaxI = math::sd_max(boxes.t<T>(i, 1), boxes.t<T>(i, 3));
-  const T yminJ = math::sd_min(boxes.t<T>(j, 0), boxes.t<T>(j, 2));
-  const T xminJ = math::sd_min(boxes.t<T>(j, 1), boxes.t<T>(j, 3));
-  const T ymaxJ = math::sd_max(boxes.t<T>(j, 0), boxes.t<T>(j, 2));
-  const T xmaxJ = math::sd_max(boxes.t<T>(j, 1), boxes.t<T>(j, 3));
-  const T areaI = (ymaxI - yminI) * (xmaxI - xminI);
-  const T areaJ = (ymaxJ - yminJ) * (xmaxJ - xminJ);
-  if (areaI <= zero || areaJ <= zero) {
-    return zero;
+class OverlapSimilarity {
+ private:
+  const T* _overlaps;
+  sd::LongType _rowStride, _columnStride;
+  std::vector<sd::LongType> _selected;
+
+ public:
+  explicit OverlapSimilarity(NDArray* overlaps)
+      : _overlaps(overlaps->bufferAsT<T>()),
+        _rowStride(overlaps->stridesOf()[0]),
+        _columnStride(overlaps->stridesOf()[1]) {}
+
+  SD_INLINE T operator()(const sd::LongType i, const sd::LongType j) const {
+    return _overlaps[i * _rowStride + j * _columnStride];
   }
-  const T intersectionYmin = math::sd_max(yminI, yminJ);
-  const T intersectionXmin = math::sd_max(xminI, xminJ);
-  const T intersectionYmax = math::sd_min(ymaxI, ymaxJ);
-  const T intersectionXmax = math::sd_min(xmaxI, xmaxJ);
-  const T intersectionY = intersectionYmax - intersectionYmin;
-  const T intersectionX = intersectionXmax - intersectionXmin;
-  const T intersectionArea = math::sd_max(intersectionY, zero) * math::sd_max(intersectionX, zero);
-  return intersectionArea / (areaI + areaJ - intersectionArea);
-}
 
-template <typename T>
-static inline T similarityOverlaps_(NDArray& boxes, sd::LongType i, sd::LongType j) {
-  return boxes.t<T>(i, j);
-}
+  void toSelected(const sd::LongType i, const sd::LongType from, const int count, T* sim) const {
+    for (int k = 0; k < count; k++) sim[k] = (*this)(i, _selected[from + k]);
+  }
 
-typedef NDArray (*SimilarityFunc)(NDArray& boxes, sd::LongType i, sd::LongType j);
+  void select(const sd::LongType i) { _selected.push_back(i); }
 
-static NDArray similiratyOverlaps(NDArray& boxes, sd::LongType i, sd::LongType j) {
-  NDArray res(boxes.dataType(), boxes.getContext());  // = NDArrayFactory::create(0.);
-  BUILD_SINGLE_SELECTOR(boxes.dataType(), res = similarityOverlaps_, (boxes, i, j), SD_FLOAT_TYPES);
-  return res;
+  template <typename Suppresses>
+  bool screen(const sd::LongType i, const sd::LongType to, const Suppresses& suppresses) const {
+    return anySuppresses<T>(*this, i, 0, to, suppresses);
+  }
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// indices of boxes which pass the score filter, ordered by score descending and by index for equal scores
+template <typename T, typename Passes>
+static std::vector<sd::LongType> candidatesOf(NDArray* scores, std::vector<T>& scoreValues, const Passes& passes) {
+  const sd::LongType numBoxes = scores->lengthOf();
+  scoreValues.resize(numBoxes);
+  for (sd::LongType i = 0; i < numBoxes; i++) scoreValues[i] = scores->e<T>(i);
+
+  // NaN score can't be ordered against other scores, such boxes are never selected
+  std::vector<sd::LongType> candidates;
+  for (sd::LongType i = 0; i < numBoxes; i++)
+    if (!sd::math::sd_isnan<T>(scoreValues[i]) && passes(scoreValues[i])) candidates.push_back(i);
+
+  std::sort(candidates.begin(), candidates.end(), [&scoreValues](const sd::LongType i, const sd::LongType j) {
+    return scoreValues[i] > scoreValues[j] || (scoreValues[i] == scoreValues[j] && i < j);
+  });
+  return candidates;
 }
 
-static NDArray similarityV3(NDArray& boxes, sd::LongType i, sd::LongType j) {
-  NDArray res(boxes.dataType(), boxes.getContext());  // = NDArrayFactory::create(0.);
-  BUILD_SINGLE_SELECTOR(boxes.dataType(), res = similirityV3_, (boxes, i, j), SD_FLOAT_TYPES);
-  return res;
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Greedy hard suppression: a candidate is selected unless a box selected before suppresses it. Candidates of every
+// block are screened against boxes selected before the block in parallel, boxes selected within the block are
+// checked serially, so the result is exactly the one of sequential processing.
+//
+// With reselect, a selected box which does not suppress itself is selected again until the output is full. That is
+// how the priority queue implementation has always behaved for such boxes and ops rely on it.
+template <typename T, typename Similarity, typename Suppresses>
+static std::vector<sd::LongType> hardSuppression(Similarity& similarity, const std::vector<sd::LongType>& candidates,
+                                                 const sd::LongType maxSize, const Suppresses& suppresses,
+                                                 const bool reselect) {
+  std::vector<sd::LongType> selected;
+  std::vector<int8_t> screened(NMS_BLOCK);
+  const sd::LongType numCandidates = candidates.size();
+
+  for (sd::LongType b = 0; b < numCandidates && static_cast<sd::LongType>(selected.size()) < maxSize;
+       b += NMS_BLOCK) {
+    const sd::LongType blockLength = sd::math::sd_min<sd::LongType>(NMS_BLOCK, numCandidates - b);
+    const sd::LongType before = selected.size();
+
+    auto screen = PRAGMA_THREADS_FOR {
+      for (auto c = start; c < stop; c++) screened[c] = similarity.screen(candidates[b + c], before, suppresses);
+    };
+
+    if (before * blockLength >= NMS_MIN_PARALLEL_WORK)
+      samediff::Threads::parallel_for(screen, 0, blockLength);
+    else
+      screen(0, 0, blockLength, 1);
+
+    for (sd::LongType c = 0; c < blockLength && static_cast<sd::LongType>(selected.size()) < maxSize; c++) {
+      const sd::LongType box = candidates[b + c];
+      if (screened[c] || anySuppresses<T>(similarity, box, before, selected.size(), suppresses)) continue;
+
+      similarity.select(box);
+      selected.push_back(box);
+
+      if (reselect && !suppresses(similarity(box, box))) {
+        selected.resize(maxSize, box);
+        return selected;
+      }
+    }
+  }
+
+  return selected;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-template <typename T, typename I>
-static sd::LongType nonMaxSuppressionGeneric_(sd::LaunchContext* context, NDArray* boxes, NDArray* scores,
-                                              int outputSize, float overlapThreshold, float scoreThreshold,
-                                              NDArray* output, SimilarityFunc f) {
-  auto numBoxes = boxes->sizeAt(0);
-  T* scoresData = scores->dataBuffer()->primaryAsT<T>();
-
-  // Data structure for a selection candidate in NMS.
+// Soft-NMS: overlapping boxes decay the score of a candidate by exp(-similarity^2 / (2 * sigma)) instead of
+// removing it, boxes more similar than overlapThreshold are removed. Candidates are re-evaluated lazily, only
+// against boxes selected since their last evaluation.
+template <typename T, typename Similarity>
+static std::vector<sd::LongType> softSuppression(Similarity& similarity, const std::vector<sd::LongType>& candidates,
+                                                 const std::vector<T>& scores, const sd::LongType maxSize,
+                                                 const double overlapThreshold, const double scoreThreshold,
+                                                 const double sigma) {
   struct Candidate {
-    int _boxIndex;
+    sd::LongType _boxIndex;
     T _score;
-    int _suppressBeginIndex;
+    sd::LongType _suppressBeginIndex;
   };
 
   auto cmp = [](const Candidate& bsI, const Candidate& bsJ) -> bool {
     return ((bsI._score == bsJ._score) && (bsI._boxIndex > bsJ._boxIndex)) || (bsI._score < bsJ._score);
   };
 
-  std::priority_queue<Candidate, std::deque<Candidate>, decltype(cmp)> candidatePriorityQueue(cmp);
-  for (auto i = 0; i < scores->lengthOf(); ++i) {
-    if ((float)scoresData[i] > (float)scoreThreshold) {
-      candidatePriorityQueue.emplace(Candidate({i, scoresData[i], 0}));
-    }
-  }
+  std::priority_queue<Candidate, std::deque<Candidate>, decltype(cmp)> queue(cmp);
+  for (auto i : candidates) queue.push(Candidate({i, scores[i], 0}));
 
-  std::vector<I> selected;
-  T similarity, originalScore;
-  Candidate nextCandidate;
-
-  while (selected.size() < static_cast<size_t>(outputSize) && !candidatePriorityQueue.empty()) {
-    nextCandidate = candidatePriorityQueue.top();
-    originalScore = nextCandidate._score;
-    candidatePriorityQueue.pop();
-
-    // Overlapping boxes are likely to have similar scores, therefore we
-    // iterate through the previously selected boxes backwards in order to
-    // see if `nextCandidate` should be suppressed. We also enforce a property
-    // that a candidate can be suppressed by another candidate no more than
-    // once via `suppress_begin_index` which tracks which previously selected
-    // boxes have already been compared against next_candidate prior to a given
-    // iteration.  These previous selected boxes are then skipped over in the
-    // following loop.
-    bool shouldHardSuppress = false;
-    for (int j = static_cast<int>(selected.size()) - 1; j >= nextCandidate._suppressBeginIndex; --j) {
-      auto similarityA =
-          f(*boxes, nextCandidate._boxIndex, selected[j]);  // boxes->t<T>(nextCandidate._boxIndex, selected[j]);
-      similarity = similarityA.template t<T>(0);
-      nextCandidate._score *= T(similarity <= overlapThreshold ? 1.0 : 0.);  // suppressWeightFunc(similarity);
-
-      // First decide whether to perform hard suppression
-      if ((float)similarity >= static_cast<float>(overlapThreshold)) {
-        shouldHardSuppress = true;
-        break;
-      }
+  const double scale = -0.5 / sigma;
+  std::vector<sd::LongType> selected;
 
-      // If next_candidate survives hard suppression, apply soft suppression
-      if ((float)nextCandidate._score <= (float)scoreThreshold) break;
+  while (static_cast<sd::LongType>(selected.size()) < maxSize && !queue.empty()) {
+    Candidate next = queue.top();
+    const T originalScore = next._score;
+    queue.pop();
+
+    for (sd::LongType j = static_cast<sd::LongType>(selected.size()) - 1; j >= next._suppressBeginIndex; --j) {
+      const double sim = static_cast<double>(similarity(next._boxIndex, selected[j]));
+      next._score = static_cast<T>(static_cast<double>(next._score) *
+                                   (sim <= overlapThreshold ? std::exp(scale * sim * sim) : 0.));
+      if (static_cast<double>(next._score) <= scoreThreshold) break;
     }
-    // If `nextCandidate._score` has not dropped below `scoreThreshold`
-    // by this point, then we know that we went through all of the previous
-    // selections and can safely update `suppress_begin_index` to
-    // `selected.size()`. If on the other hand `next_candidate.score`
-    // *has* dropped below the score threshold, then since `suppressWeight`
-    // always returns values in [0, 1], further suppression by items that were
-    // not covered in the above for loop would not have caused the algorithm
-    // to select this item. We thus do the same update to
-    // `suppressBeginIndex`, but really, this element will not be added back
-    // into the priority queue in the following.
-    nextCandidate._suppressBeginIndex = selected.size();
-
-    if (!shouldHardSuppress) {
-      if (nextCandidate._score == originalScore) {
-        // Suppression has not occurred, so select next_candidate
-        selected.push_back(nextCandidate._boxIndex);
-      }
-      if ((float)nextCandidate._score > (float)scoreThreshold) {
-        // Soft suppression has occurred and current score is still greater than
-        // score_threshold; add next_candidate back onto priority queue.
-        candidatePriorityQueue.push(nextCandidate);
-      }
+    next._suppressBeginIndex = selected.size();
+
+    if (next._score == originalScore) {
+      similarity.select(next._boxIndex);
+      selected.push_back(next._boxIndex);
+    } else if (static_cast<double>(next._score) > scoreThreshold) {
+      queue.push(next);
     }
   }
 
-  if (output) {
-    DataBuffer buf(selected.data(), selected.size() * sizeof(I), DataTypeUtils::fromT<I>());
-    output->dataBuffer()->copyBufferFrom(buf, buf.getLenInBytes());
+  return selected;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static void storeSelected(const std::vector<sd::LongType>& selected, NDArray* output) {
+  if (output == nullptr) return;
+  const sd::LongType length = sd::math::sd_min<sd::LongType>(selected.size(), output->lengthOf());
+  for (sd::LongType e = 0; e < length; e++) output->p(e, selected[e]);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename T>
+static void nonMaxSuppressionV2_(NDArray* boxes, NDArray* scales, int maxSize, double overlapThreshold,
+                                 double scoreThreshold, double softNmsSigma, NDArray* output) {
+  std::vector<T> scores;
+  const auto candidates = candidatesOf<T>(
+      scales, scores, [scoreThreshold](const T score) { return !((float)score < (float)scoreThreshold); });
+
+  IouSimilarity<T> similarity(boxes);
+  std::vector<sd::LongType> selected;
+  if (softNmsSigma > 0.) {
+    selected = softSuppression<T>(similarity, candidates, scores, output->lengthOf(), overlapThreshold,
+                                  scoreThreshold, softNmsSigma);
+  } else {
+    if (static_cast<sd::LongType>(candidates.size()) >= NMS_GRID_MIN_CANDIDATES) similarity.useGrid(candidates);
+    const T threshold = static_cast<T>(overlapThreshold);
+    selected = hardSuppression<T>(similarity, candidates, output->lengthOf(),
+                                  [threshold](const T sim) { return sim > threshold; }, false);
+  }
+
+  storeSelected(selected, output);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename T, typename Similarity>
+static sd::LongType suppressGeneric_(Similarity& similarity, const std::vector<sd::LongType>& candidates,
+                                     const std::vector<T>& scores, int outputSize, double overlapThreshold,
+                                     double scoreThreshold, double softNmsSigma, NDArray* output) {
+  std::vector<sd::LongType> selected;
+  if (softNmsSigma > 0.)
+    selected = softSuppression<T>(similarity, candidates, scores, outputSize, overlapThreshold, scoreThreshold,
+                                  softNmsSigma);
+  else
+    selected = hardSuppression<T>(
+        similarity, candidates, outputSize,
+        [overlapThreshold](const T sim) { return (float)sim >= static_cast<float>(overlapThreshold); }, true);
+
+  storeSelected(selected, output);
+  return selected.size();
+}
+
+template <typename T>
+static sd::LongType nonMaxSuppressionGeneric_(NDArray* boxes, NDArray* scores, int outputSize,
+                                              double overlapThreshold, double scoreThreshold, double softNmsSigma,
+                                              NDArray* output, bool overlaps) {
+  std::vector<T> scoreValues;
+  const auto candidates = candidatesOf<T>(
+      scores, scoreValues, [scoreThreshold](const T score) { return (float)score > (float)scoreThreshold; });
+
+  if (overlaps) {
+    OverlapSimilarity<T> similarity(boxes);
+    return suppressGeneric_<T>(similarity, candidates, scoreValues, outputSize, overlapThreshold, scoreThreshold,
+                               softNmsSigma, output);
   }
 
-  return (sd::LongType)selected.size();
+  IouSimilarity<T> similarity(boxes);
+  // zero similarity suppresses nothing only for positive threshold
+  if (overlapThreshold > 0. && softNmsSigma <= 0. &&
+      static_cast<sd::LongType>(candidates.size()) >= NMS_GRID_MIN_CANDIDATES)
+    similarity.useGrid(candidates);
+  return suppressGeneric_<T>(similarity, candidates, scoreValues, outputSize, overlapThreshold, scoreThreshold,
+                             softNmsSigma, output);
 }
 
 sd::LongType nonMaxSuppressionGeneric(sd::LaunchContext* context, NDArray* boxes, NDArray* scores, int maxSize,
-                                      double overlapThreshold, double scoreThreshold, NDArray* output) {
-  BUILD_DOUBLE_SELECTOR(boxes->dataType(), output == nullptr ? DataType::INT32 : output->dataType(),
-                        return nonMaxSuppressionGeneric_,
-                        (context, boxes, scores, maxSize, overlapThreshold, scoreThreshold, output, similiratyOverlaps),
-                        SD_FLOAT_TYPES, SD_INTEGER_TYPES);
+                                      double overlapThreshold, double scoreThreshold, NDArray* output,
+                                      double softNmsSigma) {
+  BUILD_SINGLE_SELECTOR(boxes->dataType(), return nonMaxSuppressionGeneric_,
+                        (boxes, scores, maxSize, overlapThreshold, scoreThreshold, softNmsSigma, output, true),
+                        SD_FLOAT_TYPES);
   return 0;
 }
 
 sd::LongType nonMaxSuppressionV3(sd::LaunchContext* context, NDArray* boxes, NDArray* scores, int maxSize,
-                                 double overlapThreshold, double scoreThreshold, NDArray* output) {
-  BUILD_DOUBLE_SELECTOR(boxes->dataType(), output == nullptr ? DataType::INT32 : output->dataType(),
-                        return nonMaxSuppressionGeneric_,
-                        (context, boxes, scores, maxSize, overlapThreshold, scoreThreshold, output, similarityV3),
-                        SD_FLOAT_TYPES, SD_INTEGER_TYPES);
+                                 double overlapThreshold, double scoreThreshold, NDArray* output,
+                                 double softNmsSigma) {
+  BUILD_SINGLE_SELECTOR(boxes->dataType(), return nonMaxSuppressionGeneric_,
+                        (boxes, scores, maxSize, overlapThreshold, scoreThreshold, softNmsSigma, output, false),
+                        SD_FLOAT_TYPES);
   return 0;
 }
 
-BUILD_DOUBLE_TEMPLATE(template sd::LongType nonMaxSuppressionGeneric_,
-                      (sd::LaunchContext * context, NDArray* boxes, NDArray* scores, int maxSize,
-                       float overlapThreshold, float scoreThreshold, NDArray* output, SimilarityFunc SimilarityFunc),
-                      SD_FLOAT_TYPES, SD_INTEGER_TYPES);
+BUILD_SINGLE_TEMPLATE(template sd::LongType nonMaxSuppressionGeneric_,
+                      (NDArray * boxes, NDArray* scores, int outputSize, double overlapThreshold,
+                       double scoreThreshold, double softNmsSigma, NDArray* output, bool overlaps),
+                      SD_FLOAT_TYPES);
 
 void nonMaxSuppression(sd::LaunchContext* context, NDArray* boxes, NDArray* scales, int maxSize,
-                       double overlapThreshold, double scoreThreshold, NDArray* output) {
+                       double overlapThreshold, double scoreThreshold, NDArray* output, double softNmsSigma) {
   BUILD_SINGLE_SELECTOR(boxes->dataType(), nonMaxSuppressionV2_,
-                        (boxes, scales, maxSize, overlapThreshold, scoreThreshold, output), SD_NUMERIC_TYPES);
+                        (boxes, scales, maxSize, overlapThreshold, scoreThreshold, softNmsSigma, output),
+                        SD_NUMERIC_TYPES);
 }
 BUILD_SINGLE_TEMPLATE(template void nonMaxSuppressionV2_,
                       (NDArray * boxes, NDArray* scales, int maxSize, double overlapThreshold, double scoreThreshold,
-                       NDArray* output),
+                       double softNmsSigma, NDArray* output),
                       SD_NUMERIC_TYPES);
 
 }  // namespace helpers
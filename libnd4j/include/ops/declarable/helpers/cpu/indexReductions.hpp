@@ -452,7 +452,7 @@ static void argIndexCase1Scalar(const int& second_rank, const sd::LongType* inne
                 int Count = 0;
                 func(0, 0, inner_total, 1);
 #else
-  int Count = samediff::Threads::parallel_tad(func, 0, inner_total, 1, maxThreads);
+  int Count = samediff::Threads::parallel_blocks(func, 0, inner_total, maxThreads);
 #endif
   Z arg = 0;
   X current = ptrMaxValues[0];
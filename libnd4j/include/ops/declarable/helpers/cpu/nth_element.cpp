@@ -21,11 +21,11 @@
 //
 #include <execution/Threads.h>
 #include <helpers/ConstantTadHelper.h>
+#include <helpers/SelectionEngine.h>
 #include <helpers/ShapeUtils.h>
 
 #include <ops/declarable/helpers/nth_element.h>
 
-#include "ops/specials.h"
 #if NOT_EXCLUDED(OP_nth_element)
 namespace sd {
 namespace ops {
@@ -33,28 +33,20 @@ namespace helpers {
 
 template <typename T>
 void nthElementFunctor_(NDArray* input, sd::LongType n, NDArray* output, bool reverse) {
-  NDArray sortedVals(*input);
-  if (input->isVector()) {
-    SpecialMethods<T>::sortGeneric(input, reverse);
-    output->p(0, input->e<T>(n));
-  } else {  // rank greater than 1
-    std::vector<sd::LongType> lastDims(
-        {input->rankOf() - 1});
-    SpecialMethods<T>::sortTadGeneric(&sortedVals, lastDims.data(), lastDims.size(),
-                                      reverse);
+  const sd::LongType lastDim = input->rankOf() - 1;
+  const sd::LongType width = input->sizeAt(-1);
+  const sd::LongType xStride = input->stridesOf()[lastDim];
 
-    ResultSet rows = sortedVals.allTensorsAlongDimension(lastDims);
-    sd::LongType oL = output->lengthOf();
+  auto packX = sd::ConstantTadHelper::getInstance().tadForDimensions(input->shapeInfo(), lastDim);
+  const T* x = input->bufferAsT<T>();
 
-    auto func = PRAGMA_THREADS_FOR {
-      for (auto e = start; e < stop; e++) {
-        auto row = rows.at(e);
-        output->p(e, row->e<T>(n));
-      }
-    };
+  auto func = PRAGMA_THREADS_FOR {
+    std::vector<T> scratch;
+    for (auto e = start; e < stop; e++)
+      output->p(e, selection::nthElement<T>(x + packX->platformOffsets()[e], width, xStride, n, reverse, scratch));
+  };
 
-    samediff::Threads::parallel_for(func, 0, oL);
-  }
+  samediff::Threads::parallel_tad(func, 0, packX->numberOfTads());
 }
 
 void nthElementFunctor(sd::LaunchContext* launchContext, NDArray* input, sd::LongType n, NDArray* output,
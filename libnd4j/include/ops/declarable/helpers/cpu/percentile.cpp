@@ -19,17 +19,44 @@
 //
 // @author Yurii Shyrma (iuriish@yahoo.com), created on 17.05.2018
 //
-#include <array/NDArrayFactory.h>
-#include <array/ResultSet.h>
+#include <execution/Threads.h>
+#include <helpers/ConstantTadHelper.h>
+#include <helpers/SelectionEngine.h>
 #include <ops/declarable/helpers/percentile.h>
+
+#include <algorithm>
+#include <memory>
 #if NOT_EXCLUDED(OP_percentile)
 namespace sd {
 namespace ops {
 namespace helpers {
 
 //////////////////////////////////////////////////////////////////////////
+// position of q-th percentile in ascending order within sub-array of length len
+static LongType percentilePosition(const LongType len, const float q, const int interpolation) {
+  const float fraction = 1.f - q / 100.;
+  LongType position = 0;
+
+  switch (interpolation) {
+    case 0:  // lower
+      position = math::sd_ceil<float, LongType>((len - 1) * fraction);
+      break;
+    case 1:  // higher
+      position = math::sd_floor<float, LongType>((len - 1) * fraction);
+      break;
+    case 2:  // nearest
+      position = math::sd_round<float, LongType>((len - 1) * fraction);
+      break;
+  }
+
+  return len - position - 1;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// output holds percentiles for q[0] first, then for q[1] and so on, every sub-array is copied once and partially
+// ordered so that all requested positions are in place, there is no full sort
 template <typename T>
-static void _percentile(NDArray& input, NDArray& output, std::vector<LongType>& axises, const float q,
+static void _percentile(NDArray& input, NDArray& output, std::vector<LongType>& axises, const std::vector<float>& q,
                         const int interpolation) {
   const int inputRank = input.rankOf();
 
@@ -38,51 +65,74 @@ static void _percentile(NDArray& input, NDArray& output, std::vector<LongType>&
   else
     shape::checkDimensions(inputRank, &axises);  // check, sort dimensions and remove duplicates if they are present
 
-  auto listOfSubArrs = input.allTensorsAlongDimension(axises);
+  auto pack = ConstantTadHelper::getInstance().tadForDimensions(input.shapeInfo(), &axises);
+  const LongType numOfSubArrs = pack->numberOfTads();
+  const LongType* subArrShapeInfo = pack->primaryShapeInfo();
+  const LongType len = shape::length(subArrShapeInfo);
 
-  std::vector<sd::LongType> shapeOfSubArr(listOfSubArrs.at(0)->rankOf());
-  for (size_t i = 0; i < shapeOfSubArr.size(); ++i) shapeOfSubArr[i] = listOfSubArrs.at(0)->shapeOf()[i];
+  if (numOfSubArrs == 0 || len == 0 || q.empty()) return;
 
-  auto flattenedArr = NDArrayFactory::create('c', shapeOfSubArr, input.dataType(), input.getContext());
-  const int len = flattenedArr.lengthOf();
+  std::vector<LongType> positions(q.size());
+  for (size_t k = 0; k < q.size(); ++k) positions[k] = percentilePosition(len, q[k], interpolation);
 
-  const float fraction = 1.f - q / 100.;
-  sd::LongType position = 0;
+  std::vector<LongType> ranks(positions);
+  std::sort(ranks.begin(), ranks.end());
+  ranks.erase(std::unique(ranks.begin(), ranks.end()), ranks.end());
 
-  switch (interpolation) {
-    case 0:  // lower
-      position = static_cast<sd::LongType>(math::sd_ceil<float, T>((len - 1) * fraction));
-      break;
-    case 1:  // higher
-      position = static_cast<sd::LongType>(math::sd_floor<float, T>((len - 1) * fraction));
-      break;
-    case 2:  // nearest
-      position = static_cast<sd::LongType>(math::sd_round<float, T>((len - 1) * fraction));
-      break;
-  }
-  position = len - position - 1;
-
-  // FIXME: our sort impl should be used instead, so this operation might be implemented as generic
-  // FIXME: parallelism !
-  for (int i = 0; i < listOfSubArrs.size(); ++i) {
-    auto buff = reinterpret_cast<T*>(flattenedArr.buffer());
-    flattenedArr.assign(listOfSubArrs.at(i));
-    std::sort(buff, buff + len);
-    output.p(i, flattenedArr.e<T>(position));
-  }
+  const T* x = input.bufferAsT<T>();
+  const LongType subArrRank = shape::rank(subArrShapeInfo);
+  const LongType* subArrShape = shape::shapeOf(subArrShapeInfo);
+  const LongType* subArrStride = shape::stride(subArrShapeInfo);
+
+  auto func = PRAGMA_THREADS_FOR {
+    std::unique_ptr<T[]> scratch(new T[len]);
+    LongType coords[SD_MAX_RANK];
+
+    for (auto i = start; i < stop; i++) {
+      const T* subArr = x + pack->platformOffsets()[i];
+
+      if (subArrRank == 1) {
+        const LongType stride = subArrStride[0];
+        for (LongType j = 0; j < len; j++) scratch[j] = subArr[j * stride];
+      } else {
+        for (LongType j = 0; j < len; j++) {
+          LongType offset;
+          INDEX2COORDS(j, subArrRank, subArrShape, coords);
+          COORDS2INDEX(subArrRank, subArrStride, coords, offset);
+          scratch[j] = subArr[offset];
+        }
+      }
+
+      selection::selectRanks<T>(scratch.get(), 0, len, ranks.data(), static_cast<LongType>(ranks.size()));
+
+      for (size_t k = 0; k < positions.size(); k++) {
+        const T value = scratch[positions[k]];
+        output.p(static_cast<LongType>(k) * numOfSubArrs + i, value);
+      }
+    }
+  };
+
+  samediff::Threads::parallel_tad(func, 0, numOfSubArrs);
 }
 
 void percentile(sd::LaunchContext* context, NDArray& input, NDArray& output, std::vector<LongType>& axises,
                 const float q, const int interpolation) {
+  const std::vector<float> quantiles = {q};
+  BUILD_SINGLE_SELECTOR(input.dataType(), _percentile, (input, output, axises, quantiles, interpolation),
+                        SD_COMMON_TYPES);
+}
+
+void percentile(sd::LaunchContext* context, NDArray& input, NDArray& output, std::vector<LongType>& axises,
+                const std::vector<float>& q, const int interpolation) {
   BUILD_SINGLE_SELECTOR(input.dataType(), _percentile, (input, output, axises, q, interpolation), SD_COMMON_TYPES);
 }
 
 BUILD_SINGLE_TEMPLATE(template void _percentile,
-                      (NDArray& input, NDArray& output, std::vector<LongType>& axises, const float q,
+                      (NDArray& input, NDArray& output, std::vector<LongType>& axises, const std::vector<float>& q,
                        const int interpolation),
                       SD_COMMON_TYPES);
 
 }  // namespace helpers
 }  // namespace ops
 }  // namespace sd
-#endif
\ No newline at end of file
+#endif
@@ -26,249 +26,321 @@
 #include <ops/declarable/helpers/segment.h>
 #include <helpers/ConstantTadHelper.h>
 
-#include <unordered_map>
+#include <algorithm>
+#include <memory>
+#include <vector>
 #if NOT_EXCLUDED(OP_segment)
 namespace sd {
 namespace ops {
 namespace helpers {
 
-// segment max
+// -------------------------------------------------------------------------------------------------------------- //
+// Segment reduction engine
+//
+// Every segment op reduces rows of input (input[i, ...] for i-th segment id) into rows of output. Rows are grouped
+// by segment id with a counting sort, and each output row is then owned by exactly one thread, so no atomics or locks
+// are needed. Sorted ids are already grouped and just give segment boundaries. Unsorted ids with only a few (thus
+// large) segments are reduced instead into per-thread partial outputs which are merged afterwards.
+// -------------------------------------------------------------------------------------------------------------- //
+
+// output of at most this many elements is cheap enough to be replicated per thread
+#define SEGMENT_PARTIALS_MAX_OUTPUT 4096
+// minimal number of input elements per thread for partial outputs to pay off
+#define SEGMENT_PARTIALS_MIN_CHUNK 4096
+
+// rows of segment s are rows[offsets[s] ... offsets[s + 1]), rows is left empty when ids are non-decreasing
+struct SegmentPartition {
+  std::vector<LongType> offsets;
+  std::vector<LongType> rows;
+
+  SD_INLINE LongType row(const LongType pos) const { return rows.empty() ? pos : rows[pos]; }
+  SD_INLINE LongType size(const LongType segment) const { return offsets[segment + 1] - offsets[segment]; }
+};
+
+// ids outside of [0, numOfClasses) are dropped
+static SegmentPartition segmentPartition(const LongType* ids, const LongType numOfRows, const LongType numOfClasses,
+                                         const bool withRows) {
+  SegmentPartition partition;
+  partition.offsets.assign(numOfClasses + 1, 0);
+
+  bool ordered = true;
+  for (LongType e = 0; e < numOfRows; e++) {
+    const auto id = ids[e];
+    if (id < 0 || id >= numOfClasses) {
+      ordered = false;
+      continue;
+    }
+    if (e > 0 && id < ids[e - 1]) ordered = false;
+    partition.offsets[id + 1]++;
+  }
+
+  for (LongType s = 0; s < numOfClasses; s++) partition.offsets[s + 1] += partition.offsets[s];
+
+  if (ordered || !withRows) return partition;
+
+  // stable, so rows of each segment keep their original order
+  partition.rows.resize(partition.offsets[numOfClasses]);
+  std::vector<LongType> cursor(partition.offsets.begin(), partition.offsets.end() - 1);
+  for (LongType e = 0; e < numOfRows; e++) {
+    const auto id = ids[e];
+    if (id >= 0 && id < numOfClasses) partition.rows[cursor[id]++] = e;
+  }
+
+  return partition;
+}
+
+// engine walks raw 'c' buffers of a single type, anything else is copied once
+static NDArray* segmentDenseC(NDArray* arr, const DataType dtype, std::vector<std::unique_ptr<NDArray>>& copies) {
+  if (arr->dataType() == dtype && arr->ordering() == 'c' && shape::isDense(arr->shapeInfo())) return arr;
+
+  copies.emplace_back(new NDArray(arr->dup('c')));
+  if (copies.back()->dataType() != dtype) copies.back().reset(new NDArray(copies.back()->cast(dtype)));
+
+  return copies.back().get();
+}
+
+static NDArray* segmentOutputC(NDArray* output, const DataType dtype, std::vector<std::unique_ptr<NDArray>>& copies) {
+  if (output->dataType() == dtype && output->ordering() == 'c' && shape::isDense(output->shapeInfo())) return output;
+
+  auto shape = output->getShapeAsVector();
+  copies.emplace_back(new NDArray('c', shape, dtype, output->getContext()));
+
+  return copies.back().get();
+}
+
 template <typename T>
-static void segmentMaxFunctor_(NDArray* input, NDArray* indices, NDArray* output) {
-  // if input is a vector: (as if in doc sample)
-  sd::LongType idx = indices->e<sd::LongType>(0);
-  if (input->isVector() || input->isScalar()) {
-    T val = input->e<T>(0);
-
-    for (sd::LongType e = 1; e < indices->lengthOf(); e++) {
-      if (idx == indices->e<sd::LongType>(e)) {
-        // max
-        val = sd::math::sd_max<T>(val, input->t<T>(e));
-      } else {
-        idx = indices->e<sd::LongType>(e);
-        val = input->t<T>(e);
+struct SegmentMaxOp {
+  static SD_INLINE T update(T acc, T val) { return sd::math::sd_max<T>(acc, val); }
+  static SD_INLINE T finish(T acc, LongType) { return acc; }
+  static SD_INLINE T bp(T grad, T reduced, T val, LongType) {
+    return sd::math::sd_abs<T, T>(reduced - val) <= T(1.e-6) ? grad : static_cast<T>(0);
+  }
+};
+
+template <typename T>
+struct SegmentMinOp {
+  static SD_INLINE T update(T acc, T val) { return sd::math::sd_min<T>(acc, val); }
+  static SD_INLINE T finish(T acc, LongType) { return acc; }
+  static SD_INLINE T bp(T grad, T reduced, T val, LongType) {
+    return sd::math::sd_abs<T, T>(reduced - val) <= T(1.e-6) ? grad : static_cast<T>(0);
+  }
+};
+
+template <typename T>
+struct SegmentSumOp {
+  static SD_INLINE T update(T acc, T val) { return acc + val; }
+  static SD_INLINE T finish(T acc, LongType) { return acc; }
+  static SD_INLINE T bp(T grad, T, T, LongType) { return grad; }
+};
+
+template <typename T>
+struct SegmentProdOp {
+  static SD_INLINE T update(T acc, T val) { return acc * val; }
+  static SD_INLINE T finish(T acc, LongType) { return acc; }
+  static SD_INLINE T bp(T grad, T reduced, T val, LongType) { return reduced * grad / val; }
+};
+
+template <typename T>
+struct SegmentMeanOp {
+  static SD_INLINE T update(T acc, T val) { return acc + val; }
+  static SD_INLINE T finish(T acc, LongType count) {
+    return static_cast<T>(static_cast<double>(acc) / static_cast<double>(count));
+  }
+  static SD_INLINE T bp(T grad, T, T, LongType count) { return finish(grad, count); }
+};
+
+template <typename T>
+struct SegmentSqrtNOp {
+  static SD_INLINE T update(T acc, T val) { return acc + val; }
+  static SD_INLINE T finish(T acc, LongType count) {
+    return static_cast<T>(static_cast<double>(acc) / sd::math::sd_sqrt<LongType, double>(count));
+  }
+  static SD_INLINE T bp(T grad, T, T, LongType count) { return finish(grad, count); }
+};
+
+// output[s, ...] = Op over input[i, ...] with indices[i] == s, segments without rows get emptyValue
+template <typename T, typename Op>
+static void segmentReduce_(NDArray* input, NDArray* indices, const LongType numOfClasses, const bool sorted,
+                           const T emptyValue, NDArray* output) {
+  if (output->isEmpty() || numOfClasses <= 0) return;
+
+  std::vector<std::unique_ptr<NDArray>> copies;
+  NDArray* x = segmentDenseC(input, DataTypeUtils::fromT<T>(), copies);
+  NDArray* idx = segmentDenseC(indices, DataType::INT64, copies);
+  NDArray* z = segmentOutputC(output, DataTypeUtils::fromT<T>(), copies);
+
+  const auto xBuf = x->bufferAsT<T>();
+  const auto ids = idx->bufferAsT<LongType>();
+  auto zBuf = z->bufferAsT<T>();
+
+  const LongType numOfRows = idx->lengthOf();
+  const LongType rowLen = z->lengthOf() / numOfClasses;
+  const LongType outLen = numOfClasses * rowLen;
+
+  LongType numOfChunks = 1;
+  if (!sorted && outLen <= SEGMENT_PARTIALS_MAX_OUTPUT)
+    numOfChunks = sd::math::sd_min<LongType>(Environment::getInstance().maxMasterThreads(),
+                                             numOfRows * rowLen / SEGMENT_PARTIALS_MIN_CHUNK);
+
+  const auto partition = segmentPartition(ids, numOfRows, numOfClasses, numOfChunks < 2);
+
+  if (numOfChunks < 2) {
+    // each (segment, column range) pair is owned by a single thread
+    auto func = PRAGMA_THREADS_FOR_2D {
+      for (auto s = start_x; s < stop_x; s += inc_x) {
+        T* zRow = zBuf + s * rowLen;
+        const auto first = partition.offsets[s];
+        const auto last = partition.offsets[s + 1];
+
+        if (first == last) {
+          for (auto e = start_y; e < stop_y; e++) zRow[e] = emptyValue;
+          continue;
+        }
+
+        const T* xRow = xBuf + partition.row(first) * rowLen;
+        for (auto e = start_y; e < stop_y; e++) zRow[e] = xRow[e];
+
+        for (auto pos = first + 1; pos < last; pos++) {
+          xRow = xBuf + partition.row(pos) * rowLen;
+          for (auto e = start_y; e < stop_y; e++) zRow[e] = Op::update(zRow[e], xRow[e]);
+        }
+
+        for (auto e = start_y; e < stop_y; e++) zRow[e] = Op::finish(zRow[e], last - first);
       }
-      output->r<T>(idx) = val;
-    }
+    };
+
+    samediff::Threads::parallel_for(func, 0, numOfClasses, 1, 0, rowLen, 1);
   } else {
-    std::vector<sd::LongType> zeroVec = {0};
-    std::vector<sd::LongType> *restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), 1,zeroVec.data());
-    auto listOfTensors = input->allTensorsAlongDimension(*restDims);
-    auto listOfOutTensors = output->allTensorsAlongDimension(*restDims);
-    delete restDims;
-    auto numOfClasses = output->sizeAt(0);  // number of classes
-    std::vector<std::pair<NDArray*, sd::LongType>> outputs(numOfClasses);
-    auto maxT = listOfOutTensors.at(idx);
-
-    // int pos = 0;
-    maxT->assign(listOfTensors.at(0));
-
-    for (sd::LongType i = 1; i < indices->lengthOf(); i++) {
-      if (indices->e<int>(i) == idx) {
-        for (sd::LongType e = 0; e < maxT->lengthOf(); e++) {
-          maxT->r<T>(e) = sd::math::sd_max(maxT->t<T>(e), listOfTensors.at(i)->t<T>(e));
+    // few segments: every chunk of rows gets its own copy of output, copies are merged element-wise
+    std::vector<T> partials(numOfChunks * outLen);
+    std::vector<int8_t> seen(numOfChunks * numOfClasses, 0);
+    const LongType chunkRows = (numOfRows + numOfChunks - 1) / numOfChunks;
+
+    auto reduceChunks = PRAGMA_THREADS_FOR {
+      for (auto c = start; c < stop; c++) {
+        T* partial = partials.data() + c * outLen;
+        int8_t* chunkSeen = seen.data() + c * numOfClasses;
+        const auto lastRow = sd::math::sd_min<LongType>(numOfRows, (c + 1) * chunkRows);
+
+        for (auto r = c * chunkRows; r < lastRow; r++) {
+          const auto s = ids[r];
+          if (s < 0 || s >= numOfClasses) continue;
+
+          T* pRow = partial + s * rowLen;
+          const T* xRow = xBuf + r * rowLen;
+          if (chunkSeen[s]) {
+            for (LongType e = 0; e < rowLen; e++) pRow[e] = Op::update(pRow[e], xRow[e]);
+          } else {
+            for (LongType e = 0; e < rowLen; e++) pRow[e] = xRow[e];
+            chunkSeen[s] = 1;
+          }
         }
-      } else {
-        idx = indices->e<sd::LongType>(i);
-        maxT = listOfOutTensors.at(idx);
-        maxT->assign(listOfTensors.at(i));
       }
-    }
+    };
+
+    samediff::Threads::parallel_for(reduceChunks, 0, numOfChunks, 1, numOfChunks);
+
+    auto merge = PRAGMA_THREADS_FOR {
+      for (auto e = start; e < stop; e++) {
+        const auto s = e / rowLen;
+        bool any = false;
+        T acc = emptyValue;
+
+        for (LongType c = 0; c < numOfChunks; c++) {
+          if (!seen[c * numOfClasses + s]) continue;
+          const T val = partials[c * outLen + e];
+          acc = any ? Op::update(acc, val) : val;
+          any = true;
+        }
+
+        zBuf[e] = any ? Op::finish(acc, partition.size(s)) : emptyValue;
+      }
+    };
+
+    samediff::Threads::parallel_for(merge, 0, outLen);
   }
+
+  if (z != output) output->assign(z);
+}
+
+// output[i, ...] = Op::bp(gradOut[s, ...], reduced[s, ...], input[i, ...], size of s) with s = indices[i], every
+// output row depends on a single segment so rows are simply split between threads
+template <typename T, typename Op>
+static void segmentReduceBP_(NDArray* input, NDArray* indices, NDArray* gradOut, NDArray* reduced,
+                             const LongType numOfClasses, NDArray* output) {
+  if (output->isEmpty() || indices->lengthOf() == 0) return;
+
+  std::vector<std::unique_ptr<NDArray>> copies;
+  NDArray* x = segmentDenseC(input, DataTypeUtils::fromT<T>(), copies);
+  NDArray* idx = segmentDenseC(indices, DataType::INT64, copies);
+  NDArray* g = segmentDenseC(gradOut, DataTypeUtils::fromT<T>(), copies);
+  NDArray* r = reduced != nullptr ? segmentDenseC(reduced, DataTypeUtils::fromT<T>(), copies) : g;
+  NDArray* z = segmentOutputC(output, DataTypeUtils::fromT<T>(), copies);
+
+  const auto xBuf = x->bufferAsT<T>();
+  const auto ids = idx->bufferAsT<LongType>();
+  const auto gBuf = g->bufferAsT<T>();
+  const auto rBuf = r->bufferAsT<T>();
+  auto zBuf = z->bufferAsT<T>();
+
+  const LongType numOfRows = idx->lengthOf();
+  const LongType rowLen = z->lengthOf() / numOfRows;
+
+  const auto partition = segmentPartition(ids, numOfRows, numOfClasses, false);
+
+  auto func = PRAGMA_THREADS_FOR_2D {
+    for (auto i = start_x; i < stop_x; i += inc_x) {
+      T* zRow = zBuf + i * rowLen;
+      const auto s = ids[i];
+
+      if (s < 0 || s >= numOfClasses) {
+        for (auto e = start_y; e < stop_y; e++) zRow[e] = static_cast<T>(0);
+        continue;
+      }
+
+      const T* xRow = xBuf + i * rowLen;
+      const T* gRow = gBuf + s * rowLen;
+      const T* rRow = rBuf + s * rowLen;
+      const auto count = partition.size(s);
+      for (auto e = start_y; e < stop_y; e++) zRow[e] = Op::bp(gRow[e], rRow[e], xRow[e], count);
+    }
+  };
+
+  samediff::Threads::parallel_for(func, 0, numOfRows, 1, 0, rowLen, 1);
+
+  if (z != output) output->assign(z);
+}
+
+// -------------------------------------------------------------------------------------------------------------- //
+// Sorted segment ops
+// -------------------------------------------------------------------------------------------------------------- //
+
+// segment max
+template <typename T>
+static void segmentMaxFunctor_(NDArray* input, NDArray* indices, NDArray* output) {
+  segmentReduce_<T, SegmentMaxOp<T>>(input, indices, output->sizeAt(0), true, static_cast<T>(0), output);
 }
 
 // segmen min
 template <typename T>
 static void segmentMinFunctor_(NDArray* input, NDArray* indices, NDArray* output) {
-  // if input is a vector: (as if in doc sample)
-  sd::LongType idx = indices->e<sd::LongType>(0);
-  if (input->isVector() || input->isScalar()) {
-    T val = input->e<T>(0);
-
-    for (sd::LongType e = 1; e < indices->lengthOf(); e++) {
-      if (idx == indices->e<sd::LongType>(e)) {
-        // min
-        val = sd::math::sd_min<T>(val, input->t<T>(e));
-      } else {
-        idx = indices->e<sd::LongType>(e);
-        val = input->t<T>(e);
-      }
-      output->r<T>(idx) = val;
-    }
-  } else {
-    std::vector<sd::LongType> zeroVec = {0};
-    std::vector<sd::LongType> *restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), 1,zeroVec.data());
-    ResultSet listOfTensors = input->allTensorsAlongDimension(*restDims);
-    ResultSet listOfOutTensors = output->allTensorsAlongDimension(*restDims);
-
-    int numOfClasses = output->sizeAt(0);  // number of classes
-    std::vector<std::pair<NDArray*, sd::LongType>> outputs(numOfClasses);
-    auto minT = listOfOutTensors.at(idx);
-
-    int pos = 0;
-    minT->assign(listOfTensors.at(0));
-
-    for (sd::LongType i = 1; i < indices->lengthOf(); i++) {
-      if (indices->e<sd::LongType>(i) == idx) {
-        for (sd::LongType e = 0; e < minT->lengthOf(); e++) {
-          minT->p(e, sd::math::sd_min(minT->e<T>(e), listOfTensors.at(i)->e<T>(e)));
-        }
-      } else {
-        idx = indices->e<sd::LongType>(i);
-        minT = listOfOutTensors.at(idx);
-        minT->assign(listOfTensors.at(i));
-      }
-    }
-  }
+  segmentReduce_<T, SegmentMinOp<T>>(input, indices, output->sizeAt(0), true, static_cast<T>(0), output);
 }
 
 // segmen mean
 template <typename T>
 static void segmentMeanFunctor_(NDArray* input, NDArray* indices, NDArray* output) {
-  int numClasses = output->sizeAt(0);
-  // if input is a vector: (as if in doc sample)
-  int idx = indices->e<sd::LongType>(0);
-  if (input->isVector() || input->isScalar()) {
-    T val = T(0.f);
-    int count = 0;
-
-    for (sd::LongType e = 0; e < indices->lengthOf(); e++) {
-      if (idx == indices->e<sd::LongType>(e)) {
-        // mean
-        val += input->e<T>(e);
-        count++;
-      } else {
-        output->p<T>(idx, val / count);
-        idx = indices->e<sd::LongType>(e);
-        val = input->e<T>(e);
-        count = 1;
-      }
-      output->p<T>(idx, val / count);
-    }
-  } else {
-    std::vector<sd::LongType> zeroVec = {0};
-    std::vector<sd::LongType> *restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), 1,zeroVec.data());
-    auto listOfTensors = input->allTensorsAlongDimension(*restDims);
-    auto listOfOutTensors = output->allTensorsAlongDimension(*restDims);
-    delete restDims;
-    int numOfClasses = output->sizeAt(0);  // number of classes
-    std::vector<std::pair<NDArray*, sd::LongType>> outputs(numOfClasses);
-    auto meanT = listOfOutTensors.at(idx);
-    int count = 1;
-    auto meanV = meanT->dup();
-    meanV.assign(listOfTensors.at(0));
-
-    for (sd::LongType i = 1; i < indices->lengthOf(); i++) {
-      if (indices->e<sd::LongType>(i) == idx) {
-        auto func = PRAGMA_THREADS_FOR {
-          for (auto e = start; e < stop; e++) {
-            meanV.p<T>(e, meanV.e<T>(e) + listOfTensors.at(i)->e<T>(e));
-          }
-        };
-        samediff::Threads::parallel_for(func, 0, meanT->lengthOf());
-
-        count++;
-      } else {
-        meanV.applyScalar(scalar::Divide, count, meanT);
-        idx = indices->e<sd::LongType>(i);
-        meanT = listOfOutTensors.at(idx);
-        meanV.assign(listOfTensors.at(i));
-        count = 1;
-      }
-      meanV.applyScalar(scalar::Divide, count, meanT);
-    }
-  }
+  segmentReduce_<T, SegmentMeanOp<T>>(input, indices, output->sizeAt(0), true, static_cast<T>(0), output);
 }
 
 template <typename T>
 static void segmentSumFunctor_(NDArray* input, NDArray* indices, NDArray* output) {
-  int numClasses = output->sizeAt(0);
-  // if input is a vector: (as if in doc sample)
-  int idx = indices->e<int>(0);
-  if (input->isVector() || input->isScalar()) {
-    T val = T(0.f);
-    int count = 0;
-    for (sd::LongType e = 0; e < indices->lengthOf(); e++) {
-      if (idx == indices->e<sd::LongType>(e)) {
-        // sum
-        val += input->t<T>(e);
-      } else {
-        idx = indices->e<sd::LongType>(e);
-        val = input->t<T>(e);
-      }
-      output->p(idx, val);
-    }
-  } else {
-    std::vector<sd::LongType> zeroVec = {0};
-    std::vector<sd::LongType> *restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), 1,zeroVec.data());
-    auto listOfTensors = input->allTensorsAlongDimension(*restDims);
-    auto listOfOutTensors = output->allTensorsAlongDimension(*restDims);
-    delete restDims;
-    int numOfClasses = output->sizeAt(0);  // number of classes
-    std::vector<std::pair<NDArray*, sd::LongType>> outputs(numOfClasses);
-    auto sumT = listOfOutTensors.at(idx);
-
-    for (sd::LongType i = 0; i < indices->lengthOf(); i++) {
-      if (indices->e<sd::LongType>(i) == idx) {
-        auto func = PRAGMA_THREADS_FOR {
-          for (auto e = start; e < stop; e++) {
-            sumT->p(e, sumT->e<T>(e) + listOfTensors.at(i)->e<T>(e));
-          }
-        };
-        samediff::Threads::parallel_for(func, 0, sumT->lengthOf());
-      } else {
-        idx = indices->e<sd::LongType>(i);
-        sumT = listOfOutTensors.at(idx);
-        sumT->assign(listOfTensors.at(i));
-      }
-    }
-  }
+  segmentReduce_<T, SegmentSumOp<T>>(input, indices, output->sizeAt(0), true, static_cast<T>(0), output);
 }
 
 template <typename T>
 static void segmentProdFunctor_(NDArray* input, NDArray* indices, NDArray* output) {
-  // int numClasses = output->sizeAt(0);
-  int idx = indices->e<sd::LongType>(0);
-  float one = 1.f;
-  output->assign(one);
-  if (input->isVector() || input->isScalar()) {
-    T val = input->e<T>(0);
-    int count = 0;
-
-    for (sd::LongType e = 1; e < indices->lengthOf(); e++) {
-      if (idx == indices->e<sd::LongType>(e)) {
-        // sum
-        val *= input->e<T>(e);
-      } else {
-        idx = indices->e<sd::LongType>(e);
-        val = input->e<T>(e);
-      }
-      output->p(idx, val);
-    }
-  } else {
-    std::vector<sd::LongType> zeroVec = {0};
-    std::vector<sd::LongType> *restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), 1,zeroVec.data());
-    auto listOfTensors = input->allTensorsAlongDimension(*restDims);
-    auto listOfOutTensors = output->allTensorsAlongDimension(*restDims);
-    delete restDims;
-    int numOfClasses = output->sizeAt(0);  // number of classes
-    auto sumT = listOfOutTensors.at(idx);
-    sumT->assign(listOfTensors.at(0));
-    for (sd::LongType i = 1; i < indices->lengthOf(); i++) {
-      if (indices->e<sd::LongType>(i) == idx) {
-        auto func = PRAGMA_THREADS_FOR {
-          for (auto e = start; e < stop; e++) {
-            sumT->p(e, sumT->e<T>(e) * listOfTensors.at(i)->e<T>(e));
-          }
-        };
-        samediff::Threads::parallel_for(func, 0, sumT->lengthOf());
-      } else {
-        idx = indices->e<int>(i);
-        sumT = listOfOutTensors.at(idx);
-        sumT->assign(listOfTensors.at(i));
-      }
-    }
-  }
+  segmentReduce_<T, SegmentProdOp<T>>(input, indices, output->sizeAt(0), true, static_cast<T>(1), output);
 }
 
 
@@ -333,49 +405,7 @@ bool unsortedSegmentIndicesValidate(sd::LaunchContext* context, NDArray* indices
 
 template <typename T>
 static void unsortedSegmentMaxFunctor_(NDArray* input, NDArray* indices, sd::LongType numOfClasses, NDArray* output) {
-  // if input is a vector: (as if in doc sample)
-  SD_MAP_IMPL<sd::LongType, std::vector<sd::LongType>> idxs;
-  for (sd::LongType e = 0; e < indices->lengthOf(); ++e) idxs[indices->e<sd::LongType>(e)].push_back(e);
-
-
-  if (input->isVector() || input->isScalar()) {  // 1D case
-    T maxVal = DataTypeUtils::max<T>();
-    T negMaxVal = -maxVal;
-    output->assign(negMaxVal);
-
-    for (auto fi = idxs.begin(); fi != idxs.end(); ++fi) {
-      T val = input->e<T>(fi->second.at(0));
-      for (sd::LongType idx = 1; idx < static_cast<sd::LongType>(fi->second.size()); ++idx) {
-        val = sd::math::sd_max(val, input->e<T>(fi->second.at(idx)));
-      }
-      output->p(fi->first, val);
-    }
-  } else {
-    std::vector<sd::LongType> zeroVec = {0};
-    std::vector<sd::LongType> *restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), 1,zeroVec.data());
-    auto listOfTensors = input->allTensorsAlongDimension(*restDims);
-    auto listOfOutTensors = output->allTensorsAlongDimension(*restDims);
-    delete restDims;
-    T maxVal = DataTypeUtils::max<T>();
-    output->assign(maxVal);
-
-    for (auto fi = idxs.begin(); fi != idxs.end(); ++fi) {
-      auto outputT = listOfOutTensors.at(fi->first);
-      outputT->assign(listOfTensors.at(fi->second.at(0)));
-      for (sd::LongType idx = 0; idx < listOfTensors.size(); ++idx) {
-        if (static_cast<size_t>(idx) >= fi->second.size() || fi->second.size() < 2 || fi->second.at(idx) >= listOfTensors.size()) {
-          continue;
-        }
-
-        auto maxT = listOfTensors.at(fi->second.at(idx));
-        for (sd::LongType e = 0; e < outputT->lengthOf(); ++e) {
-          T val = sd::math::sd_max(maxT->e<T>(e), outputT->e<T>(e));
-
-          outputT->p(e, val);
-        }
-      }
-    }
-  }
+  segmentReduce_<T, SegmentMaxOp<T>>(input, indices, numOfClasses, false, -DataTypeUtils::max<T>(), output);
 }
 void unsortedSegmentMaxFunctor(sd::LaunchContext* context, NDArray* input, NDArray* indices, sd::LongType numOfClasses,
                                NDArray* output) {
@@ -388,45 +418,7 @@ BUILD_SINGLE_TEMPLATE(template void unsortedSegmentMaxFunctor_,
 
 template <typename T>
 static void unsortedSegmentMinFunctor_(NDArray* input, NDArray* indices, sd::LongType numOfClasses, NDArray* output) {
-  // if input is a vector: (as if in doc sample)
-  SD_MAP_IMPL<sd::LongType, std::vector<sd::LongType>> idxs;
-
-  for (sd::LongType e = 0; e < indices->lengthOf(); ++e) idxs[indices->e<sd::LongType>(e)].push_back(e);
-
-
-  if (input->isVector() || input->isScalar()) {  // 1D case
-    T maxVal = DataTypeUtils::max<T>();
-    output->assign(maxVal);
-
-    for (auto fi = idxs.begin(); fi != idxs.end(); ++fi) {
-      T val = input->t<T>(fi->second.at(0));
-
-      for (size_t idx = 1; idx < fi->second.size(); ++idx) {
-        val = sd::math::sd_min(val, input->t<T>(fi->second.at(idx)));
-      }
-      output->r<T>(fi->first) = val;
-    }
-  } else {
-    std::vector<sd::LongType> zeroVec = {0};
-    std::vector<sd::LongType> *restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), 1,zeroVec.data());
-    auto listOfTensors = input->allTensorsAlongDimension(*restDims);
-    auto listOfOutTensors = output->allTensorsAlongDimension(*restDims);
-    delete restDims;
-    T maxVal = DataTypeUtils::max<T>();
-    output->assign(maxVal);
-
-    for (auto fi = idxs.begin(); fi != idxs.end(); ++fi) {
-      auto outputT = listOfOutTensors.at(fi->first);
-      outputT->assign(listOfTensors.at(fi->second.at(0)));
-      for (size_t idx = 1; idx < fi->second.size(); ++idx) {
-        auto minT = listOfTensors.at(fi->second.at(idx));
-
-        for (sd::LongType e = 0; e < outputT->lengthOf(); ++e) {
-          outputT->r<T>(e) = sd::math::sd_min(minT->t<T>(e), outputT->t<T>(e));
-        }
-      }
-    }
-  }
+  segmentReduce_<T, SegmentMinOp<T>>(input, indices, numOfClasses, false, DataTypeUtils::max<T>(), output);
 }
 void unsortedSegmentMinFunctor(sd::LaunchContext* context, NDArray* input, NDArray* indices, sd::LongType numOfClasses,
                                NDArray* output) {
@@ -438,114 +430,39 @@ BUILD_SINGLE_TEMPLATE(template void unsortedSegmentMinFunctor_,
                       (NDArray * input, NDArray* indices, sd::LongType numOfClasses, NDArray* output),
                       SD_NUMERIC_TYPES);
 
+template <typename T>
+static void unsortedSegmentMeanFunctor_(NDArray* input, NDArray* indices, sd::LongType numOfClasses,
+                                        NDArray* output) {
+  segmentReduce_<T, SegmentMeanOp<T>>(input, indices, numOfClasses, false, static_cast<T>(0), output);
+}
+
 void unsortedSegmentMeanFunctor(sd::LaunchContext* context, NDArray* input, NDArray* indices, sd::LongType numOfClasses,
                                 NDArray* output) {
-  SD_MAP_IMPL<sd::LongType, std::vector<sd::LongType>> idxs;
-  for (sd::LongType e = 0; e < indices->lengthOf(); ++e) idxs[indices->e<sd::LongType>(e)].push_back(e);
-
-
-  if (input->isVector() || input->isScalar()) {  // 1D case
-
-    for (auto fi = idxs.begin(); fi != idxs.end(); ++fi) {
-      double sumValue = input->e<double>(fi->second.at(0));
-      size_t loop_size = fi->second.size();
-
-      // FIXME: parallelism here?
-      for (size_t idx = 1; idx < loop_size; ++idx) {
-        sumValue += input->e<double>(fi->second.at(idx));
-      }
+  BUILD_SINGLE_SELECTOR(input->dataType(), unsortedSegmentMeanFunctor_, (input, indices, numOfClasses, output),
+                        SD_NUMERIC_TYPES);
+}
+BUILD_SINGLE_TEMPLATE(template void unsortedSegmentMeanFunctor_,
+                      (NDArray * input, NDArray* indices, sd::LongType numOfClasses, NDArray* output),
+                      SD_NUMERIC_TYPES);
 
-      output->p(fi->first, sumValue / fi->second.size());
-    }
-  } else {
-    std::vector<sd::LongType> zeroVec = {0};
-    std::vector<sd::LongType> *restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), 1,zeroVec.data());
-    auto listOfTensors = input->allTensorsAlongDimension(*restDims);
-    auto listOfOutTensors = output->allTensorsAlongDimension(*restDims);
-    delete restDims;
-    // FIXME: parallelism here?
-    for (auto fi = idxs.begin(); fi != idxs.end(); ++fi) {
-      auto outputT = listOfOutTensors.at(fi->first);
-      outputT->assign(listOfTensors.at(fi->second.at(0)));
-      sd::LongType loopSize = fi->second.size();
-
-      for (sd::LongType idx = 1; idx < loopSize; ++idx) {
-        auto current = listOfTensors.at(fi->second.at(idx));
-        *outputT += *current;
-      }
-      (*outputT) /= double(fi->second.size());
-    }
-  }
+template <typename T>
+static void unsortedSegmentSumFunctor_(NDArray* input, NDArray* indices, sd::LongType numOfClasses, NDArray* output) {
+  segmentReduce_<T, SegmentSumOp<T>>(input, indices, numOfClasses, false, static_cast<T>(0), output);
 }
 
 void unsortedSegmentSumFunctor(sd::LaunchContext* context, NDArray* input, NDArray* indices, sd::LongType numOfClasses,
                                NDArray* output) {
-  SD_MAP_IMPL<sd::LongType, std::vector<sd::LongType>> idxs;  //(indices->lengthOf());
-  for (sd::LongType e = 0; e < indices->lengthOf(); ++e) idxs[indices->e<sd::LongType>(e)].push_back(e);
-
-  if (input->isVector() || input->isScalar()) {  // 1D case
-
-    for (auto fi = idxs.begin(); fi != idxs.end(); ++fi) {
-      double sumValue = input->e<double>(fi->second.at(0));
-      sd::LongType loop_size = fi->second.size();
-
-      // FIXME: parallelism here?
-      for (sd::LongType idx = 1; idx < loop_size; ++idx) {
-        sumValue += input->e<double>(fi->second.at(idx));
-      }
-      output->p(fi->first, sumValue);
-    }
-  } else {
-    std::vector<sd::LongType> zeroVec = {0};
-    std::vector<sd::LongType> *restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), 1,zeroVec.data());
-    auto listOfTensors = input->allTensorsAlongDimension(*restDims);
-    auto listOfOutTensors = output->allTensorsAlongDimension(*restDims);
-    delete restDims;
-    for (auto fi = idxs.begin(); fi != idxs.end(); ++fi) {
-      auto outputT = listOfOutTensors.at(fi->first);
-      outputT->assign(listOfTensors.at(fi->second.at(0)));
-      sd::LongType loop_size = fi->second.size();
-
-      // FIXME: parallelism here?
-      for (sd::LongType idx = 1; idx < loop_size; ++idx) {
-        auto current = listOfTensors.at(fi->second.at(idx));
-        *(outputT) += *current;
-      }
-    }
-  }
+  BUILD_SINGLE_SELECTOR(input->dataType(), unsortedSegmentSumFunctor_, (input, indices, numOfClasses, output),
+                        SD_NUMERIC_TYPES);
 }
+BUILD_SINGLE_TEMPLATE(template void unsortedSegmentSumFunctor_,
+                      (NDArray * input, NDArray* indices, sd::LongType numOfClasses, NDArray* output),
+                      SD_NUMERIC_TYPES);
 
 template <typename T>
-void unsortedSegmentProdFunctor_(NDArray* input, NDArray* indices, sd::LongType numOfClasses, NDArray* output) {
-  SD_MAP_IMPL<sd::LongType, std::vector<sd::LongType>> idxs;  //(indices->lengthOf());
-  for (sd::LongType e = 0; e < indices->lengthOf(); ++e) idxs[indices->e<sd::LongType>(e)].push_back(e);
-  float one = 1.f;
-  output->assign(one);
-
-  if (input->isVector() || input->isScalar()) {  // 1D case
-    for (auto fi = idxs.begin(); fi != idxs.end(); ++fi) {
-      T prodValue = input->e<T>(fi->second.at(0));
-      for (size_t idx = 1; idx < fi->second.size(); ++idx) {
-        prodValue *= input->e<T>(fi->second.at(idx));
-      }
-      output->p(fi->first, prodValue);
-    }
-  } else {
-    std::vector<sd::LongType> zeroVec = {0};
-    std::vector<sd::LongType> *restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), 1,zeroVec.data());
-    auto listOfTensors = input->allTensorsAlongDimension(*restDims);
-    auto listOfOutTensors = output->allTensorsAlongDimension(*restDims);
-    delete restDims;
-    for (auto fi = idxs.begin(); fi != idxs.end(); ++fi) {
-      auto outputT = listOfOutTensors.at(fi->first);
-      outputT->assign(listOfTensors.at(fi->second.at(0)));
-      for (size_t idx = 1; idx < fi->second.size(); ++idx) {
-        auto current = listOfTensors.at(fi->second.at(idx));
-
-        *outputT *= *current;
-      }
-    }
-  }
+static void unsortedSegmentProdFunctor_(NDArray* input, NDArray* indices, sd::LongType numOfClasses,
+                                        NDArray* output) {
+  segmentReduce_<T, SegmentProdOp<T>>(input, indices, numOfClasses, false, static_cast<T>(1), output);
 }
 
 void unsortedSegmentProdFunctor(sd::LaunchContext* context, NDArray* input, NDArray* indices, sd::LongType numOfClasses,
@@ -557,89 +474,47 @@ BUILD_SINGLE_TEMPLATE(template void unsortedSegmentProdFunctor_,
                       (NDArray * input, NDArray* indices, sd::LongType numOfClasses, NDArray* output),
                       SD_NUMERIC_TYPES);
 
+template <typename T>
+static void unsortedSegmentSqrtNFunctor_(NDArray* input, NDArray* indices, sd::LongType numOfClasses,
+                                         NDArray* output) {
+  segmentReduce_<T, SegmentSqrtNOp<T>>(input, indices, numOfClasses, false, static_cast<T>(0), output);
+}
+
 void unsortedSegmentSqrtNFunctor(sd::LaunchContext* context, NDArray* input, NDArray* indices,
                                  sd::LongType numOfClasses, NDArray* output) {
-  SD_MAP_IMPL<sd::LongType, std::vector<sd::LongType>> idxs;
-  for (sd::LongType e = 0; e < indices->lengthOf(); ++e) idxs[indices->e<sd::LongType>(e)].push_back(e);
-
-
-  if (input->isVector() || input->isScalar()) {  // 1D case
-    for (auto fi = idxs.begin(); fi != idxs.end(); ++fi) {
-      double sumValue = input->e<double>(fi->second.at(0));
-      for (size_t idx = 1; idx < fi->second.size(); ++idx) {
-        sumValue += input->e<double>(fi->second.at(idx));
-      }
-      output->p(fi->first, sumValue / sd::math::sd_sqrt<sd::LongType, double>(fi->second.size()));
-    }
-  } else {
-    std::vector<sd::LongType> zeroVec = {0};
-    std::vector<sd::LongType> *restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), 1,zeroVec.data());
-    auto listOfTensors = input->allTensorsAlongDimension(*restDims);
-    auto listOfOutTensors = output->allTensorsAlongDimension(*restDims);
-    delete restDims;
-    for (auto fi = idxs.begin(); fi != idxs.end(); ++fi) {
-      auto outputT = listOfOutTensors.at(fi->first);
-      outputT->assign(listOfTensors.at(fi->second.at(0)));
-      for (size_t idx = 1; idx < fi->second.size(); ++idx) {
-        auto current = listOfTensors.at(fi->second.at(idx));
-        *outputT += *current;
-      }
-      (*outputT) /= sd::math::sd_sqrt<size_t, double>(fi->second.size());
-    }
-  }
+  BUILD_SINGLE_SELECTOR(input->dataType(), unsortedSegmentSqrtNFunctor_, (input, indices, numOfClasses, output),
+                        SD_NUMERIC_TYPES);
 }
+BUILD_SINGLE_TEMPLATE(template void unsortedSegmentSqrtNFunctor_,
+                      (NDArray * input, NDArray* indices, sd::LongType numOfClasses, NDArray* output),
+                      SD_NUMERIC_TYPES);
 
 // -------------------------------------------------------------------------------------------------------------- //
 // Backpropagate ops helpers
 // -------------------------------------------------------------------------------------------------------------- //
 // Sorted backpropagate ops
 //
+// max, min and prod need forward result, it is recomputed into array of gradOut shape
+template <typename T, typename Op>
+static void segmentFunctorBP_(NDArray* input, NDArray* indices, NDArray* gradOut, sd::LongType numOfClasses,
+                              bool sorted, bool withForward, T emptyValue, NDArray* output) {
+  if (!withForward) {
+    segmentReduceBP_<T, Op>(input, indices, gradOut, nullptr, numOfClasses, output);
+    return;
+  }
+
+  auto shape = gradOut->getShapeAsVector();
+  NDArray tempRes('c', shape, DataTypeUtils::fromT<T>(), gradOut->getContext());
+  segmentReduce_<T, Op>(input, indices, numOfClasses, sorted, emptyValue, &tempRes);
+  segmentReduceBP_<T, Op>(input, indices, gradOut, &tempRes, numOfClasses, output);
+}
+
 // segment max
 template <typename T>
 sd::Status segmentMaxFunctorBP_(sd::LaunchContext* context, NDArray* input, NDArray* indices, NDArray* gradOut,
                                 NDArray* output) {
-  // if input is a vector: (as if in doc sample)
-  auto tempRes = gradOut->dup();
-  segmentMaxFunctor_<T>(input, indices, &tempRes);
-  if (input->isVector() || input->isScalar()) {
-    sd::LongType loop_size = input->lengthOf();
-
-    auto func = PRAGMA_THREADS_FOR {
-      for (auto e = start; e < stop; e++) {
-        auto classNum = indices->e<sd::LongType>(e);
-        if (sd::math::sd_abs<T,T>(tempRes.e<T>(classNum) - input->e<T>(e)) <= T(1.e-6))
-          output->p(e, gradOut->e<T>(classNum));
-      }
-    };
-    samediff::Threads::parallel_for(func, 0, loop_size);
-  } else {
-    std::vector<sd::LongType> zeroVec = {0};
-    std::vector<sd::LongType> *restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), 1,zeroVec.data());
-    ResultSet listOfBPTensors = tempRes.allTensorsAlongDimension(*restDims);
-
-    ResultSet listOfGradOuts = gradOut->allTensorsAlongDimension(*restDims);
-    ResultSet listOfTensors = input->allTensorsAlongDimension(*restDims);
-    ResultSet listOfOutTensors = output->allTensorsAlongDimension(*restDims);
-    delete restDims;
-
-
-    auto func = PRAGMA_THREADS_FOR {
-      for (auto i = start; i < stop; i++) {
-        auto classNum = indices->e<sd::LongType>(i);
-        auto current = listOfTensors.at(i);
-        auto currentOut = listOfOutTensors.at(i);
-        auto currentGradOut = listOfGradOuts.at(classNum);
-
-        for (sd::LongType e = 0; e < current->lengthOf(); e++) {
-          if (sd::math::sd_abs<T,T>(listOfBPTensors.at(classNum)->e<T>(e) - current->e<T>(e)) <= T(1.e-6))
-            currentOut->p(e, currentGradOut->e<T>(e));
-        }
-      }
-    };
-
-    samediff::Threads::parallel_tad(func, 0, indices->lengthOf());
-  }
-
+  segmentFunctorBP_<T, SegmentMaxOp<T>>(input, indices, gradOut, gradOut->sizeAt(0), true, true, static_cast<T>(0),
+                                        output);
   return sd::Status::OK;
 }
 
@@ -654,152 +529,61 @@ BUILD_SINGLE_TEMPLATE(template sd::Status segmentMaxFunctorBP_,
                       SD_NUMERIC_TYPES);
 
 // segmen min
+template <typename T>
+static sd::Status segmentMinFunctorBP_(sd::LaunchContext* context, NDArray* input, NDArray* indices, NDArray* gradOut,
+                                       NDArray* output) {
+  segmentFunctorBP_<T, SegmentMinOp<T>>(input, indices, gradOut, gradOut->sizeAt(0), true, true, static_cast<T>(0),
+                                        output);
+  return sd::Status::OK;
+}
+
 sd::Status segmentMinFunctorBP(sd::LaunchContext* context, NDArray* input, NDArray* indices, NDArray* gradOut,
                                NDArray* output) {
-  NDArray tempRes = gradOut->dup();
-  segmentMinFunctor(context, input, indices, &tempRes);
-  if (input->isVector() || input->isScalar()) {
-    auto func = PRAGMA_THREADS_FOR {
-      for (auto e = start; e < stop; e++) {
-        auto classNum = indices->e<sd::LongType>(e);
-        if (sd::math::sd_abs<double,double>(tempRes.e<double>(classNum) - input->e<double>(e)) < 1.e-5)
-          output->p(e, gradOut->e<double>(classNum));
-      }
-    };
-    samediff::Threads::parallel_for(func, 0, input->lengthOf());
-  } else {
-    std::vector<sd::LongType> zeroVec = {0};
-    std::vector<sd::LongType> *restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), 1,zeroVec.data());
-    ResultSet listOfBPTensors = tempRes.allTensorsAlongDimension(*restDims);
-    ResultSet listOfGradOuts = gradOut->allTensorsAlongDimension(*restDims);
-    ResultSet listOfTensors = input->allTensorsAlongDimension(*restDims);
-    ResultSet listOfOutTensors = output->allTensorsAlongDimension(*restDims);
-    delete restDims;
-    double zero = 0.;
-    output->assign(zero);
-    int pos = 0;
-
-    auto func = PRAGMA_THREADS_FOR {
-      for (auto i = start; i < stop; i++) {
-        auto classNum = indices->e<sd::LongType>(i);
-        auto current = listOfTensors.at(i);
-        auto currentOut = listOfOutTensors.at(i);
-        auto currentGradOut = listOfGradOuts.at(classNum);
-
-        for (sd::LongType e = 0; e < current->lengthOf(); e++) {
-          if (sd::math::sd_abs<double,double>(listOfBPTensors.at(classNum)->e<double>(e) - current->e<double>(e)) < 1.e-5)
-            currentOut->p(e, currentGradOut->e<double>(e));
-        }
-      }
-    };
+  BUILD_SINGLE_SELECTOR(output->dataType(), return segmentMinFunctorBP_, (context, input, indices, gradOut, output),
+                        SD_NUMERIC_TYPES);
+}
 
-    samediff::Threads::parallel_tad(func, 0, indices->lengthOf());
-  }
+// segmen mean
+template <typename T>
+static sd::Status segmentMeanFunctorBP_(sd::LaunchContext* context, NDArray* input, NDArray* indices,
+                                        NDArray* gradOut, NDArray* output) {
+  segmentFunctorBP_<T, SegmentMeanOp<T>>(input, indices, gradOut, gradOut->sizeAt(0), true, false,
+                                         static_cast<T>(0), output);
   return sd::Status::OK;
 }
 
-// segmen mean
 sd::Status segmentMeanFunctorBP(sd::LaunchContext* context, NDArray* input, NDArray* indices, NDArray* gradOut,
                                 NDArray* output) {
-  int numClasses = output->sizeAt(0);
-  SD_MAP_IMPL<sd::LongType, sd::LongType> classCount;  //(numClasses);
-
-  for (sd::LongType count = 0; count < numClasses; ++count) {
-    classCount[count] = 0;
-  }
-
-  for (sd::LongType e = 0; e < indices->lengthOf(); ++e) {
-    classCount[indices->e<sd::LongType>(e)]++;
-  }
+  BUILD_SINGLE_SELECTOR(output->dataType(), return segmentMeanFunctorBP_, (context, input, indices, gradOut, output),
+                        SD_NUMERIC_TYPES);
+}
 
-  // if input is a vector: (as if in doc sample)
-  if (input->isVector() || input->isScalar()) {
-    for (sd::LongType e = 0; e < indices->lengthOf(); ++e) {
-      sd::LongType classNum = indices->e<sd::LongType>(e);
-      output->p(e, gradOut->e<double>(classNum) / classCount[classNum]);
-    }
-  } else {
-    std::vector<sd::LongType> zeroVec = {0};
-    std::vector<sd::LongType> *restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), 1,zeroVec.data());
-    ResultSet listOfGradOuts = gradOut->allTensorsAlongDimension(*restDims);
-    ResultSet listOfTensors = input->allTensorsAlongDimension(*restDims);
-    ResultSet listOfOutTensors = output->allTensorsAlongDimension(*restDims);
-    delete restDims;
-    int pos = 0;
-    for (sd::LongType i = 0; i < indices->lengthOf(); i++) {
-      auto classNum = indices->e<sd::LongType>(i);
-      auto current = listOfTensors.at(i);
-      auto currentOut = listOfOutTensors.at(i);
-      auto currentGradOut = listOfGradOuts.at(classNum);
-
-      for (sd::LongType e = 0; e < current->lengthOf(); e++) {
-        currentOut->p(e, currentGradOut->e<double>(e) / classCount.at(classNum));
-      }
-    }
-  }
+template <typename T>
+static sd::Status segmentSumFunctorBP_(sd::LaunchContext* context, NDArray* input, NDArray* indices, NDArray* gradOut,
+                                       NDArray* output) {
+  segmentFunctorBP_<T, SegmentSumOp<T>>(input, indices, gradOut, gradOut->sizeAt(0), true, false, static_cast<T>(0),
+                                        output);
   return sd::Status::OK;
 }
 
 sd::Status segmentSumFunctorBP(sd::LaunchContext* context, NDArray* input, NDArray* indices, NDArray* gradOut,
                                NDArray* output) {
-  //        int numClasses = output->sizeAt(0);
-  // if input is a vector: (as if in doc sample)
-  sd::LongType idx = indices->e<sd::LongType>(0);
-  if (input->isVector() || input->isScalar()) {
-    for (sd::LongType e = 0; e < indices->lengthOf(); ++e) {
-      sd::LongType classNum = indices->e<sd::LongType>(e);
-      output->p(e, gradOut->e<double>(classNum));
-    }
-  } else {
-    std::vector<sd::LongType> zeroVec = {0};
-    std::vector<sd::LongType> *restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), 1,zeroVec.data());
-    ResultSet listOfGradOuts = gradOut->allTensorsAlongDimension(*restDims);
-    ResultSet listOfTensors = input->allTensorsAlongDimension(*restDims);
-    ResultSet listOfOutTensors = output->allTensorsAlongDimension(*restDims);
-    delete restDims;
-    for (sd::LongType i = 0; i < indices->lengthOf(); i++) {
-      auto classNum = indices->e<sd::LongType>(i);
-      auto current = listOfTensors.at(i);
-      auto currentOut = listOfOutTensors.at(i);
-      auto currentGradOut = listOfGradOuts.at(classNum);
-
-      currentOut->assign(currentGradOut);
-    }
-  }
+  BUILD_SINGLE_SELECTOR(output->dataType(), return segmentSumFunctorBP_, (context, input, indices, gradOut, output),
+                        SD_NUMERIC_TYPES);
+}
+
+template <typename T>
+static sd::Status segmentProdFunctorBP_(sd::LaunchContext* context, NDArray* input, NDArray* indices,
+                                        NDArray* gradOut, NDArray* output) {
+  segmentFunctorBP_<T, SegmentProdOp<T>>(input, indices, gradOut, gradOut->sizeAt(0), true, true, static_cast<T>(1),
+                                         output);
   return sd::Status::OK;
 }
 
 sd::Status segmentProdFunctorBP(sd::LaunchContext* context, NDArray* input, NDArray* indices, NDArray* gradOut,
                                 NDArray* output) {
-  auto tempRes = gradOut->dup();
-  segmentProdFunctor(context, input, indices, &tempRes);
-  if (input->isVector() || input->isScalar()) {
-    for (sd::LongType e = 0; e < indices->lengthOf(); ++e) {
-      sd::LongType classNum = indices->e<sd::LongType>(e);
-      output->p(e, gradOut->e<double>(classNum) * tempRes.e<double>(classNum) / input->e<double>(e));
-    }
-  } else {
-    std::vector<sd::LongType> zeroVec = {0};
-    std::vector<sd::LongType> *restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), 1,zeroVec.data());
-    ResultSet listOfBPTensors = tempRes.allTensorsAlongDimension(*restDims);
-    ResultSet listOfGradOuts = gradOut->allTensorsAlongDimension(*restDims);
-    ResultSet listOfTensors = input->allTensorsAlongDimension(*restDims);
-    ResultSet listOfOutTensors = output->allTensorsAlongDimension(*restDims);
-
-
-    for (sd::LongType i = 0; i < indices->lengthOf(); i++) {
-      auto classNum = indices->e<sd::LongType>(i);
-      auto current = listOfTensors.at(i);
-      auto currentOut = listOfOutTensors.at(i);
-      auto currentGradOut = listOfGradOuts.at(classNum);
-      auto currentFFOut = listOfBPTensors.at(classNum);
-      auto assign = (*currentFFOut) * (*currentGradOut) / (*current);
-      currentOut->assign(&assign);
-    }
-
-  }
-
-  return sd::Status::OK;
+  BUILD_SINGLE_SELECTOR(output->dataType(), return segmentProdFunctorBP_, (context, input, indices, gradOut, output),
+                        SD_NUMERIC_TYPES);
 }
 
 // -------------------------------------------------------------------------------------------------------------- //
@@ -809,38 +593,8 @@ sd::Status segmentProdFunctorBP(sd::LaunchContext* context, NDArray* input, NDAr
 template <typename T>
 static sd::Status unsortedSegmentMaxFunctorBP_(sd::LaunchContext* context, NDArray* input, NDArray* indices,
                                                NDArray* gradOut, sd::LongType numOfClasses, NDArray* output) {
-  //        int numOfClasses = gradOut->sizeAt(0);
-  // if input is a vector: (as if in doc sample)
-  auto tempRes = gradOut->dup();
-  unsortedSegmentMaxFunctor(context, input, indices, numOfClasses, &tempRes);
-  if (input->isVector() || input->isScalar()) {
-    for (sd::LongType e = 0; e < input->lengthOf(); ++e) {
-      sd::LongType classNum = indices->e<sd::LongType>(e);
-      if (sd::math::sd_abs<double,double>(tempRes.e<double>(classNum) - input->e<double>(e)) < 1.e-5)
-        output->p(e, gradOut->e<T>(classNum));
-    }
-  } else {
-    std::vector<sd::LongType> zeroVec = {0};
-    std::vector<sd::LongType> *restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), 1,zeroVec.data());
-    ResultSet listOfBPTensors = tempRes.allTensorsAlongDimension(*restDims);
-    ResultSet listOfGradOuts = gradOut->allTensorsAlongDimension(*restDims);
-    ResultSet listOfTensors = input->allTensorsAlongDimension(*restDims);
-    ResultSet listOfOutTensors = output->allTensorsAlongDimension(*restDims);
-
-    for (sd::LongType i = 0; i < indices->lengthOf(); i++) {
-      sd::LongType classNum = indices->e<sd::LongType>(i);
-      NDArray* current = listOfTensors.at(i);
-      NDArray* currentOut = listOfOutTensors.at(i);
-      NDArray* currentGradOut = listOfGradOuts.at(classNum);
-      for (int e = 0; e < current->lengthOf(); e++) {
-        if (sd::math::sd_abs<double,double>(listOfBPTensors.at(classNum)->e<double>(e) - current->e<double>(e)) < 1.e-5)
-          currentOut->p(e, currentGradOut->e<T>(e));
-      }
-    }
-
-    delete restDims;
-  }
-
+  segmentFunctorBP_<T, SegmentMaxOp<T>>(input, indices, gradOut, numOfClasses, false, true, -DataTypeUtils::max<T>(),
+                                        output);
   return sd::Status::OK;
 }
 
@@ -857,40 +611,8 @@ BUILD_SINGLE_TEMPLATE(template sd::Status unsortedSegmentMaxFunctorBP_,
 template <typename T>
 static sd::Status unsortedSegmentMinFunctorBP_(sd::LaunchContext* context, NDArray* input, NDArray* indices,
                                                NDArray* gradOut, sd::LongType numOfClasses, NDArray* output) {
-  auto tempRes = gradOut->dup();
-  unsortedSegmentMinFunctor(context, input, indices, numOfClasses, &tempRes);
-  if (input->isVector() || input->isScalar()) {
-    auto func = PRAGMA_THREADS_FOR {
-      for (auto e = start; e < stop; e++) {
-        auto classNum = indices->e<sd::LongType>(e);
-        if (sd::math::sd_abs<T,T>(tempRes.t<T>(classNum) - input->t<T>(e)) < 1.e-6)
-          output->r<T>(e) = gradOut->t<T>(classNum);
-      }
-    };
-
-    samediff::Threads::parallel_for(func, 0, input->lengthOf());
-  } else {
-    std::vector<sd::LongType> zeroVec = {0};
-    std::vector<sd::LongType> *restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), 1,zeroVec.data());
-    ResultSet listOfBPTensors = tempRes.allTensorsAlongDimension(*restDims);
-    ResultSet listOfGradOuts = gradOut->allTensorsAlongDimension(*restDims);
-    ResultSet listOfTensors = input->allTensorsAlongDimension(*restDims);
-    ResultSet listOfOutTensors = output->allTensorsAlongDimension(*restDims);
-    delete restDims;
-    for (sd::LongType i = 0; i < indices->lengthOf(); i++) {
-      auto classNum = indices->e<sd::LongType>(i);
-      auto current = listOfTensors.at(i);
-      auto currentOut = listOfOutTensors.at(i);
-      auto currentGradOut = listOfGradOuts.at(classNum);
-
-      for (sd::LongType e = 0; e < current->lengthOf(); e++) {
-        if (sd::math::sd_abs<T,T>(listOfBPTensors.at(classNum)->t<T>(e) - current->t<T>(e)) < 1.e-6)
-          currentOut->r<T>(e) = currentGradOut->t<T>(e);
-      }
-    }
-
-  }
-
+  segmentFunctorBP_<T, SegmentMinOp<T>>(input, indices, gradOut, numOfClasses, false, true, DataTypeUtils::max<T>(),
+                                        output);
   return sd::Status::OK;
 }
 
@@ -904,156 +626,63 @@ BUILD_SINGLE_TEMPLATE(template sd::Status unsortedSegmentMinFunctorBP_,
                           sd::LongType numOfClasses, NDArray* output),
                       SD_NUMERIC_TYPES);
 
+template <typename T>
+static sd::Status unsortedSegmentMeanFunctorBP_(sd::LaunchContext* context, NDArray* input, NDArray* indices,
+                                                NDArray* gradOut, sd::LongType numOfClasses, NDArray* output) {
+  segmentFunctorBP_<T, SegmentMeanOp<T>>(input, indices, gradOut, numOfClasses, false, false, static_cast<T>(0),
+                                         output);
+  return sd::Status::OK;
+}
+
 sd::Status unsortedSegmentMeanFunctorBP(sd::LaunchContext* context, NDArray* input, NDArray* indices, NDArray* gradOut,
                                         sd::LongType numOfClasses, NDArray* output) {
-  SD_MAP_IMPL<sd::LongType, sd::LongType> classCount;  //(numClasses);
-
-  for (sd::LongType count = 0; count < numOfClasses; ++count) {
-    classCount[count] = 0;
-  }
-
-  for (sd::LongType e = 0; e < indices->lengthOf(); ++e) {
-    classCount[indices->e<sd::LongType>(e)]++;
-  }
-
-  // if input is a vector: (as if in doc sample)
-  if (input->isVector() || input->isScalar()) {
-    for (sd::LongType e = 0; e < indices->lengthOf(); ++e) {
-      sd::LongType classNum = indices->e<sd::LongType>(e);
-      output->p(e, gradOut->e<double>(classNum) / classCount[classNum]);
-    }
-  } else {
-    std::vector<sd::LongType> zeroVec = {0};
-    std::vector<sd::LongType> *restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), 1,zeroVec.data());
-    ResultSet listOfGradOuts = gradOut->allTensorsAlongDimension(*restDims);
-    ResultSet listOfTensors = input->allTensorsAlongDimension(*restDims);
-    ResultSet listOfOutTensors = output->allTensorsAlongDimension(*restDims);
-
-    for (sd::LongType i = 0; i < indices->lengthOf(); i++) {
-      sd::LongType classNum = indices->e<sd::LongType>(i);
-      NDArray* current = listOfTensors.at(i);
-      NDArray* currentOut = listOfOutTensors.at(i);
-      NDArray* currentGradOut = listOfGradOuts.at(classNum);
-      auto assign = *currentGradOut / double(classCount[classNum]);
-      currentOut->assign(&assign);
-    }
+  BUILD_SINGLE_SELECTOR(output->dataType(), return unsortedSegmentMeanFunctorBP_,
+                        (context, input, indices, gradOut, numOfClasses, output), SD_NUMERIC_TYPES);
+}
 
-    delete restDims;
-  }
+template <typename T>
+static sd::Status unsortedSegmentSumFunctorBP_(sd::LaunchContext* context, NDArray* input, NDArray* indices,
+                                               NDArray* gradOut, sd::LongType numOfClasses, NDArray* output) {
+  segmentFunctorBP_<T, SegmentSumOp<T>>(input, indices, gradOut, numOfClasses, false, false, static_cast<T>(0),
+                                        output);
   return sd::Status::OK;
 }
 
 sd::Status unsortedSegmentSumFunctorBP(sd::LaunchContext* context, NDArray* input, NDArray* indices, NDArray* gradOut,
                                        sd::LongType numOfClasses, NDArray* output) {
-  // if input is a vector: (as if in doc sample)
-  sd::LongType idx = indices->e<sd::LongType>(0);
-  if (input->isVector() || input->isScalar()) {
-    for (sd::LongType e = 0; e < indices->lengthOf(); ++e) {
-      sd::LongType classNum = indices->e<sd::LongType>(e);
-      output->p(e, gradOut->e<double>(classNum));
-    }
-  } else {
-    std::vector<sd::LongType> zeroVec = {0};
-    std::vector<sd::LongType> *restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), 1,zeroVec.data());
-    ResultSet listOfGradOuts = gradOut->allTensorsAlongDimension(*restDims);
-    ResultSet listOfTensors = input->allTensorsAlongDimension(*restDims);
-    ResultSet listOfOutTensors = output->allTensorsAlongDimension(*restDims);
-
-    for (sd::LongType i = 0; i < indices->lengthOf(); i++) {
-      auto classNum = indices->e<sd::LongType>(i);
-      auto currentOut = listOfOutTensors.at(i);
-      auto currentGradOut = listOfGradOuts.at(classNum);
-
-      currentOut->assign(currentGradOut);
-    }
-
-    delete restDims;
+  BUILD_SINGLE_SELECTOR(output->dataType(), return unsortedSegmentSumFunctorBP_,
+                        (context, input, indices, gradOut, numOfClasses, output), SD_NUMERIC_TYPES);
+}
 
-  }
+template <typename T>
+static sd::Status unsortedSegmentProdFunctorBP_(sd::LaunchContext* context, NDArray* input, NDArray* indices,
+                                                NDArray* gradOut, sd::LongType numOfClasses, NDArray* output) {
+  segmentFunctorBP_<T, SegmentProdOp<T>>(input, indices, gradOut, numOfClasses, false, true, static_cast<T>(1),
+                                         output);
   return sd::Status::OK;
 }
 
 sd::Status unsortedSegmentProdFunctorBP(sd::LaunchContext* context, NDArray* input, NDArray* indices, NDArray* gradOut,
                                         sd::LongType numOfClasses, NDArray* output) {
-  auto tempRes = gradOut->dup();
-  unsortedSegmentProdFunctor(context, input, indices, numOfClasses, &tempRes);
-  if (input->isVector() || input->isScalar()) {
-    auto func = PRAGMA_THREADS_FOR {
-      for (auto e = start; e < stop; e++) {
-        auto classNum = indices->e<sd::LongType>(e);
-        output->p<double>(e, gradOut->e<double>(classNum) * tempRes.e<double>(classNum) / input->e<double>(e));
-      }
-    };
-
-    samediff::Threads::parallel_for(func, 0, indices->lengthOf());
-  } else {
-    std::vector<sd::LongType> zeroVec = {0};
-    std::vector<sd::LongType> *restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), 1,zeroVec.data());
-    ResultSet listOfBPTensors = tempRes.allTensorsAlongDimension(*restDims);
-    ResultSet listOfGradOuts = gradOut->allTensorsAlongDimension(*restDims);
-    ResultSet listOfTensors = input->allTensorsAlongDimension(*restDims);
-    ResultSet listOfOutTensors = output->allTensorsAlongDimension(*restDims);
-    delete restDims;
-    for (sd::LongType i = 0; i < indices->lengthOf(); i++) {
-      auto classNum = indices->e<sd::LongType>(i);
-      auto current = listOfTensors.at(i);
-      auto currentOut = listOfOutTensors.at(i);
-      auto currentGradOut = listOfGradOuts.at(classNum);
-      auto currentFFOut = listOfBPTensors.at(classNum);
-     auto assign = (*currentFFOut) * (*currentGradOut) / (*current);
-      currentOut->assign(&assign);
-    }
-
-  }
+  BUILD_SINGLE_SELECTOR(output->dataType(), return unsortedSegmentProdFunctorBP_,
+                        (context, input, indices, gradOut, numOfClasses, output), SD_NUMERIC_TYPES);
+}
 
+template <typename T>
+static sd::Status unsortedSegmentSqrtNFunctorBP_(sd::LaunchContext* context, NDArray* input, NDArray* indices,
+                                                 NDArray* gradOut, sd::LongType numOfClasses, NDArray* output) {
+  segmentFunctorBP_<T, SegmentSqrtNOp<T>>(input, indices, gradOut, numOfClasses, false, false, static_cast<T>(0),
+                                          output);
   return sd::Status::OK;
 }
 
-//    template <typename T>
 sd::Status unsortedSegmentSqrtNFunctorBP(sd::LaunchContext* context, NDArray* input, NDArray* indices, NDArray* gradOut,
                                          sd::LongType numOfClasses, NDArray* output) {
-  SD_MAP_IMPL<sd::LongType, sd::LongType> classCount;  //(numClasses);
-
-  for (sd::LongType count = 0; count < numOfClasses; ++count) {
-    classCount[count] = 0;
-  }
-
-  for (sd::LongType e = 0; e < indices->lengthOf(); ++e) {
-    classCount[indices->e<sd::LongType>(e)]++;
-  }
-
-  // if input is a vector: (as if in doc sample)
-  if (input->isVector() || input->isScalar()) {
-    // auto func = PRAGMA_THREADS_FOR {
-    for (sd::LongType e = 0; e < indices->lengthOf(); e++) {
-      auto classNum = indices->e<sd::LongType>(e);
-      output->p(e, gradOut->e<double>(classNum) / sd::math::sd_sqrt<double, double>(classCount[classNum]));
-    }
-
-  } else {
-    std::vector<sd::LongType> zeroVec = {0};
-    std::vector<sd::LongType> *restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), 1,zeroVec.data());
-    ResultSet listOfGradOuts = gradOut->allTensorsAlongDimension(*restDims);
-    ResultSet listOfTensors = input->allTensorsAlongDimension(*restDims);
-    ResultSet listOfOutTensors = output->allTensorsAlongDimension(*restDims);
-    delete restDims;
-    for (sd::LongType i = 0; i < indices->lengthOf(); i++) {
-      auto classNum = indices->e<sd::LongType>(i);
-      auto current = listOfTensors.at(i);
-      auto currentOut = listOfOutTensors.at(i);
-      auto currentGradOut = listOfGradOuts.at(classNum);
-
-      for (int e = 0; e < current->lengthOf(); e++) {
-        currentOut->p<double>(e,
-                              currentGradOut->e<double>(e) / sd::math::sd_sqrt<double, double>(classCount[classNum]));
-      }
-    }
-
-  }
-  return sd::Status::OK;
+  BUILD_SINGLE_SELECTOR(output->dataType(), return unsortedSegmentSqrtNFunctorBP_,
+                        (context, input, indices, gradOut, numOfClasses, output), SD_NUMERIC_TYPES);
 }
 
 }  // namespace helpers
 }  // namespace ops
 }  // namespace sd
-#endif
\ No newline at end of file
+#endif
@@ -705,7 +705,7 @@ static void reductionCase1Scalar(const int& second_rank, const sd::LongType* inn
                 int Count = 0;
                 func(0, 0, inner_total, 1);
 #else
-  int Count = samediff::Threads::parallel_tad(func, 0, inner_total, 1, maxThreads);
+  int Count = samediff::Threads::parallel_blocks(func, 0, inner_total, maxThreads);
 #endif
   auto current = ptrAggs[0];
   for (int i = 1; i < Count; i++) {
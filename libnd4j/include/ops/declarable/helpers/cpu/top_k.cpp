@@ -21,6 +21,8 @@
 //
 #include <array/NDArrayFactory.h>
 #include <execution/Threads.h>
+#include <helpers/ConstantTadHelper.h>
+#include <helpers/SelectionEngine.h>
 #include <ops/declarable/headers/parity_ops.h>
 #include <ops/declarable/helpers/top_k.h>
 
@@ -33,117 +35,82 @@ namespace helpers {
 template <typename T>
 static sd::Status topKFunctor_(NDArray* input, NDArray* values, NDArray* indices, const sd::LongType k,
                                bool needSort) {
-  sd::LongType width = input->sizeAt(-1);
-  sd::LongType lastDim = input->rankOf() - 1;
-  std::vector<sd::LongType> dimsToExclude(input->rankOf() - 1);
-  for (size_t d = 0; d < dimsToExclude.size(); ++d) dimsToExclude[d] = d;
-
-  const sd::LongType numOfSubArrs = ShapeUtils::getNumOfSubArrs(input->shapeInfo(), dimsToExclude);
-
-  if (k == 1) {
-    for (sd::LongType e = 0; e < numOfSubArrs; ++e) {
-      auto trial = (*input)(e, dimsToExclude);
-      sd::LongType maxPos = 0;
-      T maxVal = trial.e<T>(0);
-      for (sd::LongType pos = 1; pos < trial.lengthOf(); pos++)
-        if (maxVal < trial.e<T>(pos)) {
-          maxPos = pos;
-          maxVal = trial.e<T>(pos);
-        }
-      if (indices) indices->p(e, maxPos);  // topIndex;
-      if (values) values->p(e, maxVal);
-    }
-  } else {
-    int nextPos = 0;
-
-    for (sd::LongType e = 0; e < numOfSubArrs; ++e) {
-      auto trial = (*input)(e, dimsToExclude);
-
-      // fill up the first k elements
-      NDArray topValues = NDArrayFactory::create<T>('c', {k}, input->getContext());
-      NDArray sortedVals = NDArrayFactory::create<T>('c', {k}, input->getContext());
-      NDArray topIndices = NDArrayFactory::create<sd::LongType>('c', {k}, input->getContext());
-      for (sd::LongType pos = 0; pos < k; ++pos) {
-        topIndices.r<sd::LongType>(pos) = pos;
-        topValues.r<T>(pos) = trial.t<T>(pos);
-      }
-      sortedVals.assign(&topValues);
-      SpecialMethods<T>::sortGeneric(&sortedVals, false);
-      for (sd::LongType i = static_cast<sd::LongType>(k); i < width; ++i) {
-        T val = trial.e<T>(i);
-        T minTopVal = sortedVals.t<T>(0);
-        if (minTopVal < val) {  // value should be inserted to top k
-          // only if it is not contained in
-          T* begin = reinterpret_cast<T*>(sortedVals.buffer());
-          T* end = begin + k;
-          bool exists = std::binary_search(begin, end, val);
-          if (!exists) {
-            // exchangePos - a distance between begin and minimal existed to be suppressed by val
-            T* topBegin = reinterpret_cast<T*>(topValues.buffer());
-            T* topEnd = topBegin + k;
-            auto exchangePos = std::distance(topBegin, std::find(topBegin, topEnd, sortedVals.t<T>(0)));
-            topValues.r<T>(exchangePos) = val;  //*exchangeIt = val;
-            topIndices.r<sd::LongType>(exchangePos) = i;
-            sortedVals.r<T>(0) = val;  // suppress in sorted
-            SpecialMethods<T>::sortGeneric(&sortedVals, false);
-
-          }
-        }
+  if (input->lengthOf() == 0) return sd::Status::OK;
+
+  const sd::LongType lastDim = input->rankOf() - 1;
+  const sd::LongType width = input->sizeAt(-1);
+  const sd::LongType xStride = input->stridesOf()[lastDim];
+
+  // results are produced as T and INT64, outputs of other types get them through assign
+  std::unique_ptr<NDArray> valuesCopy, indicesCopy;
+  NDArray* z = values;
+  if (values != nullptr && values->dataType() != input->dataType()) {
+    std::vector<sd::LongType> shape = values->getShapeAsVector();
+    valuesCopy.reset(new NDArray(values->ordering(), shape, input->dataType(), values->getContext()));
+    z = valuesCopy.get();
+  }
+  NDArray* idx = indices;
+  if (indices != nullptr && indices->dataType() != sd::DataType::INT64) {
+    std::vector<sd::LongType> shape = indices->getShapeAsVector();
+    indicesCopy.reset(new NDArray(indices->ordering(), shape, sd::DataType::INT64, indices->getContext()));
+    idx = indicesCopy.get();
+  }
+
+  auto packX = sd::ConstantTadHelper::getInstance().tadForDimensions(input->shapeInfo(), lastDim);
+  auto packZ = z != nullptr ? sd::ConstantTadHelper::getInstance().tadForDimensions(z->shapeInfo(), lastDim) : nullptr;
+  auto packI =
+      idx != nullptr ? sd::ConstantTadHelper::getInstance().tadForDimensions(idx->shapeInfo(), lastDim) : nullptr;
+
+  const sd::LongType numOfRows = packX->numberOfTads();
+  const sd::LongType zStride = z != nullptr ? z->stridesOf()[lastDim] : 0;
+  const sd::LongType iStride = idx != nullptr ? idx->stridesOf()[lastDim] : 0;
+  const T* x = input->bufferAsT<T>();
+
+  auto func = PRAGMA_THREADS_FOR {
+    std::vector<selection::Entry<T>> top(k), scratch;
+
+    for (auto r = start; r < stop; r++) {
+      selection::topK<T>(x + packX->platformOffsets()[r], width, xStride, k, needSort, top.data(), scratch);
+
+      if (z != nullptr) {
+        T* zRow = z->bufferAsT<T>() + packZ->platformOffsets()[r];
+        for (sd::LongType j = 0; j < k; j++) zRow[j * zStride] = top[j].value;
       }
-      if (needSort) {
-        SpecialMethods<T>::sortGeneric(&topValues,true);
-
-        for (sd::LongType j = 0; j < width; j++)
-          for (sd::LongType pos = 0; pos < k; ++pos)
-            if (topValues.t<T>(pos) == trial.t<T>(j)) topIndices.r<sd::LongType>(pos) = j;
-      } else {  // else sort by indices
-        std::map<sd::LongType, T> sortValsMap;
-        for (sd::LongType e = 0; e < topValues.lengthOf(); ++e) {
-          sortValsMap[topIndices.t<sd::LongType>(e)] = topValues.t<T>(e);
-        }
-
-        sd::LongType e = 0;
-        for (auto it = sortValsMap.begin(); it != sortValsMap.end(); ++it, e++) {
-          topIndices.r<sd::LongType>(e) = it->first;
-          topValues.r<T>(e) = it->second;
-        }
+      if (idx != nullptr) {
+        sd::LongType* iRow = idx->bufferAsT<sd::LongType>() + packI->platformOffsets()[r];
+        for (sd::LongType j = 0; j < k; j++) iRow[j * iStride] = top[j].index;
       }
-      if (values) (*values)(e, dimsToExclude).assign(&topValues);
-      if (indices) (*indices)(e, dimsToExclude).assign(&topIndices);
     }
-  }
+  };
+
+  samediff::Threads::parallel_tad(func, 0, numOfRows);
+
+  if (valuesCopy) values->assign(valuesCopy.get());
+  if (indicesCopy) indices->assign(indicesCopy.get());
+
   return sd::Status::OK;
 }
 // ----------------------------------------------------------------------------------------------- //
 
 template <typename T>
-static sd::Status inTopKFunctor_(sd::LaunchContext* context, NDArray* input, NDArray* target,
-                                 NDArray* result, const sd::LongType k) {
-  std::vector<sd::LongType> shapeI(input->rankOf());
-  for (int i = 0; i < input->rankOf() - 1; i++) shapeI[i] = input->sizeAt(i);
-  shapeI[input->rankOf() - 1] = k;
-  std::unique_ptr<NDArray> indices(NDArrayFactory::create_<sd::LongType>(input->ordering(), shapeI, context));
-  NDArray* values = nullptr;
-  sd::Status status = topKFunctor(context, input, values, indices.get(), k, true);
-  int assign = 0;
-  result->assign(assign);
-  if (status == sd::Status::OK) {
-    auto func = PRAGMA_THREADS_FOR {
-      for (auto e = start; e < stop; e++) {
-        bool found = false;
-        for (sd::LongType j = 0; j < k; j++) {
-          if (target->e<sd::LongType>(e) == indices->e<sd::LongType>(e * k + j)) {
-            found = true;
-            break;
-          }
-        }
-        if (found) result->p<bool>(e, true);
-      }
-    };
+static sd::Status inTopKFunctor_(sd::LaunchContext* context, NDArray* input, NDArray* target, NDArray* result,
+                                 const sd::LongType k) {
+  const sd::LongType lastDim = input->rankOf() - 1;
+  const sd::LongType width = input->sizeAt(-1);
+  const sd::LongType xStride = input->stridesOf()[lastDim];
 
-    samediff::Threads::parallel_tad(func, 0, target->lengthOf());
-  }
-  return status;
+  auto packX = sd::ConstantTadHelper::getInstance().tadForDimensions(input->shapeInfo(), lastDim);
+  const T* x = input->bufferAsT<T>();
+
+  auto func = PRAGMA_THREADS_FOR {
+    for (auto r = start; r < stop; r++)
+      result->p<bool>(r, selection::inTopK<T>(x + packX->platformOffsets()[r], width, xStride,
+                                              target->e<sd::LongType>(r), k));
+  };
+
+  samediff::Threads::parallel_tad(func, 0, target->lengthOf());
+
+  return sd::Status::OK;
 }
 
 sd::Status topKFunctor(sd::LaunchContext* context, NDArray* input, NDArray* values, NDArray* indices,
@@ -521,7 +521,8 @@ static LongType nonMaxSuppressionGeneric_(LaunchContext* context, NDArray* boxes
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 void nonMaxSuppression(LaunchContext* context, NDArray* boxes, NDArray* scales, int maxSize, double threshold,
-                       double scoreThreshold, NDArray* output) {
+                       double scoreThreshold, NDArray* output, double softNmsSigma) {
+  if (softNmsSigma > 0.) THROW_EXCEPTION("non_max_suppression cuda: soft NMS mode is not implemented yet !");
   BUILD_DOUBLE_SELECTOR(boxes->dataType(), output->dataType(), nonMaxSuppressionV2_,
                         (context, boxes, scales, maxSize, threshold, scoreThreshold, output), SD_FLOAT_TYPES,
                         SD_INDEXING_TYPES);
@@ -529,7 +530,9 @@ void nonMaxSuppression(LaunchContext* context, NDArray* boxes, NDArray* scales,
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 LongType nonMaxSuppressionGeneric(LaunchContext* context, NDArray* boxes, NDArray* scales, int maxSize,
-                                  double threshold, double scoreThreshold, NDArray* output) {
+                                  double threshold, double scoreThreshold, NDArray* output, double softNmsSigma) {
+  if (softNmsSigma > 0.)
+    THROW_EXCEPTION("non_max_suppression_overlaps cuda: soft NMS mode is not implemented yet !");
   BUILD_DOUBLE_SELECTOR(boxes->dataType(), output ? output->dataType() : DataType::INT32,
                         return nonMaxSuppressionGeneric_,
                         (context, boxes, scales, maxSize, threshold, scoreThreshold, output, similiratyOverlaps),
@@ -538,7 +541,9 @@ LongType nonMaxSuppressionGeneric(LaunchContext* context, NDArray* boxes, NDArra
 }
 
 LongType nonMaxSuppressionV3(LaunchContext* context, NDArray* boxes, NDArray* scores, int maxSize,
-                                 double overlapThreshold, double scoreThreshold, NDArray* output) {
+                                 double overlapThreshold, double scoreThreshold, NDArray* output,
+                                 double softNmsSigma) {
+  if (softNmsSigma > 0.) THROW_EXCEPTION("non_max_suppression_v3 cuda: soft NMS mode is not implemented yet !");
   BUILD_DOUBLE_SELECTOR(boxes->dataType(), output ? output->dataType() : DataType::INT32,
                         return nonMaxSuppressionGeneric_,
                         (context, boxes, scores, maxSize, overlapThreshold, scoreThreshold, output, similarityV3),
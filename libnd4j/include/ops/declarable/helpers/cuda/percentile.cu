@@ -138,6 +138,22 @@ void percentile(LaunchContext* context, NDArray& input, NDArray& output, std::ve
   NDArray::registerSpecialUse({&output}, {&input});
 }
 
+void percentile(LaunchContext* context, NDArray& input, NDArray& output, std::vector<LongType>& axises,
+                const std::vector<float>& q, const int interpolation) {
+  if (q.empty()) return;
+
+  // every percentile is computed separately here, leading dimension of output enumerates them
+  const LongType numOfSubArrs = output.lengthOf() / static_cast<LongType>(q.size());
+  std::vector<LongType> subArrShape = {numOfSubArrs};
+  NDArray perQ('c', subArrShape, output.dataType(), context);
+
+  for (size_t k = 0; k < q.size(); ++k) {
+    std::vector<LongType> dims(axises);
+    percentile(context, input, perQ, dims, q[k], interpolation);
+    for (LongType i = 0; i < numOfSubArrs; ++i) output.p(k * numOfSubArrs + i, perQ.e<double>(i));
+  }
+}
+
 BUILD_SINGLE_TEMPLATE(template void _percentile,
                       (sd::LaunchContext * context, NDArray& input, NDArray& output, std::vector<sd::LongType>& axises,
                        const float q, const int interpolation),
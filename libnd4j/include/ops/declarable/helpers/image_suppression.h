@@ -28,13 +28,16 @@ namespace sd {
 namespace ops {
 namespace helpers {
 
+// softNmsSigma > 0 enables soft-NMS: overlapping boxes decay scores of candidates instead of suppressing them
 SD_LIB_HIDDEN void nonMaxSuppression(LaunchContext* context, NDArray* boxes, NDArray* scales, int maxSize,
-                                     double overlapThreshold, double scoreThreshold, NDArray* output);
+                                     double overlapThreshold, double scoreThreshold, NDArray* output,
+                                     double softNmsSigma = 0.);
 SD_LIB_HIDDEN LongType nonMaxSuppressionV3(LaunchContext* context, NDArray* boxes, NDArray* scales, int maxSize,
-                                               double overlapThreshold, double scoreThreshold, NDArray* output);
+                                               double overlapThreshold, double scoreThreshold, NDArray* output,
+                                               double softNmsSigma = 0.);
 SD_LIB_HIDDEN LongType nonMaxSuppressionGeneric(LaunchContext* context, NDArray* boxes, NDArray* scores,
                                                     int maxSize, double overlapThreshold, double scoreThreshold,
-                                                    NDArray* output);
+                                                    NDArray* output, double softNmsSigma = 0.);
 
 }  // namespace helpers
 }  // namespace ops
@@ -0,0 +1,354 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Fused scaled dot product attention, score matrix is never materialized
+//
+#include <system/op_boilerplate.h>
+#if NOT_EXCLUDED(OP_fused_dot_product_attention)
+
+#include <execution/Threads.h>
+#include <ops/declarable/helpers/attention.h>
+
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <type_traits>
+
+namespace sd {
+namespace ops {
+namespace helpers {
+
+// queries handled together by one job, keys processed per step for each of them
+static constexpr LongType ATTENTION_QUERY_TILE = 32;
+static constexpr LongType ATTENTION_KEY_TILE = 64;
+
+struct AttentionDims {
+  LongType groups;  // product of all leading dimensions, batch or batch * heads
+  LongType tq, tv, d, dv;
+};
+
+// optional [B, T] mask flattened once, groups (e.g. heads) belonging to the same batch row share it
+class AttentionMask {
+ public:
+  AttentionMask(NDArray* mask, const LongType groups, const LongType length) : _length(length) {
+    if (mask == nullptr || mask->isEmpty()) return;
+    const LongType rows = mask->lengthOf() / length;
+    _groupsPerRow = groups / rows;
+    _keep.resize(mask->lengthOf());
+    for (LongType e = 0; e < mask->lengthOf(); e++) _keep[e] = mask->e<double>(e) != 0.;
+  }
+
+  bool keep(const LongType group, const LongType pos) const {
+    return _keep.empty() || _keep[(group / _groupsPerRow) * _length + pos] != 0;
+  }
+
+ private:
+  std::vector<int8_t> _keep;
+  LongType _groupsPerRow = 1;
+  LongType _length;
+};
+
+// raw buffers below assume dense 'c' layout, anything else is copied once (linear in sequence length)
+static NDArray* denseC(NDArray* arr, std::vector<std::unique_ptr<NDArray>>& copies) {
+  if (arr->ordering() == 'c' && shape::isDense(arr->shapeInfo())) return arr;
+  copies.emplace_back(new NDArray(arr->dup('c')));
+  return copies.back().get();
+}
+
+template <typename T>
+using AttentionAcc = typename std::conditional<std::is_same<T, double>::value, double, float>::type;
+
+template <typename A, typename T>
+static SD_INLINE A attentionDot(const T* x, const T* y, const LongType length) {
+  A sum = 0;
+  for (LongType e = 0; e < length; e++) sum += static_cast<A>(x[e]) * static_cast<A>(y[e]);
+  return sum;
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename T>
+static void fusedAttention_(NDArray* queries, NDArray* keys, NDArray* values, const AttentionDims& dims,
+                            const AttentionMask& qKeep, const AttentionMask& vKeep, const double scale,
+                            const bool causal, NDArray* output, NDArray* logSumExp) {
+  using A = AttentionAcc<T>;
+  const T* q = queries->bufferAsT<T>();
+  const T* k = keys->bufferAsT<T>();
+  const T* v = values->bufferAsT<T>();
+  T* out = output->bufferAsT<T>();
+  T* lse = logSumExp->bufferAsT<T>();
+  const A minusInf = -std::numeric_limits<A>::infinity();
+  const A alpha = static_cast<A>(scale);
+  const LongType qTiles = (dims.tq + ATTENTION_QUERY_TILE - 1) / ATTENTION_QUERY_TILE;
+
+  auto func = PRAGMA_THREADS_FOR {
+    // per query: running max, running softmax denominator and unnormalized output row
+    std::vector<A> rowMax(ATTENTION_QUERY_TILE), rowSum(ATTENTION_QUERY_TILE);
+    std::vector<A> acc(ATTENTION_QUERY_TILE * dims.dv);
+    std::vector<A> scores(ATTENTION_KEY_TILE);
+
+    for (auto job = start; job < stop; job++) {
+      const LongType g = job / qTiles;
+      const LongType i0 = (job % qTiles) * ATTENTION_QUERY_TILE;
+      const LongType rows = std::min<LongType>(ATTENTION_QUERY_TILE, dims.tq - i0);
+      const T* kG = k + g * dims.tv * dims.d;
+      const T* vG = v + g * dims.tv * dims.dv;
+
+      std::fill(rowMax.begin(), rowMax.end(), minusInf);
+      std::fill(rowSum.begin(), rowSum.end(), static_cast<A>(0));
+      std::fill(acc.begin(), acc.end(), static_cast<A>(0));
+
+      // with causal masking no query of this tile sees keys past its last row
+      const LongType kEnd = causal ? std::min<LongType>(dims.tv, i0 + rows) : dims.tv;
+
+      for (LongType j0 = 0; j0 < kEnd; j0 += ATTENTION_KEY_TILE) {
+        const LongType cols = std::min<LongType>(ATTENTION_KEY_TILE, kEnd - j0);
+
+        for (LongType r = 0; r < rows; r++) {
+          const LongType i = i0 + r;
+          if (!qKeep.keep(g, i)) continue;
+
+          const T* qRow = q + (g * dims.tq + i) * dims.d;
+          A tileMax = minusInf;
+          for (LongType c = 0; c < cols; c++) {
+            const LongType j = j0 + c;
+            if ((causal && j > i) || !vKeep.keep(g, j)) {
+              scores[c] = minusInf;
+              continue;
+            }
+            scores[c] = alpha * attentionDot<A>(qRow, kG + j * dims.d, dims.d);
+            tileMax = sd::math::sd_max<A>(tileMax, scores[c]);
+          }
+
+          if (tileMax == minusInf) continue;
+
+          // rescale what was accumulated so far to the new max
+          const A newMax = sd::math::sd_max<A>(rowMax[r], tileMax);
+          const A correction = std::exp(rowMax[r] - newMax);
+          A* accRow = acc.data() + r * dims.dv;
+          rowSum[r] *= correction;
+          for (LongType e = 0; e < dims.dv; e++) accRow[e] *= correction;
+
+          for (LongType c = 0; c < cols; c++) {
+            if (scores[c] == minusInf) continue;
+            const A p = std::exp(scores[c] - newMax);
+            const T* vRow = vG + (j0 + c) * dims.dv;
+            rowSum[r] += p;
+            for (LongType e = 0; e < dims.dv; e++) accRow[e] += p * static_cast<A>(vRow[e]);
+          }
+          rowMax[r] = newMax;
+        }
+      }
+
+      for (LongType r = 0; r < rows; r++) {
+        const LongType i = i0 + r;
+        T* outRow = out + (g * dims.tq + i) * dims.dv;
+        const A* accRow = acc.data() + r * dims.dv;
+
+        if (rowSum[r] == static_cast<A>(0)) {
+          for (LongType e = 0; e < dims.dv; e++) outRow[e] = static_cast<T>(0);
+          lse[g * dims.tq + i] = static_cast<T>(minusInf);
+          continue;
+        }
+
+        const A norm = static_cast<A>(1) / rowSum[r];
+        for (LongType e = 0; e < dims.dv; e++) outRow[e] = static_cast<T>(accRow[e] * norm);
+        lse[g * dims.tq + i] = static_cast<T>(rowMax[r] + std::log(rowSum[r]));
+      }
+    }
+  };
+
+  samediff::Threads::parallel_for(func, 0, dims.groups * qTiles);
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename T>
+static void fusedAttentionBp_(NDArray* queries, NDArray* keys, NDArray* values, NDArray* output, NDArray* logSumExp,
+                              NDArray* gradO, const AttentionDims& dims, const AttentionMask& qKeep,
+                              const AttentionMask& vKeep, const double scale, const bool causal, NDArray* dLdq,
+                              NDArray* dLdk, NDArray* dLdv) {
+  using A = AttentionAcc<T>;
+  const T* q = queries->bufferAsT<T>();
+  const T* k = keys->bufferAsT<T>();
+  const T* v = values->bufferAsT<T>();
+  const T* out = output->bufferAsT<T>();
+  const T* lse = logSumExp->bufferAsT<T>();
+  const T* eps = gradO->bufferAsT<T>();
+  T* dq = dLdq->bufferAsT<T>();
+  T* dk = dLdk->bufferAsT<T>();
+  T* dv = dLdv->bufferAsT<T>();
+  const A alpha = static_cast<A>(scale);
+
+  // p_ij = exp(scale * q_i k_j - lse_i), dS_ij = p_ij * (eps_i v_j - eps_i out_i)
+  std::vector<A> rowDot(dims.groups * dims.tq);
+  auto funcRowDot = PRAGMA_THREADS_FOR {
+    for (auto e = start; e < stop; e++)
+      rowDot[e] = attentionDot<A>(eps + e * dims.dv, out + e * dims.dv, dims.dv);
+  };
+  samediff::Threads::parallel_for(funcRowDot, 0, dims.groups * dims.tq);
+
+  const auto visibleQuery = [&](const LongType g, const LongType i) -> bool {
+    return qKeep.keep(g, i) && !std::isinf(static_cast<A>(lse[g * dims.tq + i]));
+  };
+
+  // dK and dV, every job owns a tile of keys so nothing is shared between threads
+  const LongType kTiles = (dims.tv + ATTENTION_KEY_TILE - 1) / ATTENTION_KEY_TILE;
+  auto funcKeys = PRAGMA_THREADS_FOR {
+    std::vector<A> dkAcc(ATTENTION_KEY_TILE * dims.d), dvAcc(ATTENTION_KEY_TILE * dims.dv);
+
+    for (auto job = start; job < stop; job++) {
+      const LongType g = job / kTiles;
+      const LongType j0 = (job % kTiles) * ATTENTION_KEY_TILE;
+      const LongType cols = std::min<LongType>(ATTENTION_KEY_TILE, dims.tv - j0);
+      std::fill(dkAcc.begin(), dkAcc.end(), static_cast<A>(0));
+      std::fill(dvAcc.begin(), dvAcc.end(), static_cast<A>(0));
+
+      for (LongType i = causal ? j0 : 0; i < dims.tq; i++) {
+        if (!visibleQuery(g, i)) continue;
+
+        const T* qRow = q + (g * dims.tq + i) * dims.d;
+        const T* epsRow = eps + (g * dims.tq + i) * dims.dv;
+        const A rowLse = static_cast<A>(lse[g * dims.tq + i]);
+
+        for (LongType c = 0; c < cols; c++) {
+          const LongType j = j0 + c;
+          if ((causal && j > i) || !vKeep.keep(g, j)) continue;
+
+          const A p = std::exp(alpha * attentionDot<A>(qRow, k + (g * dims.tv + j) * dims.d, dims.d) - rowLse);
+          const A ds = p * (attentionDot<A>(epsRow, v + (g * dims.tv + j) * dims.dv, dims.dv) - rowDot[g * dims.tq + i]);
+
+          A* dvRow = dvAcc.data() + c * dims.dv;
+          for (LongType e = 0; e < dims.dv; e++) dvRow[e] += p * static_cast<A>(epsRow[e]);
+          A* dkRow = dkAcc.data() + c * dims.d;
+          for (LongType e = 0; e < dims.d; e++) dkRow[e] += alpha * ds * static_cast<A>(qRow[e]);
+        }
+      }
+
+      for (LongType c = 0; c < cols; c++) {
+        T* dkRow = dk + (g * dims.tv + j0 + c) * dims.d;
+        T* dvRow = dv + (g * dims.tv + j0 + c) * dims.dv;
+        for (LongType e = 0; e < dims.d; e++) dkRow[e] = static_cast<T>(dkAcc[c * dims.d + e]);
+        for (LongType e = 0; e < dims.dv; e++) dvRow[e] = static_cast<T>(dvAcc[c * dims.dv + e]);
+      }
+    }
+  };
+  samediff::Threads::parallel_for(funcKeys, 0, dims.groups * kTiles);
+
+  // dQ, probabilities are recomputed instead of being shared with the pass above
+  auto funcQueries = PRAGMA_THREADS_FOR {
+    std::vector<A> dqAcc(dims.d);
+
+    for (auto row = start; row < stop; row++) {
+      const LongType g = row / dims.tq;
+      const LongType i = row % dims.tq;
+      std::fill(dqAcc.begin(), dqAcc.end(), static_cast<A>(0));
+
+      if (visibleQuery(g, i)) {
+        const T* qRow = q + row * dims.d;
+        const T* epsRow = eps + row * dims.dv;
+        const A rowLse = static_cast<A>(lse[row]);
+        const LongType kEnd = causal ? std::min<LongType>(dims.tv, i + 1) : dims.tv;
+
+        for (LongType j = 0; j < kEnd; j++) {
+          if (!vKeep.keep(g, j)) continue;
+
+          const T* kRow = k + (g * dims.tv + j) * dims.d;
+          const A p = std::exp(alpha * attentionDot<A>(qRow, kRow, dims.d) - rowLse);
+          const A ds = p * (attentionDot<A>(epsRow, v + (g * dims.tv + j) * dims.dv, dims.dv) - rowDot[row]);
+          for (LongType e = 0; e < dims.d; e++) dqAcc[e] += alpha * ds * static_cast<A>(kRow[e]);
+        }
+      }
+
+      T* dqRow = dq + row * dims.d;
+      for (LongType e = 0; e < dims.d; e++) dqRow[e] = static_cast<T>(dqAcc[e]);
+    }
+  };
+  samediff::Threads::parallel_for(funcQueries, 0, dims.groups * dims.tq);
+}
+
+//////////////////////////////////////////////////////////////////////////
+static AttentionDims attentionDims(NDArray* queries, NDArray* keys, NDArray* values) {
+  AttentionDims dims;
+  dims.tq = queries->sizeAt(-2);
+  dims.d = queries->sizeAt(-1);
+  dims.tv = keys->sizeAt(-2);
+  dims.dv = values->sizeAt(-1);
+  dims.groups = queries->lengthOf() / (dims.tq * dims.d);
+  return dims;
+}
+
+void fusedDotProductAttention(LaunchContext* context, NDArray* queries, NDArray* keys, NDArray* values,
+                              NDArray* qMask, NDArray* vMask, double scale, bool causal, NDArray* output,
+                              NDArray* logSumExp) {
+  const auto dims = attentionDims(queries, keys, values);
+  const AttentionMask qKeep(qMask, dims.groups, dims.tq);
+  const AttentionMask vKeep(vMask, dims.groups, dims.tv);
+
+  // kernel runs on host, make sure buffers are available there
+  NDArray::preparePrimaryUse({output, logSumExp}, {queries, keys, values});
+
+  std::vector<std::unique_ptr<NDArray>> copies;
+  auto q = denseC(queries, copies);
+  auto k = denseC(keys, copies);
+  auto v = denseC(values, copies);
+  auto out = denseC(output, copies);
+  auto lse = denseC(logSumExp, copies);
+
+  BUILD_SINGLE_SELECTOR(queries->dataType(), fusedAttention_, (q, k, v, dims, qKeep, vKeep, scale, causal, out, lse),
+                        SD_FLOAT_TYPES);
+
+  if (out != output) output->assign(out);
+  if (lse != logSumExp) logSumExp->assign(lse);
+
+  NDArray::registerPrimaryUse({output, logSumExp}, {queries, keys, values});
+}
+
+void fusedDotProductAttentionBp(LaunchContext* context, NDArray* queries, NDArray* keys, NDArray* values,
+                                NDArray* qMask, NDArray* vMask, double scale, bool causal, NDArray* output,
+                                NDArray* logSumExp, NDArray* eps, NDArray* dLdq, NDArray* dLdk, NDArray* dLdv) {
+  const auto dims = attentionDims(queries, keys, values);
+  const AttentionMask qKeep(qMask, dims.groups, dims.tq);
+  const AttentionMask vKeep(vMask, dims.groups, dims.tv);
+
+  NDArray::preparePrimaryUse({dLdq, dLdk, dLdv}, {queries, keys, values, output, logSumExp, eps});
+
+  std::vector<std::unique_ptr<NDArray>> copies;
+  auto q = denseC(queries, copies);
+  auto k = denseC(keys, copies);
+  auto v = denseC(values, copies);
+  auto out = denseC(output, copies);
+  auto lse = denseC(logSumExp, copies);
+  auto gradO = denseC(eps, copies);
+  auto dq = denseC(dLdq, copies);
+  auto dk = denseC(dLdk, copies);
+  auto dv = denseC(dLdv, copies);
+
+  BUILD_SINGLE_SELECTOR(queries->dataType(), fusedAttentionBp_,
+                        (q, k, v, out, lse, gradO, dims, qKeep, vKeep, scale, causal, dq, dk, dv), SD_FLOAT_TYPES);
+
+  if (dq != dLdq) dLdq->assign(dq);
+  if (dk != dLdk) dLdk->assign(dk);
+  if (dv != dLdv) dLdv->assign(dv);
+
+  NDArray::registerPrimaryUse({dLdq, dLdk, dLdv}, {queries, keys, values, output, logSumExp, eps});
+}
+
+}  // namespace helpers
+}  // namespace ops
+}  // namespace sd
+#endif
@@ -23,26 +23,47 @@
 #include <system/op_boilerplate.h>
 
 #if NOT_EXCLUDED(OP_listdiff)
+#include <execution/Threads.h>
+#include <helpers/UniqueEngine.h>
 #include <ops/declarable/helpers/listdiff.h>
 
+#include <memory>
 #include <vector>
 
 namespace sd {
 namespace ops {
 namespace helpers {
+
+// flags[e] = 1 if values[e] is not in keep, returns number of such values
 template <typename T>
-static sd::LongType listDiffCount_(NDArray* values, NDArray* keep) {
-  sd::LongType saved = 0L;
-  for (sd::LongType e = 0; e < values->lengthOf(); e++) {
-    auto v = values->e<double>(e);
-    ExtraArguments extras({v, 0.0, 10.0});
-    auto idx = keep->indexReduceNumber(indexreduce::FirstIndex, &extras);
-    auto index = idx.e<sd::LongType>(0);
-    if (index < 0) saved++;
-  }
+static sd::LongType listDiffFlags(NDArray* values, NDArray* keep, std::vector<uint8_t>& flags) {
+  std::unique_ptr<NDArray> valuesCopy, keepCopy;
+  if (values->ordering() != 'c' || !shape::isDense(values->shapeInfo()))
+    valuesCopy.reset(new NDArray(values->dup('c')));
+  if (keep->ordering() != 'c' || !shape::isDense(keep->shapeInfo())) keepCopy.reset(new NDArray(keep->dup('c')));
+  auto x = valuesCopy ? valuesCopy.get() : values;
+  auto y = keepCopy ? keepCopy.get() : keep;
+
+  const dedup::HashSet<T> kept(y->bufferAsT<T>(), y->lengthOf());
+  const auto xBuf = x->bufferAsT<T>();
+  flags.resize(x->lengthOf());
+
+  auto func = PRAGMA_REDUCE_LONG {
+    sd::LongType saved = 0;
+    for (auto e = start; e < stop; e++) {
+      flags[e] = kept.contains(xBuf[e]) ? 0 : 1;
+      saved += flags[e];
+    }
+    return saved;
+  };
 
+  return samediff::Threads::parallel_long(func, LAMBDA_AL { return _old + _new; }, 0, x->lengthOf());
+}
 
-  return saved;
+template <typename T>
+static sd::LongType listDiffCount_(NDArray* values, NDArray* keep) {
+  std::vector<uint8_t> flags;
+  return listDiffFlags<T>(values, keep, flags);
 }
 
 sd::LongType listDiffCount(sd::LaunchContext* context, NDArray* values, NDArray* keep) {
@@ -60,41 +81,40 @@ BUILD_SINGLE_TEMPLATE(template sd::LongType listDiffCount_, (NDArray * values, N
 
 template <typename T>
 static sd::Status listDiffFunctor_(NDArray* values, NDArray* keep, NDArray* output1, NDArray* output2) {
-  std::vector<T> saved;
-  std::vector<sd::LongType> indices;
-  for (sd::LongType e = 0; e < values->lengthOf(); e++) {
-    auto v = values->e<double>(e);
-    ExtraArguments extras({v, 0.0, 10.0});
-    NDArray idxScalar = keep->indexReduceNumber(indexreduce::FirstIndex, &extras);
-    sd::LongType idx = idxScalar.e<sd::LongType>(0);
-    if (idx < 0) {
-      saved.emplace_back(v);
-      indices.emplace_back(e);
-    }
-  }
+  std::vector<uint8_t> flags;
+  const auto saved = listDiffFlags<T>(values, keep, flags);
 
-  if (saved.size() == 0) {
+  if (saved == 0) {
     sd_printf("ListDiff: search returned no results", "");
     THROW_EXCEPTION("Op validation failed");
-  } else {
-    auto z0 = output1;
-    auto z1 = output2;
+  }
 
-    if (static_cast<size_t>(z0->lengthOf()) != saved.size()) {
-      sd_printf("ListDiff: output/actual size mismatch", "");
-      THROW_EXCEPTION("Op validation failed");
-    }
+  auto z0 = output1;
+  auto z1 = output2;
 
-    if (static_cast<size_t>(z1->lengthOf()) != saved.size()) {
-      sd_printf("ListDiff: output/actual indices size mismatch", "");
-      THROW_EXCEPTION("Op validation failed");
-    }
-    memcpy(z0->buffer(), saved.data(), saved.size() * sizeof(T));
-    for (size_t e = 0; e < indices.size(); e++) {
-      z1->p(e, indices[e]);
-    }
+  if (z0->lengthOf() != saved) {
+    sd_printf("ListDiff: output/actual size mismatch", "");
+    THROW_EXCEPTION("Op validation failed");
+  }
 
+  if (z1->lengthOf() != saved) {
+    sd_printf("ListDiff: output/actual indices size mismatch", "");
+    THROW_EXCEPTION("Op validation failed");
   }
+
+  std::vector<sd::LongType> positions;
+  positions.reserve(saved);
+  for (sd::LongType e = 0; e < static_cast<sd::LongType>(flags.size()); e++)
+    if (flags[e]) positions.push_back(e);
+
+  auto func = PRAGMA_THREADS_FOR {
+    for (auto i = start; i < stop; i++) {
+      z0->p(i, values->e<T>(positions[i]));
+      z1->p(i, positions[i]);
+    }
+  };
+  samediff::Threads::parallel_for(func, 0, saved);
+
   return sd::Status::OK;
 }
 
@@ -183,15 +183,212 @@ static SD_INLINE int getBatchTimeTotalIndex(const int dataFormat, const int sL,
   return b * sL + t;  // NTS, NST: shape [bS, sL, nIn], [bS, nIn, sL]
 }
 
+//////////////////////////////////////////////////////////////////////////
+// element-wise counterpart of applyActivation, used inside fused gate kernel
+template <typename T>
+static SD_INLINE T lstmActivation(const T x, const int opId, const T alpha, const T beta) {
+  switch (opId) {
+    case 0:
+      return sd::math::sd_tanh<T, T>(x);
+    case 1:
+      return x < static_cast<T>(0.f) ? static_cast<T>(0.f) : x;
+    case 2:
+      return sd::math::sd_sigmoid<T, T>(x);
+    case 3:
+      return alpha * x + beta;
+    case 4:
+      return x < static_cast<T>(0.f) ? alpha * x : x;
+    case 5:
+      return x > alpha ? x : static_cast<T>(0.f);
+    case 6:
+      return alpha * sd::math::sd_tanh<T, T>(beta * x);
+    case 7: {
+      const T y = static_cast<T>(0.2f) * x + static_cast<T>(0.5f);
+      return sd::math::sd_min<T>(static_cast<T>(1.f), sd::math::sd_max<T>(static_cast<T>(0.f), y));
+    }
+    case 8:
+      return sd::math::sd_elu<T, T>(x, alpha);
+    case 9:
+      return sd::math::sd_softsign<T, T>(x);
+    default:
+      return sd::math::sd_softplus<T, T>(x);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////
+// strides along bS and nOut axes, arrays are either [bS, K] or [K]
+static SD_INLINE void rowColStrides(NDArray* arr, sd::LongType& rowStride, sd::LongType& colStride) {
+  rowStride = arr->rankOf() == 1 ? 0 : arr->strideAt(0);
+  colStride = arr->strideAt(-1);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// fused gates activations, cell state update, clipping and peephole terms for one time step
+// z - on entry x × Wx + hI × Wr, on exit zi,zf,zg,zo with biases and peepholes added, [bS, 4*nOut] or [4*nOut]
+// a - i,f,g,o, optional, may be nullptr, [bS, 4*nOut] or [4*nOut]
+// h, c may be the same arrays as hI, cI
+template <typename T>
+static void lstmLayerGates_(NDArray* z, NDArray* b, NDArray* cI, NDArray* Wp, const std::vector<float>& params,
+                            NDArray* a, NDArray* h, NDArray* c) {
+  const sd::LongType nOut = z->sizeAt(-1) / 4;
+  const sd::LongType bS = z->rankOf() == 1 ? 1 : z->sizeAt(0);
+
+  const T clip = static_cast<T>(params[2]);
+  const int gateAct = params[3], cellAct = params[6], outAct = params[9];
+  const T gateAlpha = static_cast<T>(params[4]), gateBeta = static_cast<T>(params[5]);
+  const T cellAlpha = static_cast<T>(params[7]), cellBeta = static_cast<T>(params[8]);
+  const T outAlpha = static_cast<T>(params[10]), outBeta = static_cast<T>(params[11]);
+
+  for (const int act : {gateAct, cellAct, outAct})
+    if (act < 0 || act > 10) THROW_EXCEPTION("LSTM_LAYER operation: wrong id number of activation !");
+
+  T* zBuff = z->bufferAsT<T>();
+  T* aBuff = a != nullptr ? a->bufferAsT<T>() : nullptr;
+  T* hBuff = h->bufferAsT<T>();
+  T* cBuff = c->bufferAsT<T>();
+  const T* cIBuff = cI->bufferAsT<T>();
+  const T* bBuff = b != nullptr ? b->bufferAsT<T>() : nullptr;
+  const T* WpBuff = Wp != nullptr ? Wp->bufferAsT<T>() : nullptr;
+
+  sd::LongType zRow, zCol, aRow = 0, aCol = 0, hRow, hCol, cRow, cCol, cIRow, cICol;
+  rowColStrides(z, zRow, zCol);
+  if (a != nullptr) rowColStrides(a, aRow, aCol);
+  rowColStrides(h, hRow, hCol);
+  rowColStrides(c, cRow, cCol);
+  rowColStrides(cI, cIRow, cICol);
+  const sd::LongType bStride = b != nullptr ? b->strideAt(-1) : 0;
+  const sd::LongType WpStride = Wp != nullptr ? Wp->strideAt(-1) : 0;
+
+  auto func = PRAGMA_THREADS_FOR {
+    for (auto e = start; e < stop; ++e) {
+      const sd::LongType r = e / nOut;
+      const sd::LongType j = e % nOut;
+
+      T* zr = zBuff + r * zRow;
+      const T cPrev = cIBuff[r * cIRow + j * cICol];
+
+      T zi = zr[j * zCol];
+      T zf = zr[(nOut + j) * zCol];
+      T zg = zr[(2 * nOut + j) * zCol];
+      T zo = zr[(3 * nOut + j) * zCol];
+
+      if (bBuff != nullptr) {
+        zi += bBuff[j * bStride];
+        zf += bBuff[(nOut + j) * bStride];
+        zg += bBuff[(2 * nOut + j) * bStride];
+        zo += bBuff[(3 * nOut + j) * bStride];
+      }
+
+      // peephole connections for input and forget gates
+      if (WpBuff != nullptr) {
+        zi += cPrev * WpBuff[j * WpStride];
+        zf += cPrev * WpBuff[(nOut + j) * WpStride];
+      }
+
+      const T i = lstmActivation<T>(zi, gateAct, gateAlpha, gateBeta);
+      const T f = lstmActivation<T>(zf, gateAct, gateAlpha, gateBeta);
+      const T g = lstmActivation<T>(zg, cellAct, cellAlpha, cellBeta);
+
+      T cCurr = f * cPrev + i * g;
+      if (clip != static_cast<T>(0.f)) cCurr = cCurr > clip ? clip : (cCurr < -clip ? -clip : cCurr);
+
+      // peephole connection for output gate
+      if (WpBuff != nullptr) zo += cCurr * WpBuff[(2 * nOut + j) * WpStride];
+
+      const T o = lstmActivation<T>(zo, gateAct, gateAlpha, gateBeta);
+
+      zr[j * zCol] = zi;
+      zr[(nOut + j) * zCol] = zf;
+      zr[(2 * nOut + j) * zCol] = zg;
+      zr[(3 * nOut + j) * zCol] = zo;
+
+      if (aBuff != nullptr) {
+        T* ar = aBuff + r * aRow;
+        ar[j * aCol] = i;
+        ar[(nOut + j) * aCol] = f;
+        ar[(2 * nOut + j) * aCol] = g;
+        ar[(3 * nOut + j) * aCol] = o;
+      }
+
+      hBuff[r * hRow + j * hCol] = lstmActivation<T>(cCurr, outAct, outAlpha, outBeta) * o;
+      cBuff[r * cRow + j * cCol] = cCurr;
+    }
+  };
+
+  samediff::Threads::parallel_for(func, 0, bS * nOut);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// one time step when input projection x × Wx is already stored in z
+static void lstmLayerStep(NDArray* z, NDArray* Wr, NDArray* b, NDArray* hI, NDArray* cI, NDArray* Wp,
+                          const std::vector<float>& params, NDArray* a, NDArray* h, NDArray* c) {
+  // z += hI × Wr, [bS, nOut] x [nOut, 4*nOut] = [bS, 4*nOut] (or [nOut] x [nOut, 4*nOut] = [4*nOut])
+  MmulHelper::mmul(hI, Wr, z, 1.0, 1.0);
+
+  // kernel reads b, cI and Wp buffers directly, so they must have the same type as z
+  const auto type = z->dataType();
+  NDArray* bT = b != nullptr && b->dataType() != type ? new NDArray(b->cast(type)) : b;
+  NDArray* cIT = cI->dataType() != type ? new NDArray(cI->cast(type)) : cI;
+  NDArray* WpT = Wp != nullptr && Wp->dataType() != type ? new NDArray(Wp->cast(type)) : Wp;
+
+  BUILD_SINGLE_SELECTOR(type, lstmLayerGates_, (z, bT, cIT, WpT, params, a, h, c), SD_FLOAT_TYPES);
+
+  if (bT != b) delete bT;
+  if (cIT != cI) delete cIT;
+  if (WpT != Wp) delete WpT;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// copy of x (any dataFormat) laid out as contiguous time major rows [sL*bS, nIn], row index is t*bS + b
+static NDArray* timeMajorRows(NDArray* x, const int dataFormat, const DataType type) {
+  std::vector<sd::LongType> perm;
+  if (dataFormat == 1) perm = {1, 0, 2};  // NTS: [bS, sL, nIn] -> [sL, bS, nIn]
+  if (dataFormat == 2) perm = {2, 0, 1};  // NST: [bS, nIn, sL] -> [sL, bS, nIn]
+
+  NDArray* xTNS = perm.empty() ? x : &x->permute(perm, false, false);
+
+  std::vector<sd::LongType> shape = {xTNS->sizeAt(0), xTNS->sizeAt(1), xTNS->sizeAt(2)};
+  NDArray* rows = new NDArray('c', shape, type, x->getContext());
+  rows->assign(xTNS);
+  rows->reshapei({shape[0] * shape[1], shape[2]});
+
+  if (xTNS != x) delete xTNS;
+  return rows;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// inverse of timeMajorRows: scatter time major rows [sL*bS, nIn] into x of given dataFormat
+static void fromTimeMajorRows(NDArray* rows, const int dataFormat, NDArray* x) {
+  std::vector<sd::LongType> perm;
+  if (dataFormat == 1) perm = {1, 0, 2};
+  if (dataFormat == 2) perm = {2, 0, 1};
+
+  NDArray* xTNS = perm.empty() ? x : &x->permute(perm, false, false);
+
+  std::vector<sd::LongType> shape = {xTNS->sizeAt(0), xTNS->sizeAt(1), xTNS->sizeAt(2)};
+  NDArray& rowsTNS = rows->reshape('c', shape, false);
+  xTNS->assign(&rowsTNS);
+
+  delete &rowsTNS;
+  if (xTNS != x) delete xTNS;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// input projection for whole sequence by single gemm: [sL*bS, nIn] x [nIn, 4*nOut] = [sL*bS, 4*nOut]
+// z must be c-ordered [sL, bS, 4*nOut]
+static void inputProjection(NDArray* xRows, NDArray* Wx, NDArray* z) {
+  std::vector<sd::LongType> shape = {xRows->sizeAt(0), z->sizeAt(-1)};
+  NDArray& zRows = z->reshape('c', shape, false);
+  MmulHelper::mmul(xRows, Wx, &zRows);
+  delete &zRows;
+}
+
 //////////////////////////////////////////////////////////////////////////
 void lstmLayerCell(NDArray* x, NDArray* Wx, NDArray* Wr, NDArray* b, NDArray* hI,
                    NDArray* cI, NDArray* Wp, const std::vector<float>& params, NDArray* h, NDArray* c) {
   // * -> means element-wise multiplication
   // × -> means matrix multiplication
 
-  /************************ THIS IS NOT OPTIMAZED CODE ***********************************/
-  /** the objective is to provide math-readable code **/
-
   // equations (no peephole connections)
   // it  = σ(Wxi × xt  +  Wri × ht-1  +  bi)
   // ft  = σ(Wxf × xt  +  Wrf × ht-1  +  bf)
@@ -243,101 +440,149 @@ void lstmLayerCell(NDArray* x, NDArray* Wx, NDArray* Wr, NDArray* b, NDArray* hI
   // !!! dimension 4*nOut implies order it, ft, c't, ot
   // !!! dimension 3*nOut implies order it, ft, ot
 
-  const sd::LongType nOut = Wx->sizeAt(-1) / 4;
+  auto z = mmul(*x, *Wx);  // [bs, nIn] * [nIn, 4*nOut] = [bS, 4*nOut] or [nIn] * [nIn, 4*nOut] = [4*nOut]
+
+  lstmLayerStep(&z, Wr, b, hI, cI, Wp, params, nullptr, h, c);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// this auxiliary ff should be running before backprop
+void lstmLayerCell(NDArray* x, NDArray* Wx, NDArray* Wr, NDArray* b, NDArray* hI,
+                   NDArray* cI, NDArray* Wp, const std::vector<float>& params, NDArray* z, NDArray* a,
+                   NDArray* h, NDArray* c) {
+  // z - zi, zf, zg, zo
+  // a - i, f, g, o
+
+  MmulHelper::mmul(x, Wx, z);  // [bs, nIn] * [nIn, 4*nOut] = [bS, 4*nOut] or [nIn] * [nIn, 4*nOut] = [4*nOut]
+
+  lstmLayerStep(z, Wr, b, hI, cI, Wp, params, a, h, c);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// recurrent part of lstmLayerCellBp: fills dLdz (dLdzi, dLdzf, dLdzg, dLdzo) and accumulates dLdhI, dLdcI, dLdWr,
+// dLdWp; dLdx, dLdWx and dLdb depend on dLdz only, so time loop evaluates them once for all time steps
+static void lstmLayerCellBpRecurrent(NDArray* Wr, NDArray* hI, NDArray* cI, NDArray* Wp, NDArray* dLdh,
+                                     NDArray* dLdhL, NDArray* dLdcL, NDArray* z, NDArray* a, NDArray* c,
+                                     const std::vector<float>& params, NDArray* dLdzArr, NDArray* dLdWr,
+                                     NDArray* dLdhI, NDArray* dLdcI, NDArray* dLdWp) {
+  const sd::LongType nOut = z->sizeAt(-1) / 4;
+
+  NDArray zi = z->rankOf() == 1 ? (*z)({0, nOut}) : (*z)({0, 0, 0, nOut});  // input gate i, [bS, nOut](or[nOut])
+  NDArray zf =
+      z->rankOf() == 1 ? (*z)({nOut, 2 * nOut}) : (*z)({0, 0, nOut, 2 * nOut});  // forget gate f, [bS, nOut](or[nOut])
+  NDArray zg = z->rankOf() == 1 ? (*z)({2 * nOut, 3 * nOut})
+                                : (*z)({0, 0, 2 * nOut, 3 * nOut});  // cell gate g, [bS, nOut](or[nOut])
+  NDArray zo = z->rankOf() == 1 ? (*z)({3 * nOut, 4 * nOut})
+                                : (*z)({0, 0, 3 * nOut, 4 * nOut});  // output gate o, [bS, nOut](or[nOut])
+
+  NDArray i = z->rankOf() == 1 ? (*a)({0, nOut}) : (*a)({0, 0, 0, nOut});  // input gate i, [bS, nOut](or[nOut])
+  NDArray f =
+      z->rankOf() == 1 ? (*a)({nOut, 2 * nOut}) : (*a)({0, 0, nOut, 2 * nOut});  // forget gate f, [bS, nOut](or[nOut])
+  NDArray g = z->rankOf() == 1 ? (*a)({2 * nOut, 3 * nOut})
+                               : (*a)({0, 0, 2 * nOut, 3 * nOut});  // cell gate g, [bS, nOut](or[nOut])
+  NDArray o = z->rankOf() == 1 ? (*a)({3 * nOut, 4 * nOut})
+                               : (*a)({0, 0, 3 * nOut, 4 * nOut});  // output gate o, [bS, nOut](or[nOut])
 
-  auto z = mmul(*x, *Wx) + mmul(*hI, *Wr);  //   [bs, nIn] * [nIn, 4*nOut] + [bs, nOut] * [nOut, 4*nOut] = [bS, 4*nOut]
-  // or [nIn] * [nIn, 4*nOut] + [nOut] * [nOut, 4*nOut] = [4*nOut]
+  NDArray& dLdz = *dLdzArr;  // [bS, 4*nOut](or[4*nOut])
+  NDArray dLdzi = z->rankOf() == 1 ? dLdz({0, nOut}) : dLdz({0, 0, 0, nOut});
+  NDArray dLdzf = z->rankOf() == 1 ? dLdz({nOut, 2 * nOut}) : dLdz({0, 0, nOut, 2 * nOut});
+  NDArray dLdzg = z->rankOf() == 1 ? dLdz({2 * nOut, 3 * nOut}) : dLdz({0, 0, 2 * nOut, 3 * nOut});
+  NDArray dLdzo = z->rankOf() == 1 ? dLdz({3 * nOut, 4 * nOut}) : dLdz({0, 0, 3 * nOut, 4 * nOut});
 
-  // add biases if they are given
-  if (b != nullptr) z += *b;  // broadcast [bS, 4*nOut](or[4*nOut]) + [4*nOut] = [bS, 4*nOut]
+  // dcdzi = dcdi*didzi, [bS, nOut](or[nOut])
+  activationDeriv(&zi, params[3], params[4], params[5], &dLdzi);  // didzi, inplace
+  dLdzi *= g;                                                   // dcdi = g*clipDeriv
 
-  auto zi = x->rankOf() == 1 ? z({0, nOut}) : z({0, 0, 0, nOut});                // input gate it, [bS, nOut](or[nOut])
-  auto zf = x->rankOf() == 1 ? z({nOut, 2 * nOut}) : z({0, 0, nOut, 2 * nOut});  // forget gate ft, [bS, nOut](or[nOut])
-  auto zg = x->rankOf() == 1 ? z({2 * nOut, 3 * nOut})
-                             : z({0, 0, 2 * nOut, 3 * nOut});  // cell gate c't, [bS, nOut](or[nOut])
-  auto zo = x->rankOf() == 1 ? z({3 * nOut, 4 * nOut})
-                             : z({0, 0, 3 * nOut, 4 * nOut});  // output gate ot, [bS, nOut](or[nOut])
+  // dcdzf = dcdf*dfdzf, [bS, nOut](or[nOut])
+  activationDeriv(&zf, params[3], params[4], params[5], &dLdzf);  // dfdzf, inplace
+  dLdzf *= *cI;                                                 // dcdf = cI*clipDeriv
+
+  // dcdzg = dcde*dedzg, [bS, nOut](or[nOut])
+  activationDeriv(&zg, params[6], params[7], params[8], &dLdzg);  // dgdzg, inplace
+  dLdzg *= i;                                                   // dcdf = i*clipDeriv
+
+  // dhdzo = dhdo*dodzo = actH(c)*dodzo, [bS, nOut](or[nOut])
+  activationDeriv(&zo, params[3], params[4], params[5], &dLdzo);
+  NDArray *dLdzoUlike = dLdzo.ulike();
+  NDArray temp = *dLdzoUlike;
+  applyActivation(c, params[9], params[10], params[11], &temp);  // actH(c), inplace
+  dLdzo *= temp;
+
+  // dcdcI
+  NDArray dcdcI = f.dup();  // dcdcI = f*clipDeriv [bS, nOut](or[nOut])
+
+  // take into account possible deposit from clipping derivative
+  clipDeriv(params[2], *c, dLdzi, dLdzf, dLdzg, dcdcI);
+
+  // dhdc
+  NDArray *cUlike = c->ulike();
+  NDArray dhdc = *cUlike;
+  activationDeriv(c, params[9], params[10], params[11], &dhdc);  // [bS, nOut]
+  dhdc *= o;
 
-  // peephole connections for input and forget gates
-  if (Wp != nullptr) {
-    zi += *cI * (*Wp)({0, nOut});         // broadcast: [bS, nOut] + [bS, nOut] * [nOut] = [bS, nOut](or[nOut])
-    zf += *cI * (*Wp)({nOut, 2 * nOut});  // broadcast: [bS, nOut] + [bS, nOut] * [nOut] = [bS, nOut](or[nOut])
+  if (Wp) {
+    dhdc += dLdzo * (*Wp)({2 * nOut, 3 * nOut});
+    dcdcI += dLdzi * (*Wp)({0, nOut}) + dLdzf * (*Wp)({nOut, 2 * nOut});  // broadcast [bS, nOut] * nOut + ...
   }
 
-  applyActivation(&zi, params[3], params[4], params[5], &zi);  // inplace
-  applyActivation(&zf, params[3], params[4], params[5], &zf);  // inplace
-  applyActivation(&zg, params[6], params[7], params[8], &zg);  // inplace
-  NDArray cAssign = zf * *cI + zi * zg;
-  c->assign(&cAssign);  // [bS, nOut] * [bS, nOut] + [bS, nOut] * [bS, nOut] = [bS, nOut](or[nOut])
+  if (dLdh) *dLdhI += *dLdh;
+  if (dLdhL) *dLdhI += *dLdhL;
+  if (dLdcL) *dLdcI += *dLdcL;
 
-  // if clipping value is non-zero then cell state is clipped by this value prior to the cell output activation
-  if (params[2] != 0) c->applyScalar(scalar::LstmClip, params[2], c);
+  *dLdcI += *dLdhI * dhdc;
 
-  // peephole connections for output gate
-  if (Wp != nullptr)
-    zo += *c * (*Wp)({2 * nOut, 3 * nOut});  // broadcast: [bS, nOut] + [bS, nOut] * [nOut] = [bS, nOut](or[nOut])
+  dLdzi *= *dLdcI;  // [bS, nOut](or[nOut])
+  dLdzf *= *dLdcI;  // [bS, nOut](or[nOut])
+  dLdzg *= *dLdcI;  // [bS, nOut](or[nOut])
+  dLdzo *= *dLdhI;  // [bS, nOut](or[nOut])
 
-  applyActivation(&zo, params[3], params[4], params[5], &zo);
+  // dLdhI
+  NDArray WrT = Wr->transpose();
+  MmulHelper::mmul(&dLdz, &WrT,
+                   dLdhI);  // [bS, 4*nOut] x [4*nOut, nOut] (or [4*nOut] x [4*nOut, nOut]) = [bS, nOut] ( or[nOut] )
 
-  applyActivation(c, params[9], params[10], params[11], h);
-  *h *= zo;  // [bS, nOut] * [bS, nOut](or[nOut])
-}
+  NDArray dLdcIAssign = *dLdcI * dcdcI;
+  // dLdcI
+  dLdcI->assign(&dLdcIAssign);  // [bS, nOut](or[nOut])
 
-//////////////////////////////////////////////////////////////////////////
-// this auxiliary ff should be running before backprop
-void lstmLayerCell(NDArray* x, NDArray* Wx, NDArray* Wr, NDArray* b, NDArray* hI,
-                   NDArray* cI, NDArray* Wp, const std::vector<float>& params, NDArray* z, NDArray* a,
-                   NDArray* h, NDArray* c) {
-  // z - zi, zf, zg, zo
-  // a - i, f, g, o
+  if (z->rankOf() == 1) {
+    std::vector<sd::LongType> hIShape = {nOut, 1};
+    std::vector<sd::LongType> dLdzShape = {1, 4 * nOut};
+    NDArray hIT = hI->reshape(hI->ordering(), hIShape);          // [nOut] -> [nOut, 1]
+    NDArray dLdzR = dLdz.reshape(dLdz.ordering(), dLdzShape);  // [nOut] -> [1, 4*nOut]
 
-  const sd::LongType nOut = Wx->sizeAt(-1) / 4;
-  NDArray zAssign = mmul(*x, *Wx) +
-                    mmul(*hI, *Wr);
-  z->assign(&zAssign);  //   [bs, nIn] * [nIn, 4*nOut] + [bs, nOut] * [nOut, 4*nOut] = [bS, 4*nOut]
-  // or [nIn] * [nIn, 4*nOut] + [nOut] * [nOut, 4*nOut] = [4*nOut]
-  // add biases if they are given
-  if (b != nullptr) *z += *b;  // broadcast [bS, 4*nOut](or[4*nOut]) + [4*nOut] = [bS, 4*nOut]
-
-  auto zi = x->rankOf() == 1 ? (*z)({0, nOut}) : (*z)({0, 0, 0, nOut});  // input gate it, [bS, nOut](or[nOut])
-  auto zf =
-      x->rankOf() == 1 ? (*z)({nOut, 2 * nOut}) : (*z)({0, 0, nOut, 2 * nOut});  // forget gate ft, [bS, nOut](or[nOut])
-  auto zg = x->rankOf() == 1 ? (*z)({2 * nOut, 3 * nOut})
-                             : (*z)({0, 0, 2 * nOut, 3 * nOut});  // cell gate c't, [bS, nOut](or[nOut])
-  auto zo = x->rankOf() == 1 ? (*z)({3 * nOut, 4 * nOut})
-                             : (*z)({0, 0, 3 * nOut, 4 * nOut});  // output gate ot, [bS, nOut](or[nOut])
-
-  auto i = x->rankOf() == 1 ? (*a)({0, nOut}) : (*a)({0, 0, 0, nOut});  // input gate it, [bS, nOut](or[nOut])
-  auto f =
-      x->rankOf() == 1 ? (*a)({nOut, 2 * nOut}) : (*a)({0, 0, nOut, 2 * nOut});  // forget gate ft, [bS, nOut](or[nOut])
-  auto g = x->rankOf() == 1 ? (*a)({2 * nOut, 3 * nOut})
-                            : (*a)({0, 0, 2 * nOut, 3 * nOut});  // cell gate c't, [bS, nOut](or[nOut])
-  auto o = x->rankOf() == 1 ? (*a)({3 * nOut, 4 * nOut})
-                            : (*a)({0, 0, 3 * nOut, 4 * nOut});  // output gate ot, [bS, nOut](or[nOut])
-
-  // peephole connections for input and forget gates
-  if (Wp != nullptr) {
-    zi += *cI * (*Wp)({0, nOut});         // broadcast: [bS, nOut] + [bS, nOut] * [nOut] = [bS, nOut](or[nOut])
-    zf += *cI * (*Wp)({nOut, 2 * nOut});  // broadcast: [bS, nOut] + [bS, nOut] * [nOut] = [bS, nOut](or[nOut])
+    // dLdWr
+    *dLdWr += mmul(hIT, dLdzR);  // [nOut, 1] x [1, 4*nOut] = [nOut, 4*nOut]
+  } else {
+    NDArray hIT = hI->transpose();
+
+    // dLdWr
+    *dLdWr += mmul(hIT, dLdz);  // [nOut, bS] x [bS, 4*nOut] = [nOut, 4*nOut]
   }
 
-  applyActivation(&zi, params[3], params[4], params[5], &i);
-  applyActivation(&zf, params[3], params[4], params[5], &f);
-  applyActivation(&zg, params[6], params[7], params[8], &g);
-  NDArray cAssign = f * *cI + i * g;
-  c->assign(&cAssign);  // [bS, nOut] * [bS, nOut] + [bS, nOut] * [bS, nOut] = [bS, nOut](or[nOut])
+  // dLdWp
+  if (Wp && z->rankOf() == 1) {
+    (*dLdWp)({0, nOut}) += std::move(dLdzi) * (*cI);            // [nOut]
+    (*dLdWp)({nOut, 2 * nOut}) += std::move(dLdzf) * (*cI);     // [nOut]
+    (*dLdWp)({2 * nOut, 3 * nOut}) += std::move(dLdzo) * (*c);  // [nOut]
 
-  // if clipping value is non-zero then cell state is clipped by this value prior to the cell output activation
-  if (params[2] != 0) c->applyScalar(scalar::LstmClip, params[2], c);
+  } else if (Wp) {
+    std::vector<sd::LongType> shape = {nOut};
+    NDArray temp2(Wp->ordering(), shape, Wp->dataType(), Wp->getContext());
+    std::vector<sd::LongType> dims = {0};
 
-  // peephole connections for output gate
-  if (Wp != nullptr)
-    zo += *c * (*Wp)({2 * nOut, 3 * nOut});  // broadcast: [bS, nOut] + [bS, nOut] * [nOut] = [bS, nOut](or[nOut])
+    (std::move(dLdzi) * (*cI)).reduceAlongDimension(reduce::Sum, &temp2, &dims);  // [bS, nOut] -> reduce -> [nOut]
+    (*dLdWp)({0, nOut}) += temp2;
+    (std::move(dLdzf) * (*cI)).reduceAlongDimension(reduce::Sum, &temp2, &dims);  // [bS, nOut] -> reduce -> [nOut]
+    (*dLdWp)({nOut, 2 * nOut}) += temp2;
+    (std::move(dLdzo) * (*c)).reduceAlongDimension(reduce::Sum, &temp2, &dims);  // [bS, nOut] -> reduce -> [nOut]
+    (*dLdWp)({2 * nOut, 3 * nOut}) += temp2;
 
-  applyActivation(&zo, params[3], params[4], params[5], &o);
+  }
+
+  delete cUlike;
+  delete dLdzoUlike;
 
-  applyActivation(c, params[9], params[10], params[11], h);
-  *h *= o;  // [bS, nOut] * [bS, nOut](or[nOut])
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -456,111 +701,28 @@ void lstmLayerCellBp(NDArray* x, NDArray* Wx, NDArray* Wr, NDArray* b, NDArray*
   const sd::LongType nOut = Wx->sizeAt(-1) / 4;
   const sd::LongType nIn = x->sizeAt(-1);
 
-  NDArray zi = x->rankOf() == 1 ? (*z)({0, nOut}) : (*z)({0, 0, 0, nOut});  // input gate i, [bS, nOut](or[nOut])
-  NDArray zf =
-      x->rankOf() == 1 ? (*z)({nOut, 2 * nOut}) : (*z)({0, 0, nOut, 2 * nOut});  // forget gate f, [bS, nOut](or[nOut])
-  NDArray zg = x->rankOf() == 1 ? (*z)({2 * nOut, 3 * nOut})
-                                : (*z)({0, 0, 2 * nOut, 3 * nOut});  // cell gate g, [bS, nOut](or[nOut])
-  NDArray zo = x->rankOf() == 1 ? (*z)({3 * nOut, 4 * nOut})
-                                : (*z)({0, 0, 3 * nOut, 4 * nOut});  // output gate o, [bS, nOut](or[nOut])
-
-  NDArray i = x->rankOf() == 1 ? (*a)({0, nOut}) : (*a)({0, 0, 0, nOut});  // input gate i, [bS, nOut](or[nOut])
-  NDArray f =
-      x->rankOf() == 1 ? (*a)({nOut, 2 * nOut}) : (*a)({0, 0, nOut, 2 * nOut});  // forget gate f, [bS, nOut](or[nOut])
-  NDArray g = x->rankOf() == 1 ? (*a)({2 * nOut, 3 * nOut})
-                               : (*a)({0, 0, 2 * nOut, 3 * nOut});  // cell gate g, [bS, nOut](or[nOut])
-  NDArray o = x->rankOf() == 1 ? (*a)({3 * nOut, 4 * nOut})
-                               : (*a)({0, 0, 3 * nOut, 4 * nOut});  // output gate o, [bS, nOut](or[nOut])
-
-  NDArray *zUlike = z->ulike();  // [bS, 4*nOut](or[4*nOut])
-  NDArray dLdz = *zUlike;  // [bS, 4*nOut](or[4*nOut])
-  NDArray dLdzi = x->rankOf() == 1 ? dLdz({0, nOut}) : dLdz({0, 0, 0, nOut});
-  NDArray dLdzf = x->rankOf() == 1 ? dLdz({nOut, 2 * nOut}) : dLdz({0, 0, nOut, 2 * nOut});
-  NDArray dLdzg = x->rankOf() == 1 ? dLdz({2 * nOut, 3 * nOut}) : dLdz({0, 0, 2 * nOut, 3 * nOut});
-  NDArray dLdzo = x->rankOf() == 1 ? dLdz({3 * nOut, 4 * nOut}) : dLdz({0, 0, 3 * nOut, 4 * nOut});
-
-  // dcdzi = dcdi*didzi, [bS, nOut](or[nOut])
-  activationDeriv(&zi, params[3], params[4], params[5], &dLdzi);  // didzi, inplace
-  dLdzi *= g;                                                   // dcdi = g*clipDeriv
-
-  // dcdzf = dcdf*dfdzf, [bS, nOut](or[nOut])
-  activationDeriv(&zf, params[3], params[4], params[5], &dLdzf);  // dfdzf, inplace
-  dLdzf *= *cI;                                                 // dcdf = cI*clipDeriv
-
-  // dcdzg = dcde*dedzg, [bS, nOut](or[nOut])
-  activationDeriv(&zg, params[6], params[7], params[8], &dLdzg);  // dgdzg, inplace
-  dLdzg *= i;                                                   // dcdf = i*clipDeriv
+  NDArray *dLdzArr = z->ulike();  // [bS, 4*nOut](or[4*nOut])
+  NDArray& dLdz = *dLdzArr;
 
-  // dhdzo = dhdo*dodzo = actH(c)*dodzo, [bS, nOut](or[nOut])
-  activationDeriv(&zo, params[3], params[4], params[5], &dLdzo);
-  NDArray *dLdzoUlike = dLdzo.ulike();
-  NDArray temp = *dLdzoUlike;
-  applyActivation(c, params[9], params[10], params[11], &temp);  // actH(c), inplace
-  dLdzo *= temp;
-
-  // dcdcI
-  NDArray dcdcI = f.dup();  // dcdcI = f*clipDeriv [bS, nOut](or[nOut])
-
-  // take into account possible deposit from clipping derivative
-  clipDeriv(params[2], *c, dLdzi, dLdzf, dLdzg, dcdcI);
-
-  // dhdc
-  NDArray *cUlike = c->ulike();
-  NDArray dhdc = *cUlike;
-  activationDeriv(c, params[9], params[10], params[11], &dhdc);  // [bS, nOut]
-  dhdc *= o;
-
-  if (Wp) {
-    dhdc += dLdzo * (*Wp)({2 * nOut, 3 * nOut});
-    dcdcI += dLdzi * (*Wp)({0, nOut}) + dLdzf * (*Wp)({nOut, 2 * nOut});  // broadcast [bS, nOut] * nOut + ...
-  }
-
-  if (dLdh) *dLdhI += *dLdh;
-  if (dLdhL) *dLdhI += *dLdhL;
-  if (dLdcL) *dLdcI += *dLdcL;
-
-  *dLdcI += *dLdhI * dhdc;
-
-  dLdzi *= *dLdcI;  // [bS, nOut](or[nOut])
-  dLdzf *= *dLdcI;  // [bS, nOut](or[nOut])
-  dLdzg *= *dLdcI;  // [bS, nOut](or[nOut])
-  dLdzo *= *dLdhI;  // [bS, nOut](or[nOut])
+  lstmLayerCellBpRecurrent(Wr, hI, cI, Wp, dLdh, dLdhL, dLdcL, z, a, c, params, dLdzArr, dLdWr, dLdhI, dLdcI, dLdWp);
 
   // dLdx
   NDArray WxT = Wx->transpose();
   MmulHelper::mmul(&dLdz, &WxT,
                    dLdx);  // [bS, 4*nOut] x [4*nOut, nIn] (or [4*nOut] x [4*nOut, nIn]) = [bS, nIn] ( or[nIn] )
 
-  // dLdhI
-  NDArray WrT = Wr->transpose();
-  MmulHelper::mmul(&dLdz, &WrT,
-                   dLdhI);  // [bS, 4*nOut] x [4*nOut, nOut] (or [4*nOut] x [4*nOut, nOut]) = [bS, nOut] ( or[nOut] )
-
-  NDArray dLdcIAssign = *dLdcI * dcdcI;
-  // dLdcI
-  dLdcI->assign(&dLdcIAssign);  // [bS, nOut](or[nOut])
-
   if (x->rankOf() == 1) {
     std::vector<sd::LongType> xShape = {nIn, 1};
-    std::vector<sd::LongType> hIShape = {nOut, 1};
     std::vector<sd::LongType> dLdzShape = {1, 4 * nOut};
     NDArray xT = x->reshape(x->ordering(), xShape);              // [nIn]  -> [nIn, 1]
-    NDArray hIT = hI->reshape(hI->ordering(), hIShape);          // [nOut] -> [nOut, 1]
     NDArray dLdzR = dLdz.reshape(dLdz.ordering(), dLdzShape);  // [nOut] -> [1, 4*nOut]
 
     // dLdWx
     *dLdWx += mmul(xT, dLdzR);  // [nIn, 1] x [1, 4*nOut] = [nIn, 4*nOut]
-
-    // dLdWr
-    *dLdWr += mmul(hIT, dLdzR);  // [nOut, 1] x [1, 4*nOut] = [nOut, 4*nOut]
   } else {
     NDArray xT = x->transpose();
-    NDArray hIT = hI->transpose();
     // dLdWx
     *dLdWx += mmul(xT, dLdz);  // [nIn, bS] x [bS, 4*nOut] = [nIn, 4*nOut]
-
-    // dLdWr
-    *dLdWr += mmul(hIT, dLdz);  // [nOut, bS] x [bS, 4*nOut] = [nOut, 4*nOut]
   }
 
   // dLdb
@@ -570,30 +732,8 @@ void lstmLayerCellBp(NDArray* x, NDArray* Wx, NDArray* Wr, NDArray* b, NDArray*
     std::vector<sd::LongType> dims = {0};
     *dLdb += dLdz.reduceAlongDimension(reduce::Sum, &dims);  // [bS, 4*nOut] -> reduce -> [4*nOut];
   }
-  // dLdWp
-  if (Wp && x->rankOf() == 1) {
-    (*dLdWp)({0, nOut}) += std::move(dLdzi) * (*cI);            // [nOut]
-    (*dLdWp)({nOut, 2 * nOut}) += std::move(dLdzf) * (*cI);     // [nOut]
-    (*dLdWp)({2 * nOut, 3 * nOut}) += std::move(dLdzo) * (*c);  // [nOut]
-
-  } else if (Wp) {
-    std::vector<sd::LongType> shape = {nOut};
-    NDArray temp2(Wp->ordering(), shape, Wp->dataType(), Wp->getContext());
-    std::vector<sd::LongType> dims = {0};
-
-    (std::move(dLdzi) * (*cI)).reduceAlongDimension(reduce::Sum, &temp2, &dims);  // [bS, nOut] -> reduce -> [nOut]
-    (*dLdWp)({0, nOut}) += temp2;
-    (std::move(dLdzf) * (*cI)).reduceAlongDimension(reduce::Sum, &temp2, &dims);  // [bS, nOut] -> reduce -> [nOut]
-    (*dLdWp)({nOut, 2 * nOut}) += temp2;
-    (std::move(dLdzo) * (*c)).reduceAlongDimension(reduce::Sum, &temp2, &dims);  // [bS, nOut] -> reduce -> [nOut]
-    (*dLdWp)({2 * nOut, 3 * nOut}) += temp2;
-
-  }
-
-  delete zUlike;
-  delete cUlike;
-  delete dLdzoUlike;
 
+  delete dLdzArr;
 }
 
 
@@ -648,21 +788,29 @@ void lstmLayerTimeLoop(NDArray* x, NDArray* Wx, NDArray* Wr, NDArray* b, NDArray
   auto ht = hL;
   if (!h && !hL) ht = new NDArray(x->ordering(), shapeOut, type, x->getContext());
 
+  // input projection x × Wx for all time steps by one gemm, stored time major [sL, bS, 4*nOut]
+  // later each time step adds its recurrent part hI × Wr in place
+  std::vector<sd::LongType> zShape = {sL, bS, 4 * nOut};
+  NDArray xW('c', zShape, type, x->getContext());
+  NDArray* xRows = timeMajorRows(x, dataFormat, type);
+  inputProjection(xRows, Wx, &xW);
+  delete xRows;
+
   // create sets of required (depends on seqLen presence) sub-arrays
   std::vector<sd::LongType> *dims;
-  ResultSet *xSet(nullptr), *hSet(nullptr), *h0Set(nullptr), *c0Set(nullptr), *htSet(nullptr), *ctSet(nullptr);
+  ResultSet *xWSet(nullptr), *hSet(nullptr), *h0Set(nullptr), *c0Set(nullptr), *htSet(nullptr), *ctSet(nullptr);
 
   if (!seqLen) {
     std::vector<sd::LongType> dims2 =  {dataFormat < 3 ? dataFormat : 0};
     dims = ShapeUtils::evalDimsToExclude(x->rankOf(),
                                          dims2.size(),dims2.data());  // points on bS and nIn/nOut axes
 
-    xSet = new ResultSet(x->allTensorsAlongDimension(*dims));         // sub-arrays with shape [bS, nIn]
+    xWSet = new ResultSet(xW.allTensorsAlongDimension({1, 2}));        // sub-arrays with shape [bS, 4*nOut]
     if (h) hSet = new ResultSet(h->allTensorsAlongDimension(*dims));  // sub-arrays with shape [bS, nOut]
   } else {
     dims = dataFormat == 2 ? new std::vector<sd::LongType>({1}) : new std::vector<sd::LongType>({2});  // points on nIn/nOut axis
 
-    xSet = new ResultSet(x->allTensorsAlongDimension(*dims));           //  sub-arrays with shape [nIn]
+    xWSet = new ResultSet(xW.allTensorsAlongDimension({2}));            //  sub-arrays with shape [4*nOut]
     h0Set = new ResultSet(h0->allTensorsAlongDimension({1}));          //  sub-arrays with shape [nOut]
     c0Set = new ResultSet(c0->allTensorsAlongDimension({1}));          //  sub-arrays with shape [nOut]
     ctSet = new ResultSet(ct->allTensorsAlongDimension({1}));          //  sub-arrays with shape [nOut]
@@ -677,14 +825,15 @@ void lstmLayerTimeLoop(NDArray* x, NDArray* Wx, NDArray* Wr, NDArray* b, NDArray
     if (!seqLen) {
       if (!h) {  // seqLen and h are absent
 
-        lstmLayerCell(xSet->at(0), Wx, Wr, b, h0, c0, Wp, params, ht, ct);  // first time step
+        lstmLayerStep(xWSet->at(0), Wr, b, h0, c0, Wp, params, nullptr, ht, ct);  // first time step
         for (sd::LongType t = 1; t < sL; ++t)
-          lstmLayerCell(xSet->at(t), Wx, Wr, b, ht, ct, Wp, params, ht, ct);  // rest time steps
+          lstmLayerStep(xWSet->at(t), Wr, b, ht, ct, Wp, params, nullptr, ht, ct);  // rest time steps
       } else {                                                                // seqLen is absent and h is present
 
-        lstmLayerCell(xSet->at(0), Wx, Wr, b, h0, c0, Wp, params, hSet->at(0), ct);  // first time step
+        lstmLayerStep(xWSet->at(0), Wr, b, h0, c0, Wp, params, nullptr, hSet->at(0), ct);  // first time step
         for (sd::LongType t = 1; t < sL; ++t)
-          lstmLayerCell(xSet->at(t), Wx, Wr, b, hSet->at(t - 1), ct, Wp, params, hSet->at(t), ct);  // rest time steps
+          lstmLayerStep(xWSet->at(t), Wr, b, hSet->at(t - 1), ct, Wp, params, nullptr, hSet->at(t),
+                        ct);  // rest time steps
 
         if (hL) hL->assign(hSet->at(sL - 1));  // assign last output to hL if it is not nullptr
       }
@@ -700,13 +849,13 @@ void lstmLayerTimeLoop(NDArray* x, NDArray* Wx, NDArray* Wr, NDArray* b, NDArray
             continue;
           }
 
-          auto ind = getBatchTimeTotalIndex(dataFormat, sL, bS, 0, e);
-          lstmLayerCell(xSet->at(ind), Wx, Wr, b, h0Set->at(e), c0Set->at(e), Wp, params, htSet->at(e),
+          auto ind = e;
+          lstmLayerStep(xWSet->at(ind), Wr, b, h0Set->at(e), c0Set->at(e), Wp, params, nullptr, htSet->at(e),
                         ctSet->at(e));  // first time step
 
           for (int t = 1; t < limit; ++t) {
-            ind = getBatchTimeTotalIndex(dataFormat, sL, bS, t, e);
-            lstmLayerCell(xSet->at(ind), Wx, Wr, b, htSet->at(e), ctSet->at(e), Wp, params, htSet->at(e),
+            ind = t * bS + e;
+            lstmLayerStep(xWSet->at(ind), Wr, b, htSet->at(e), ctSet->at(e), Wp, params, nullptr, htSet->at(e),
                           ctSet->at(e));  // rest time steps
           }
         }
@@ -726,13 +875,13 @@ void lstmLayerTimeLoop(NDArray* x, NDArray* Wx, NDArray* Wr, NDArray* b, NDArray
           }
 
           auto indPrev = getBatchTimeTotalIndex(dataFormat, sL, bS, 0, e);
-          lstmLayerCell(xSet->at(indPrev), Wx, Wr, b, h0Set->at(e), c0Set->at(e), Wp, params, hSet->at(indPrev),
+          lstmLayerStep(xWSet->at(e), Wr, b, h0Set->at(e), c0Set->at(e), Wp, params, nullptr, hSet->at(indPrev),
                         ctSet->at(e));  // first time step
 
           for (int t = 1; t < limit; ++t) {
             auto indCurr = getBatchTimeTotalIndex(dataFormat, sL, bS, t, e);
-            lstmLayerCell(xSet->at(indCurr), Wx, Wr, b, hSet->at(indPrev), ctSet->at(e), Wp, params, hSet->at(indCurr),
-                          ctSet->at(e));  // rest time steps
+            lstmLayerStep(xWSet->at(t * bS + e), Wr, b, hSet->at(indPrev), ctSet->at(e), Wp, params, nullptr,
+                          hSet->at(indCurr), ctSet->at(e));  // rest time steps
             indPrev = indCurr;
           }
 
@@ -749,14 +898,15 @@ void lstmLayerTimeLoop(NDArray* x, NDArray* Wx, NDArray* Wr, NDArray* b, NDArray
     if (!seqLen) {
       if (!h) {  // seqLen and h are absent
 
-        lstmLayerCell(xSet->at(sL - 1), Wx, Wr, b, h0, c0, Wp, params, ht, ct);  // first time step
+        lstmLayerStep(xWSet->at(sL - 1), Wr, b, h0, c0, Wp, params, nullptr, ht, ct);  // first time step
         for (sd::LongType t = sL - 2; t >= 0; --t)
-          lstmLayerCell(xSet->at(t), Wx, Wr, b, ht, ct, Wp, params, ht, ct);  // rest time steps
+          lstmLayerStep(xWSet->at(t), Wr, b, ht, ct, Wp, params, nullptr, ht, ct);  // rest time steps
       } else {                                                                // seqLen is absent and h is present
 
-        lstmLayerCell(xSet->at(sL - 1), Wx, Wr, b, h0, c0, Wp, params, hSet->at(sL - 1), ct);  // first time step
+        lstmLayerStep(xWSet->at(sL - 1), Wr, b, h0, c0, Wp, params, nullptr, hSet->at(sL - 1), ct);  // first time step
         for (sd::LongType t = sL - 2; t >= 0; --t)
-          lstmLayerCell(xSet->at(t), Wx, Wr, b, hSet->at(t + 1), ct, Wp, params, hSet->at(t), ct);  // rest time steps
+          lstmLayerStep(xWSet->at(t), Wr, b, hSet->at(t + 1), ct, Wp, params, nullptr, hSet->at(t),
+                        ct);  // rest time steps
 
         if (hL) hL->assign(hSet->at(0));  // assign last output to hL if it is not nullptr
       }
@@ -773,13 +923,13 @@ void lstmLayerTimeLoop(NDArray* x, NDArray* Wx, NDArray* Wr, NDArray* b, NDArray
             continue;
           }
 
-          auto ind = getBatchTimeTotalIndex(dataFormat, sL, bS, sL - 1, e);
-          lstmLayerCell(xSet->at(ind), Wx, Wr, b, h0Set->at(e), c0Set->at(e), Wp, params, htSet->at(e),
+          auto ind = (sL - 1) * bS + e;
+          lstmLayerStep(xWSet->at(ind), Wr, b, h0Set->at(e), c0Set->at(e), Wp, params, nullptr, htSet->at(e),
                         ctSet->at(e));  // first time step
 
           for (sd::LongType t = sL - 2; t >= sL - limit; --t) {
-            ind = getBatchTimeTotalIndex(dataFormat, sL, bS, t, e);
-            lstmLayerCell(xSet->at(ind), Wx, Wr, b, htSet->at(e), ctSet->at(e), Wp, params, htSet->at(e),
+            ind = t * bS + e;
+            lstmLayerStep(xWSet->at(ind), Wr, b, htSet->at(e), ctSet->at(e), Wp, params, nullptr, htSet->at(e),
                           ctSet->at(e));  // rest time steps
           }
         }
@@ -799,13 +949,13 @@ void lstmLayerTimeLoop(NDArray* x, NDArray* Wx, NDArray* Wr, NDArray* b, NDArray
           }
 
           auto indPrev = getBatchTimeTotalIndex(dataFormat, sL, bS, sL - 1, e);
-          lstmLayerCell(xSet->at(indPrev), Wx, Wr, b, h0Set->at(e), c0Set->at(e), Wp, params, hSet->at(indPrev),
-                        ctSet->at(e));  // first time step
+          lstmLayerStep(xWSet->at((sL - 1) * bS + e), Wr, b, h0Set->at(e), c0Set->at(e), Wp, params, nullptr,
+                        hSet->at(indPrev), ctSet->at(e));  // first time step
 
           for (sd::LongType t = sL - 2; t >= sL - limit; --t) {
             auto indCurr = getBatchTimeTotalIndex(dataFormat, sL, bS, t, e);
-            lstmLayerCell(xSet->at(indCurr), Wx, Wr, b, hSet->at(indPrev), ctSet->at(e), Wp, params, hSet->at(indCurr),
-                          ctSet->at(e));  // rest time steps
+            lstmLayerStep(xWSet->at(t * bS + e), Wr, b, hSet->at(indPrev), ctSet->at(e), Wp, params, nullptr,
+                          hSet->at(indCurr), ctSet->at(e));  // rest time steps
             indPrev = indCurr;
           }
 
@@ -829,13 +979,13 @@ void lstmLayerTimeLoop(NDArray* x, NDArray* Wx, NDArray* Wr, NDArray* b, NDArray
             continue;
           }
 
-          auto ind = getBatchTimeTotalIndex(dataFormat, sL, bS, limit - 1, e);
-          lstmLayerCell(xSet->at(ind), Wx, Wr, b, h0Set->at(e), c0Set->at(e), Wp, params, htSet->at(e),
+          auto ind = (limit - 1) * bS + e;
+          lstmLayerStep(xWSet->at(ind), Wr, b, h0Set->at(e), c0Set->at(e), Wp, params, nullptr, htSet->at(e),
                         ctSet->at(e));  // first time step
 
           for (int t = limit - 2; t >= 0; --t) {
-            ind = getBatchTimeTotalIndex(dataFormat, sL, bS, t, e);
-            lstmLayerCell(xSet->at(ind), Wx, Wr, b, htSet->at(e), ctSet->at(e), Wp, params, htSet->at(e),
+            ind = t * bS + e;
+            lstmLayerStep(xWSet->at(ind), Wr, b, htSet->at(e), ctSet->at(e), Wp, params, nullptr, htSet->at(e),
                           ctSet->at(e));  // rest time steps
           }
         }
@@ -855,13 +1005,13 @@ void lstmLayerTimeLoop(NDArray* x, NDArray* Wx, NDArray* Wr, NDArray* b, NDArray
           }
 
           auto indPrev = getBatchTimeTotalIndex(dataFormat, sL, bS, limit - 1, e);
-          lstmLayerCell(xSet->at(indPrev), Wx, Wr, b, h0Set->at(e), c0Set->at(e), Wp, params, hSet->at(indPrev),
-                        ctSet->at(e));  // first time step
+          lstmLayerStep(xWSet->at((limit - 1) * bS + e), Wr, b, h0Set->at(e), c0Set->at(e), Wp, params, nullptr,
+                        hSet->at(indPrev), ctSet->at(e));  // first time step
 
           for (int t = limit - 2; t >= 0; --t) {
             auto indCurr = getBatchTimeTotalIndex(dataFormat, sL, bS, t, e);
-            lstmLayerCell(xSet->at(indCurr), Wx, Wr, b, hSet->at(indPrev), ctSet->at(e), Wp, params, hSet->at(indCurr),
-                          ctSet->at(e));  // rest time steps
+            lstmLayerStep(xWSet->at(t * bS + e), Wr, b, hSet->at(indPrev), ctSet->at(e), Wp, params, nullptr,
+                          hSet->at(indCurr), ctSet->at(e));  // rest time steps
             indPrev = indCurr;
           }
 
@@ -875,7 +1025,7 @@ void lstmLayerTimeLoop(NDArray* x, NDArray* Wx, NDArray* Wr, NDArray* b, NDArray
     }
   }
 
-  delete xSet;
+  delete xWSet;
   delete hSet;
   delete h0Set;
   delete c0Set;
@@ -939,25 +1089,29 @@ void lstmLayerTimeLoopBp(NDArray* x, NDArray* Wx, NDArray* Wr, NDArray* b, NDArr
                         x->getContext());  // this constructor nullifies array automatically
 
   std::vector<LongType> zShape = {sL, bS, 4 * nOut};
-  NDArray z(x->ordering(), zShape, type, x->getContext());
+  NDArray z('c', zShape, type, x->getContext());
   NDArray *zUlike2 = z.ulike();
   NDArray a = *zUlike2;
+  NDArray dLdz('c', zShape, type, x->getContext());  // this constructor nullifies array automatically
   std::vector<LongType> hShape = {sL + 1, bS, nOut};
   NDArray h(x->ordering(), hShape, type, x->getContext());
   NDArray *hUlike = h.ulike();
   NDArray c = *hUlike;
 
+  // input projection x × Wx for all time steps by one gemm, stored time major [sL, bS, 4*nOut]
+  NDArray* xRows = timeMajorRows(x, dataFormat, type);  // [sL*bS, nIn]
+  inputProjection(xRows, Wx, &z);
+
   // create sets of required (depends on seqLen presence) sub-arrays
   std::vector<sd::LongType> *dims;
-  ResultSet *xSet(nullptr), *dLdxSet(nullptr), *hSet(nullptr), *cSet(nullptr), *zSet(nullptr), *aSet(nullptr),
+  ResultSet *dLdzSet(nullptr), *hSet(nullptr), *cSet(nullptr), *zSet(nullptr), *aSet(nullptr),
       *dLdhSet(nullptr), *dLdh0Set(nullptr), *dLdc0Set(nullptr), *dLdhLSet(nullptr), *dLdcLSet(nullptr),
       *hISet(nullptr), *cISet(nullptr);
 
   if (!seqLen) {
     std::vector<sd::LongType> dim =  {dataFormat < 3 ? dataFormat : 0};
     dims = ShapeUtils::evalDimsToExclude(x->rankOf(),dim.size(),dim.data());  // points on [bS, nIn/nOut]
-    xSet = new ResultSet(x->allTensorsAlongDimension(*dims));                  // sub-arrays with shape [bS, nIn]
-    dLdxSet = new ResultSet(dLdx->allTensorsAlongDimension(*dims));            // sub-arrays with shape [bS, nIn]
+    dLdzSet = new ResultSet(dLdz.allTensorsAlongDimension({1, 2}));           // sub-arrays with shape [bS, 4*nOut]
     hSet = new ResultSet(h.allTensorsAlongDimension({1, 2}));                 // sub-arrays with shape [bS, nOut]
     cSet = new ResultSet(c.allTensorsAlongDimension({1, 2}));                 // sub-arrays with shape [bS, nOut]
     zSet = new ResultSet(z.allTensorsAlongDimension({1, 2}));                 // sub-arrays with shape [bS, 4*nOut]
@@ -967,8 +1121,7 @@ void lstmLayerTimeLoopBp(NDArray* x, NDArray* Wx, NDArray* Wr, NDArray* b, NDArr
   } else {
     dims = dataFormat == 2 ? new std::vector<sd::LongType>({1}) : new std::vector<sd::LongType>({2});  // points on nIn/nOut axis
 
-    xSet = new ResultSet(x->allTensorsAlongDimension(*dims));        // sub-arrays with shape [nIn]
-    dLdxSet = new ResultSet(dLdx->allTensorsAlongDimension(*dims));  // sub-arrays with shape [nIn]
+    dLdzSet = new ResultSet(dLdz.allTensorsAlongDimension({2}));    // sub-arrays with shape [4*nOut]
     hSet = new ResultSet(h.allTensorsAlongDimension({2}));          // sub-arrays with shape [nOut]
     cSet = new ResultSet(c.allTensorsAlongDimension({2}));          // sub-arrays with shape [nOut]
     zSet = new ResultSet(z.allTensorsAlongDimension({2}));          // sub-arrays with shape [4*nOut]
@@ -1002,8 +1155,8 @@ void lstmLayerTimeLoopBp(NDArray* x, NDArray* Wx, NDArray* Wr, NDArray* b, NDArr
 
       // ff
       for (sd::LongType t = 0; t < sL; ++t) {
-        lstmLayerCell(xSet->at(t), Wx, Wr, b, hSet->at(t), cSet->at(t), Wp, params, zSet->at(t), aSet->at(t),
-                      hSet->at(t + 1), cSet->at(t + 1));
+        lstmLayerStep(zSet->at(t), Wr, b, hSet->at(t), cSet->at(t), Wp, params, aSet->at(t), hSet->at(t + 1),
+                      cSet->at(t + 1));
       }
 
       // bp
@@ -1012,8 +1165,8 @@ void lstmLayerTimeLoopBp(NDArray* x, NDArray* Wx, NDArray* Wr, NDArray* b, NDArr
         NDArray* dLdhh = dLdh ? dLdhSet->at(t) : nullptr;
         NDArray* dLdhhL = (t == sL - 1 && dLdhL) ? dLdhL : nullptr;
         NDArray* dLdccL = (t == sL - 1 && dLdcL) ? dLdcL : nullptr;
-        lstmLayerCellBp(xSet->at(t), Wx, Wr, b, hSet->at(t), cSet->at(t), Wp, dLdhh, dLdhhL, dLdccL, zSet->at(t),
-                        aSet->at(t), cSet->at(t + 1), params, dLdxSet->at(t), dLdWx, dLdWr, dLdh0, dLdc0, dLdb, dLdWp);
+        lstmLayerCellBpRecurrent(Wr, hSet->at(t), cSet->at(t), Wp, dLdhh, dLdhhL, dLdccL, zSet->at(t), aSet->at(t),
+                                 cSet->at(t + 1), params, dLdzSet->at(t), dLdWr, dLdh0, dLdc0, dLdWp);
 
       }
 
@@ -1024,11 +1177,7 @@ void lstmLayerTimeLoopBp(NDArray* x, NDArray* Wx, NDArray* Wr, NDArray* b, NDArr
       for (sd::LongType e = 0; e < bS; ++e) {
         const sd::LongType limit = seqLen->e<sd::LongType>(e);
 
-        if (limit == 0) {
-          tensorAlongTimeBatchDims(*dLdx, dataFormat, 0, 0, e, e + 1)
-              .nullify();  // nullify for given e and whole time range
-          continue;
-        }
+        if (limit == 0) continue;  // dLdz stays zero for given e, and so does dLdx
 
         if (hI)
           hSet->at(e)->assign(hISet->at(e));
@@ -1041,9 +1190,8 @@ void lstmLayerTimeLoopBp(NDArray* x, NDArray* Wx, NDArray* Wr, NDArray* b, NDArr
 
         // ff
         for (sd::LongType t = 0; t < limit; ++t) {
-          lstmLayerCell(xSet->at(getBatchTimeTotalIndex(dataFormat, sL, bS, t, e)), Wx, Wr, b, hSet->at(t * bS + e),
-                        cSet->at(t * bS + e), Wp, params, zSet->at(t * bS + e), aSet->at(t * bS + e),
-                        hSet->at((t + 1) * bS + e), cSet->at((t + 1) * bS + e));
+          lstmLayerStep(zSet->at(t * bS + e), Wr, b, hSet->at(t * bS + e), cSet->at(t * bS + e), Wp, params,
+                        aSet->at(t * bS + e), hSet->at((t + 1) * bS + e), cSet->at((t + 1) * bS + e));
         }
         // bp
         for (sd::LongType t = limit - 1; t >= 0; --t) {
@@ -1051,14 +1199,10 @@ void lstmLayerTimeLoopBp(NDArray* x, NDArray* Wx, NDArray* Wr, NDArray* b, NDArr
           NDArray* dLdhh = dLdh ? dLdhSet->at(ind) : nullptr;
           NDArray* dLdhhL = (t == limit - 1 && dLdhL) ? dLdhLSet->at(e) : nullptr;
           NDArray* dLdccL = (t == limit - 1 && dLdcL) ? dLdcLSet->at(e) : nullptr;
-          lstmLayerCellBp(xSet->at(ind), Wx, Wr, b, hSet->at(t * bS + e), cSet->at(t * bS + e), Wp, dLdhh, dLdhhL,
-                          dLdccL, zSet->at(t * bS + e), aSet->at(t * bS + e), cSet->at((t + 1) * bS + e), params,
-                          dLdxSet->at(ind), dLdWx, dLdWr, dLdh0Set->at(e), dLdc0Set->at(e), dLdb, dLdWp);
+          lstmLayerCellBpRecurrent(Wr, hSet->at(t * bS + e), cSet->at(t * bS + e), Wp, dLdhh, dLdhhL, dLdccL,
+                                   zSet->at(t * bS + e), aSet->at(t * bS + e), cSet->at((t + 1) * bS + e), params,
+                                   dLdzSet->at(t * bS + e), dLdWr, dLdh0Set->at(e), dLdc0Set->at(e), dLdWp);
         }
-
-        if (limit != sL)
-          tensorAlongTimeBatchDims(*dLdx, dataFormat, limit, sL, e, e + 1)
-              .nullify();  // nullify for given e and time range [limit, sL)
       }
 
     }
@@ -1077,8 +1221,8 @@ void lstmLayerTimeLoopBp(NDArray* x, NDArray* Wx, NDArray* Wr, NDArray* b, NDArr
 
       // ff
       for (sd::LongType t = sL - 1; t >= 0; --t) {
-        lstmLayerCell(xSet->at(t), Wx, Wr, b, hSet->at(t + 1), cSet->at(t + 1), Wp, params, zSet->at(t), aSet->at(t),
-                      hSet->at(t), cSet->at(t));
+        lstmLayerStep(zSet->at(t), Wr, b, hSet->at(t + 1), cSet->at(t + 1), Wp, params, aSet->at(t), hSet->at(t),
+                      cSet->at(t));
       }
 
       // bp
@@ -1086,9 +1230,8 @@ void lstmLayerTimeLoopBp(NDArray* x, NDArray* Wx, NDArray* Wr, NDArray* b, NDArr
         NDArray* dLdhh = dLdh ? dLdhSet->at(t) : nullptr;
         NDArray* dLdhhL = (t == 0 && dLdhL) ? dLdhL : nullptr;
         NDArray* dLdccL = (t == 0 && dLdcL) ? dLdcL : nullptr;
-        lstmLayerCellBp(xSet->at(t), Wx, Wr, b, hSet->at(t + 1), cSet->at(t + 1), Wp, dLdhh, dLdhhL, dLdccL,
-                        zSet->at(t), aSet->at(t), cSet->at(t), params, dLdxSet->at(t), dLdWx, dLdWr, dLdh0, dLdc0, dLdb,
-                        dLdWp);
+        lstmLayerCellBpRecurrent(Wr, hSet->at(t + 1), cSet->at(t + 1), Wp, dLdhh, dLdhhL, dLdccL, zSet->at(t),
+                                 aSet->at(t), cSet->at(t), params, dLdzSet->at(t), dLdWr, dLdh0, dLdc0, dLdWp);
       }
 
 
@@ -1098,11 +1241,7 @@ void lstmLayerTimeLoopBp(NDArray* x, NDArray* Wx, NDArray* Wr, NDArray* b, NDArr
       for (sd::LongType e = 0; e < bS; ++e) {
         const sd::LongType limit = seqLen->e<sd::LongType>(e);
 
-        if (limit == 0) {
-          tensorAlongTimeBatchDims(*dLdx, dataFormat, 0, 0, e, e + 1)
-              .nullify();  // nullify for given e and whole time range
-          continue;
-        }
+        if (limit == 0) continue;  // dLdz stays zero for given e, and so does dLdx
 
         if (hI)
           hSet->at(sL * bS + e)->assign(hISet->at(e));
@@ -1115,8 +1254,7 @@ void lstmLayerTimeLoopBp(NDArray* x, NDArray* Wx, NDArray* Wr, NDArray* b, NDArr
 
         // ff
         for (int t = sL - 1; t >= sL - limit; --t)
-          lstmLayerCell(xSet->at(getBatchTimeTotalIndex(dataFormat, sL, bS, t, e)), Wx, Wr, b,
-                        hSet->at((t + 1) * bS + e), cSet->at((t + 1) * bS + e), Wp, params, zSet->at(t * bS + e),
+          lstmLayerStep(zSet->at(t * bS + e), Wr, b, hSet->at((t + 1) * bS + e), cSet->at((t + 1) * bS + e), Wp, params,
                         aSet->at(t * bS + e), hSet->at(t * bS + e), cSet->at(t * bS + e));
 
         // bp
@@ -1125,14 +1263,10 @@ void lstmLayerTimeLoopBp(NDArray* x, NDArray* Wx, NDArray* Wr, NDArray* b, NDArr
           NDArray* dLdhh = dLdh ? dLdhSet->at(ind) : nullptr;
           NDArray* dLdhhL = (t == sL - limit && dLdhL) ? dLdhLSet->at(e) : nullptr;
           NDArray* dLdccL = (t == sL - limit && dLdcL) ? dLdcLSet->at(e) : nullptr;
-          lstmLayerCellBp(xSet->at(ind), Wx, Wr, b, hSet->at((t + 1) * bS + e), cSet->at((t + 1) * bS + e), Wp, dLdhh,
-                          dLdhhL, dLdccL, zSet->at(t * bS + e), aSet->at(t * bS + e), cSet->at(t * bS + e), params,
-                          dLdxSet->at(ind), dLdWx, dLdWr, dLdh0Set->at(e), dLdc0Set->at(e), dLdb, dLdWp);
+          lstmLayerCellBpRecurrent(Wr, hSet->at((t + 1) * bS + e), cSet->at((t + 1) * bS + e), Wp, dLdhh, dLdhhL,
+                                   dLdccL, zSet->at(t * bS + e), aSet->at(t * bS + e), cSet->at(t * bS + e), params,
+                                   dLdzSet->at(t * bS + e), dLdWr, dLdh0Set->at(e), dLdc0Set->at(e), dLdWp);
         }
-
-        if (limit != sL)
-          tensorAlongTimeBatchDims(*dLdx, dataFormat, 0, sL - limit, e, e + 1)
-              .nullify();  // nullify for given e and time range [limit, sL)
       }
 
 
@@ -1141,11 +1275,7 @@ void lstmLayerTimeLoopBp(NDArray* x, NDArray* Wx, NDArray* Wr, NDArray* b, NDArr
       for (sd::LongType e = 0; e < bS; ++e) {
         const int limit = seqLen->e<sd::LongType>(e);
 
-        if (limit == 0) {
-          tensorAlongTimeBatchDims(*dLdx, dataFormat, 0, 0, e, e + 1)
-              .nullify();  // nullify for given e and whole time range
-          continue;
-        }
+        if (limit == 0) continue;  // dLdz stays zero for given e, and so does dLdx
 
         if (hI)
           h({limit, limit + 1, e, e + 1, 0, 0}).assign(hISet->at(e));
@@ -1158,8 +1288,7 @@ void lstmLayerTimeLoopBp(NDArray* x, NDArray* Wx, NDArray* Wr, NDArray* b, NDArr
 
         // ff
         for (int t = limit - 1; t >= 0; --t)
-          lstmLayerCell(xSet->at(getBatchTimeTotalIndex(dataFormat, sL, bS, t, e)), Wx, Wr, b,
-                        hSet->at((t + 1) * bS + e), cSet->at((t + 1) * bS + e), Wp, params, zSet->at(t * bS + e),
+          lstmLayerStep(zSet->at(t * bS + e), Wr, b, hSet->at((t + 1) * bS + e), cSet->at((t + 1) * bS + e), Wp, params,
                         aSet->at(t * bS + e), hSet->at(t * bS + e), cSet->at(t * bS + e));
 
         // bp
@@ -1168,22 +1297,40 @@ void lstmLayerTimeLoopBp(NDArray* x, NDArray* Wx, NDArray* Wr, NDArray* b, NDArr
           NDArray* dLdhh = dLdh ? dLdhSet->at(ind) : nullptr;
           NDArray* dLdhhL = (t == 0 && dLdhL) ? dLdhLSet->at(e) : nullptr;
           NDArray* dLdccL = (t == 0 && dLdcL) ? dLdcLSet->at(e) : nullptr;
-          lstmLayerCellBp(xSet->at(ind), Wx, Wr, b, hSet->at((t + 1) * bS + e), cSet->at((t + 1) * bS + e), Wp, dLdhh,
-                          dLdhhL, dLdccL, zSet->at(t * bS + e), aSet->at(t * bS + e), cSet->at(t * bS + e), params,
-                          dLdxSet->at(ind), dLdWx, dLdWr, dLdh0Set->at(e), dLdc0Set->at(e), dLdb, dLdWp);
+          lstmLayerCellBpRecurrent(Wr, hSet->at((t + 1) * bS + e), cSet->at((t + 1) * bS + e), Wp, dLdhh, dLdhhL,
+                                   dLdccL, zSet->at(t * bS + e), aSet->at(t * bS + e), cSet->at(t * bS + e), params,
+                                   dLdzSet->at(t * bS + e), dLdWr, dLdh0Set->at(e), dLdc0Set->at(e), dLdWp);
         }
-
-        if (limit != sL)
-          tensorAlongTimeBatchDims(*dLdx, dataFormat, limit, sL, e, e + 1)
-              .nullify();  // nullify for given e and time range [limit, sL)
       }
 
 
     }
   }
 
-  delete xSet;
-  delete dLdxSet;
+  // dLdx, dLdWx and dLdb depend on dLdz only, evaluate them for all time steps at once
+  std::vector<sd::LongType> dLdzRowsShape = {sL * bS, 4 * nOut};
+  NDArray& dLdzRows = dLdz.reshape('c', dLdzRowsShape, false);  // [sL*bS, 4*nOut]
+
+  // dLdx
+  std::vector<sd::LongType> dLdxRowsShape = {sL * bS, xRows->sizeAt(1)};
+  NDArray dLdxRows('c', dLdxRowsShape, dLdx->dataType(), x->getContext());
+  NDArray WxT = Wx->transpose();
+  MmulHelper::mmul(&dLdzRows, &WxT, &dLdxRows);  // [sL*bS, 4*nOut] x [4*nOut, nIn] = [sL*bS, nIn]
+  fromTimeMajorRows(&dLdxRows, dataFormat, dLdx);
+
+  // dLdWx
+  NDArray xRowsT = xRows->transpose();
+  MmulHelper::mmul(&xRowsT, &dLdzRows, dLdWx, 1.0, 1.0);  // [nIn, sL*bS] x [sL*bS, 4*nOut] = [nIn, 4*nOut]
+
+  // dLdb
+  if (b) {
+    std::vector<sd::LongType> reduceDims = {0};
+    *dLdb += dLdzRows.reduceAlongDimension(reduce::Sum, &reduceDims);  // [sL*bS, 4*nOut] -> reduce -> [4*nOut]
+  }
+
+  delete &dLdzRows;
+  delete xRows;
+  delete dLdzSet;
   delete hSet;
   delete cSet;
   delete aSet;
@@ -25,26 +25,31 @@
 
 #include <execution/Threads.h>
 #include <graph/Variable.h>
+#include <helpers/UniqueEngine.h>
 #include <ops/declarable/helpers/unique.h>
 
+#include <memory>
+
 namespace sd {
 namespace ops {
 namespace helpers {
 
+// input is deduplicated as flat 'c' buffer, anything else is copied once
+static NDArray* uniqueInput(NDArray* input, std::unique_ptr<NDArray>& copy) {
+  if (input->ordering() == 'c' && shape::isDense(input->shapeInfo())) return input;
+  copy.reset(new NDArray(input->dup('c')));
+  return copy.get();
+}
+
 template <typename T>
 static LongType uniqueCount_(NDArray* input) {
-  LongType count = 0;
+  std::unique_ptr<NDArray> copy;
+  auto x = uniqueInput(input, copy);
 
-  std::vector<T> values;
+  std::vector<LongType> firsts, counts;
+  dedup::uniqueOf(x->bufferAsT<T>(), x->lengthOf(), nullptr, firsts, counts);
 
-  for (LongType e = 0; e < input->lengthOf(); e++) {
-    T v = input->e<T>(e);
-    if (std::find(values.begin(), values.end(), v) == values.end()) {
-      values.push_back(v);
-      count++;
-    }
-  }
-  return count;
+  return static_cast<LongType>(firsts.size());
 }
 
 LongType uniqueCount(LaunchContext* context, NDArray* input) {
@@ -56,38 +61,36 @@ BUILD_SINGLE_TEMPLATE(template sd::LongType uniqueCount_, (NDArray * input), SD_
 
 template <typename T>
 static Status uniqueFunctor_(NDArray* input, NDArray* values, NDArray* indices, NDArray* counts) {
-  std::vector<T> valuesVector;
-  SD_MAP_IMPL<T, int> indicesMap;
-  SD_MAP_IMPL<T, int> countsMap;
-
-  for (LongType e = 0; e < input->lengthOf(); e++) {
-    T v = input->e<T>(e);
-    if (std::find(valuesVector.begin(), valuesVector.end(), v) == valuesVector.end()) {
-      valuesVector.push_back(v);
-      indicesMap[v] = e;
-      countsMap[v] = 1;
-    } else {
-      countsMap[v]++;
-    }
-  }
+  std::unique_ptr<NDArray> copy;
+  auto x = uniqueInput(input, copy);
+  const auto xBuf = x->bufferAsT<T>();
+  const LongType length = x->lengthOf();
+
+  const bool denseIndices = indices->dataType() == INT64 && indices->ordering() == 'c' &&
+                            shape::isDense(indices->shapeInfo());
+  std::vector<LongType> ownIds(denseIndices ? 0 : length);
+  LongType* ids = denseIndices ? indices->bufferAsT<LongType>() : ownIds.data();
+
+  std::vector<LongType> firsts, occurrences;
+  dedup::uniqueOf(xBuf, length, ids, firsts, occurrences);
 
   auto func = PRAGMA_THREADS_FOR {
     for (auto e = start; e < stop; e++) {
-      values->p(e, static_cast<T>(valuesVector[e]));
-      if (counts != nullptr) counts->p(e, countsMap[valuesVector[e]]);
+      values->p(e, xBuf[firsts[e]]);
+      if (counts != nullptr) counts->p(e, occurrences[e]);
     }
   };
   samediff::Threads::parallel_for(func, 0, values->lengthOf());
 
-  for (LongType e = 0; e < indices->lengthOf(); e++) {
-    auto posI = std::find(valuesVector.begin(), valuesVector.end(), input->e<T>(e));
-    auto dist = std::distance(valuesVector.begin(), posI);
-    indices->p(e, LongType(dist));  // indicesMap[(*input)(e)];
+  if (!denseIndices) {
+    auto copyIds = PRAGMA_THREADS_FOR {
+      for (auto e = start; e < stop; e++) indices->p(e, ids[e]);
+    };
+    samediff::Threads::parallel_for(copyIds, 0, indices->lengthOf());
   }
 
   return Status::OK;
 }
-
 Status uniqueFunctor(LaunchContext* context, NDArray* input, NDArray* values, NDArray* indices,
                          NDArray* counts) {
   input->syncToHost();
@@ -33,6 +33,10 @@ namespace helpers {
 SD_LIB_HIDDEN void percentile(LaunchContext* context, NDArray& input, NDArray& output,
                               std::vector<LongType>& axises, const float q, const int interpolation);
 
+// output holds percentiles for every q, stacked along its leading dimension
+SD_LIB_HIDDEN void percentile(LaunchContext* context, NDArray& input, NDArray& output,
+                              std::vector<LongType>& axises, const std::vector<float>& q, const int interpolation);
+
 }
 }  // namespace ops
 }  // namespace sd
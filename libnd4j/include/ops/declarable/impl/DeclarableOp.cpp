@@ -26,6 +26,7 @@
 #include <helpers/ShapeUtils.h>
 #include <helpers/StringUtils.h>
 #include <ops/declarable/DeclarableOp.h>
+#include <ops/declarable/ExecutionPlan.h>
 #include <ops/declarable/OpRegistrator.h>
 
 #include <cstdarg>
@@ -651,16 +652,41 @@ sd::Status sd::ops::DeclarableOp::execute(Context *block) {
   sd::LongType memoryBefore =
       block->workspace() == nullptr ? 0L : block->workspace()->getSpilledSize() + block->workspace()->getUsedSize();
   if (Environment::getInstance().isProfiling()) timeEnter = std::chrono::system_clock::now();
-  // basic validation: ensure inputs are set
-  REQUIRE_OK(this->validateNonEmptyInput(*block));
 
-  // ensure number of IArgs, TArgs match our expectations
-  REQUIRE_OK(this->validateArguments(*block));
-  // validating data types for inputs and (optionally) outputs
-  REQUIRE_OK(this->validateDataTypes(*block));
+  // execution plans are used for fast path calls only, profiling and verbose mode need every step to be executed
+  std::vector<sd::LongType> signature;
+  const bool usePlan = Environment::getInstance().isExecutionPlans() && block->isFastPath() &&
+                       !Environment::getInstance().isProfiling() && !Environment::getInstance().isDebugAndVerbose() &&
+                       ExecutionPlanCache::buildSignature(this->getOpHash(), *block, signature);
+  auto plan = usePlan ? ExecutionPlanCache::getInstance().lookup(signature) : nullptr;
+
+  int numOutputs;
+  bool outputShapesKnown = false;
+  if (plan != nullptr) {
+    // this call signature was validated before
+    if (plan->hasOutputShapes()) {
+      plan->allocateOutputs(*block);
+      numOutputs = plan->numOutputs;
+    } else {
+      numOutputs = this->prepareOutputs(*block);
+    }
+  } else {
+    // basic validation: ensure inputs are set
+    REQUIRE_OK(this->validateNonEmptyInput(*block));
 
-  // this method will allocate output NDArrays for this op
-  auto numOutputs = this->prepareOutputs(*block);
+    // ensure number of IArgs, TArgs match our expectations
+    REQUIRE_OK(this->validateArguments(*block));
+    // validating data types for inputs and (optionally) outputs
+    REQUIRE_OK(this->validateDataTypes(*block));
+
+    // this method will allocate output NDArrays for this op
+    block->resetInputsAccessed();
+    numOutputs = this->prepareOutputs(*block);
+
+    // output shapes can be reused only if shape function had nothing but input shapes and arguments to look at
+    outputShapesKnown = !block->inputsAccessed() && !block->isInplace() && !block->shapeFunctionOverride() &&
+                        block->fastpath_out().size() >= static_cast<size_t>(numOutputs);
+  }
 
 
   if (Environment::getInstance().isProfiling()) {
@@ -670,17 +696,36 @@ sd::Status sd::ops::DeclarableOp::execute(Context *block) {
 
   sd::Status status;
   bool hasHelper = false;
+  platforms::PlatformHelper *helper = nullptr;
 
-  // platform helpers use might be forbidden for various reasons, so we'll check it out first
-  if (block->helpersAllowed() && sd::Environment::getInstance().helpersAllowed()) {
+  if (plan != nullptr) {
+    helper = plan->helper;
+  } else if (block->helpersAllowed() && sd::Environment::getInstance().helpersAllowed()) {
+    // platform helpers use might be forbidden for various reasons, so we'll check it out first
     // if we have platform-specific helper for this op - invoke it
     if (OpRegistrator::getInstance().hasHelper(this->getOpHash(), block->engine())) {
-      auto helper = OpRegistrator::getInstance().getPlatformHelper(this->getOpHash(), block->engine());
-      if (helper->isUsable(*block)) {
-        status = helper->invokeHelper(*block);
-        hasHelper = true;
+      auto candidate = OpRegistrator::getInstance().getPlatformHelper(this->getOpHash(), block->engine());
+      if (candidate->isUsable(*block)) helper = candidate;
+    }
+  }
+
+  if (usePlan && plan == nullptr) {
+    auto newPlan = std::make_shared<ExecutionPlan>();
+    newPlan->numOutputs = numOutputs;
+    newPlan->helper = helper;
+    if (outputShapesKnown) {
+      for (int e = 0; e < numOutputs; e++) {
+        auto shapeInfo = block->fastpath_out()[e]->shapeInfo();
+        newPlan->outputShapes.emplace_back(shapeInfo, shapeInfo + shape::shapeInfoLength(shapeInfo));
       }
     }
+
+    ExecutionPlanCache::getInstance().store(signature, newPlan);
+  }
+
+  if (helper != nullptr) {
+    status = helper->invokeHelper(*block);
+    hasHelper = true;
   }
 
 
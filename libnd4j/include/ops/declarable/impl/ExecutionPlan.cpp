@@ -0,0 +1,160 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Execution plans cache for DeclarableOp::execute(Context*)
+//
+#include <ops/declarable/ExecutionPlan.h>
+
+#include <cstring>
+
+namespace sd {
+namespace ops {
+
+void ExecutionPlan::allocateOutputs(graph::Context& block) const {
+  for (size_t e = block.fastpath_out().size(); e < outputShapes.size(); e++) {
+    // NDArray takes shape info by non-const pointer, it's copied into constant shape cache anyway
+    std::vector<LongType> shapeInfo(outputShapes[e]);
+    auto outArr = new NDArray(shapeInfo.data(), true, block.launchContext());
+    block.setOutputArray(static_cast<int>(e), outArr, true);
+  }
+}
+
+size_t ExecutionPlanCache::SignatureHash::operator()(const std::vector<LongType>& signature) const {
+  uint64_t hash = 14695981039346656037ULL;
+  for (const auto v : signature) {
+    hash ^= static_cast<uint64_t>(v);
+    hash *= 0x9e3779b97f4a7c15ULL;
+    hash ^= hash >> 32;
+  }
+
+  return static_cast<size_t>(hash);
+}
+
+ExecutionPlanCache& ExecutionPlanCache::getInstance() {
+  static ExecutionPlanCache instance;
+  return instance;
+}
+
+static void appendShapeInfo(NDArray* array, std::vector<LongType>& signature) {
+  auto shapeInfo = array->shapeInfo();
+  const auto length = shape::shapeInfoLength(shapeInfo);
+
+  signature.push_back(length);
+  signature.insert(signature.end(), shapeInfo, shapeInfo + length);
+}
+
+bool ExecutionPlanCache::buildSignature(LongType opHash, graph::Context& block, std::vector<LongType>& signature) {
+  signature.clear();
+
+  signature.push_back(opHash);
+  signature.push_back(block.opNum());
+  signature.push_back(static_cast<LongType>(block.engine()));
+  signature.push_back(static_cast<LongType>(block.executionMode()));
+  signature.push_back(block.helpersAllowed() && Environment::getInstance().helpersAllowed());
+  signature.push_back(block.isUseONEDNN());
+  signature.push_back(block.isInplace());
+  signature.push_back(block.shapeFunctionOverride());
+
+  // inputs, and outputs given by caller
+  signature.push_back(static_cast<LongType>(block.fastpath_in().size()));
+  for (auto array : block.fastpath_in()) {
+    if (array == nullptr) return false;
+    appendShapeInfo(array, signature);
+  }
+
+  signature.push_back(static_cast<LongType>(block.fastpath_out().size()));
+  for (auto array : block.fastpath_out()) {
+    if (array == nullptr) return false;
+    appendShapeInfo(array, signature);
+  }
+
+  // arguments
+  auto iArgs = block.getIArguments();
+  signature.push_back(static_cast<LongType>(iArgs->size()));
+  signature.insert(signature.end(), iArgs->begin(), iArgs->end());
+
+  auto tArgs = block.getTArguments();
+  signature.push_back(static_cast<LongType>(tArgs->size()));
+  for (const auto t : *tArgs) {
+    LongType bits;
+    std::memcpy(&bits, &t, sizeof(bits));
+    signature.push_back(bits);
+  }
+
+  auto bArgs = block.getBArguments();
+  signature.push_back(static_cast<LongType>(bArgs->size()));
+  for (const auto b : *bArgs) signature.push_back(b);
+
+  auto dArgs = block.getDArguments();
+  signature.push_back(static_cast<LongType>(dArgs->size()));
+  for (const auto d : *dArgs) signature.push_back(static_cast<LongType>(d));
+
+  auto sArgs = block.getSArguments();
+  signature.push_back(static_cast<LongType>(sArgs->size()));
+  for (const auto& s : *sArgs) {
+    signature.push_back(static_cast<LongType>(s.size()));
+    for (const auto c : s) signature.push_back(c);
+  }
+
+  auto axis = block.getAxis();
+  signature.push_back(static_cast<LongType>(axis->size()));
+  signature.insert(signature.end(), axis->begin(), axis->end());
+
+  return true;
+}
+
+std::shared_ptr<const ExecutionPlan> ExecutionPlanCache::lookup(const std::vector<LongType>& signature) {
+  SHARED_LOCK_TYPE<MUTEX_TYPE> lock(_lock);
+
+  auto it = _plans.find(signature);
+  if (it == _plans.end()) {
+    _misses++;
+    return nullptr;
+  }
+
+  _hits++;
+  return it->second;
+}
+
+void ExecutionPlanCache::store(const std::vector<LongType>& signature, std::shared_ptr<const ExecutionPlan> plan) {
+  std::unique_lock<MUTEX_TYPE> lock(_lock);
+
+  if (static_cast<LongType>(_plans.size()) >= EXECUTION_PLAN_CACHE_LIMIT) _plans.clear();
+
+  _plans[signature] = std::move(plan);
+}
+
+void ExecutionPlanCache::clear() {
+  std::unique_lock<MUTEX_TYPE> lock(_lock);
+  _plans.clear();
+  _hits = 0;
+  _misses = 0;
+}
+
+LongType ExecutionPlanCache::hits() { return _hits.load(); }
+
+LongType ExecutionPlanCache::misses() { return _misses.load(); }
+
+LongType ExecutionPlanCache::size() {
+  SHARED_LOCK_TYPE<MUTEX_TYPE> lock(_lock);
+  return static_cast<LongType>(_plans.size());
+}
+
+}  // namespace ops
+}  // namespace sd
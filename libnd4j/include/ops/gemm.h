@@ -30,6 +30,8 @@ struct bfloat16;
 #include <math/templatemath.h>
 #include <system/op_boilerplate.h>
 
+#include <type_traits>
+
 namespace sd {
 namespace blas {
 template <typename T>
@@ -38,12 +40,36 @@ static void *transpose(int orderSource, int orderTarget, int rows, int cols, voi
 static inline int linearIndexC(int rows, int cols, int r, int c);
 static inline int linearIndexF(int rows, int cols, int r, int c);
 
+/**
+ * Type used to accumulate dot products in fallback GEMM: integer inputs are summed as 64-bit integers,
+ * half/bfloat16 inputs as float, and anything involving double as double
+ */
+template <typename X, typename Y, typename Z>
+struct GemmAccumulator {
+  using type = typename std::conditional<
+      std::is_integral<X>::value && std::is_integral<Y>::value, sd::LongType,
+      typename std::conditional<std::is_same<X, double>::value || std::is_same<Y, double>::value ||
+                                    std::is_same<Z, double>::value,
+                                double, float>::type>::type;
+};
+
 template <typename X, typename Y, typename Z>
 class GEMM {
  protected:
  public:
   static void op(int Order, int TransA, int TransB, int M, int N, int K, double alpha, void *A, int lda, void *B,
                  int ldb, double beta, void *C, int ldc);
+
+  /**
+   * C = alpha * A x B + beta * C, with every matrix described by its element strides along both axes,
+   * so any 2D view can be passed in without copying.
+   *
+   * A and B are packed into contiguous panels of accumulator type, the product is computed by a
+   * register-blocked micro-kernel, and output tiles are distributed between threads.
+   */
+  static void op(sd::LongType M, sd::LongType N, sd::LongType K, double alpha, const X *A, sd::LongType aStrideM,
+                 sd::LongType aStrideK, const Y *B, sd::LongType bStrideK, sd::LongType bStrideN, double beta, Z *C,
+                 sd::LongType cStrideM, sd::LongType cStrideN);
 };
 
 template <typename X, typename Y, typename Z>
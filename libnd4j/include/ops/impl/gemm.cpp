@@ -21,10 +21,14 @@
 // Modified by GS <sgazeos@gmail.com> on 3/9/2018
 //
 #include <execution/Threads.h>
+#include <helpers/CpuIsa.h>
 #include <ops/gemm.h>
 #include <system/Environment.h>
 #include <types/types.h>
 
+#include <algorithm>
+#include <vector>
+
 namespace sd {
 namespace blas {
 
@@ -50,58 +54,169 @@ void *transpose(int orderSource, int orderTarget, int rows, int cols, void *vsou
   return ret;
 }
 
-template <typename X, typename Y, typename Z>
-void GEMM<X, Y, Z>::op(int Order, int TransA, int TransB, int M, int N, int K, double alpha, void *vA, int lda,
-                       void *vB, int ldb, double beta, void *vC, int ldc) {
-  auto A = reinterpret_cast<X *>(vA);
-  auto B = reinterpret_cast<Y *>(vB);
-  auto C = reinterpret_cast<Z *>(vC);
-
-  bool transAFlag = TransA == CblasTrans;
-  bool transBFlag = TransB == CblasTrans;
-
-  if (beta == 0.0) {
-    Z z = 0.f;
-    int length = M * N;
-    if (length <= Environment::getInstance().elementwiseThreshold()) {
-      for (int r = 0; r < length; r++) C[r] = z;
-    } else {
-      auto func = PRAGMA_THREADS_FOR {
-        for (auto r = start; r < stop; r++) C[r] = z;
-      };
-      samediff::Threads::parallel_for(func, 0, length);
+// micro-kernel computes MR x NR block of C, kept in registers while walking along K
+static constexpr sd::LongType GEMM_MR = 4;
+static constexpr sd::LongType GEMM_NR = 8;
+// cache blocking: packed KC x NR panel of B is meant to stay in L1 and MC x KC block of A in L2
+static constexpr sd::LongType GEMM_MC = 64;
+static constexpr sd::LongType GEMM_NC = 256;
+static constexpr sd::LongType GEMM_KC = 256;
+// products with fewer multiply-adds than this aren't worth waking up threads
+static constexpr sd::LongType GEMM_PARALLEL_THRESHOLD = 64 * 64 * 64;
+
+// copies mc x kc block of A into MR-row panels, each stored k-major, zero-padding the last panel
+template <typename T, typename A>
+static void packA(const T *src, sd::LongType strideM, sd::LongType strideK, sd::LongType mc, sd::LongType kc,
+                  A *dst) {
+  for (sd::LongType i0 = 0; i0 < mc; i0 += GEMM_MR) {
+    const auto rows = sd::math::sd_min<sd::LongType>(GEMM_MR, mc - i0);
+    const T *panel = src + i0 * strideM;
+    for (sd::LongType k = 0; k < kc; k++) {
+      const T *p = panel + k * strideK;
+      sd::LongType i = 0;
+      for (; i < rows; i++) dst[i] = static_cast<A>(p[i * strideM]);
+      for (; i < GEMM_MR; i++) dst[i] = static_cast<A>(0);
+      dst += GEMM_MR;
+    }
+  }
+}
+
+// copies kc x nc block of B into NR-column panels, each stored k-major, zero-padding the last panel
+template <typename T, typename A>
+static void packB(const T *src, sd::LongType strideK, sd::LongType strideN, sd::LongType kc, sd::LongType nc,
+                  A *dst) {
+  for (sd::LongType j0 = 0; j0 < nc; j0 += GEMM_NR) {
+    const auto cols = sd::math::sd_min<sd::LongType>(GEMM_NR, nc - j0);
+    const T *panel = src + j0 * strideN;
+    for (sd::LongType k = 0; k < kc; k++) {
+      const T *p = panel + k * strideK;
+      sd::LongType j = 0;
+      for (; j < cols; j++) dst[j] = static_cast<A>(p[j * strideN]);
+      for (; j < GEMM_NR; j++) dst[j] = static_cast<A>(0);
+      dst += GEMM_NR;
     }
   }
+}
 
-  auto func = PRAGMA_THREADS_FOR_2D {
-    for (auto r = start_x; r < stop_x; r += inc_x) {
-      for (auto c = start_y; c < stop_y; c += inc_y) {
-        int zIdx = linearIndexF(M, N, r, c);
+// c[MR x NR] += a[MR x kc] * b[kc x NR], both operands are packed panels
+template <typename A>
+static SD_INLINE void microKernel(sd::LongType kc, const A *__restrict a, const A *__restrict b, A *__restrict c,
+                                  sd::LongType ldc) {
+  A acc[GEMM_MR][GEMM_NR];
+  for (sd::LongType i = 0; i < GEMM_MR; i++)
+    for (sd::LongType j = 0; j < GEMM_NR; j++) acc[i][j] = static_cast<A>(0);
+
+  for (sd::LongType k = 0; k < kc; k++) {
+    for (sd::LongType i = 0; i < GEMM_MR; i++) {
+      const A av = a[i];
+      PRAGMA_OMP_SIMD
+      for (sd::LongType j = 0; j < GEMM_NR; j++) acc[i][j] += av * b[j];
+    }
+    a += GEMM_MR;
+    b += GEMM_NR;
+  }
 
-        Z dot = static_cast<Z>(0.0f);
+  for (sd::LongType i = 0; i < GEMM_MR; i++)
+    for (sd::LongType j = 0; j < GEMM_NR; j++) c[i * ldc + j] += acc[i][j];
+}
 
-        if (alpha != 0.0) {
-          int bIdx;  // = linearIndexF(K, N, 0, c);
-          int aIdx;
+template <typename X, typename Y, typename Z>
+void GEMM<X, Y, Z>::op(sd::LongType M, sd::LongType N, sd::LongType K, double alpha, const X *A,
+                       sd::LongType aStrideM, sd::LongType aStrideK, const Y *B, sd::LongType bStrideK,
+                       sd::LongType bStrideN, double beta, Z *C, sd::LongType cStrideM, sd::LongType cStrideN) {
+  using Acc = typename GemmAccumulator<X, Y, Z>::type;
 
-          for (int k = 0; k < K; k++) {
-            aIdx = (transAFlag ? linearIndexC(M, K, r, k) : linearIndexF(M, K, r, k));
-            bIdx = (transBFlag ? linearIndexC(K, N, k, c) : linearIndexF(K, N, k, c));
-            dot += static_cast<Z>(alpha) * static_cast<Z>(A[aIdx]) *
-                   static_cast<Z>(B[bIdx]);  // A[aIdx]sd::math::sd_dot<T>(aX, bX, K) * alpha;
-          }
-        }
+  if (M <= 0 || N <= 0) return;
 
-        if (beta != 0.0) {
-          C[zIdx] = static_cast<Z>(dot + static_cast<Z>(beta) * C[zIdx]);
-        } else {
-          C[zIdx] = static_cast<Z>(dot);
+  const Acc alphaA = static_cast<Acc>(alpha);
+  const Acc betaA = static_cast<Acc>(beta);
+  const bool scaled = alpha != 1.0;
+  const bool betaPresent = beta != 0.0;
+
+  // shrink tiles until there are enough of them to keep all threads busy
+  auto numThreads = static_cast<sd::LongType>(Environment::getInstance().maxMasterThreads());
+  if (M * N * K < GEMM_PARALLEL_THRESHOLD) numThreads = 1;
+
+  sd::LongType mBlock = GEMM_MC, nBlock = GEMM_NC;
+  auto numTiles = [&]() { return ((M + mBlock - 1) / mBlock) * ((N + nBlock - 1) / nBlock); };
+  while (numTiles() < numThreads && mBlock > 2 * GEMM_MR && mBlock / 2 >= M / numThreads) mBlock /= 2;
+  while (numTiles() < numThreads && nBlock > 4 * GEMM_NR) nBlock /= 2;
+
+  const sd::LongType tilesN = (N + nBlock - 1) / nBlock;
+  const sd::LongType tiles = numTiles();
+  const sd::LongType kBlock = sd::math::sd_min<sd::LongType>(GEMM_KC, sd::math::sd_max<sd::LongType>(K, 1));
+
+  // scratch is sized by the largest tile this product has, rounded up to whole panels, so small products
+  // don't pay for full-size blocks
+  const sd::LongType mPanels = (sd::math::sd_min<sd::LongType>(M, mBlock) + GEMM_MR - 1) / GEMM_MR * GEMM_MR;
+  const sd::LongType ldc = (sd::math::sd_min<sd::LongType>(N, nBlock) + GEMM_NR - 1) / GEMM_NR * GEMM_NR;
+
+  auto func = PRAGMA_THREADS_FOR {
+    std::vector<Acc> aPack(mPanels * kBlock);
+    std::vector<Acc> bPack(kBlock * ldc);
+    std::vector<Acc> cTile(mPanels * ldc);
+
+    for (auto t = start; t < stop; t++) {
+      const sd::LongType i0 = (t / tilesN) * mBlock;
+      const sd::LongType j0 = (t % tilesN) * nBlock;
+      const sd::LongType mc = sd::math::sd_min<sd::LongType>(mBlock, M - i0);
+      const sd::LongType nc = sd::math::sd_min<sd::LongType>(nBlock, N - j0);
+
+      // padding of the last panels only ever gets zero products added, so clearing mc x nc part is enough
+      for (sd::LongType i = 0; i < mc; i++)
+        std::fill(cTile.begin() + i * ldc, cTile.begin() + i * ldc + nc, static_cast<Acc>(0));
+
+      for (sd::LongType p0 = 0; p0 < K; p0 += kBlock) {
+        const sd::LongType kc = sd::math::sd_min<sd::LongType>(kBlock, K - p0);
+
+        packA(A + i0 * aStrideM + p0 * aStrideK, aStrideM, aStrideK, mc, kc, aPack.data());
+        packB(B + p0 * bStrideK + j0 * bStrideN, bStrideK, bStrideN, kc, nc, bPack.data());
+
+        // the micro-kernel is where the flops are, so it runs as the clone for the host's widest ISA
+        const Acc *aPanel = aPack.data();
+        const Acc *bPanel = bPack.data();
+        Acc *cPanel = cTile.data();
+        CpuIsa::dispatch([&]() {
+          for (sd::LongType jr = 0; jr < nc; jr += GEMM_NR)
+            for (sd::LongType ir = 0; ir < mc; ir += GEMM_MR)
+              microKernel<Acc>(kc, aPanel + ir * kc, bPanel + jr * kc, cPanel + ir * ldc + jr, ldc);
+        });
+      }
+
+      // alpha and beta are applied once per element, on the way out
+      for (sd::LongType i = 0; i < mc; i++) {
+        Z *c = C + (i0 + i) * cStrideM + j0 * cStrideN;
+        const Acc *acc = cTile.data() + i * ldc;
+        for (sd::LongType j = 0; j < nc; j++) {
+          Acc v = scaled ? alphaA * acc[j] : acc[j];
+          if (betaPresent) v += betaA * static_cast<Acc>(c[j * cStrideN]);
+          c[j * cStrideN] = static_cast<Z>(v);
         }
       }
     }
   };
 
-  samediff::Threads::parallel_for(func, 0, M, 1, 0, N, 1);
+  samediff::Threads::parallel_for(func, 0, tiles, 1, sd::math::sd_min<sd::LongType>(numThreads, tiles));
+}
+
+template <typename X, typename Y, typename Z>
+void GEMM<X, Y, Z>::op(int Order, int TransA, int TransB, int M, int N, int K, double alpha, void *vA, int lda,
+                       void *vB, int ldb, double beta, void *vC, int ldc) {
+  const bool colMajor = Order == CblasColMajor;
+  const bool transA = TransA == CblasTrans;
+  const bool transB = TransB == CblasTrans;
+
+  // element (r, c) of column-major matrix lives at r + c * ld, and of row-major one at r * ld + c;
+  // transposition swaps the roles of rows and columns
+  const sd::LongType aStrideM = colMajor != transA ? 1 : lda;
+  const sd::LongType aStrideK = colMajor != transA ? lda : 1;
+  const sd::LongType bStrideK = colMajor != transB ? 1 : ldb;
+  const sd::LongType bStrideN = colMajor != transB ? ldb : 1;
+  const sd::LongType cStrideM = colMajor ? 1 : ldc;
+  const sd::LongType cStrideN = colMajor ? ldc : 1;
+
+  op(M, N, K, alpha, reinterpret_cast<X *>(vA), aStrideM, aStrideK, reinterpret_cast<Y *>(vB), bStrideK, bStrideN,
+     beta, reinterpret_cast<Z *>(vC), cStrideM, cStrideN);
 }
 
 template <typename X, typename Y, typename Z>
@@ -131,5 +246,6 @@ void GEMV<X, Y, Z>::op(int TRANS, int M, int N, double alpha, void *vX, int lda,
 
 // BUILD_TRIPLE_TEMPLATE(template class  GEMV, , SD_COMMON_TYPES, SD_FLOAT_TYPES, SD_FLOAT_TYPES);
 // BUILD_TRIPLE_TEMPLATE(template class  GEMM, , SD_COMMON_TYPES, SD_FLOAT_TYPES, SD_FLOAT_TYPES);
+BUILD_SINGLE_TEMPLATE_THRICE(template class SD_LIB_EXPORT GEMM, , SD_NUMERIC_TYPES);
 }  // namespace blas
 }  // namespace sd
@@ -23,6 +23,7 @@
 
 #include <array/NDArray.h>
 #include <helpers/Loops.h>
+#include <helpers/SortEngine.h>
 
 #include <helpers/shape.h>
 #include <ops/declarable/CustomOperations.h>
@@ -296,146 +297,30 @@ void SpecialMethods<T>::splitCpuGeneric(NDArray& input, const std::vector<NDArra
 
 template <typename T>
 void SpecialMethods<T>::sortGeneric(NDArray *input, bool descending) {
-  auto x = input->bufferAsT<T>();
-  auto xShapeInfo = input->shapeInfo();
-  quickSort_parallel(input, Environment::getInstance().maxMasterThreads(), descending);
-}
-
-template <typename T>
-void SpecialMethods<T>::quickSort_parallel_internal(NDArray *x, int left, int right, int cutoff, bool descending) {
-  if (right - left <= cutoff) {
-    // Use insertion sort for small arrays
-    auto xBuff = x->bufferAsT<T>();
-    for (int i = left + 1; i <= right; i++) {
-      T key = xBuff[i];
-      int j = i - 1;
-      if (descending) {
-        while (j >= left && xBuff[j] < key) {
-          xBuff[j + 1] = xBuff[j];
-          j--;
-        }
-      } else {
-        while (j >= left && xBuff[j] > key) {
-          xBuff[j + 1] = xBuff[j];
-          j--;
-        }
-      }
-      xBuff[j + 1] = key;
-    }
-    return;
-  }
-
-  // Choose pivot as median of three
-  auto xBuff = x->bufferAsT<T>();
-  int mid = (left + right) / 2;
-  if (descending) {
-    if (xBuff[right] > xBuff[left]) std::swap(xBuff[right], xBuff[left]);
-    if (xBuff[mid] > xBuff[left]) std::swap(xBuff[mid], xBuff[left]);
-    if (xBuff[right] > xBuff[mid]) std::swap(xBuff[right], xBuff[mid]);
-  } else {
-    if (xBuff[right] < xBuff[left]) std::swap(xBuff[right], xBuff[left]);
-    if (xBuff[mid] < xBuff[left]) std::swap(xBuff[mid], xBuff[left]);
-    if (xBuff[right] < xBuff[mid]) std::swap(xBuff[right], xBuff[mid]);
-  }
-
-  // Partition
-  T pivot = xBuff[mid];
-  int i = left;
-  int j = right;
-
-  while (i <= j) {
-    if (descending) {
-      while (xBuff[i] > pivot) i++;
-      while (xBuff[j] < pivot) j--;
-    } else {
-      while (xBuff[i] < pivot) i++;
-      while (xBuff[j] > pivot) j--;
-    }
-
-    if (i <= j) {
-      std::swap(xBuff[i], xBuff[j]);
-      i++;
-      j--;
-    }
-  }
-
-  // Recursively sort sub-arrays
-  if (left < j) quickSort_parallel_internal(x, left, j, cutoff, descending);
-  if (i < right) quickSort_parallel_internal(x, i, right, cutoff, descending);
+  sorting::sortArray<T>(input, descending, Environment::getInstance().maxMasterThreads());
 }
 
 template <typename T>
 void SpecialMethods<T>::quickSort_parallel(NDArray *x, int numThreads, bool descending) {
-  const int CUTOFF = 32;  // Threshold for switching to insertion sort
-  auto length = x->lengthOf();
-
-  if (length <= 1) return;
-
-  // For very small arrays, just use the internal sort
-  if (length <= CUTOFF || numThreads <= 1) {
-    quickSort_parallel_internal(x, 0, length - 1, CUTOFF, descending);
-    return;
-  }
-
-  // For larger arrays, partition into segments and sort in parallel
-  int segmentSize = length / numThreads;
-  auto func = PRAGMA_THREADS_FOR {
-    int threadLeft = start * segmentSize;
-    int threadRight = (start == numThreads - 1) ? length - 1 : (start + 1) * segmentSize - 1;
-    quickSort_parallel_internal(x, threadLeft, threadRight, CUTOFF, descending);
-  };
-
-  samediff::Threads::parallel_for(func, 0, numThreads);
-
-  // Merge sorted segments if we used multiple threads
-  if (numThreads > 1) {
-    auto xBuff = x->bufferAsT<T>();
-    std::vector<T> temp(length);
-    for (int size = segmentSize; size < length; size *= 2) {
-      for (int left = 0; left < length; left += 2 * size) {
-        int mid = std::min(left + size, (int)length);
-        int right = std::min(left + 2 * size, (int)length);
-        int i = left, j = mid, k = left;
-
-        // Merge two segments
-        while (i < mid && j < right) {
-          if (descending) {
-            temp[k++] = (xBuff[i] >= xBuff[j]) ? xBuff[i++] : xBuff[j++];
-          } else {
-            temp[k++] = (xBuff[i] <= xBuff[j]) ? xBuff[i++] : xBuff[j++];
-          }
-        }
-        while (i < mid) temp[k++] = xBuff[i++];
-        while (j < right) temp[k++] = xBuff[j++];
-
-        // Copy back
-        for (i = left; i < right; i++) {
-          xBuff[i] = temp[i];
-        }
-      }
-    }
-  }
+  sorting::sortArray<T>(x, descending, sd::math::sd_max<int>(1, numThreads));
 }
 
 template <typename T>
 void SpecialMethods<T>::sortTadGeneric(NDArray *input, sd::LongType *dimension, int dimensionLength, bool descending) {
-  auto x = input->bufferAsT<T>();
   sd::LongType xLength = input->lengthOf();
   sd::LongType xTadLength = shape::tadLength(input->shapeInfo(), dimension, dimensionLength);
-  int numTads = xLength / xTadLength;
+  if (xLength == 0 || xTadLength == 0) return;
+  sd::LongType numTads = xLength / xTadLength;
 
   const std::vector<sd::LongType> dimVector(dimension, dimension + dimensionLength);
   auto pack = sd::ConstantTadHelper::getInstance().tadForDimensions(
       const_cast<sd::LongType *>(input->shapeInfo()), const_cast<sd::LongType *>(dimVector.data()), false);
 
-  auto func = PRAGMA_THREADS_FOR {
-    for (auto r = start; r < stop; r++) {
-      NDArray *dx = pack->extractTadView(input, r);
-      quickSort_parallel(dx,  xTadLength, descending);
-      delete dx;
-    }
-  };
-  samediff::Threads::parallel_tad(func, 0, numTads);
+  sorting::forEachTad(numTads, [&](LongType r, int numThreads) {
+    NDArray *dx = pack->extractTadView(input, r);
+    sorting::sortArray<T>(dx, descending, numThreads);
+    delete dx;
+  });
 }
 
 }  // namespace sd
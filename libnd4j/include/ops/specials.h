@@ -60,8 +60,6 @@ class SD_LIB_EXPORT SpecialMethods {
   static void averageGeneric(NDArray **x, NDArray *z, int n, const sd::LongType length, bool propagate);
 
   static sd::LongType getPosition(NDArray *input, sd::LongType index);
-  static void quickSort_parallel_internal(NDArray *x, int left, int right, int cutoff,
-                                          bool descending);
   static void quickSort_parallel(NDArray *x, int numThreads,
                                  bool descending);
 
@@ -50,6 +50,10 @@ class SD_LIB_EXPORT Environment {
   std::atomic<bool> _precBoost;
   std::atomic<bool> _useONEDNN{true};
   std::atomic<bool> _allowHelpers{true};
+  std::atomic<bool> _numaAware{false};
+  std::atomic<bool> _workStealing{false};
+  std::atomic<bool> _executionPlans{false};
+  std::atomic<int> _maxIsaLevel{3};
   std::atomic<bool> funcTracePrintDeallocate;
   std::atomic<bool> funcTracePrintAllocate;
   std::atomic<int> _maxThreads;
@@ -196,6 +200,45 @@ class SD_LIB_EXPORT Environment {
   bool helpersAllowed();
   void allowHelpers(bool reallyAllow);
 
+  /**
+   * When NUMA awareness is on, ThreadPool workers are grouped per NUMA node and pinned to it,
+   * parallel loops are kept within the node of the calling thread, and workspace buffers are bound to that node.
+   * Worker pinning happens when ThreadPool is created, so this should be set via SD_NUMA_AWARE env var
+   * or before the first parallel loop.
+   * @return
+   */
+  bool isNumaAware();
+  void setNumaAware(bool reallyAware);
+
+  /**
+   * When work stealing is on, samediff::Threads::parallel_for and parallel_tad split loops into chunks and
+   * execute them via WorkStealingScheduler instead of static per-thread spans. In this mode loop function
+   * can be invoked several times with the same thread id, for different ranges, one after another.
+   * Can be enabled via SD_WORK_STEALING env var
+   * @return
+   */
+  bool isWorkStealing();
+  void setWorkStealing(bool reallyUse);
+
+  /**
+   * When execution plans are on, DeclarableOp::execute(Context*) remembers validation results, output shapes and
+   * the chosen platform helper for every distinct call signature (op, input/output shapes and data types, arguments),
+   * and repeated fast path calls with the same signature skip straight to the op or helper.
+   * Can be enabled via SD_EXECUTION_PLANS env var
+   * @return
+   */
+  bool isExecutionPlans();
+  void setExecutionPlans(bool reallyUse);
+
+  /**
+   * Upper bound for the instruction set CpuIsa::dispatch may pick for hot loops:
+   * 1 - generic build flags, 2 - AVX2, 3 - AVX-512. The host capability is still checked on top of it.
+   * Can be set via SD_MAX_ISA env var, either as a number or as generic/avx2/avx512
+   * @return
+   */
+  int maxIsaLevel();
+  void setMaxIsaLevel(int level);
+
   bool blasFallback();
 
   int tadThreshold();
@@ -29,6 +29,7 @@
 SELECTOR_TRIPLE_3, SELECTOR_TRIPLE_2, SELECTOR_TRIPLE, SELECTOR_SINGLE, SELECTOR_SINGLE_THRICE, SELECTOR_SINGLE_TWICE, SELECTOR_PARTIAL_SINGLE: These macros are used to generate switch-case statements for different combinations of types. They help in selecting the appropriate template instantiation based on the provided types.
 Template Macros:
 TEMPLATE_SINGLE_TWICE: This macro is used to instantiate a template with two identical types.
+TEMPLATE_SINGLE_THRICE: This macro is used to instantiate a template with three identical types.
 Random Macros:
 RANDOMSINGLE, RANDOMSINGLEU, RANDOMDOUBLE, RANDOMDOUBLE2, RANDOMPAIRWISE, RANDOMTRIPLE3, RANDOMTRIPLE2, RANDOMTRIPLE: These macros are used to generate template instantiations for various combinations of types.
 Broadcast Macros:
@@ -1153,6 +1154,8 @@ INSTANT_PROCESS_COMBINATION, INSTANT_PROCESS_COMBINATION_3, INSTANT_PROCESS_COMB
 #define BUILD_SINGLE_TEMPLATE(NAME, SIGNATURE, TYPES) EVAL(_EXEC_SINGLE_T(RANDOMSINGLE, NAME, (SIGNATURE), TYPES))
 #define BUILD_SINGLE_TEMPLATE_TWICE(NAME, SIGNATURE, TYPES) \
  EVAL(_EXEC_SELECTOR_T(TEMPLATE_SINGLE_TWICE, NAME, SIGNATURE, TYPES))
+#define BUILD_SINGLE_TEMPLATE_THRICE(NAME, SIGNATURE, TYPES) \
+ EVAL(_EXEC_SELECTOR_T(TEMPLATE_SINGLE_THRICE, NAME, SIGNATURE, TYPES))
 #define BUILD_DOUBLE_TEMPLATE(NAME, SIGNATURE, TYPES_A, TYPES_B) \
  EVAL(_EXEC_DOUBLE_T(RANDOMDOUBLE, NAME, (SIGNATURE), (TYPES_A), TYPES_B))
 #define BUILD_SINGLE_SELECTOR(XTYPE, NAME, SIGNATURE, TYPES)                   \
@@ -1342,6 +1345,9 @@ INSTANT_PROCESS_COMBINATION, INSTANT_PROCESS_COMBINATION_3, INSTANT_PROCESS_COMB
 #define _TEMPLATE_SINGLE_TWICE(A, B, C, D) A<D, D> B;
 #define TEMPLATE_SINGLE_TWICE(A, B, C) EVALUATING_PASTE(_TEM, PLATE_SINGLE_TWICE(A, B, UNPAREN(C)))
 
+#define _TEMPLATE_SINGLE_THRICE(A, B, C, D) A<D, D, D> B;
+#define TEMPLATE_SINGLE_THRICE(A, B, C) EVALUATING_PASTE(_TEM, PLATE_SINGLE_THRICE(A, B, UNPAREN(C)))
+
 #define _SELECTOR_PARTIAL_SINGLE(A, B, C, D) \
  case C: {                                  \
    A D, UNPAREN2(B);                        \
@@ -121,3 +121,128 @@ TEST_F(AttentionTests, basic_multi_head_dot_product_attention_with_mask) {
   ASSERT_EQ(sd::Status::OK, result.status());
 }
 
+
+// plain softmax(scale * q * k^T) * v for [B, T, D] arrays, masks are [B, T] or nullptr
+static NDArray fusedAttentionReference(NDArray& q, NDArray& k, NDArray& v, NDArray* vMask, double scale, bool causal) {
+  const int bS = q.sizeAt(0), tq = q.sizeAt(1), tv = k.sizeAt(1), d = q.sizeAt(2), dv = v.sizeAt(2);
+  std::vector<LongType> outShape = {bS, tq, dv};
+  NDArray out('c', outShape, q.dataType());
+  double zero = 0.;
+  out.assign(zero);
+
+  for (int b = 0; b < bS; b++)
+    for (int i = 0; i < tq; i++) {
+      std::vector<double> p(tv, 0.);
+      double max = -1e300, sum = 0.;
+      for (int j = 0; j < tv; j++) {
+        if ((causal && j > i) || (vMask != nullptr && vMask->e<double>(b, j) == 0.)) continue;
+        double s = 0.;
+        for (int e = 0; e < d; e++) s += q.e<double>(b, i, e) * k.e<double>(b, j, e);
+        p[j] = s * scale;
+        max = std::max(max, p[j]);
+      }
+      for (int j = 0; j < tv; j++) {
+        if ((causal && j > i) || (vMask != nullptr && vMask->e<double>(b, j) == 0.)) continue;
+        p[j] = std::exp(p[j] - max);
+        sum += p[j];
+      }
+      for (int e = 0; e < dv; e++) {
+        double o = 0.;
+        for (int j = 0; j < tv; j++)
+          if ((!causal || j <= i) && (vMask == nullptr || vMask->e<double>(b, j) != 0.)) o += p[j] / sum * v.e<double>(b, j, e);
+        out.p(b, i, e, o);
+      }
+    }
+  return out;
+}
+
+TEST_F(AttentionTests, fused_dot_product_attention_1) {
+  auto queries = NDArrayFactory::create<float>('c', {2, 50, 8});
+  auto keys = NDArrayFactory::create<float>('c', {2, 90, 8});
+  auto values = NDArrayFactory::create<float>('c', {2, 90, 5});
+  queries.linspace(-1, 0.013);
+  keys.linspace(1, -0.007);
+  values.linspace(-2, 0.011);
+  queries.applyTransform(transform::Sin, &queries);
+  keys.applyTransform(transform::Tanh, &keys);
+
+  auto expected = fusedAttentionReference(queries, keys, values, nullptr, 0.35, false);
+
+  ops::fused_dot_product_attention op;
+  auto result = op.evaluate({&queries, &values, &keys}, {0.35}, {}, {false});
+  ASSERT_EQ(sd::Status::OK, result.status());
+
+  std::vector<LongType> lseShape = {2, 50};
+  ASSERT_TRUE(expected.isSameShape(result.at(0)));
+  ASSERT_TRUE(expected.equalsTo(result.at(0), 1e-4));
+  ASSERT_EQ(lseShape, result.at(1)->getShapeAsVector());
+}
+
+TEST_F(AttentionTests, fused_dot_product_attention_causal_and_mask_1) {
+  auto queries = NDArrayFactory::create<double>('c', {3, 70, 4});
+  auto keys = NDArrayFactory::create<double>('c', {3, 70, 4});
+  auto values = NDArrayFactory::create<double>('c', {3, 70, 6});
+  auto vMask = NDArrayFactory::create<double>('c', {3, 70});
+  auto qMask = NDArrayFactory::create<double>('c', {3, 70});
+  queries.linspace(-1, 0.017);
+  keys.linspace(2, -0.009);
+  values.linspace(-2, 0.013);
+  queries.applyTransform(transform::Sin, &queries);
+  keys.applyTransform(transform::Tanh, &keys);
+  double one = 1.;
+  vMask.assign(one);
+  qMask.assign(one);
+  for (int j = 0; j < 70; j += 3) vMask.p(1, j, 0.);
+  qMask.p(2, 5, 0.);
+
+  auto expected = fusedAttentionReference(queries, keys, values, &vMask, 0.5, true);
+  for (int e = 0; e < 6; e++) expected.p(2, 5, e, 0.);
+
+  ops::fused_dot_product_attention op;
+  auto result = op.evaluate({&queries, &values, &keys, &qMask, &vMask}, {0.5}, {}, {true});
+  ASSERT_EQ(sd::Status::OK, result.status());
+
+  ASSERT_TRUE(expected.isSameShape(result.at(0)));
+  ASSERT_TRUE(expected.equalsTo(result.at(0), 1e-10));
+}
+
+TEST_F(AttentionTests, fused_dot_product_attention_bp_1) {
+  auto queries = NDArrayFactory::create<double>('c', {2, 7, 3});
+  auto keys = NDArrayFactory::create<double>('c', {2, 9, 3});
+  auto values = NDArrayFactory::create<double>('c', {2, 9, 4});
+  auto eps = NDArrayFactory::create<double>('c', {2, 7, 4});
+  queries.linspace(-1, 0.07);
+  keys.linspace(2, -0.05);
+  values.linspace(-2, 0.06);
+  eps.linspace(1, -0.03);
+  queries.applyTransform(transform::Sin, &queries);
+  keys.applyTransform(transform::Tanh, &keys);
+
+  ops::fused_dot_product_attention op;
+  ops::fused_dot_product_attention_bp opBP;
+  auto forward = op.evaluate({&queries, &values, &keys}, {0.8}, {}, {true});
+  ASSERT_EQ(sd::Status::OK, forward.status());
+  auto gradients = opBP.evaluate({&queries, &values, &keys, forward.at(0), forward.at(1), &eps}, {0.8}, {}, {true});
+  ASSERT_EQ(sd::Status::OK, gradients.status());
+
+  // loss = sum(eps * output), checked against central differences
+  const auto loss = [&]() -> double {
+    auto result = op.evaluate({&queries, &values, &keys}, {0.8}, {}, {true});
+    return (*result.at(0) * eps).reduceNumber(reduce::Sum).e<double>(0);
+  };
+
+  const double h = 1e-6;
+  std::vector<NDArray*> inputs = {&queries, &values, &keys};
+  for (int i = 0; i < 3; i++) {
+    for (LongType e = 0; e < inputs[i]->lengthOf(); e++) {
+      const double original = inputs[i]->e<double>(e);
+      inputs[i]->p(e, original + h);
+      const double plus = loss();
+      inputs[i]->p(e, original - h);
+      const double minus = loss();
+      inputs[i]->p(e, original);
+
+      ASSERT_NEAR((plus - minus) / (2 * h), gradients.at(i)->e<double>(e), 1e-6);
+    }
+  }
+}
@@ -0,0 +1,102 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+
+//
+// BenchmarkHelper tests
+//
+#include <helpers/BenchmarkHelper.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "testlayers.h"
+
+using namespace sd;
+
+class BenchmarkHelperTests : public NDArrayTests {
+ public:
+};
+
+TEST_F(BenchmarkHelperTests, Summarize_1) {
+  std::vector<LongType> timings;
+  for (LongType e = 100; e >= 1; e--) timings.push_back(e * 1000);
+
+  BenchmarkResult result;
+  BenchmarkHelper::summarize(timings, result);
+
+  ASSERT_EQ(100, result.iterations);
+  ASSERT_NEAR(1.0, result.min, 1e-9);
+  ASSERT_NEAR(100.0, result.max, 1e-9);
+  ASSERT_NEAR(50.5, result.median, 1e-9);
+  ASSERT_NEAR(50.5, result.mean, 1e-9);
+  ASSERT_NEAR(99.0, result.p99, 1e-9);
+}
+
+TEST_F(BenchmarkHelperTests, ParametersBatch_1) {
+  IntPowerParameters length("length", 2, 0, 4, 2);
+  BoolParameters inplace("inplace");
+  PredefinedParameters k("k", {3, 5});
+
+  ParametersBatch batch({&length, &inplace, &k});
+  auto parameters = batch.parameters();
+
+  ASSERT_EQ(3 * 2 * 2, parameters.size());
+  ASSERT_EQ(std::string("length=1;inplace=0;k=3"), parameters.front().asString());
+  ASSERT_EQ(std::string("length=16;inplace=1;k=5"), parameters.back().asString());
+
+  // empty batch still runs benchmark once
+  ParametersBatch empty;
+  ASSERT_EQ(1, empty.parameters().size());
+}
+
+TEST_F(BenchmarkHelperTests, Report_1) {
+  BenchmarkHelper helper(1, 5);
+  helper.setPrintOut(false);
+
+  IntParameters length("length", 8, 16, 8);
+  ParametersBatch batch({&length});
+
+  auto generator = PARAMETRIC_XZ() {
+    std::vector<LongType> shape({p.getIntParam("length")});
+    x.push_back(NDArrayFactory::create_<float>('c', shape));
+    z.push_back(NDArrayFactory::create_<float>('c', shape));
+  };
+
+  TransformBenchmark tb(transform::StrictOps::Tanh, "tanh");
+  helper.runOperationSuit(&tb, generator, batch, "Tanh");
+
+  // filtered out
+  helper.setFilter("Sigmoid");
+  helper.runOperationSuit(&tb, generator, batch, "Tanh");
+
+  auto &results = helper.results();
+  ASSERT_EQ(2, results.size());
+  ASSERT_EQ(std::string("length=8"), results[0].parameters);
+  ASSERT_EQ(5, results[0].iterations);
+  ASSERT_LE(results[0].min, results[0].median);
+  ASSERT_LE(results[0].median, results[0].p99);
+  ASSERT_LE(results[0].p99, results[0].max);
+
+  auto csv = helper.report(BenchmarkFormat::CSV);
+  ASSERT_EQ(3, std::count(csv.begin(), csv.end(), '\n'));
+
+  auto json = helper.report(BenchmarkFormat::JSON);
+  ASSERT_NE(std::string::npos, json.find("\"suite\": \"Tanh\""));
+}
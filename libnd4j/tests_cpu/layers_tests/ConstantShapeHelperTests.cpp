@@ -22,6 +22,7 @@
 #include <array/ConstantDataBuffer.h>
 #include <array/ShapeDescriptor.h>
 #include <helpers/ConstantShapeHelper.h>
+#include <helpers/ConstantTadHelper.h>
 #include <helpers/PointersManager.h>
 #include <ops/declarable/CustomOperations.h>
 
@@ -329,3 +330,65 @@ TEST_F(ConstantShapeHelperTests, ShapeDescriptor_paddedBuffer) {
     }
   }
 }
+
+TEST_F(ConstantShapeHelperTests, cache_statistics_1) {
+  DirectShapeTrie trie;
+  auto shapeInfo = ShapeBuilders::createShapeInfo(FLOAT32, 'c', {3, 5, 7});
+
+  auto bufferA = trie.getOrCreate(shapeInfo);
+  auto bufferB = trie.getOrCreate(shapeInfo);
+
+  ASSERT_EQ(bufferA, bufferB);
+  ASSERT_EQ(1, trie.misses());
+  ASSERT_EQ(1, trie.hits());
+  ASSERT_EQ(1, trie.entries());
+  ASSERT_EQ(shape::shapeInfoLength(3) * sizeof(LongType), trie.cachedBytes());
+
+  delete[] shapeInfo;
+}
+
+TEST_F(ConstantShapeHelperTests, cache_statistics_2) {
+  DirectShapeTrie trie;
+  auto firstShape = ShapeBuilders::createShapeInfo(FLOAT32, 'c', {3, 1});
+  auto first = trie.getOrCreate(firstShape);
+
+  for (int e = 1; e < 100; e++) {
+    auto shapeInfo = ShapeBuilders::createShapeInfo(FLOAT32, 'c', {3, e + 1});
+    trie.getOrCreate(shapeInfo);
+    delete[] shapeInfo;
+  }
+
+  ASSERT_EQ(100, trie.misses());
+  ASSERT_EQ(100, trie.entries());
+  ASSERT_EQ(100 * shape::shapeInfoLength(2) * sizeof(LongType), trie.cachedBytes());
+
+  // arrays keep raw pointers into cached shape infos, so entries are never dropped
+  ASSERT_EQ(first, trie.getOrCreate(firstShape));
+  ASSERT_EQ(1, trie.hits());
+
+  delete[] firstShape;
+}
+
+TEST_F(ConstantTadHelperTests, cache_statistics_1) {
+  DirectTadTrie trie;
+  auto shapeA = ShapeBuilders::createShapeInfo(FLOAT32, 'c', {4, 5, 6});
+  auto shapeB = ShapeBuilders::createShapeInfo(FLOAT32, 'c', {4, 7, 6});
+  std::vector<LongType> dimensions = {2};
+
+  auto packA = trie.getOrCreate(dimensions, shapeA);
+  auto packB = trie.getOrCreate(dimensions, shapeB);
+  auto packC = trie.getOrCreate(dimensions, shapeA);
+
+  // same dimensions over different shapes must give different packs
+  ASSERT_NE(packA, packB);
+  ASSERT_EQ(packA, packC);
+  ASSERT_EQ(20, packA->numberOfTads());
+  ASSERT_EQ(28, packB->numberOfTads());
+
+  ASSERT_EQ(2, trie.misses());
+  ASSERT_EQ(1, trie.hits());
+  ASSERT_EQ(2, trie.entries());
+
+  delete[] shapeA;
+  delete[] shapeB;
+}
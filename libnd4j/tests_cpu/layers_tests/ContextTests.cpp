@@ -20,6 +20,7 @@
 // Created by raver119 on 30.10.2017.
 //
 #include <ops/declarable/CustomOperations.h>
+#include <ops/declarable/ExecutionPlan.h>
 
 #include "testlayers.h"
 
@@ -346,3 +347,59 @@ TEST_F(ContextTests, test_short_context_3) {
 
   ASSERT_EQ(*exp, *z);
 }
+
+TEST_F(ContextTests, test_execution_plans_1) {
+  Environment::getInstance().setExecutionPlans(true);
+  ExecutionPlanCache::getInstance().clear();
+
+  auto x = NDArrayFactory::create<float>('c', {3, 2}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f});
+  auto y = NDArrayFactory::create<float>('c', {3, 2}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f});
+  auto exp = NDArrayFactory::create<float>('c', {3, 2}, {2.f, 4.f, 6.f, 8.f, 10.f, 12.f});
+
+  add op;
+  for (int e = 0; e < 3; e++) {
+    Context ctx(1);
+    ctx.setInputArray(0, &x);
+    ctx.setInputArray(1, &y);
+
+    ASSERT_EQ(sd::Status::OK, op.execute(&ctx));
+    ASSERT_EQ(1, ctx.fastpath_out().size());
+
+    auto z = ctx.fastpath_out()[0];
+    ASSERT_TRUE(exp.isSameShape(z));
+    ASSERT_TRUE(exp.equalsTo(z));
+  }
+
+  ASSERT_EQ(1, ExecutionPlanCache::getInstance().size());
+  ASSERT_EQ(1, ExecutionPlanCache::getInstance().misses());
+  ASSERT_EQ(2, ExecutionPlanCache::getInstance().hits());
+
+  Environment::getInstance().setExecutionPlans(false);
+}
+
+TEST_F(ContextTests, test_execution_plans_2) {
+  Environment::getInstance().setExecutionPlans(true);
+  ExecutionPlanCache::getInstance().clear();
+
+  // output shape of fill depends on values of its input, so only validation may come from the plan
+  auto shape1 = NDArrayFactory::create<int>('c', {2}, {4, 2});
+  auto shape2 = NDArrayFactory::create<int>('c', {2}, {2, 4});
+
+  fill op;
+  for (auto shape : {&shape1, &shape2, &shape1}) {
+    Context ctx(1);
+    ctx.setInputArray(0, shape);
+    ctx.setTArguments({3.0});
+
+    ASSERT_EQ(sd::Status::OK, op.execute(&ctx));
+
+    auto z = ctx.fastpath_out()[0];
+    ASSERT_EQ(shape->e<LongType>(0), z->sizeAt(0));
+    ASSERT_EQ(shape->e<LongType>(1), z->sizeAt(1));
+    ASSERT_EQ(3.0, z->e<double>(7));
+  }
+
+  ASSERT_EQ(2, ExecutionPlanCache::getInstance().hits());
+
+  Environment::getInstance().setExecutionPlans(false);
+}
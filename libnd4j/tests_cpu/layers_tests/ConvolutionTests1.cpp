@@ -393,6 +393,301 @@ TEST_F(ConvolutionTests1, conv2d_10) {
   ASSERT_TRUE(expOutput.equalsTo(output));
 }
 
+//////////////////////////////////////////////////////////////////////
+// plain loop reference for NHWC conv2d, weights in [kH, kW, iC, oC]
+static NDArray conv2dNhwcReference(NDArray& input, NDArray& weights, NDArray& bias, int sH, int sW, int pH, int pW,
+                                   int dH, int dW, int oH, int oW) {
+  const int bS = input.sizeAt(0), iH = input.sizeAt(1), iW = input.sizeAt(2), iC = input.sizeAt(3);
+  const int kH = weights.sizeAt(0), kW = weights.sizeAt(1), oC = weights.sizeAt(3);
+
+  std::vector<LongType> outShape = {bS, oH, oW, oC};
+  NDArray expected('c', outShape, FLOAT32);
+  for (int b = 0; b < bS; b++)
+    for (int oh = 0; oh < oH; oh++)
+      for (int ow = 0; ow < oW; ow++)
+        for (int o = 0; o < oC; o++) {
+          double sum = bias.e<double>(o);
+          for (int kh = 0; kh < kH; kh++)
+            for (int kw = 0; kw < kW; kw++) {
+              const int ih = oh * sH - pH + kh * dH;
+              const int iw = ow * sW - pW + kw * dW;
+              if (ih < 0 || ih >= iH || iw < 0 || iw >= iW) continue;
+              for (int c = 0; c < iC; c++) sum += input.e<double>(b, ih, iw, c) * weights.e<double>(kh, kw, c, o);
+            }
+          expected.p(b, oh, ow, o, sum);
+        }
+  return expected;
+}
+
+//////////////////////////////////////////////////////////////////////
+TEST_F(ConvolutionTests1, conv2d_nhwc_1) {
+  int bS = 2, iH = 7, iW = 6, iC = 5, oC = 4, kH = 3, kW = 3, sH = 2, sW = 1, pH = 1, pW = 2, dH = 1, dW = 2;
+  int oH = 4, oW = 6;
+  int paddingMode = 0;  // 1-SAME, 0-VALID;
+  int dataFormat = 1;   // 1-NHWC, 0-NCHW
+  int wFormat = 1;      // 0-[kH, kW, iC, oC], 1-[oC, iC, kH, kW], 2-[oC, kH, kW, iC]
+
+  std::vector<LongType> inShape = {bS, iH, iW, iC};
+  std::vector<LongType> wShape = {kH, kW, iC, oC};
+  std::vector<LongType> bShape = {oC};
+  std::vector<double> bValues = {-1, 2, 0.5, 0.25};
+  NDArray input('c', inShape, FLOAT32);
+  NDArray weights('c', wShape, FLOAT32);
+  NDArray bias('c', bShape, bValues, FLOAT32);
+  input.linspace(-3, 0.05);
+  weights.linspace(-1.5, 0.02);
+
+  NDArray expOutput = conv2dNhwcReference(input, weights, bias, sH, sW, pH, pW, dH, dW, oH, oW);
+
+  std::vector<LongType> perm = {3, 2, 0, 1};
+  NDArray& permuted = weights.permute(perm, false, false);
+  NDArray weightsOIHW = permuted.dup('c');
+  delete &permuted;
+
+  ops::conv2d op;
+  auto results = op.evaluate({&input, &weightsOIHW, &bias}, {},
+                             {kH, kW, sH, sW, pH, pW, dH, dW, paddingMode, dataFormat, wFormat});
+  auto output = results.at(0);
+
+  ASSERT_EQ(sd::Status::OK, results.status());
+  ASSERT_TRUE(expOutput.isSameShape(output));
+  ASSERT_TRUE(expOutput.equalsTo(output, 1e-4));
+}
+
+//////////////////////////////////////////////////////////////////////
+TEST_F(ConvolutionTests1, conv2d_nhwc_2) {
+  int bS = 3, iH = 5, iW = 4, iC = 6, oC = 7, kH = 1, kW = 1, sH = 1, sW = 1, pH = 0, pW = 0, dH = 1, dW = 1;
+  int paddingMode = 0;  // 1-SAME, 0-VALID;
+  int dataFormat = 1;   // 1-NHWC, 0-NCHW
+  int wFormat = 0;      // 0-[kH, kW, iC, oC], 1-[oC, iC, kH, kW], 2-[oC, kH, kW, iC]
+
+  std::vector<LongType> inShape = {bS, iH, iW, iC};
+  std::vector<LongType> wShape = {kH, kW, iC, oC};
+  std::vector<LongType> bShape = {oC};
+  NDArray input('c', inShape, FLOAT32);
+  NDArray weights('c', wShape, FLOAT32);
+  NDArray bias('c', bShape, FLOAT32);
+  input.linspace(2, -0.03);
+  weights.linspace(-0.8, 0.04);
+  bias.linspace(0.1, 0.1);
+
+  NDArray expOutput = conv2dNhwcReference(input, weights, bias, sH, sW, pH, pW, dH, dW, iH, iW);
+
+  ops::conv2d op;
+  auto results =
+      op.evaluate({&input, &weights, &bias}, {}, {kH, kW, sH, sW, pH, pW, dH, dW, paddingMode, dataFormat, wFormat});
+  auto output = results.at(0);
+
+  ASSERT_EQ(sd::Status::OK, results.status());
+  ASSERT_TRUE(expOutput.isSameShape(output));
+  ASSERT_TRUE(expOutput.equalsTo(output, 1e-4));
+}
+
+//////////////////////////////////////////////////////////////////////
+TEST_F(ConvolutionTests1, conv2d_nhwc_3) {
+  int bS = 2, iH = 7, iW = 6, iC = 5, oC = 4, kH = 3, kW = 2, sH = 2, sW = 1, pH = 1, pW = 1, dH = 1, dW = 2;
+  int wFormat = 0;  // 0-[kH, kW, iC, oC], 1-[oC, iC, kH, kW], 2-[oC, kH, kW, iC]
+
+  std::vector<LongType> inShape = {bS, iH, iW, iC};
+  std::vector<LongType> wShape = {kH, kW, iC, oC};
+  std::vector<LongType> bShape = {oC};
+  NDArray input('c', inShape, DOUBLE);
+  NDArray weights('c', wShape, DOUBLE);
+  NDArray bias('c', bShape, DOUBLE);
+  input.linspace(-2, 0.07);
+  weights.linspace(-1, 0.03);
+  bias.linspace(-0.5, 0.25);
+  input.applyTransform(transform::Sin, &input);
+
+  std::vector<LongType> toNchw = {0, 3, 1, 2};
+  NDArray& permutedInput = input.permute(toNchw, false, false);
+  NDArray inputNCHW = permutedInput.dup('c');
+  delete &permutedInput;
+
+  // native NHWC path must resolve paddings exactly like NCHW im2col path does, for every padding mode
+  ops::conv2d op;
+  Environment::getInstance().allowHelpers(false);
+  for (int paddingMode = 0; paddingMode < 3; paddingMode++) {  // 0-VALID, 1-SAME, 2-CAUSAL
+    auto nhwc = op.evaluate({&input, &weights, &bias}, {}, {kH, kW, sH, sW, pH, pW, dH, dW, paddingMode, 1, wFormat});
+    auto nchw =
+        op.evaluate({&inputNCHW, &weights, &bias}, {}, {kH, kW, sH, sW, pH, pW, dH, dW, paddingMode, 0, wFormat});
+
+    ASSERT_EQ(sd::Status::OK, nhwc.status());
+    ASSERT_EQ(sd::Status::OK, nchw.status());
+
+    std::vector<LongType> toNhwc = {0, 2, 3, 1};
+    NDArray& permutedOutput = nchw.at(0)->permute(toNhwc, false, false);
+    NDArray expOutput = permutedOutput.dup('c');
+    delete &permutedOutput;
+
+    ASSERT_TRUE(expOutput.isSameShape(nhwc.at(0)));
+    ASSERT_TRUE(expOutput.equalsTo(nhwc.at(0), 1e-8));
+  }
+  Environment::getInstance().allowHelpers(true);
+}
+
+//////////////////////////////////////////////////////////////////////
+TEST_F(ConvolutionTests1, conv2d_winograd_1) {
+  int bS = 2, iH = 16, iW = 13, iC = 8, oC = 12, kH = 3, kW = 3, sH = 1, sW = 1, pH = 1, pW = 1, dH = 1, dW = 1;
+  int paddingMode = 0;  // 1-SAME, 0-VALID;
+  int dataFormat = 0;   // 1-NHWC, 0-NCHW
+  int wFormat = 0;      // 0-[kH, kW, iC, oC], 1-[oC, iC, kH, kW], 2-[oC, kH, kW, iC]
+
+  std::vector<LongType> inShape = {bS, iC, iH, iW};
+  std::vector<LongType> wShape = {kH, kW, iC, oC};
+  std::vector<LongType> bShape = {oC};
+  NDArray input('c', inShape, FLOAT32);
+  NDArray weights('c', wShape, FLOAT32);
+  NDArray bias('c', bShape, FLOAT32);
+  input.linspace(-2, 0.37);
+  weights.linspace(-1, 0.13);
+  bias.linspace(-0.5, 0.1);
+  input.applyTransform(transform::Sin, &input);
+  weights.applyTransform(transform::Sin, &weights);
+
+  ops::conv2d op;
+  auto winograd =
+      op.evaluate({&input, &weights, &bias}, {}, {kH, kW, sH, sW, pH, pW, dH, dW, paddingMode, dataFormat, wFormat});
+
+  Environment::getInstance().allowHelpers(false);
+  auto im2col =
+      op.evaluate({&input, &weights, &bias}, {}, {kH, kW, sH, sW, pH, pW, dH, dW, paddingMode, dataFormat, wFormat});
+  Environment::getInstance().allowHelpers(true);
+
+  ASSERT_EQ(sd::Status::OK, winograd.status());
+  ASSERT_EQ(sd::Status::OK, im2col.status());
+  ASSERT_TRUE(im2col.at(0)->isSameShape(winograd.at(0)));
+  ASSERT_TRUE(im2col.at(0)->equalsTo(winograd.at(0), 1e-4));
+}
+
+//////////////////////////////////////////////////////////////////////
+TEST_F(ConvolutionTests1, conv2d_winograd_2) {
+  int bS = 3, iH = 7, iW = 6, iC = 9, oC = 8, kH = 3, kW = 3, sH = 1, sW = 1, pH = 0, pW = 1, dH = 1, dW = 1;
+  int paddingMode = 0;  // 1-SAME, 0-VALID;
+  int dataFormat = 1;   // 1-NHWC, 0-NCHW
+  int wFormat = 2;      // 0-[kH, kW, iC, oC], 1-[oC, iC, kH, kW], 2-[oC, kH, kW, iC]
+
+  std::vector<LongType> inShape = {bS, iH, iW, iC};
+  std::vector<LongType> wShape = {oC, kH, kW, iC};
+  NDArray input('c', inShape, DOUBLE);
+  NDArray weights('c', wShape, DOUBLE);
+  input.linspace(1, 0.29);
+  weights.linspace(-3, 0.11);
+  input.applyTransform(transform::Sin, &input);
+  weights.applyTransform(transform::Sin, &weights);
+
+  ops::conv2d op;
+  auto winograd = op.evaluate({&input, &weights}, {}, {kH, kW, sH, sW, pH, pW, dH, dW, paddingMode, dataFormat, wFormat});
+
+  // without helpers NHWC input goes through NHWC gemm, so reference is NCHW im2col run on permuted input
+  std::vector<LongType> toNchw = {0, 3, 1, 2};
+  NDArray& permutedInput = input.permute(toNchw, false, false);
+  NDArray inputNCHW = permutedInput.dup('c');
+  delete &permutedInput;
+
+  Environment::getInstance().allowHelpers(false);
+  auto im2col = op.evaluate({&inputNCHW, &weights}, {}, {kH, kW, sH, sW, pH, pW, dH, dW, paddingMode, 0, wFormat});
+  Environment::getInstance().allowHelpers(true);
+
+  ASSERT_EQ(sd::Status::OK, winograd.status());
+  ASSERT_EQ(sd::Status::OK, im2col.status());
+
+  std::vector<LongType> toNhwc = {0, 2, 3, 1};
+  NDArray& permutedOutput = im2col.at(0)->permute(toNhwc, false, false);
+  NDArray expOutput = permutedOutput.dup('c');
+  delete &permutedOutput;
+
+  ASSERT_TRUE(expOutput.isSameShape(winograd.at(0)));
+  ASSERT_TRUE(expOutput.equalsTo(winograd.at(0), 1e-10));
+}
+
+//////////////////////////////////////////////////////////////////////
+TEST_F(ConvolutionTests1, conv2d_bp_winograd_1) {
+  int bS = 2, iH = 10, iW = 9, iC = 8, oC = 10, kH = 3, kW = 3, sH = 1, sW = 1, pH = 1, pW = 0, dH = 1, dW = 1;
+  int oH = 10, oW = 7;
+  int paddingMode = 0;  // 1-SAME, 0-VALID;
+  int dataFormat = 0;   // 1-NHWC, 0-NCHW
+  int wFormat = 1;      // 0-[kH, kW, iC, oC], 1-[oC, iC, kH, kW], 2-[oC, kH, kW, iC]
+
+  std::vector<LongType> inShape = {bS, iC, iH, iW};
+  std::vector<LongType> wShape = {oC, iC, kH, kW};
+  std::vector<LongType> bShape = {oC};
+  std::vector<LongType> gradOShape = {bS, oC, oH, oW};
+  NDArray input('c', inShape, FLOAT32);
+  NDArray weights('c', wShape, FLOAT32);
+  NDArray bias('c', bShape, FLOAT32);
+  NDArray gradO('c', gradOShape, FLOAT32);
+  input.linspace(-2, 0.23);
+  weights.linspace(-1, 0.07);
+  bias.linspace(0.1, 0.1);
+  gradO.linspace(0.5, 0.19);
+  input.applyTransform(transform::Sin, &input);
+  weights.applyTransform(transform::Sin, &weights);
+  gradO.applyTransform(transform::Sin, &gradO);
+
+  ops::conv2d_bp op;
+  auto winograd = op.evaluate({&input, &weights, &bias, &gradO}, {},
+                              {kH, kW, sH, sW, pH, pW, dH, dW, paddingMode, dataFormat, wFormat});
+
+  Environment::getInstance().allowHelpers(false);
+  auto im2col = op.evaluate({&input, &weights, &bias, &gradO}, {},
+                            {kH, kW, sH, sW, pH, pW, dH, dW, paddingMode, dataFormat, wFormat});
+  Environment::getInstance().allowHelpers(true);
+
+  ASSERT_EQ(sd::Status::OK, winograd.status());
+  ASSERT_EQ(sd::Status::OK, im2col.status());
+  for (int i = 0; i < 3; i++) {
+    ASSERT_TRUE(im2col.at(i)->isSameShape(winograd.at(i)));
+    ASSERT_TRUE(im2col.at(i)->equalsTo(winograd.at(i), 1e-4));
+  }
+}
+
+//////////////////////////////////////////////////////////////////////
+TEST_F(ConvolutionTests1, conv2d_winograd_3) {
+  int bS = 2, iH = 11, iW = 9, iC = 8, oC = 9, kH = 3, kW = 3, sH = 1, sW = 1, pH = 1, pW = 1, dH = 1, dW = 1;
+  int paddingMode = 1;  // 1-SAME, 0-VALID;
+  int dataFormat = 0;   // 1-NHWC, 0-NCHW
+  int wFormat = 0;      // 0-[kH, kW, iC, oC], 1-[oC, iC, kH, kW], 2-[oC, kH, kW, iC]
+
+  std::vector<LongType> inShape = {bS, iC, iH, iW};
+  std::vector<LongType> wShape = {kH, kW, iC, oC};
+  std::vector<LongType> bShape = {oC};
+  std::vector<LongType> gradOShape = {bS, oC, iH, iW};
+  NDArray input('c', inShape, DOUBLE);
+  NDArray weights('c', wShape, DOUBLE);
+  NDArray bias('c', bShape, DOUBLE);
+  NDArray gradO('c', gradOShape, DOUBLE);
+  input.linspace(-1, 0.17);
+  weights.linspace(-2, 0.09);
+  bias.linspace(-0.3, 0.1);
+  gradO.linspace(0.2, 0.13);
+  input.applyTransform(transform::Sin, &input);
+  weights.applyTransform(transform::Sin, &weights);
+  gradO.applyTransform(transform::Sin, &gradO);
+
+  // SAME mode takes paddings as given in both winograd and im2col paths
+  ops::conv2d op;
+  ops::conv2d_bp opBP;
+  std::vector<LongType> iArgs = {kH, kW, sH, sW, pH, pW, dH, dW, paddingMode, dataFormat, wFormat};
+  auto winograd = op.evaluate({&input, &weights, &bias}, {}, iArgs);
+  auto winogradBP = opBP.evaluate({&input, &weights, &bias, &gradO}, {}, iArgs);
+
+  Environment::getInstance().allowHelpers(false);
+  auto im2col = op.evaluate({&input, &weights, &bias}, {}, iArgs);
+  auto im2colBP = opBP.evaluate({&input, &weights, &bias, &gradO}, {}, iArgs);
+  Environment::getInstance().allowHelpers(true);
+
+  ASSERT_EQ(sd::Status::OK, winograd.status());
+  ASSERT_EQ(sd::Status::OK, im2col.status());
+  ASSERT_TRUE(im2col.at(0)->isSameShape(winograd.at(0)));
+  ASSERT_TRUE(im2col.at(0)->equalsTo(winograd.at(0), 1e-8));
+
+  ASSERT_EQ(sd::Status::OK, winogradBP.status());
+  ASSERT_EQ(sd::Status::OK, im2colBP.status());
+  ASSERT_TRUE(im2colBP.at(0)->isSameShape(winogradBP.at(0)));
+  ASSERT_TRUE(im2colBP.at(0)->equalsTo(winogradBP.at(0), 1e-8));
+}
+
 //////////////////////////////////////////////////////////////////////
 TEST_F(ConvolutionTests1, sconv2d_1) {
   float _expB[] = {
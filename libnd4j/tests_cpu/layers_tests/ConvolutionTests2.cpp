@@ -4527,6 +4527,97 @@ TEST_F(ConvolutionTests2, depthwise_conv2d_11) {
   ASSERT_TRUE(expOutput.equalsTo(output));
 }
 
+//////////////////////////////////////////////////////////////////////
+TEST_F(ConvolutionTests2, depthwise_conv2d_12) {
+  int bS = 2, iH = 6, iW = 7, iC = 3, mC = 2, kH = 3, kW = 2, sH = 2, sW = 1, pH = 1, pW = 1, dH = 1, dW = 2;
+  int oC = iC * mC;
+  int oH = 3, oW = 7;
+  int paddingMode = 0;  // 1-SAME, 0-VALID;
+  int dataFormat = 1;   // 1-NHWC, 0-NCHW
+  int wFormat = 1;      // 0-[kH, kW, iC, mC], 1-[mC, iC, kH, kW], 2-[mC, kH, kW, iC]
+
+  std::vector<LongType> inShape = {bS, iH, iW, iC};
+  std::vector<LongType> wShape = {mC, iC, kH, kW};
+  std::vector<LongType> bShape = {oC};
+  std::vector<LongType> outShape = {bS, oH, oW, oC};
+  std::vector<double> bValues = {-1, 2, 0.5, 0.25, -0.75, 1.5};
+  NDArray input('c', inShape, FLOAT32);
+  NDArray weights('c', wShape, FLOAT32);
+  NDArray bias('c', bShape, bValues, FLOAT32);
+  input.linspace(-4, 0.03);
+  weights.linspace(-1, 0.05);
+
+  NDArray expOutput('c', outShape, FLOAT32);
+  for (int b = 0; b < bS; b++)
+    for (int oh = 0; oh < oH; oh++)
+      for (int ow = 0; ow < oW; ow++)
+        for (int c = 0; c < iC; c++)
+          for (int m = 0; m < mC; m++) {
+            double sum = bias.e<double>(c * mC + m);
+            for (int kh = 0; kh < kH; kh++)
+              for (int kw = 0; kw < kW; kw++) {
+                const int ih = oh * sH - pH + kh * dH;
+                const int iw = ow * sW - pW + kw * dW;
+                if (ih < 0 || ih >= iH || iw < 0 || iw >= iW) continue;
+                sum += input.e<double>(b, ih, iw, c) * weights.e<double>(m, c, kh, kw);
+              }
+            expOutput.p(b, oh, ow, c * mC + m, sum);
+          }
+
+  ops::depthwise_conv2d op;
+  auto results = op.evaluate({&input, &weights, &bias}, {},
+                             {kH, kW, sH, sW, pH, pW, dH, dW, paddingMode, dataFormat, wFormat});
+  auto output = results.at(0);
+
+  ASSERT_EQ(sd::Status::OK, results.status());
+  ASSERT_TRUE(expOutput.isSameShape(output));
+  ASSERT_TRUE(expOutput.equalsTo(output, 1e-4));
+}
+
+//////////////////////////////////////////////////////////////////////
+TEST_F(ConvolutionTests2, depthwise_conv2d_13) {
+  int bS = 2, iH = 6, iW = 7, iC = 3, mC = 2, kH = 3, kW = 2, sH = 2, sW = 1, pH = 1, pW = 1, dH = 1, dW = 2;
+  int oC = iC * mC;
+  int wFormat = 0;  // 0-[kH, kW, iC, mC], 1-[mC, iC, kH, kW], 2-[mC, kH, kW, iC]
+
+  std::vector<LongType> inShape = {bS, iH, iW, iC};
+  std::vector<LongType> wShape = {kH, kW, iC, mC};
+  std::vector<LongType> bShape = {oC};
+  NDArray input('c', inShape, DOUBLE);
+  NDArray weights('c', wShape, DOUBLE);
+  NDArray bias('c', bShape, DOUBLE);
+  input.linspace(-4, 0.05);
+  weights.linspace(-1, 0.04);
+  bias.linspace(-0.75, 0.25);
+  input.applyTransform(transform::Sin, &input);
+
+  std::vector<LongType> toNchw = {0, 3, 1, 2};
+  NDArray& permutedInput = input.permute(toNchw, false, false);
+  NDArray inputNCHW = permutedInput.dup('c');
+  delete &permutedInput;
+
+  // direct NHWC loop must resolve paddings exactly like NCHW im2col path does, for every padding mode
+  ops::depthwise_conv2d op;
+  Environment::getInstance().allowHelpers(false);
+  for (int paddingMode = 0; paddingMode < 3; paddingMode++) {  // 0-VALID, 1-SAME, 2-CAUSAL
+    auto nhwc = op.evaluate({&input, &weights, &bias}, {}, {kH, kW, sH, sW, pH, pW, dH, dW, paddingMode, 1, wFormat});
+    auto nchw =
+        op.evaluate({&inputNCHW, &weights, &bias}, {}, {kH, kW, sH, sW, pH, pW, dH, dW, paddingMode, 0, wFormat});
+
+    ASSERT_EQ(sd::Status::OK, nhwc.status());
+    ASSERT_EQ(sd::Status::OK, nchw.status());
+
+    std::vector<LongType> toNhwc = {0, 2, 3, 1};
+    NDArray& permutedOutput = nchw.at(0)->permute(toNhwc, false, false);
+    NDArray expOutput = permutedOutput.dup('c');
+    delete &permutedOutput;
+
+    ASSERT_TRUE(expOutput.isSameShape(nhwc.at(0)));
+    ASSERT_TRUE(expOutput.equalsTo(nhwc.at(0), 1e-8));
+  }
+  Environment::getInstance().allowHelpers(true);
+}
+
 //////////////////////////////////////////////////////////////////////
 TEST_F(ConvolutionTests2, depthwise_conv2d_bp_test1) {
   int bS = 2, iH = 4, iW = 3, iC = 2, mC = 2, kH = 3, kW = 2, sH = 1, sW = 1, pH = 0, pW = 0, dH = 1, dW = 1;
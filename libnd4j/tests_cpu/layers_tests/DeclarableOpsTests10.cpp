@@ -832,6 +832,38 @@ TEST_F(DeclarableOpsTests10, histogram_fixed_width_test6) {
   ASSERT_TRUE(exp.equalsTo(out));
 }
 
+///////////////////////////////////////////////////////////////////
+TEST_F(DeclarableOpsTests10, histogram_fixed_width_test7) {
+  // long enough to be counted by several threads into private bins
+  const sd::LongType length = 300000;
+  const sd::LongType nbins = 9;
+  std::vector<sd::LongType> inShape = {length};
+  std::vector<sd::LongType> rangeShape = {2};
+  std::vector<sd::LongType> binsShape = {nbins};
+  std::vector<double> rangeValues = {0., 90.};
+  NDArray input('c', inShape, sd::DataType::DOUBLE);
+  NDArray range('c', rangeShape, rangeValues, sd::DataType::DOUBLE);
+  NDArray exp('c', binsShape, sd::DataType::INT64);
+
+  std::vector<sd::LongType> counts(nbins, 0);
+  for (sd::LongType e = 0; e < length; e++) {
+    const double value = static_cast<double>((e * 7919) % 1000) / 10. - 5.;
+    input.p(e, value);
+    const sd::LongType bin = value < 10. ? 0 : value >= 80. ? nbins - 1 : static_cast<sd::LongType>(value / 10.);
+    counts[bin]++;
+  }
+  for (sd::LongType b = 0; b < nbins; b++) exp.p(b, counts[b]);
+
+  ops::histogram_fixed_width op;
+  auto results = op.evaluate({&input, &range}, {}, {nbins}, {});
+
+  ASSERT_EQ(sd::Status::OK, results.status());
+
+  auto out = results.at(0);
+  ASSERT_TRUE(exp.isSameShape(out));
+  ASSERT_TRUE(exp.equalsTo(out));
+}
+
 ///////////////////////////////////////////////////////////////////
 TEST_F(DeclarableOpsTests10, NTH_Element_Test_1) {
   NDArray input = NDArrayFactory::create<float>('c', {12}, {10, 1, 9, 8, 11, 7, 6, 5, 12, 3, 2, 4});
@@ -993,6 +1025,29 @@ TEST_F(DeclarableOpsTests10, NTH_Element_Test_8) {
 ASSERT_EQ(exp,*output);
 }
 
+///////////////////////////////////////////////////////////////////
+TEST_F(DeclarableOpsTests10, NTH_Element_Test_9) {
+  // rows of a permuted array are strided
+  NDArray input = NDArrayFactory::create<float>('c', {200, 3});
+  input.linspace(1.f);
+  std::vector<LongType> perm = {1, 0};
+  NDArray& rows = input.permute(perm, false, false);
+  NDArray n = NDArrayFactory::create<int>(150);
+  NDArray exp = NDArrayFactory::create<float>('c', {3}, {451.f, 452.f, 453.f});
+  NDArray expReverse = NDArrayFactory::create<float>('c', {3}, {148.f, 149.f, 150.f});
+
+  ops::nth_element op;
+  auto results = op.evaluate({&rows, &n}, {}, {});
+  ASSERT_EQ(sd::Status::OK, results.status());
+  ASSERT_TRUE(exp.equalsTo(results.at(0)));
+
+  auto reversed = op.evaluate({&rows, &n}, {}, {1});
+  ASSERT_EQ(sd::Status::OK, reversed.status());
+  ASSERT_TRUE(expReverse.equalsTo(reversed.at(0)));
+
+  delete &rows;
+}
+
 ///////////////////////////////////////////////////////////////////
 TEST_F(DeclarableOpsTests10, broadcast_to_test1) {
   auto input = NDArrayFactory::create<LongType>('c', {3});
@@ -1976,6 +2031,54 @@ TEST_F(DeclarableOpsTests10, Image_NonMaxSuppressing_7) {
   ASSERT_TRUE(result->isEmpty());
 }
 
+////////////////////////////////////////////////////////////////////
+TEST_F(DeclarableOpsTests10, Image_NonMaxSuppressing_8) {
+  // pairs of heavily overlapping boxes on a lattice, the one with higher score survives in every pair
+  const LongType numBoxes = 2000;
+  std::vector<LongType> boxesShape = {numBoxes, 4};
+  std::vector<LongType> scoresShape = {numBoxes};
+  NDArray boxes('c', boxesShape, sd::DataType::FLOAT32);
+  NDArray scores('c', scoresShape, sd::DataType::FLOAT32);
+  for (LongType i = 0; i < numBoxes; i++) {
+    const LongType site = i / 2;
+    const float shift = i % 2 == 0 ? 0.f : 0.5f;
+    const float y = (site / 40) * 10.f, x = (site % 40) * 10.f + shift;
+    boxes.p(i * 4 + 0, y);
+    boxes.p(i * 4 + 1, x);
+    boxes.p(i * 4 + 2, y + 5.f);
+    boxes.p(i * 4 + 3, x + 5.f);
+    scores.p(i, (i % 2 == 0 ? 1.f : 0.5f) - i / 10000.f);
+  }
+
+  ops::non_max_suppression_v3 op;
+  auto results = op.evaluate({&boxes, &scores}, {0.5, 0.}, {numBoxes});
+  ASSERT_EQ(sd::Status::OK, results.status());
+
+  NDArray* result = results.at(0);
+  ASSERT_EQ(numBoxes / 2, result->lengthOf());
+  for (LongType e = 0; e < result->lengthOf(); e++) ASSERT_EQ(2 * e, result->e<LongType>(e));
+}
+
+////////////////////////////////////////////////////////////////////
+TEST_F(DeclarableOpsTests10, Image_NonMaxSuppressing_SoftNms_1) {
+  NDArray boxes = NDArrayFactory::create<double>('c', {3, 4}, {0, 0, 1, 1, 0, 0.1, 1, 1.1, 0, 10, 1, 11});
+  NDArray scores = NDArrayFactory::create<double>('c', {3}, {0.9, 0.75, 0.6});
+  NDArray expectedHard = NDArrayFactory::create<int>('c', {3}, {0, 1, 2});
+  NDArray expectedSoft = NDArrayFactory::create<int>('c', {2}, {0, 2});
+
+  // overlap of the first two boxes is below threshold, so only soft suppression can drop the second one
+  ops::non_max_suppression_v3 op;
+  auto hard = op.evaluate({&boxes, &scores}, {0.9, 0.5}, {3});
+  ASSERT_EQ(sd::Status::OK, hard.status());
+  ASSERT_TRUE(expectedHard.isSameShapeStrict(*hard.at(0)));
+  ASSERT_TRUE(expectedHard.equalsTo(hard.at(0)));
+
+  auto soft = op.evaluate({&boxes, &scores}, {0.9, 0.5, 0.5}, {3});
+  ASSERT_EQ(sd::Status::OK, soft.status());
+  ASSERT_TRUE(expectedSoft.isSameShapeStrict(*soft.at(0)));
+  ASSERT_TRUE(expectedSoft.equalsTo(soft.at(0)));
+}
+
 ////////////////////////////////////////////////////////////////////
 TEST_F(DeclarableOpsTests10, Image_NonMaxSuppressingOverlap_1) {
   NDArray boxes =
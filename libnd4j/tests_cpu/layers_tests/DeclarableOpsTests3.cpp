@@ -137,6 +137,54 @@ TEST_F(DeclarableOpsTests3, Test_Unique_2) {
   ASSERT_TRUE(expC.equalsTo(c));
 }
 
+TEST_F(DeclarableOpsTests3, Test_Unique_3) {
+  // large enough for the partitioned parallel path, values are expected in order of first occurrence
+  const LongType length = 400000;
+  const LongType numValues = 5000;
+  std::vector<LongType> shape = {length};
+  NDArray x('c', shape, sd::DataType::INT32);
+  for (LongType e = 0; e < length; e++) x.p(e, static_cast<int>((e * 7919 + e / 3) % numValues));
+
+  std::vector<LongType> firstId(numValues, -1), expValues, expIdx(length), expCounts;
+  for (LongType e = 0; e < length; e++) {
+    auto v = x.e<LongType>(e);
+    if (firstId[v] < 0) {
+      firstId[v] = expValues.size();
+      expValues.push_back(v);
+      expCounts.push_back(0);
+    }
+    expIdx[e] = firstId[v];
+    expCounts[firstId[v]]++;
+  }
+
+  // partitioned path needs at least 2 chunks, so it's forced regardless of number of cores
+  auto oldMaxThreads = Environment::getInstance().maxThreads();
+  auto oldMaxMasterThreads = Environment::getInstance().maxMasterThreads();
+  Environment::getInstance().setMaxThreads(sd::math::sd_max<int>(oldMaxThreads, 4));
+  Environment::getInstance().setMaxMasterThreads(4);
+
+  ops::unique_with_counts op;
+  auto result = op.evaluate({&x}, {}, {});
+
+  Environment::getInstance().setMaxMasterThreads(oldMaxMasterThreads);
+  Environment::getInstance().setMaxThreads(oldMaxThreads);
+
+  ASSERT_EQ(sd::Status::OK, result.status());
+
+  auto v = result.at(0);
+  auto i = result.at(1);
+  auto c = result.at(2);
+  ASSERT_EQ(expValues.size(), v->lengthOf());
+  ASSERT_EQ(expCounts.size(), c->lengthOf());
+  ASSERT_EQ(length, i->lengthOf());
+
+  for (LongType e = 0; e < v->lengthOf(); e++) {
+    ASSERT_EQ(expValues[e], v->e<LongType>(e));
+    ASSERT_EQ(expCounts[e], c->e<LongType>(e));
+  }
+  for (LongType e = 0; e < length; e++) ASSERT_EQ(expIdx[e], i->e<LongType>(e));
+}
+
 TEST_F(DeclarableOpsTests3, Test_Rint_1) {
   auto x = NDArrayFactory::create<float>('c', {1, 7}, {-1.7f, -1.5f, -0.2f, 0.2f, 1.5f, 1.7f, 2.0f});
   auto exp = NDArrayFactory::create<float>('c', {1, 7}, {-2.f, -2.f, -0.f, 0.f, 2.f, 2.f, 2.f});
@@ -236,6 +284,27 @@ TEST_F(DeclarableOpsTests3, Test_ListDiff_1) {
   ASSERT_TRUE(exp1.equalsTo(z1));
 }
 
+TEST_F(DeclarableOpsTests3, Test_ListDiff_2) {
+  auto x = NDArrayFactory::create<double>('c', {8}, {5., -0., 2., 7., 5., 0., 9., 2.});
+  auto y = NDArrayFactory::create<double>('c', {4}, {2., 0., 11., 2.});
+
+  auto exp0 = NDArrayFactory::create<double>('c', {4}, {5., 7., 5., 9.});
+  auto exp1 = NDArrayFactory::create<LongType>('c', {4}, {0, 3, 4, 6});
+
+  ops::listdiff op;
+  auto result = op.evaluate({&x, &y});
+  ASSERT_EQ(sd::Status::OK, result.status());
+
+  auto z0 = result.at(0);
+  auto z1 = result.at(1);
+
+  ASSERT_TRUE(exp0.isSameShape(z0));
+  ASSERT_TRUE(exp0.equalsTo(z0));
+
+  ASSERT_TRUE(exp1.isSameShape(z1));
+  ASSERT_TRUE(exp1.equalsTo(z1));
+}
+
 TEST_F(DeclarableOpsTests3, Test_Range_1) {
   auto start = NDArrayFactory::create<float>(0.3f);
   auto stop = NDArrayFactory::create<float>(-5.f);
@@ -336,6 +336,36 @@ TEST_F(DeclarableOpsTests5, histogram_test2) {
   ASSERT_TRUE(exp.equalsTo(z));
 }
 
+////////////////////////////////////////////////////////////////////
+TEST_F(DeclarableOpsTests5, histogram_test3) {
+  // strided view, counted by several threads
+  const sd::LongType rows = 100000;
+  std::vector<sd::LongType> shape = {rows, 2};
+  std::vector<sd::LongType> binsShape = {4};
+  NDArray matrix('c', shape, sd::DataType::FLOAT32);
+  NDArray exp('c', binsShape, sd::DataType::INT64);
+
+  std::vector<sd::LongType> counts(4, 0);
+  for (sd::LongType r = 0; r < rows; r++) {
+    const float value = static_cast<float>(r % 8);
+    matrix.p(r * 2, value);
+    matrix.p(r * 2 + 1, -100.f);
+    counts[sd::math::sd_min<sd::LongType>(3, static_cast<sd::LongType>(value / 1.75f))]++;
+  }
+  for (sd::LongType b = 0; b < 4; b++) exp.p(b, counts[b]);
+
+  std::vector<sd::LongType> columnDims = {1};
+  auto &column = matrix(0, columnDims);
+
+  ops::histogram op;
+  auto result = op.evaluate({&column}, {}, {4}, {});
+  delete &column;
+  ASSERT_EQ(sd::Status::OK, result.status());
+
+  auto z = result.at(0);
+  ASSERT_TRUE(exp.equalsTo(z));
+}
+
 ////////////////////////////////////////////////////////////////////
 TEST_F(DeclarableOpsTests5, Identity_test1) {
   auto matrix = NDArrayFactory::create<float>('c', {3, 3}, {-4.f, -3.f, -2.f, -1.f, 0.f, 1.f, 2.f, 3.f, 4.f});
@@ -1245,6 +1275,36 @@ TEST_F(DeclarableOpsTests5, Test_TopK_5) {
   ASSERT_TRUE(expI.equalsTo(i));
 }
 
+//////////////////////////////////////////////////////////////////////
+TEST_F(DeclarableOpsTests5, Test_TopK_6) {
+  // wide rows with repeated values, equal values are expected in order of their positions
+  const LongType width = 1000;
+  std::vector<LongType> shape = {3, width};
+  NDArray x('c', shape, sd::DataType::FLOAT32);
+  for (LongType r = 0; r < 3; r++)
+    for (LongType j = 0; j < width; j++) x.p(r * width + j, static_cast<float>((j * 37 + r) % 50));
+
+  ops::top_k op;
+  auto sorted = op.evaluate({&x}, {}, {5}, {true});
+  ASSERT_EQ(sd::Status::OK, sorted.status());
+  auto unsorted = op.evaluate({&x}, {}, {5}, {false});
+  ASSERT_EQ(sd::Status::OK, unsorted.status());
+
+  for (LongType r = 0; r < 3; r++) {
+    // value 49 is the maximum of every row and it repeats 20 times
+    std::vector<LongType> positions;
+    for (LongType j = 0; j < width && positions.size() < 5; j++)
+      if (x.e<float>(r * width + j) == 49.f) positions.push_back(j);
+
+    for (LongType j = 0; j < 5; j++) {
+      ASSERT_EQ(49.f, sorted.at(0)->e<float>(r * 5 + j));
+      ASSERT_EQ(positions[j], sorted.at(1)->e<LongType>(r * 5 + j));
+      ASSERT_EQ(49.f, unsorted.at(0)->e<float>(r * 5 + j));
+      ASSERT_EQ(positions[j], unsorted.at(1)->e<LongType>(r * 5 + j));
+    }
+  }
+}
+
 ///////////////////////////////////////////////////////////
 TEST_F(DeclarableOpsTests5, Test_Moments_1) {
   auto x = NDArrayFactory::create<double>('c', {2, 3, 4},
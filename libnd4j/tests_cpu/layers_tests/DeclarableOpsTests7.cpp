@@ -2294,6 +2294,130 @@ TEST_F(DeclarableOpsTests7, TestUnsortedSegmentProdBP_4) {
   ASSERT_TRUE(exp.equalsTo(result.at(0)));
 }
 
+////////////////////////////////////////////////////////////////////////////////
+TEST_F(DeclarableOpsTests7, TestUnsortedSegmentSum_Parallel_1) {
+  // many rows in few segments, reduced through per-thread partial outputs
+  const sd::LongType numOfRows = 20000;
+  const sd::LongType numOfClasses = 7;
+  std::vector<sd::LongType> xShape = {numOfRows};
+  std::vector<sd::LongType> zShape = {numOfClasses};
+  NDArray x('c', xShape, sd::DataType::DOUBLE);
+  NDArray idx('c', xShape, sd::DataType::INT32);
+  NDArray expSum('c', zShape, sd::DataType::DOUBLE);
+  NDArray expMean('c', zShape, sd::DataType::DOUBLE);
+
+  std::vector<double> sums(numOfClasses, 0.);
+  std::vector<double> counts(numOfClasses, 0.);
+  for (sd::LongType e = 0; e < numOfRows; e++) {
+    const int s = static_cast<int>((e * 7919) % numOfClasses);
+    const double val = (e % 13) * 0.5;
+    x.p(e, val);
+    idx.p(e, s);
+    sums[s] += val;
+    counts[s] += 1.;
+  }
+  for (sd::LongType s = 0; s < numOfClasses; s++) {
+    expSum.p(s, sums[s]);
+    expMean.p(s, sums[s] / counts[s]);
+  }
+
+  ops::unsorted_segment_sum opSum;
+  auto resultSum = opSum.evaluate({&x, &idx}, {}, {numOfClasses});
+  ASSERT_EQ(resultSum.status(), sd::Status::OK);
+  ASSERT_TRUE(expSum.equalsTo(resultSum.at(0)));
+
+  ops::unsorted_segment_mean opMean;
+  auto resultMean = opMean.evaluate({&x, &idx}, {}, {numOfClasses});
+  ASSERT_EQ(resultMean.status(), sd::Status::OK);
+  ASSERT_TRUE(expMean.equalsTo(resultMean.at(0)));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TEST_F(DeclarableOpsTests7, TestUnsortedSegmentMax_Parallel_1) {
+  // many segments, rows are grouped by segment first, classes 97..99 stay empty
+  const sd::LongType numOfRows = 600;
+  const sd::LongType rowLen = 8;
+  const sd::LongType numOfClasses = 100;
+  std::vector<sd::LongType> xShape = {numOfRows, rowLen};
+  std::vector<sd::LongType> idxShape = {numOfRows};
+  std::vector<sd::LongType> zShape = {numOfClasses, rowLen};
+  NDArray x('c', xShape, sd::DataType::DOUBLE);
+  NDArray idx('c', idxShape, sd::DataType::INT32);
+  NDArray gradO('c', zShape, sd::DataType::DOUBLE);
+  NDArray exp('c', zShape, sd::DataType::DOUBLE);
+  NDArray expBP('c', xShape, sd::DataType::DOUBLE);
+
+  const double principalMax = DataTypeUtils::max<double>();
+  std::vector<double> maxs(numOfClasses * rowLen, -principalMax);
+  for (sd::LongType r = 0; r < numOfRows; r++) {
+    const int s = static_cast<int>((r * 31) % 97);
+    idx.p(r, s);
+    for (sd::LongType e = 0; e < rowLen; e++) {
+      const double val = static_cast<double>(((r * rowLen + e) * 37) % 101) - 50.;
+      x.p(r * rowLen + e, val);
+      maxs[s * rowLen + e] = sd::math::sd_max<double>(maxs[s * rowLen + e], val);
+    }
+  }
+  gradO.linspace(1.);
+  for (sd::LongType e = 0; e < numOfClasses * rowLen; e++) exp.p(e, maxs[e]);
+  for (sd::LongType r = 0; r < numOfRows; r++) {
+    const auto s = idx.e<sd::LongType>(r);
+    for (sd::LongType e = 0; e < rowLen; e++)
+      expBP.p(r * rowLen + e, x.e<double>(r * rowLen + e) == maxs[s * rowLen + e] ? gradO.e<double>(s * rowLen + e) : 0.);
+  }
+
+  ops::unsorted_segment_max op;
+  auto result = op.evaluate({&x, &idx}, {}, {numOfClasses});
+  ASSERT_EQ(result.status(), sd::Status::OK);
+  ASSERT_TRUE(exp.equalsTo(result.at(0)));
+
+  ops::unsorted_segment_max_bp opBP;
+  auto resultBP = opBP.evaluate({&x, &idx, &gradO}, {}, {numOfClasses});
+  ASSERT_EQ(resultBP.status(), sd::Status::OK);
+  ASSERT_TRUE(expBP.equalsTo(resultBP.at(0)));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TEST_F(DeclarableOpsTests7, TestSegmentMean_Parallel_1) {
+  const sd::LongType numOfRows = 300;
+  const sd::LongType rowLen = 5;
+  const sd::LongType numOfClasses = (numOfRows + 6) / 7;
+  std::vector<sd::LongType> xShape = {numOfRows, rowLen};
+  std::vector<sd::LongType> idxShape = {numOfRows};
+  std::vector<sd::LongType> zShape = {numOfClasses, rowLen};
+  NDArray x('c', xShape, sd::DataType::DOUBLE);
+  NDArray idx('c', idxShape, sd::DataType::INT32);
+  NDArray gradO('c', zShape, sd::DataType::DOUBLE);
+  NDArray exp('c', zShape, sd::DataType::DOUBLE);
+  NDArray expBP('c', xShape, sd::DataType::DOUBLE);
+
+  x.linspace(1.);
+  gradO.linspace(0.5, 0.5);
+  for (sd::LongType r = 0; r < numOfRows; r++) idx.p(r, static_cast<int>(r / 7));
+
+  for (sd::LongType s = 0; s < numOfClasses; s++) {
+    const sd::LongType first = s * 7;
+    const sd::LongType last = sd::math::sd_min<sd::LongType>(numOfRows, first + 7);
+    for (sd::LongType e = 0; e < rowLen; e++) {
+      double sum = 0.;
+      for (sd::LongType r = first; r < last; r++) sum += x.e<double>(r * rowLen + e);
+      exp.p(s * rowLen + e, sum / (last - first));
+      for (sd::LongType r = first; r < last; r++)
+        expBP.p(r * rowLen + e, gradO.e<double>(s * rowLen + e) / (last - first));
+    }
+  }
+
+  ops::segment_mean op;
+  auto result = op.evaluate({&x, &idx}, {}, {});
+  ASSERT_EQ(result.status(), sd::Status::OK);
+  ASSERT_TRUE(exp.equalsTo(result.at(0)));
+
+  ops::segment_mean_bp opBP;
+  auto resultBP = opBP.evaluate({&x, &idx, &gradO}, {}, {});
+  ASSERT_EQ(resultBP.status(), sd::Status::OK);
+  ASSERT_TRUE(expBP.equalsTo(resultBP.at(0)));
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 TEST_F(DeclarableOpsTests7, TestExtractImagePatches_1) {
   auto x = NDArrayFactory::create<double>(
@@ -3325,6 +3449,54 @@ TEST_F(DeclarableOpsTests7, percentile_test12) {
   ASSERT_TRUE(expected.equalsTo(output));
 }
 
+////////////////////////////////////////////////////////////////////////////////
+TEST_F(DeclarableOpsTests7, percentile_test13) {
+  const int dim0 = 1000, dim1 = 3;
+
+  auto input = NDArrayFactory::create<float>('c', {dim0, dim1});
+  for (int i = 0; i < dim0; ++i)
+    for (int j = 0; j < dim1; ++j) input.p(i * dim1 + j, j * dim0 + dim0 - i);
+
+  auto q = NDArrayFactory::create<float>('c', {3}, {50.f, 95.f, 99.f});
+
+  auto expected = NDArrayFactory::create<float>(
+      'c', {3, dim1}, {500.f, 1500.f, 2500.f, 950.f, 1950.f, 2950.f, 990.f, 1990.f, 2990.f});
+
+  ops::percentile op;
+  // q (taken from input), interpolation, keepDims
+  auto result = op.evaluate({&input, &q}, {0, 0, 0}, {0});
+  ASSERT_EQ(result.status(), sd::Status::OK);
+  auto output = result.at(0);
+
+  ASSERT_TRUE(expected.isSameShape(output));
+  ASSERT_TRUE(expected.equalsTo(output));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TEST_F(DeclarableOpsTests7, percentile_test14) {
+  const int dim0 = 1000, dim1 = 3;
+
+  auto input = NDArrayFactory::create<float>('c', {dim0, dim1});
+  for (int i = 0; i < dim0; ++i)
+    for (int j = 0; j < dim1; ++j) input.p(i * dim1 + j, j * dim0 + dim0 - i);
+
+  auto q = NDArrayFactory::create<float>('c', {2}, {50.f, 99.f});
+
+  auto expected = NDArrayFactory::create<float>('c', {2, dim1}, {500.f, 1500.f, 2500.f, 990.f, 1990.f, 2990.f});
+
+  ops::percentile op;
+  // no float arguments at all, q is taken from input
+  auto result = op.evaluate({&input, &q}, {}, {0});
+  ASSERT_EQ(result.status(), sd::Status::OK);
+  auto output = result.at(0);
+
+  ASSERT_TRUE(expected.isSameShape(output));
+  ASSERT_TRUE(expected.equalsTo(output));
+
+  // neither float argument nor second input
+  ASSERT_ANY_THROW(op.evaluate({&input}, {}, {0}));
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 TEST_F(DeclarableOpsTests7, transpose_test3) {
   auto input = NDArrayFactory::create<double>(
@@ -19,7 +19,17 @@
 //
 // Created by raver119 on 11.12.17.
 //
+#include <execution/Threads.h>
+#include <graph/ExecutionResult.h>
+#include <graph/GraphExecutioner.h>
 #include <graph/GraphHolder.h>
+#include <graph/InferenceRequest.h>
+#include <graph/Node.h>
+
+#include <chrono>
+#include <limits>
+#include <thread>
+#include <vector>
 
 #include "testlayers.h"
 
@@ -29,6 +39,50 @@ using namespace sd::graph;
 
 class GraphHolderTests : public NDArrayTests {
  public:
+  // abs -> cos -> abs over input variable -1
+  static Graph* buildGraph() {
+    auto graph = new Graph();
+
+    std::vector<LongType> shape = {5, 5};
+    auto x = NDArrayFactory::create_<float>('c', shape);
+    float zero = 0.f;
+    x->assign(zero);
+    graph->getVariableSpace()->putVariable(-1, x);
+
+    graph->addNode(new Node(::graph::OpType_TRANSFORM_SAME, transform::Abs, 1, {-1}, {2}));
+    graph->addNode(new Node(::graph::OpType_TRANSFORM_STRICT, transform::Cosine, 2, {1}, {3}));
+    graph->addNode(new Node(::graph::OpType_TRANSFORM_SAME, transform::Abs, 3, {2}, {}));
+
+    return graph;
+  }
+
+  // executes graph via GraphHolder for input filled with value, and returns first element of result
+  // if all elements of result are equal, or NaN otherwise
+  static float execute(LongType graphId, float value, LongType rows = 5) {
+    std::vector<LongType> shape = {rows, 5};
+    auto input = NDArrayFactory::create<float>('c', shape);
+    input.assign(value);
+
+    flatbuffers::FlatBufferBuilder requestBuilder(1024);
+    InferenceRequest ir(graphId);
+    ir.appendVariable(-1, 0, &input);
+    requestBuilder.Finish(ir.asFlatInferenceRequest(requestBuilder));
+    auto request = ::graph::GetFlatInferenceRequest(requestBuilder.GetBufferPointer());
+
+    flatbuffers::FlatBufferBuilder builder(1024);
+    auto result = GraphHolder::getInstance().execute(graphId, builder, request);
+    builder.Finish(result);
+
+    ExecutionResult restored(::graph::GetFlatResult(builder.GetBufferPointer()));
+    auto output = restored.at(0)->getNDArray();
+    if (output->sizeAt(0) != rows) return std::numeric_limits<float>::quiet_NaN();
+
+    auto first = output->e<float>(0);
+    for (LongType e = 1; e < output->lengthOf(); e++)
+      if (output->e<float>(e) != first) return std::numeric_limits<float>::quiet_NaN();
+
+    return first;
+  }
 };
 
 TEST_F(GraphHolderTests, SimpleTests_1) {
@@ -81,3 +135,165 @@ TEST_F(GraphHolderTests, SimpleTests_3) {
 
   delete graph2;
 }
+
+TEST_F(GraphHolderTests, SessionPool_1) {
+  LongType graphId = 121;
+  GraphHolder::getInstance().registerGraph(graphId, buildGraph());
+
+  ASSERT_NEAR(std::abs(std::cos(2.f)), execute(graphId, -2.f), 1e-5);
+  ASSERT_NEAR(std::abs(std::cos(3.f)), execute(graphId, -3.f), 1e-5);
+  ASSERT_NEAR(std::abs(std::cos(1.f)), execute(graphId, 1.f), 1e-5);
+
+  // sequential requests are served by the same session
+  auto pool = GraphHolder::getInstance().sessionPool(graphId);
+  ASSERT_EQ(1, pool->created());
+  ASSERT_EQ(2, pool->reused());
+  ASSERT_EQ(1, pool->numberOfIdle());
+
+  // and original graph isn't touched by executions
+  auto original = GraphHolder::getInstance().pullGraph(graphId);
+  ASSERT_FALSE(original->getVariableSpace()->getVariable(3)->hasNDArray());
+
+  GraphHolder::getInstance().dropGraphAny(graphId);
+  ASSERT_FALSE(GraphHolder::getInstance().hasGraph(graphId));
+  ASSERT_TRUE(GraphHolder::getInstance().sessionPool(graphId) == nullptr);
+}
+
+TEST_F(GraphHolderTests, SessionPool_2) {
+  LongType graphId = 122;
+  const int numThreads = 4;
+  const int perThread = 25;
+
+  auto maxIdle = GraphHolder::getInstance().maxIdleSessions();
+  GraphHolder::getInstance().setMaxIdleSessions(numThreads);
+  GraphHolder::getInstance().registerGraph(graphId, buildGraph());
+  GraphHolder::getInstance().setMaxIdleSessions(maxIdle);
+
+  GraphHolder::getInstance().prepareSessions(graphId, numThreads);
+  auto pool = GraphHolder::getInstance().sessionPool(graphId);
+  ASSERT_EQ(numThreads, pool->created());
+  ASSERT_EQ(numThreads, pool->numberOfIdle());
+
+  std::vector<int> failures(numThreads, 0);
+  auto func = PRAGMA_THREADS_FOR {
+    for (auto t = start; t < stop; t++)
+      for (int e = 0; e < perThread; e++) {
+        float value = -static_cast<float>(t * perThread + e) / 100.f;
+        if (std::abs(std::abs(std::cos(value)) - execute(graphId, value)) > 1e-5) failures[t]++;
+      }
+  };
+
+  samediff::Threads::parallel_for(func, 0, numThreads, 1, numThreads);
+
+  for (auto f : failures) ASSERT_EQ(0, f);
+
+  // every request got one of prepared sessions
+  ASSERT_EQ(numThreads, pool->created());
+  ASSERT_EQ(numThreads * perThread, pool->reused());
+
+  GraphHolder::getInstance().dropGraphAny(graphId);
+}
+
+TEST_F(GraphHolderTests, Throughput_1) {
+  LongType graphId = 123;
+  const int numRequests = 200;
+
+  GraphHolder::getInstance().registerGraph(graphId, buildGraph());
+
+  // reference: graph is cloned for every request
+  auto input = NDArrayFactory::create<float>('c', {5, 5});
+  float value = -1.f;
+  input.assign(value);
+
+  flatbuffers::FlatBufferBuilder requestBuilder(1024);
+  InferenceRequest ir(graphId);
+  ir.appendVariable(-1, 0, &input);
+  requestBuilder.Finish(ir.asFlatInferenceRequest(requestBuilder));
+  auto request = ::graph::GetFlatInferenceRequest(requestBuilder.GetBufferPointer());
+
+  auto timeStart = std::chrono::system_clock::now();
+  for (int e = 0; e < numRequests; e++) {
+    flatbuffers::FlatBufferBuilder builder(1024);
+    auto graph = GraphHolder::getInstance().cloneGraph(graphId);
+    builder.Finish(GraphExecutioner::execute(graph, builder, request));
+    delete graph;
+  }
+  auto timeClone = std::chrono::system_clock::now();
+
+  for (int e = 0; e < numRequests; e++) {
+    flatbuffers::FlatBufferBuilder builder(1024);
+    builder.Finish(GraphHolder::getInstance().execute(graphId, builder, request));
+  }
+  auto timePooled = std::chrono::system_clock::now();
+
+  auto cloneTime = std::chrono::duration_cast<std::chrono::microseconds>(timeClone - timeStart).count();
+  auto pooledTime = std::chrono::duration_cast<std::chrono::microseconds>(timePooled - timeClone).count();
+  sd_printf("GraphHolder throughput: clone per request %lld req/s, pooled sessions %lld req/s\n",
+            static_cast<LongType>(numRequests * 1000000.0 / (cloneTime > 0 ? cloneTime : 1)),
+            static_cast<LongType>(numRequests * 1000000.0 / (pooledTime > 0 ? pooledTime : 1)));
+
+  ASSERT_EQ(1, GraphHolder::getInstance().sessionPool(graphId)->created());
+
+  GraphHolder::getInstance().dropGraphAny(graphId);
+}
+
+TEST_F(GraphHolderTests, Batching_1) {
+  LongType graphId = 124;
+  const int numThreads = 4;
+
+  GraphHolder::getInstance().registerGraph(graphId, buildGraph());
+
+  // window is long enough for all requests to arrive, so they're executed as one batch
+  GraphHolder::getInstance().enableBatching(graphId, numThreads, 10000000);
+
+  std::vector<float> results(numThreads, 0.f);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < numThreads; t++)
+    threads.emplace_back([&, t] { results[t] = execute(graphId, -static_cast<float>(t + 1), 1); });
+
+  for (auto& t : threads) t.join();
+
+  for (int t = 0; t < numThreads; t++) ASSERT_NEAR(std::abs(std::cos(t + 1.f)), results[t], 1e-5);
+
+  auto stats = GraphHolder::getInstance().requestBatcher(graphId)->stats();
+  ASSERT_EQ(numThreads, stats.requests);
+  ASSERT_EQ(1, stats.batches);
+  ASSERT_EQ(0, stats.queueDepth);
+  ASSERT_EQ(numThreads, stats.maxQueueDepth);
+  ASSERT_NEAR(numThreads, stats.meanBatchSize, 1e-5);
+
+  GraphHolder::getInstance().dropGraphAny(graphId);
+  ASSERT_TRUE(GraphHolder::getInstance().requestBatcher(graphId) == nullptr);
+}
+
+TEST_F(GraphHolderTests, Batching_2) {
+  LongType graphId = 125;
+  const int numThreads = 4;
+  const int perThread = 10;
+
+  GraphHolder::getInstance().registerGraph(graphId, buildGraph());
+  GraphHolder::getInstance().enableBatching(graphId, 6, 200);
+
+  // requests of different sizes are split back correctly, and too large ones are executed on their own
+  std::vector<int> failures(numThreads, 0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < numThreads; t++)
+    threads.emplace_back([&, t] {
+      for (int e = 0; e < perThread; e++) {
+        float value = -static_cast<float>(t * perThread + e) / 10.f;
+        LongType rows = 1 + (t + e) % 8;
+        if (std::abs(std::abs(std::cos(value)) - execute(graphId, value, rows)) > 1e-5) failures[t]++;
+      }
+    });
+
+  for (auto& t : threads) t.join();
+
+  for (auto f : failures) ASSERT_EQ(0, f);
+
+  auto stats = GraphHolder::getInstance().requestBatcher(graphId)->stats();
+  ASSERT_EQ(numThreads * perThread, stats.requests);
+  ASSERT_GE(numThreads * perThread, stats.batches);
+  ASSERT_LE(stats.p50LatencyMicros, stats.p99LatencyMicros);
+
+  GraphHolder::getInstance().dropGraphAny(graphId);
+}
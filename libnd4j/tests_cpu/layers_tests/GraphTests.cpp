@@ -104,6 +104,39 @@ TEST_F(GraphTests, DoubleInput1) {
   delete graph;
 }
 
+TEST_F(GraphTests, ParallelLayer1) {
+  auto graph = new Graph();
+  graph->getExecutorConfiguration()->_executionMode = ExecutionMode_AUTO;
+
+  // 8 independent branches, so first layer has 8 nodes to run concurrently
+  const int numBranches = 8;
+  for (int e = 1; e <= numBranches; e++) {
+    auto x = NDArrayFactory::create_<float>('c', {64, 64});
+    x->assign(-static_cast<float>(e));
+    graph->getVariableSpace()->putVariable(-e, x);
+
+    graph->addNode(new Node(OpType_TRANSFORM_SAME, transform::Abs, e, {-e}, {numBranches + e}));
+    graph->addNode(new Node(OpType_TRANSFORM_SAME, transform::Neg, numBranches + e, {e}, {}));
+  }
+
+  ASSERT_EQ(numBranches, graph->rootNodes());
+
+  ASSERT_EQ(Status::OK, GraphExecutioner::execute(graph));
+
+  for (int e = 1; e <= numBranches; e++) {
+    ASSERT_TRUE(graph->getVariableSpace()->hasVariable(e));
+    ASSERT_TRUE(graph->getVariableSpace()->hasVariable(numBranches + e));
+
+    auto abs = graph->getVariableSpace()->getVariable(e)->getNDArray();
+    auto neg = graph->getVariableSpace()->getVariable(numBranches + e)->getNDArray();
+
+    ASSERT_NEAR(static_cast<float>(e), abs->reduceNumber(reduce::Mean).e<float>(0), 1e-5);
+    ASSERT_NEAR(-static_cast<float>(e), neg->reduceNumber(reduce::Mean).e<float>(0), 1e-5);
+  }
+
+  delete graph;
+}
+
 TEST_F(GraphTests, SingleInput3) {
   auto graph = new Graph();
 
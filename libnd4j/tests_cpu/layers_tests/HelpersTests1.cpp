@@ -1656,6 +1656,96 @@ TEST_F(HelpersTests1, mmmulHelperAgain) {
   ASSERT_TRUE(e.equalsTo(z));
 }
 
+////////////////////////////////////////////////////////////////////
+// straightforward triple loop, the way fallback gemm used to work
+static void naiveGemm(NDArray &a, NDArray &b, NDArray &c, double alpha, double beta) {
+  for (LongType i = 0; i < c.sizeAt(0); i++)
+    for (LongType j = 0; j < c.sizeAt(1); j++) {
+      double sum = 0.;
+      for (LongType k = 0; k < a.sizeAt(1); k++) sum += a.e<double>(i, k) * b.e<double>(k, j);
+      c.p<double>(i, j, alpha * sum + beta * c.e<double>(i, j));
+    }
+}
+
+static void fillPattern(NDArray &x, int modulo) {
+  for (LongType i = 0; i < x.lengthOf(); i++) x.p(i, static_cast<int>(i % modulo) - modulo / 2);
+}
+
+////////////////////////////////////////////////////////////////////
+TEST_F(HelpersTests1, mmulHelper_blockedGemm_1) {
+  NDArray x('c', {67, 129}, INT32);
+  NDArray y('f', {129, 45}, INT32);
+  NDArray z('c', {67, 45}, INT32);
+  NDArray e('c', {67, 45}, INT32);
+
+  fillPattern(x, 7);
+  fillPattern(y, 5);
+  e.assign(0);
+
+  MmulHelper::mmul(&x, &y, &z, 1., 0.);
+  naiveGemm(x, y, e, 1., 0.);
+
+  ASSERT_TRUE(e.equalsTo(z));
+}
+
+////////////////////////////////////////////////////////////////////
+TEST_F(HelpersTests1, mmulHelper_blockedGemm_2) {
+  // column-major A is laid out the same way as transposed row-major one
+  NDArray x('f', {33, 40}, BFLOAT16);
+  NDArray y('c', {40, 21}, BFLOAT16);
+  NDArray z('f', {33, 21}, BFLOAT16);
+
+  fillPattern(x, 5);
+  fillPattern(y, 3);
+  fillPattern(z, 4);
+
+  auto e = z.dup('c');
+
+  MmulHelper::mmul(&x, &y, &z, 2., 0.5);
+  naiveGemm(x, y, e, 2., 0.5);
+
+  ASSERT_TRUE(e.equalsTo(z));
+}
+
+////////////////////////////////////////////////////////////////////
+TEST_F(HelpersTests1, mmulHelper_blockedGemm_3) {
+  NDArray x('c', {3, 300}, HALF);
+  NDArray y('c', {300, 1}, HALF);
+  NDArray z('c', {3, 1}, HALF);
+  NDArray e('c', {3, 1}, HALF);
+
+  x.assign(0.25);
+  y.assign(0.25);
+  e.assign(18.75);
+
+  // accumulation happens in float, so summing many small half products doesn't lose precision
+  MmulHelper::mmul(&x, &y, &z, 1., 0.);
+
+  ASSERT_TRUE(e.equalsTo(z));
+}
+
+////////////////////////////////////////////////////////////////////
+TEST_F(HelpersTests1, mmulHelper_blockedGemm_4) {
+  // sizes aren't multiples of any block size, so edge panels are covered for every packed type
+  const LongType M = 67, N = 45, K = 131;
+
+  for (auto dtype : {HALF, BFLOAT16, INT16}) {
+    NDArray x('c', {M, K}, dtype);
+    NDArray y('c', {K, N}, dtype);
+    NDArray z('c', {M, N}, dtype);
+    NDArray e('c', {M, N}, dtype);
+
+    fillPattern(x, 3);
+    fillPattern(y, 3);
+    e.assign(0);
+
+    MmulHelper::mmul(&x, &y, &z, 1., 0.);
+    naiveGemm(x, y, e, 1., 0.);
+
+    ASSERT_TRUE(e.equalsTo(z));
+  }
+}
+
 ////////////////////////////////////////////////////////////////////
 TEST_F(HelpersTests1, OpArgsHolder_test1) {
   auto x1 = NDArrayFactory::create<float>('c', {1, 1});
@@ -2585,3 +2675,166 @@ TEST_F(HelpersTests1, lstmLayerCell_3) {
   ASSERT_TRUE(expC.isSameShape(c));
   ASSERT_TRUE(expC.equalsTo(c));
 }
+
+///////////////////////////////////////////////////////////////////
+// time loop with input projection hoisted out of recurrence vs. cell by cell evaluation
+TEST_F(HelpersTests1, lstmLayerTimeLoop_1) {
+  const int sL = 17;
+  const int bS = 3;
+  const int nIn = 5;
+  const int nOut = 4;
+
+  const float dataFormat = 1;  // [bS, sL, nIn]
+  const float cellClip = 1.2;  // clipping value
+  const float gateAct = 2;     // sigmoid activation for input (i), forget (f) and output (o) gates
+  const float cellAct = 0;     // tanh activation for cell state
+  const float outAct = 0;      // tanh activation for output
+
+  std::vector<float> params = {dataFormat, 0, cellClip, gateAct, 0, 0, cellAct, 0, 0, outAct, 0, 0};
+
+  NDArray x('c', {bS, sL, nIn}, FLOAT32);
+  NDArray Wx('c', {nIn, 4 * nOut}, FLOAT32);
+  NDArray Wr('c', {nOut, 4 * nOut}, FLOAT32);
+  NDArray b('c', {4 * nOut}, FLOAT32);
+  NDArray hI('c', {bS, nOut}, FLOAT32);
+  NDArray cI('c', {bS, nOut}, FLOAT32);
+  NDArray Wp('c', {3 * nOut}, FLOAT32);
+  NDArray seqLen('c', {bS}, {sL, 7, 1}, FLOAT32);
+
+  NDArray h('c', {bS, sL, nOut}, FLOAT32);
+  NDArray hL('c', {bS, nOut}, FLOAT32);
+  NDArray cL('c', {bS, nOut}, FLOAT32);
+  NDArray hLFull('c', {bS, nOut}, FLOAT32);
+  NDArray cLFull('c', {bS, nOut}, FLOAT32);
+
+  x.linspace(-1.7, 0.04);
+  Wx.linspace(0.4, -0.01);
+  Wr.linspace(-0.3, 0.015);
+  b.linspace(0.1, 0.02);
+  hI.linspace(-0.2, 0.03);
+  cI.linspace(0.5, -0.08);
+  Wp.linspace(0.3, -0.05);
+
+  ops::helpers::lstmLayerTimeLoop(&x, &Wx, &Wr, &b, &seqLen, &hI, &cI, &Wp, params, true, &h, &hL, &cL);
+  ops::helpers::lstmLayerTimeLoop(&x, &Wx, &Wr, &b, nullptr, &hI, &cI, &Wp, params, true, nullptr, &hLFull, &cLFull);
+
+  for (int e = 0; e < bS; ++e) {
+    const int limit = seqLen.e<int>(e);
+
+    NDArray hRef = hI({e, e + 1, 0, 0}).dup();
+    NDArray cRef = cI({e, e + 1, 0, 0}).dup();
+
+    for (int t = 0; t < limit; ++t) {
+      auto xt = x({e, e + 1, t, t + 1, 0, 0});
+      ops::helpers::lstmLayerCell(&xt, &Wx, &Wr, &b, &hRef, &cRef, &Wp, params, &hRef, &cRef);
+      ASSERT_TRUE(hRef.equalsTo(h({e, e + 1, t, t + 1, 0, 0})));
+    }
+
+    ASSERT_TRUE(hRef.equalsTo(hL({e, e + 1, 0, 0})));
+    ASSERT_TRUE(cRef.equalsTo(cL({e, e + 1, 0, 0})));
+
+    if (limit == sL) {
+      ASSERT_TRUE(hRef.equalsTo(hLFull({e, e + 1, 0, 0})));
+      ASSERT_TRUE(cRef.equalsTo(cLFull({e, e + 1, 0, 0})));
+    }
+  }
+}
+
+///////////////////////////////////////////////////////////////////
+// backprop time loop with input related gradients hoisted out of recurrence vs. cell by cell evaluation
+TEST_F(HelpersTests1, lstmLayerTimeLoopBp_1) {
+  const int sL = 9;
+  const int bS = 2;
+  const int nIn = 3;
+  const int nOut = 4;
+
+  const float dataFormat = 1;  // [bS, sL, nIn]
+  const float cellClip = 0;    // no clipping
+  const float gateAct = 2;     // sigmoid activation for input (i), forget (f) and output (o) gates
+  const float cellAct = 0;     // tanh activation for cell state
+  const float outAct = 0;      // tanh activation for output
+
+  std::vector<float> params = {dataFormat, 0, cellClip, gateAct, 0, 0, cellAct, 0, 0, outAct, 0, 0};
+
+  NDArray x('c', {bS, sL, nIn}, DOUBLE);
+  NDArray Wx('c', {nIn, 4 * nOut}, DOUBLE);
+  NDArray Wr('c', {nOut, 4 * nOut}, DOUBLE);
+  NDArray b('c', {4 * nOut}, DOUBLE);
+  NDArray hI('c', {bS, nOut}, DOUBLE);
+  NDArray cI('c', {bS, nOut}, DOUBLE);
+  NDArray Wp('c', {3 * nOut}, DOUBLE);
+  NDArray dLdh('c', {bS, sL, nOut}, DOUBLE);
+  NDArray dLdhL('c', {bS, nOut}, DOUBLE);
+  NDArray dLdcL('c', {bS, nOut}, DOUBLE);
+
+  x.linspace(-1.2, 0.05);
+  Wx.linspace(0.5, -0.02);
+  Wr.linspace(-0.4, 0.025);
+  b.linspace(0.2, -0.03);
+  hI.linspace(-0.3, 0.07);
+  cI.linspace(0.6, -0.1);
+  Wp.linspace(-0.2, 0.04);
+  dLdh.linspace(0.5, -0.01);
+  dLdhL.linspace(-0.25, 0.1);
+  dLdcL.linspace(0.15, 0.05);
+
+  NDArray dLdx('c', {bS, sL, nIn}, DOUBLE);
+  NDArray dLdWx('c', {nIn, 4 * nOut}, DOUBLE);
+  NDArray dLdWr('c', {nOut, 4 * nOut}, DOUBLE);
+  NDArray dLdb('c', {4 * nOut}, DOUBLE);
+  NDArray dLdhI('c', {bS, nOut}, DOUBLE);
+  NDArray dLdcI('c', {bS, nOut}, DOUBLE);
+  NDArray dLdWp('c', {3 * nOut}, DOUBLE);
+
+  ops::helpers::lstmLayerTimeLoopBp(&x, &Wx, &Wr, &b, nullptr, &hI, &cI, &Wp, &dLdh, &dLdhL, &dLdcL, params, true,
+                                    &dLdx, &dLdWx, &dLdWr, &dLdb, &dLdhI, &dLdcI, &dLdWp);
+
+  // reference: ff and bp cell by cell
+  NDArray hs('c', {sL + 1, bS, nOut}, DOUBLE);
+  NDArray cs('c', {sL + 1, bS, nOut}, DOUBLE);
+  NDArray zs('c', {sL, bS, 4 * nOut}, DOUBLE);
+  NDArray as('c', {sL, bS, 4 * nOut}, DOUBLE);
+  hs({0, 1, 0, 0, 0, 0}).assign(&hI);
+  cs({0, 1, 0, 0, 0, 0}).assign(&cI);
+
+  for (int t = 0; t < sL; ++t) {
+    auto xt = x({0, 0, t, t + 1, 0, 0});
+    auto hPrev = hs({t, t + 1, 0, 0, 0, 0});
+    auto cPrev = cs({t, t + 1, 0, 0, 0, 0});
+    auto hNext = hs({t + 1, t + 2, 0, 0, 0, 0});
+    auto cNext = cs({t + 1, t + 2, 0, 0, 0, 0});
+    auto zt = zs({t, t + 1, 0, 0, 0, 0});
+    auto at = as({t, t + 1, 0, 0, 0, 0});
+    ops::helpers::lstmLayerCell(&xt, &Wx, &Wr, &b, &hPrev, &cPrev, &Wp, params, &zt, &at, &hNext, &cNext);
+  }
+
+  NDArray dLdxRef('c', {bS, sL, nIn}, DOUBLE);
+  NDArray dLdWxRef('c', {nIn, 4 * nOut}, DOUBLE);
+  NDArray dLdWrRef('c', {nOut, 4 * nOut}, DOUBLE);
+  NDArray dLdbRef('c', {4 * nOut}, DOUBLE);
+  NDArray dLdhIRef('c', {bS, nOut}, DOUBLE);
+  NDArray dLdcIRef('c', {bS, nOut}, DOUBLE);
+  NDArray dLdWpRef('c', {3 * nOut}, DOUBLE);
+
+  for (int t = sL - 1; t >= 0; --t) {
+    auto xt = x({0, 0, t, t + 1, 0, 0});
+    auto dLdxt = dLdxRef({0, 0, t, t + 1, 0, 0});
+    auto dLdht = dLdh({0, 0, t, t + 1, 0, 0});
+    auto hPrev = hs({t, t + 1, 0, 0, 0, 0});
+    auto cPrev = cs({t, t + 1, 0, 0, 0, 0});
+    auto cNext = cs({t + 1, t + 2, 0, 0, 0, 0});
+    auto zt = zs({t, t + 1, 0, 0, 0, 0});
+    auto at = as({t, t + 1, 0, 0, 0, 0});
+    ops::helpers::lstmLayerCellBp(&xt, &Wx, &Wr, &b, &hPrev, &cPrev, &Wp, &dLdht, t == sL - 1 ? &dLdhL : nullptr,
+                                  t == sL - 1 ? &dLdcL : nullptr, &zt, &at, &cNext, params, &dLdxt, &dLdWxRef,
+                                  &dLdWrRef, &dLdhIRef, &dLdcIRef, &dLdbRef, &dLdWpRef);
+  }
+
+  ASSERT_TRUE(dLdxRef.equalsTo(dLdx));
+  ASSERT_TRUE(dLdWxRef.equalsTo(dLdWx));
+  ASSERT_TRUE(dLdWrRef.equalsTo(dLdWr));
+  ASSERT_TRUE(dLdbRef.equalsTo(dLdb));
+  ASSERT_TRUE(dLdhIRef.equalsTo(dLdhI));
+  ASSERT_TRUE(dLdcIRef.equalsTo(dLdcI));
+  ASSERT_TRUE(dLdWpRef.equalsTo(dLdWp));
+}
@@ -21,6 +21,7 @@
 //
 #include <array/NDArray.h>
 #include <helpers/ConstantTadHelper.h>
+#include <helpers/CpuIsa.h>
 #include <helpers/ShapeUtils.h>
 
 #include <loops/reduce3.h>
@@ -682,3 +683,42 @@ TEST_F(LegacyOpsTests, test_legacy_transform_float_1) {
                                           x.shapeInfo(), x.specialBuffer(), x.specialShapeInfo(), nullptr, nullptr,
                                           nullptr);
 }
+
+TEST_F(LegacyOpsTests, isa_dispatch_test_1) {
+  ASSERT_LE(CpuIsa::activeLevel(), CpuIsa::hostLevel());
+
+  const int length = 10007;
+  auto x = NDArrayFactory::create<float>('c', {length});
+  auto y = NDArrayFactory::create<float>('c', {length});
+  auto xBuffer = x.bufferAsT<float>();
+  auto yBuffer = y.bufferAsT<float>();
+  for (int e = 0; e < length; e++) {
+    xBuffer[e] = 0.001f * static_cast<float>(e % 1000);
+    yBuffer[e] = 1.f - 0.0005f * static_cast<float>(e % 2000);
+  }
+
+  auto oldLevel = Environment::getInstance().maxIsaLevel();
+  Environment::getInstance().setMaxIsaLevel(CpuIsa::GENERIC);
+  ASSERT_EQ(CpuIsa::GENERIC, CpuIsa::activeLevel());
+
+  auto sum = x + y;
+  auto scaled = x * 2.f;
+  auto exp = x.transform(transform::Exp);
+  auto total = x.reduceNumber(reduce::Sum).e<float>(0);
+
+  // every level this host supports has to give the same results as the generic loops
+  for (int level = CpuIsa::AVX2; level <= CpuIsa::hostLevel(); level++) {
+    Environment::getInstance().setMaxIsaLevel(level);
+    ASSERT_EQ(level, CpuIsa::activeLevel());
+
+    auto otherSum = x + y;
+    auto otherScaled = x * 2.f;
+    auto otherExp = x.transform(transform::Exp);
+    ASSERT_TRUE(sum.equalsTo(otherSum));
+    ASSERT_TRUE(scaled.equalsTo(otherScaled));
+    ASSERT_TRUE(exp.equalsTo(otherExp));
+    ASSERT_NEAR(total, x.reduceNumber(reduce::Sum).e<float>(0), 1e-2f);
+  }
+
+  Environment::getInstance().setMaxIsaLevel(oldLevel);
+}
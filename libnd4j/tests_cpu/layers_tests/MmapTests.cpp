@@ -23,7 +23,10 @@
 #include <legacy/NativeOps.h>
 #include <ops/declarable/CustomOperations.h>
 
+#include <cstring>
 #include <fstream>
+#include <string>
+#include <vector>
 
 #include "testlayers.h"
 
@@ -54,3 +57,131 @@ TEST_F(MmapTests, Test_Basic_Mmap_1) {
 
   remove("file");
 }
+
+// .npy stream for float array, header is padded so data starts at 64 bytes boundary
+static std::string npyBytes(const std::string &shape, const std::vector<float> &values) {
+  std::string header = "{'descr': '<f4', 'fortran_order': False, 'shape': " + shape + ", }";
+  while ((10 + header.size() + 1) % 64 != 0) header += ' ';
+  header += '\n';
+
+  std::string result("\x93NUMPY\x01\x00", 8);
+  result += static_cast<char>(header.size() & 0xFF);
+  result += static_cast<char>(header.size() >> 8);
+  result += header;
+  result.append(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(float));
+  return result;
+}
+
+template <typename T>
+static void appendLittleEndian(std::string &buffer, T value) {
+  buffer.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+// minimal zip archive with stored members, the way numpy.savez writes it
+static void writeNpz(const char *fileName, const std::vector<std::pair<std::string, std::string>> &members,
+                     uint16_t method = 0) {
+  std::string archive, directory;
+  for (auto &m : members) {
+    auto name = m.first + ".npy";
+    auto offset = static_cast<uint32_t>(archive.size());
+    auto size = static_cast<uint32_t>(m.second.size());
+
+    appendLittleEndian<uint32_t>(archive, 0x04034b50);
+    appendLittleEndian<uint16_t>(archive, 20);      // version
+    appendLittleEndian<uint16_t>(archive, 0);       // flags
+    appendLittleEndian<uint16_t>(archive, method);
+    appendLittleEndian<uint32_t>(archive, 0);       // time & date
+    appendLittleEndian<uint32_t>(archive, 0);       // crc32, not verified
+    appendLittleEndian<uint32_t>(archive, size);
+    appendLittleEndian<uint32_t>(archive, size);
+    appendLittleEndian<uint16_t>(archive, name.size());
+    appendLittleEndian<uint16_t>(archive, 0);
+    archive += name;
+    archive += m.second;
+
+    appendLittleEndian<uint32_t>(directory, 0x02014b50);
+    appendLittleEndian<uint16_t>(directory, 20);
+    appendLittleEndian<uint16_t>(directory, 20);
+    appendLittleEndian<uint16_t>(directory, 0);
+    appendLittleEndian<uint16_t>(directory, method);
+    appendLittleEndian<uint32_t>(directory, 0);
+    appendLittleEndian<uint32_t>(directory, 0);
+    appendLittleEndian<uint32_t>(directory, size);
+    appendLittleEndian<uint32_t>(directory, size);
+    appendLittleEndian<uint16_t>(directory, name.size());
+    appendLittleEndian<uint16_t>(directory, 0);     // extra
+    appendLittleEndian<uint16_t>(directory, 0);     // comment
+    appendLittleEndian<uint16_t>(directory, 0);     // disk
+    appendLittleEndian<uint16_t>(directory, 0);     // internal attributes
+    appendLittleEndian<uint32_t>(directory, 0);     // external attributes
+    appendLittleEndian<uint32_t>(directory, offset);
+    directory += name;
+  }
+
+  auto directoryOffset = static_cast<uint32_t>(archive.size());
+  archive += directory;
+  appendLittleEndian<uint32_t>(archive, 0x06054b50);
+  appendLittleEndian<uint16_t>(archive, 0);
+  appendLittleEndian<uint16_t>(archive, 0);
+  appendLittleEndian<uint16_t>(archive, members.size());
+  appendLittleEndian<uint16_t>(archive, members.size());
+  appendLittleEndian<uint32_t>(archive, directory.size());
+  appendLittleEndian<uint32_t>(archive, directoryOffset);
+  appendLittleEndian<uint16_t>(archive, 0);
+
+  std::ofstream ofs(fileName, std::ios::binary | std::ios::out);
+  ofs.write(archive.data(), archive.size());
+}
+
+TEST_F(MmapTests, Test_Mmap_Npy_1) {
+  if (!Environment::getInstance().isCPU()) return;
+
+  auto exp = NDArrayFactory::create<float>('c', {3, 4});
+  exp.linspace(0);
+
+  auto array = NDArrayFactory::mmapNpyFile("./resources/arr_3,4_float32.npy");
+
+  ASSERT_EQ(exp, *array);
+
+  delete array->dataBuffer();
+  delete array;
+}
+
+TEST_F(MmapTests, Test_Mmap_Npz_1) {
+  if (!Environment::getInstance().isCPU()) return;
+
+  auto a = NDArrayFactory::create<float>('c', {2, 3}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f});
+  auto b = NDArrayFactory::create<float>('c', {4}, {-1.f, -2.f, -3.f, -4.f});
+  auto c = NDArrayFactory::create<float>(7.f);
+
+  writeNpz("mmap_test.npz", {{"a", npyBytes("(2, 3)", {1.f, 2.f, 3.f, 4.f, 5.f, 6.f})},
+                             {"b", npyBytes("(4,)", {-1.f, -2.f, -3.f, -4.f})},
+                             {"c", npyBytes("()", {7.f})}});
+
+  auto arrays = NDArrayFactory::mmapNpzFile("mmap_test.npz");
+
+  ASSERT_EQ(3, arrays.size());
+  ASSERT_EQ(a, *arrays["a"]);
+  ASSERT_EQ(b, *arrays["b"]);
+  ASSERT_EQ(c, *arrays["c"]);
+
+  // arrays keep mapping alive, even after the file is gone
+  remove("mmap_test.npz");
+  ASSERT_EQ(b, *arrays["b"]);
+
+  for (auto &v : arrays) {
+    delete v.second->dataBuffer();
+    delete v.second;
+  }
+}
+
+TEST_F(MmapTests, Test_Mmap_Npz_2) {
+  if (!Environment::getInstance().isCPU()) return;
+
+  // deflated members can't be mapped
+  writeNpz("mmap_test_deflated.npz", {{"a", npyBytes("(2,)", {1.f, 2.f})}}, 8);
+
+  ASSERT_ANY_THROW(NDArrayFactory::mmapNpzFile("mmap_test_deflated.npz"));
+
+  remove("mmap_test_deflated.npz");
+}
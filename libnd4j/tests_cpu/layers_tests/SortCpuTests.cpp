@@ -23,6 +23,9 @@
 #include <helpers/BitwiseUtils.h>
 #include <legacy/NativeOps.h>
 #include <ops/declarable/CustomOperations.h>
+#include <ops/specials.h>
+
+#include <random>
 
 #include "testlayers.h"
 
@@ -106,3 +109,138 @@ TEST_F(SortCpuTests, test_tad_sort_by_val_1) {
   ASSERT_EQ(ek, k);
   ASSERT_EQ(ev, v);
 }
+
+template <typename T>
+static std::vector<T> randomValues(LongType length, double range, unsigned seed) {
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<double> dist(-range, range);
+
+  std::vector<T> result(length);
+  for (auto &v : result) v = static_cast<T>(dist(gen));
+
+  return result;
+}
+
+TEST_F(SortCpuTests, test_sort_generic_large_1) {
+  if (!Environment::getInstance().isCPU()) return;
+
+  const LongType length = 1 << 21;
+  auto values = randomValues<float>(length, 1e6, 119);
+
+  auto x = NDArrayFactory::create('c', {length}, FLOAT32);
+  std::copy(values.begin(), values.end(), x.bufferAsT<float>());
+
+  SpecialMethods<float>::sortGeneric(&x, false);
+  std::sort(values.begin(), values.end());
+
+  auto buffer = x.bufferAsT<float>();
+  for (LongType e = 0; e < length; e++) ASSERT_EQ(values[e], buffer[e]);
+}
+
+TEST_F(SortCpuTests, test_sort_generic_large_2) {
+  if (!Environment::getInstance().isCPU()) return;
+
+  const LongType length = 1 << 20;
+  auto values = randomValues<LongType>(length, 1e15, 120);
+
+  auto x = NDArrayFactory::create('c', {length}, INT64);
+  std::copy(values.begin(), values.end(), x.bufferAsT<LongType>());
+
+  SpecialMethods<LongType>::sortGeneric(&x, true);
+  std::sort(values.begin(), values.end(), std::greater<LongType>());
+
+  auto buffer = x.bufferAsT<LongType>();
+  for (LongType e = 0; e < length; e++) ASSERT_EQ(values[e], buffer[e]);
+}
+
+TEST_F(SortCpuTests, test_sort_tad_generic_large_1) {
+  if (!Environment::getInstance().isCPU()) return;
+
+  const LongType rows = 3;
+  const LongType columns = 100000;
+  auto values = randomValues<double>(rows * columns, 1e3, 121);
+
+  // sorting columns of 'c' ordered array, so each TAD is strided
+  auto x = NDArrayFactory::create('c', {columns, rows}, DOUBLE);
+  std::copy(values.begin(), values.end(), x.bufferAsT<double>());
+
+  LongType axis = 0;
+  SpecialMethods<double>::sortTadGeneric(&x, &axis, 1, false);
+
+  auto buffer = x.bufferAsT<double>();
+  for (LongType r = 0; r < rows; r++) {
+    std::vector<double> expected(columns);
+    for (LongType c = 0; c < columns; c++) expected[c] = values[c * rows + r];
+    std::sort(expected.begin(), expected.end());
+
+    for (LongType c = 0; c < columns; c++) ASSERT_EQ(expected[c], buffer[c * rows + r]);
+  }
+}
+
+TEST_F(SortCpuTests, test_sort_by_key_large_1) {
+  if (!Environment::getInstance().isCPU()) return;
+
+  const LongType length = 1 << 20;
+
+  // lots of duplicate keys, so values also show sort is stable
+  auto keys = randomValues<int>(length, 1000, 122);
+
+  auto k = NDArrayFactory::create('c', {length}, INT32);
+  auto v = NDArrayFactory::create('c', {length}, INT64);
+  std::copy(keys.begin(), keys.end(), k.bufferAsT<int>());
+  v.linspace(0);
+
+  DoubleMethods<int, LongType>::sortByKey(&k, &v, false);
+
+  auto kBuffer = k.bufferAsT<int>();
+  auto vBuffer = v.bufferAsT<LongType>();
+  for (LongType e = 0; e < length; e++) {
+    ASSERT_EQ(keys[vBuffer[e]], kBuffer[e]);
+    if (e > 0) {
+      ASSERT_LE(kBuffer[e - 1], kBuffer[e]);
+      if (kBuffer[e - 1] == kBuffer[e]) ASSERT_LT(vBuffer[e - 1], vBuffer[e]);
+    }
+  }
+}
+
+TEST_F(SortCpuTests, test_sort_by_value_large_1) {
+  if (!Environment::getInstance().isCPU()) return;
+
+  const LongType length = 1 << 20;
+  auto values = randomValues<float>(length, 1e3, 123);
+
+  auto k = NDArrayFactory::create('c', {length}, INT64);
+  auto v = NDArrayFactory::create('c', {length}, FLOAT32);
+  k.linspace(0);
+  std::copy(values.begin(), values.end(), v.bufferAsT<float>());
+
+  DoubleMethods<LongType, float>::sortByValue(&k, &v, true);
+
+  auto kBuffer = k.bufferAsT<LongType>();
+  auto vBuffer = v.bufferAsT<float>();
+  for (LongType e = 0; e < length; e++) {
+    ASSERT_EQ(values[kBuffer[e]], vBuffer[e]);
+    if (e > 0) ASSERT_GE(vBuffer[e - 1], vBuffer[e]);
+  }
+}
+
+TEST_F(SortCpuTests, test_sort_by_key_large_2) {
+  if (!Environment::getInstance().isCPU()) return;
+
+  const LongType length = 1 << 16;
+  auto keys = randomValues<double>(length, 1e6, 125);
+
+  auto k = NDArrayFactory::create('c', {length}, DOUBLE);
+  auto v = NDArrayFactory::create('c', {length}, INT64);
+  std::copy(keys.begin(), keys.end(), k.bufferAsT<double>());
+  v.linspace(0);
+
+  DoubleMethods<double, LongType>::sortByKey(&k, &v, false);
+
+  auto kBuffer = k.bufferAsT<double>();
+  auto vBuffer = v.bufferAsT<LongType>();
+  for (LongType e = 0; e < length; e++) {
+    ASSERT_EQ(keys[vBuffer[e]], kBuffer[e]);
+    if (e > 0) ASSERT_LE(kBuffer[e - 1], kBuffer[e]);
+  }
+}
@@ -19,8 +19,10 @@
 //
 // @author raver119@gmail.com
 //
+#include <execution/NumaTopology.h>
 #include <execution/ThreadPool.h>
 #include <execution/Threads.h>
+#include <execution/WorkStealingScheduler.h>
 #include <loops/type_conversions.h>
 #include <ops/declarable/CustomOperations.h>
 
@@ -212,3 +214,199 @@ TEST_F(ThreadsTests, crash_test_1) {
 }
 
 
+
+TEST_F(ThreadsTests, numa_cpulist_1) {
+  ASSERT_EQ(std::vector<int>({0, 1, 2, 3}), NumaTopology::parseCpuList("0-3"));
+  ASSERT_EQ(std::vector<int>({0, 1, 8, 10, 11}), NumaTopology::parseCpuList("0-1,8,10-11\n"));
+  ASSERT_TRUE(NumaTopology::parseCpuList("").empty());
+}
+
+TEST_F(ThreadsTests, numa_topology_1) {
+  auto &topology = NumaTopology::getInstance();
+  ASSERT_LE(1, topology.numberOfNodes());
+
+  // every CPU belongs to exactly the node that lists it
+  for (int node = 0; node < topology.numberOfNodes(); node++)
+    for (auto cpu : topology.cpusOfNode(node)) ASSERT_EQ(node, topology.nodeOfCpu(cpu));
+
+  auto node = topology.currentNode();
+  ASSERT_TRUE(node >= 0 && node < topology.numberOfNodes());
+}
+
+TEST_F(ThreadsTests, numa_parallel_for_1) {
+  Environment::getInstance().setNumaAware(true);
+
+  std::vector<int> values(1024 * 64, 0);
+  auto func = PRAGMA_THREADS_FOR {
+    for (auto e = start; e < stop; e++) values[e] += 1;
+  };
+
+  Threads::parallel_for(func, 0, values.size());
+  Environment::getInstance().setNumaAware(false);
+
+  for (auto v : values) ASSERT_EQ(1, v);
+}
+
+TEST_F(ThreadsTests, work_stealing_test_1) {
+  const int numThreads = 4;
+  const int numChunks = 1000;
+
+  std::vector<std::atomic<int>> visits(numChunks);
+  std::vector<std::atomic<int>> running(numThreads);
+  std::atomic<int> violations{0};
+
+  WorkStealingScheduler::getInstance().run(numThreads, numChunks, [&](uint64_t threadId, int64_t chunk) {
+    // thread ids must stay within requested range, and never run concurrently
+    if (threadId >= numThreads || running[threadId].fetch_add(1) != 0) violations++;
+
+    visits[chunk]++;
+
+    if (threadId < numThreads) running[threadId]--;
+  });
+
+  ASSERT_EQ(0, violations.load());
+  for (auto &v : visits) ASSERT_EQ(1, v.load());
+}
+
+TEST_F(ThreadsTests, work_stealing_test_2) {
+  Environment::getInstance().setWorkStealing(true);
+
+  // cost of each element grows with its index, so static split leaves last thread as straggler
+  std::vector<double> values(2048, 0.0);
+  auto func = PRAGMA_THREADS_FOR {
+    for (auto e = start; e < stop; e++) {
+      double sum = 0.0;
+      for (int i = 0; i < e * 10; i++) sum += 1.0;
+      values[e] = sum;
+    }
+  };
+
+  Threads::parallel_tad(func, 0, values.size());
+  Environment::getInstance().setWorkStealing(false);
+
+  for (size_t e = 0; e < values.size(); e++) ASSERT_EQ(e * 10.0, values[e]);
+}
+
+TEST_F(ThreadsTests, work_stealing_test_3) {
+  Environment::getInstance().setWorkStealing(true);
+
+  const int outer = 64;
+  const int inner = 256;
+  std::vector<std::atomic<int>> visits(outer * inner);
+
+  // nested regions are executed through the same scheduler instead of falling back to single thread
+  auto func = PRAGMA_THREADS_FOR {
+    for (auto o = start; o < stop; o++) {
+      auto innerFunc = PRAGMA_THREADS_FOR {
+        for (auto i = start; i < stop; i++) visits[o * inner + i]++;
+      };
+
+      Threads::parallel_tad(innerFunc, 0, inner);
+    }
+  };
+
+  Threads::parallel_tad(func, 0, outer);
+  Environment::getInstance().setWorkStealing(false);
+
+  for (auto &v : visits) ASSERT_EQ(1, v.load());
+}
+
+TEST_F(ThreadsTests, work_stealing_test_4) {
+  if (std::thread::hardware_concurrency() < 2) return;
+
+  Environment::getInstance().setWorkStealing(true);
+
+  // first chunk blocks its thread, so the rest of the loop has to be taken by others
+  std::vector<std::atomic<int>> perThread(64);
+  auto func = PRAGMA_THREADS_FOR {
+    if (start == 0) std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    for (auto e = start; e < stop; e++) perThread[thread_id]++;
+  };
+
+  auto numThreads = Threads::parallel_tad(func, 0, 1024, 1, 4);
+  Environment::getInstance().setWorkStealing(false);
+
+  int participants = 0;
+  int total = 0;
+  for (auto &v : perThread) {
+    participants += v.load() > 0 ? 1 : 0;
+    total += v.load();
+  }
+
+  ASSERT_EQ(1024, total);
+  ASSERT_LT(1, participants);
+  ASSERT_GE(numThreads, participants);
+}
+
+TEST_F(ThreadsTests, work_stealing_test_5) {
+  // index reductions keep one partial result per slot, ties must still resolve to the first index
+  const LongType length = 1 << 20;
+  auto x = NDArrayFactory::create<float>('c', {length});
+  x.p(1000, 5.f);
+  x.p(length - 1000, 5.f);
+  x.p(2000, -5.f);
+  x.p(length - 2000, -5.f);
+
+  Environment::getInstance().setWorkStealing(true);
+
+  ops::argmax argmax;
+  auto resultMax = argmax.evaluate({&x}, {}, {0});
+  ops::argmin argmin;
+  auto resultMin = argmin.evaluate({&x}, {}, {0});
+  auto indexMax = x.indexReduceNumber(indexreduce::IndexMax);
+
+  Environment::getInstance().setWorkStealing(false);
+
+  ASSERT_EQ(sd::Status::OK, resultMax.status());
+  ASSERT_EQ(sd::Status::OK, resultMin.status());
+  ASSERT_EQ(1000, resultMax.at(0)->e<LongType>(0));
+  ASSERT_EQ(2000, resultMin.at(0)->e<LongType>(0));
+  ASSERT_EQ(1000, indexMax.e<LongType>(0));
+}
+
+TEST_F(ThreadsTests, work_stealing_test_6) {
+  auto x = NDArrayFactory::create<double>('c', {1 << 20});
+  x.linspace(1.);
+
+  ops::reduce_variance variance;
+  ops::reduce_stdev stdev;
+  auto expVariance = variance.evaluate({&x}, {}, {0});
+  auto expStdev = stdev.evaluate({&x}, {}, {0});
+
+  Environment::getInstance().setWorkStealing(true);
+
+  auto resultVariance = variance.evaluate({&x}, {}, {0});
+  auto resultStdev = stdev.evaluate({&x}, {}, {0});
+
+  Environment::getInstance().setWorkStealing(false);
+
+  ASSERT_EQ(sd::Status::OK, resultVariance.status());
+  ASSERT_EQ(sd::Status::OK, resultStdev.status());
+  ASSERT_TRUE(expVariance.at(0)->equalsTo(resultVariance.at(0)));
+  ASSERT_TRUE(expStdev.at(0)->equalsTo(resultStdev.at(0)));
+}
+
+TEST_F(ThreadsTests, thread_budget_test_1) {
+  ASSERT_EQ(0, Threads::threadBudget());
+
+  Threads::setThreadBudget(2);
+
+  std::atomic<int> visits{0};
+  auto func = PRAGMA_THREADS_FOR {
+    for (auto e = start; e < stop; e++) visits++;
+  };
+
+  // budget caps whatever was requested
+  ASSERT_GE(2, Threads::parallel_tad(func, 0, 1024, 1, 8));
+  ASSERT_EQ(1024, visits.load());
+
+  // and it's thread-local
+  int otherBudget = -1;
+  std::thread t([&]() { otherBudget = Threads::threadBudget(); });
+  t.join();
+  ASSERT_EQ(0, otherBudget);
+
+  Threads::setThreadBudget(0);
+  ASSERT_EQ(0, Threads::threadBudget());
+}
@@ -69,3 +69,96 @@ TEST_F(TypeCastTests, Test_ConvertDtype_1) {
 
 #endif
 }
+
+TEST_F(TypeCastTests, Test_Threshold64_RoundTrip_1) {
+#ifndef __CUDABLAS__
+  // sparse head, dense middle block and a partial tail block, so hybrid mode emits both record kinds
+  const LongType length = 3 * 4096 + 123;
+  const float threshold = 0.5f;
+  std::vector<float> original(length);
+  for (LongType e = 0; e < length; e++) {
+    auto dense = e >= 4096 && e < 2 * 4096;
+    original[e] = (dense || e % 97 == 0) ? (e % 2 == 0 ? 1.f : -0.75f) : 0.01f * static_cast<float>(e % 7);
+  }
+
+  for (int compression : {THRESHOLD_INDICES_RAW, THRESHOLD_INDICES_VARINT, THRESHOLD_INDICES_HYBRID}) {
+    auto residual = original;
+    std::vector<int8_t> encoded(TypeCast::estimateThreshold64Size(length, length, compression));
+    auto header = reinterpret_cast<ThresholdHeader *>(encoded.data());
+    header->capacity = length;
+    header->threshold = threshold;
+    header->compression = compression;
+
+    TypeCast::convertToThreshold64<float>(nullptr, residual.data(), length, encoded.data());
+    ASSERT_EQ(length, header->length);
+    ASSERT_LE(static_cast<LongType>(sizeof(ThresholdHeader)) + header->payloadBytes,
+              static_cast<LongType>(encoded.size()));
+
+    std::vector<float> decoded(length, 0.f);
+    TypeCast::convertFromThreshold64<float>(nullptr, encoded.data(), length, decoded.data());
+
+    LongType hits = 0;
+    for (LongType e = 0; e < length; e++) {
+      if (original[e] >= threshold || original[e] <= -threshold) hits++;
+      ASSERT_NEAR(original[e], residual[e] + decoded[e], 1e-5f);
+      ASSERT_LT(std::fabs(residual[e]), threshold);
+    }
+    ASSERT_EQ(hits, header->encoded);
+  }
+#endif
+}
+
+TEST_F(TypeCastTests, Test_Threshold64_Capacity_1) {
+#ifndef __CUDABLAS__
+  // only the first `capacity` hits in index order get encoded, the rest stay in the residual untouched
+  const LongType length = 2 * 4096 + 7;
+  const LongType capacity = 1000;
+  std::vector<float> original(length);
+  for (LongType e = 0; e < length; e++) original[e] = e % 3 == 0 ? -2.f : 0.f;
+
+  for (int compression : {THRESHOLD_INDICES_RAW, THRESHOLD_INDICES_VARINT, THRESHOLD_INDICES_HYBRID}) {
+    auto residual = original;
+    std::vector<int8_t> encoded(TypeCast::estimateThreshold64Size(length, capacity, compression));
+    auto header = reinterpret_cast<ThresholdHeader *>(encoded.data());
+    header->capacity = capacity;
+    header->threshold = 1.f;
+    header->compression = compression;
+
+    TypeCast::convertToThreshold64<float>(nullptr, residual.data(), length, encoded.data());
+    ASSERT_EQ(capacity, header->encoded);
+
+    std::vector<float> decoded(length, 0.f);
+    TypeCast::convertFromThreshold64<float>(nullptr, encoded.data(), length, decoded.data());
+
+    for (LongType e = 0; e < length; e++) {
+      auto expected = e % 3 == 0 && e / 3 < capacity ? -1.f : 0.f;
+      ASSERT_NEAR(expected, decoded[e], 1e-5f);
+      ASSERT_NEAR(original[e], residual[e] + decoded[e], 1e-5f);
+    }
+  }
+#endif
+}
+
+TEST_F(TypeCastTests, Test_Threshold_Legacy_1) {
+#ifndef __CUDABLAS__
+  const int length = 5000;
+  const int limit = 10;
+  std::vector<float> x(length, 0.f);
+  for (int e = 0; e < length; e += 250) x[e] = e % 500 == 0 ? 1.5f : -1.5f;
+
+  std::vector<int> encoded(4 + limit, 0);
+  FloatBits fb;
+  fb.f_ = 1.f;
+  encoded[0] = limit;
+  encoded[2] = fb.i_;
+
+  TypeCast::convertToThreshold<float>(nullptr, x.data(), length, encoded.data());
+  ASSERT_EQ(length, encoded[1]);
+
+  // encoded indices come out in index order
+  for (int e = 0; e < limit; e++) ASSERT_EQ(e % 2 == 0 ? e * 250 + 1 : -(e * 250) - 1, encoded[4 + e]);
+
+  ASSERT_NEAR(0.5f, x[0], 1e-5f);
+  ASSERT_NEAR(1.5f, x[limit * 250], 1e-5f);
+#endif
+}
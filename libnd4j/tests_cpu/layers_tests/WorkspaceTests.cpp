@@ -0,0 +1,245 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Workspace allocation tests
+//
+#include <execution/Threads.h>
+#include <memory/Workspace.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "testlayers.h"
+
+using namespace sd;
+using namespace sd::memory;
+
+class WorkspaceTests : public NDArrayTests {
+ public:
+};
+
+TEST_F(WorkspaceTests, BasicInitialization_1) {
+  if (!Environment::getInstance().isCPU()) return;
+
+  Workspace workspace(1024);
+
+  ASSERT_EQ(1024, workspace.getCurrentSize());
+  ASSERT_EQ(0, workspace.getCurrentOffset());
+
+  auto p0 = (char *)workspace.allocateBytes(100);
+  auto p1 = (char *)workspace.allocateBytes(200);
+
+  ASSERT_EQ(100, p1 - p0);
+  ASSERT_EQ(300, workspace.getCurrentOffset());
+  ASSERT_EQ(0, workspace.getSpilledSize());
+}
+
+TEST_F(WorkspaceTests, Spills_1) {
+  if (!Environment::getInstance().isCPU()) return;
+
+  Workspace workspace(1024);
+
+  workspace.allocateBytes(1000);
+  workspace.allocateBytes(100);
+
+  ASSERT_EQ(1000, workspace.getCurrentOffset());
+  ASSERT_EQ(100, workspace.getSpilledSize());
+
+  workspace.scopeOut();
+  workspace.scopeIn();
+
+  // cycle needed 1100 bytes, so buffer should've grown and spills should be released
+  ASSERT_EQ(1100, workspace.getCurrentSize());
+  ASSERT_EQ(0, workspace.getSpilledSize());
+  ASSERT_EQ(0, workspace.getCurrentOffset());
+}
+
+TEST_F(WorkspaceTests, ConcurrentAllocations_1) {
+  if (!Environment::getInstance().isCPU()) return;
+
+  const int numThreads = 8;
+  const int perThread = 1000;
+  const LongType chunk = 16;
+
+  Workspace workspace(numThreads * perThread * chunk / 2);
+  std::vector<char *> pointers(numThreads * perThread);
+
+  auto func = PRAGMA_THREADS_FOR {
+    for (auto t = start; t < stop; t++)
+      for (int e = 0; e < perThread; e++) {
+        auto p = (char *)workspace.allocateBytes(chunk);
+        memset(p, 1, chunk);
+        pointers[t * perThread + e] = p;
+      }
+  };
+
+  samediff::Threads::parallel_for(func, 0, numThreads, 1, numThreads);
+
+  // no allocation gets lost: whatever didn't fit into buffer went into spills
+  ASSERT_EQ(numThreads * perThread * chunk, workspace.getCurrentOffset() + workspace.getSpilledSize());
+
+  // and allocations never overlap
+  std::sort(pointers.begin(), pointers.end());
+  for (size_t e = 1; e < pointers.size(); e++) ASSERT_LE(pointers[e - 1] + chunk, pointers[e]);
+}
+
+TEST_F(WorkspaceTests, ThreadArenas_1) {
+  if (!Environment::getInstance().isCPU()) return;
+
+  Workspace workspace(4096);
+  workspace.setThreadArenas(4, 512);
+
+  ASSERT_EQ(4, workspace.getNumberOfThreadArenas());
+  ASSERT_EQ(512, workspace.getThreadArenaSize());
+
+  // first allocation carves arena out of the buffer, following ones reuse it
+  auto p0 = (char *)workspace.allocateBytes(100);
+  auto p1 = (char *)workspace.allocateBytes(100);
+
+  ASSERT_EQ(100, p1 - p0);
+  ASSERT_EQ(512, workspace.getCurrentOffset());
+
+  // allocations bigger than arena go straight to the shared buffer
+  workspace.allocateBytes(1024);
+  ASSERT_EQ(1536, workspace.getCurrentOffset());
+
+  workspace.scopeOut();
+  ASSERT_EQ(0, workspace.getCurrentOffset());
+
+  // after reset arena is carved again
+  workspace.allocateBytes(10);
+  ASSERT_EQ(512, workspace.getCurrentOffset());
+}
+
+TEST_F(WorkspaceTests, ThreadArenas_2) {
+  if (!Environment::getInstance().isCPU()) return;
+
+  const int numThreads = 8;
+  const int perThread = 1000;
+  const LongType chunk = 24;
+
+  Workspace workspace(numThreads * perThread * chunk / 2);
+  workspace.setThreadArenas(numThreads, 4096);
+  std::vector<char *> pointers(numThreads * perThread);
+
+  auto func = PRAGMA_THREADS_FOR {
+    for (auto t = start; t < stop; t++)
+      for (int e = 0; e < perThread; e++) {
+        auto p = (char *)workspace.allocateBytes(chunk);
+        memset(p, 1, chunk);
+        pointers[t * perThread + e] = p;
+      }
+  };
+
+  samediff::Threads::parallel_for(func, 0, numThreads, 1, numThreads);
+
+  std::sort(pointers.begin(), pointers.end());
+  for (size_t e = 1; e < pointers.size(); e++) ASSERT_LE(pointers[e - 1] + chunk, pointers[e]);
+
+  workspace.scopeOut();
+  workspace.scopeIn();
+
+  // buffer should be able to fit both whole cycle and all arenas next time
+  ASSERT_LE(numThreads * perThread * chunk + numThreads * 4096, workspace.getCurrentSize());
+  ASSERT_EQ(0, workspace.getSpilledSize());
+}
+
+TEST_F(WorkspaceTests, GrowthPolicy_1) {
+  if (!Environment::getInstance().isCPU()) return;
+
+  Workspace workspace(1024);
+
+  WorkspaceGrowthPolicy policy;
+  policy.growthFactor = 1.5;
+  policy.zeroFill = false;
+  workspace.setGrowthPolicy(policy);
+
+  workspace.allocateBytes(2000);
+  workspace.scopeOut();
+  workspace.scopeIn();
+
+  ASSERT_EQ(3000, workspace.getCurrentSize());
+
+  // cycle that fits into headroom doesn't trigger reallocation
+  workspace.allocateBytes(2500);
+  ASSERT_EQ(0, workspace.getSpilledSize());
+  workspace.scopeOut();
+  workspace.scopeIn();
+
+  ASSERT_EQ(3000, workspace.getCurrentSize());
+}
+
+TEST_F(WorkspaceTests, GrowthPolicy_2) {
+  if (!Environment::getInstance().isCPU()) return;
+
+  Workspace workspace(4096);
+
+  WorkspaceGrowthPolicy policy;
+  policy.shrinkAfterCycles = 3;
+  policy.shrinkThreshold = 0.5;
+  workspace.setGrowthPolicy(policy);
+
+  // two small cycles aren't enough to shrink
+  for (int e = 0; e < 2; e++) {
+    workspace.allocateBytes(e == 0 ? 1000 : 500);
+    workspace.scopeOut();
+    workspace.scopeIn();
+    ASSERT_EQ(4096, workspace.getCurrentSize());
+  }
+
+  // third one shrinks the buffer down to the high-water mark of the window
+  workspace.allocateBytes(700);
+  workspace.scopeOut();
+  workspace.scopeIn();
+  ASSERT_EQ(1000, workspace.getCurrentSize());
+}
+
+TEST_F(WorkspaceTests, SpillPool_1) {
+  if (!Environment::getInstance().isCPU()) return;
+
+  Workspace workspace(1024);
+
+  WorkspaceGrowthPolicy policy;
+  policy.maxSize = 1024;
+  policy.spillPoolLimit = 1024 * 1024;
+  workspace.setGrowthPolicy(policy);
+
+  workspace.allocateBytes(1024);
+  auto spill = workspace.allocateBytes(3000);
+  workspace.scopeOut();
+  workspace.scopeIn();
+
+  // buffer is capped, so spilled block goes to the pool instead of the system allocator
+  ASSERT_EQ(1024, workspace.getCurrentSize());
+  ASSERT_EQ(SpillPool::classCapacity(SpillPool::sizeClass(3000)), workspace.getPooledSpillsSize());
+
+  // and it's reused by next cycle with similar spill size
+  workspace.allocateBytes(1024);
+  auto reused = workspace.allocateBytes(2900);
+  ASSERT_EQ(spill, reused);
+  ASSERT_EQ(0, workspace.getPooledSpillsSize());
+}
+
+TEST_F(WorkspaceTests, SpillPool_2) {
+  for (LongType e = 1; e < 100000; e += 7) {
+    auto cls = SpillPool::sizeClass(e);
+    ASSERT_LE(e, SpillPool::classCapacity(cls));
+    if (cls > 0) ASSERT_GT(e, SpillPool::classCapacity(cls - 1));
+  }
+}
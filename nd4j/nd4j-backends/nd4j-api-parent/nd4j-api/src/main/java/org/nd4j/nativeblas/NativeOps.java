@@ -352,6 +352,14 @@ public interface NativeOps {
  long numpyHeaderLength(OpaqueDataBuffer opaqueDataBuffer,Pointer shapeBuffer);
 
  long getCachedMemory(int deviceId);
+ long getShapeCacheHits();
+ long getShapeCacheMisses();
+ long getShapeCacheEntries();
+ long getShapeCacheBytes();
+ long getTadCacheHits();
+ long getTadCacheMisses();
+ long getTadCacheEntries();
+ long getTadCacheBytes();
  Pointer lcScalarPointer(org.nd4j.nativeblas.OpaqueLaunchContext lc);
  Pointer lcReductionPointer(org.nd4j.nativeblas.OpaqueLaunchContext lc);
  Pointer lcAllocationPointer(org.nd4j.nativeblas.OpaqueLaunchContext lc);
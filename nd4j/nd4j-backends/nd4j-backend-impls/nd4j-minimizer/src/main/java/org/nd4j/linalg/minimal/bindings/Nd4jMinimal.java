@@ -2179,6 +2179,14 @@ public native int getDeviceMajor(int deviceId);
  * @return
  */
 public native @Cast("sd::LongType") long getCachedMemory(int deviceId);
+public native @Cast("sd::LongType") long getShapeCacheHits();
+public native @Cast("sd::LongType") long getShapeCacheMisses();
+public native @Cast("sd::LongType") long getShapeCacheEntries();
+public native @Cast("sd::LongType") long getShapeCacheBytes();
+public native @Cast("sd::LongType") long getTadCacheHits();
+public native @Cast("sd::LongType") long getTadCacheMisses();
+public native @Cast("sd::LongType") long getTadCacheEntries();
+public native @Cast("sd::LongType") long getTadCacheBytes();
 
 /**
  *